@@ -1,8 +1,14 @@
 # Create target to discover tests
+# The tests are read from the test manifest of the executable when it has one, without running it
 function (cpputest_buildtime_discover_tests EXECUTABLE)
+    set(MANIFEST_READER "")
+    if (TARGET CppUTestManifestReader)
+        add_dependencies(${EXECUTABLE} CppUTestManifestReader)
+        set(MANIFEST_READER "$<TARGET_FILE:CppUTestManifestReader>")
+    endif (TARGET CppUTestManifestReader)
     add_custom_command (TARGET ${EXECUTABLE}
 			POST_BUILD
-			COMMAND ${CMAKE_COMMAND} -DTESTS_DETAILED:BOOL=${TESTS_DETAILED} -DEXECUTABLE=${EXECUTABLE} -P ${PROJECT_SOURCE_DIR}/cmake/Scripts/CppUTestBuildTimeDiscoverTests.cmake
+			COMMAND ${CMAKE_COMMAND} -DTESTS_DETAILED:BOOL=${TESTS_DETAILED} -DEXECUTABLE=${EXECUTABLE} -DMANIFEST_READER=${MANIFEST_READER} -P ${PROJECT_SOURCE_DIR}/cmake/Scripts/CppUTestBuildTimeDiscoverTests.cmake
 			WORKING_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR}
 			COMMENT "Discovering Tests in ${EXECUTABLE}"
 			VERBATIM)
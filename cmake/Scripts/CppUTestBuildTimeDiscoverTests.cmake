@@ -7,6 +7,8 @@
 #
 # Steps to generate ADD_TEST() commands build time
 # - Read CTestTestfile.cmake
+# - List the tests with MANIFEST_READER when the executable has a test manifest,
+#   otherwise by running the executable
 # - Create update entries
 # - Remove duplicate entries
 # - Write new CTestTestfile.cmake
@@ -55,24 +57,43 @@ endfunction()
 set(CTESTFNAME "${CMAKE_CURRENT_BINARY_DIR}/CTestTestfile.cmake")
 file(STRINGS ${CTESTFNAME} CTESTTESTS)
 set(EXECUTABLE_CMD "${CMAKE_CURRENT_BINARY_DIR}/${EXECUTABLE}")
+set(DISCOVER_CMD "${EXECUTABLE_CMD}")
+set(DISCOVER_FILE "")
+
+if (MANIFEST_READER)
+  execute_process(COMMAND ${MANIFEST_READER} -lg ${EXECUTABLE_CMD}
+    RESULT_VARIABLE MANIFEST_RESULT
+    OUTPUT_QUIET
+    ERROR_QUIET)
+  if (${MANIFEST_RESULT} EQUAL 0)
+    set(DISCOVER_CMD "${MANIFEST_READER}")
+    set(DISCOVER_FILE "${EXECUTABLE_CMD}")
+  endif (${MANIFEST_RESULT} EQUAL 0)
+endif (MANIFEST_READER)
 
 if (TESTS_DETAILED)
   set(DISCOVER_ARG "-ln")
-  buildtime_discover_tests("${EXECUTABLE_CMD}" "${DISCOVER_ARG}" TestList_GroupsAndNames)
+  buildtime_discover_tests("${DISCOVER_CMD}" "${DISCOVER_ARG};${DISCOVER_FILE}" TestList_GroupsAndNames)
   set(lastgroup "")
   foreach(testfullname ${TestList_GroupsAndNames})
     string(REGEX MATCH "^([^/.]+)" groupname ${testfullname})
-    string(REGEX MATCH "([^/.]+)$" testname ${testfullname})
+    string(REGEX REPLACE "^[^.]+\\." "" testname ${testfullname})
     if (NOT ("${groupname}" STREQUAL "${lastgroup}"))
       message("TestGroup: ${groupname}:")
       set(lastgroup "${groupname}")
     endif (NOT ("${groupname}" STREQUAL "${lastgroup}"))
     message("... ${testname}")
-    buildtime_add_test(${EXECUTABLE}.${testfullname} ${EXECUTABLE_CMD} -sg ${groupname} -sn ${testname} -c)
+    # The manifest lists the rows of a parameterized test as name/*, which -sn matches strictly
+    if (testname MATCHES "/\\*$")
+      string(REGEX REPLACE "\\*$" "" rowsname ${testname})
+      buildtime_add_test(${EXECUTABLE}.${groupname}.${rowsname} ${EXECUTABLE_CMD} -sg ${groupname} -sn ${testname} -c)
+    else (testname MATCHES "/\\*$")
+      buildtime_add_test(${EXECUTABLE}.${testfullname} ${EXECUTABLE_CMD} -sg ${groupname} -sn ${testname} -c)
+    endif (testname MATCHES "/\\*$")
   endforeach()
 else (TESTS_DETAILED)
   set(DISCOVER_ARG "-lg")
-  buildtime_discover_tests("${EXECUTABLE_CMD}" "${DISCOVER_ARG}" TestList_Groups)
+  buildtime_discover_tests("${DISCOVER_CMD}" "${DISCOVER_ARG};${DISCOVER_FILE}" TestList_Groups)
   foreach(group ${TestList_Groups})
     message("TestGroup: ${group}")
     buildtime_add_test(${EXECUTABLE}.${group} "${EXECUTABLE_CMD}" -sg ${group} -c)
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2007, Michael Feathers, James Grenning and Bas Vodde
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE EARLIER MENTIONED AUTHORS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <copyright holder> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// AllocationFailureRunner runs a test once to count the allocations it makes
+// and then runs it again once per allocation, failing that allocation. A test
+// that fails on one of the reruns does not handle running out of memory.
+// Allocations made while the fixture of the test is constructed or destroyed
+// are left alone.
+//
+// With -p, the counting run and the reruns of a test all run in one separate
+// process. The reruns are counted apart from the tests that ran.
+//
+
+#ifndef D_AllocationFailureRunner_h
+#define D_AllocationFailureRunner_h
+
+#include "TestMemoryAllocator.h"
+
+class UtestShell;
+class TestPlugin;
+class TestResult;
+
+class AllocationFailureRunner
+{
+public:
+    AllocationFailureRunner();
+    virtual ~AllocationFailureRunner();
+
+    virtual void runOneTest(UtestShell& test, TestPlugin* plugin, TestResult& result);
+    virtual void runOneTestInCurrentProcess(UtestShell& test, TestPlugin* plugin, TestResult& result);
+
+private:
+    friend class AllocationFailureAttemptShell;
+
+    void installAllocators(UtestShell& test, unsigned allocationToFail);
+    void removeAllocators();
+
+    FaultInjectionSchedule schedule_;
+    FaultInjectionMemoryAllocator mallocAllocator_;
+    FaultInjectionMemoryAllocator newAllocator_;
+    FaultInjectionMemoryAllocator newArrayAllocator_;
+
+    AllocationFailureRunner(const AllocationFailureRunner&);
+    AllocationFailureRunner& operator=(const AllocationFailureRunner&);
+};
+
+#endif
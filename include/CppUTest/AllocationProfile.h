@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2007, Michael Feathers, James Grenning and Bas Vodde
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE EARLIER MENTIONED AUTHORS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <copyright holder> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef D_AllocationProfile_h
+#define D_AllocationProfile_h
+
+#include "CppUTest/TestPlugin.h"
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// AllocationProfile.h
+//
+// Aggregates the allocations seen by the memory leak detector per call site:
+// the number of allocations, the bytes allocated and the peak of live bytes.
+// The profile also remembers which test and which test group allocated the
+// most at each site. Attach it with MemoryLeakDetector::setAllocationProfile
+// and mark the test boundaries with the AllocationProfilePlugin, or use -ap
+// (or -apcollapsed) on the command line to print it at the end of the run.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+struct AllocationCallSite
+{
+    const char* file_;
+    int line_;
+    size_t allocations_;
+    size_t bytes_;
+    size_t liveBytes_;
+    size_t peakLiveBytes_;
+
+    size_t testBytes_;
+    size_t groupBytes_;
+    size_t heaviestTestBytes_;
+    const char* heaviestTest_;
+    size_t heaviestGroupBytes_;
+    const char* heaviestGroup_;
+};
+
+/*
+ * Call sites are kept in an open addressing hash table keyed on the file
+ * pointer and the line, allocated with the platform malloc so that profiling
+ * never allocates through the detector it is attached to. The names of the
+ * tests and groups are copied when they start, so a site can name a test
+ * whose shell is gone or has moved on to another row.
+ */
+class AllocationProfile
+{
+public:
+    enum ProfileFormat
+    {
+        profile_table, profile_collapsed
+    };
+
+    AllocationProfile();
+    virtual ~AllocationProfile();
+
+    void allocated(const char* file, int line, size_t size);
+    void freed(const char* file, int line, size_t size);
+
+    void startTest(UtestShell& test);
+    void endTest();
+    void endGroup();
+    void clear();
+
+    size_t getNumberOfCallSites() const;
+    const AllocationCallSite* getCallSite(const char* file, int line) const;
+
+    SimpleString asString(ProfileFormat format = profile_table) const;
+
+private:
+    AllocationCallSite* sites_;
+    size_t capacity_;
+    size_t numberOfSites_;
+    char** names_;
+    size_t namesCapacity_;
+    size_t numberOfNames_;
+    const char* currentTest_;
+    const char* currentGroup_;
+
+    size_t indexOf(const char* file, int line) const;
+    AllocationCallSite* findSite(const char* file, int line) const;
+    AllocationCallSite* findOrAddSite(const char* file, int line);
+    bool grow();
+    const char* keepName(const SimpleString& name);
+    void forgetNames();
+
+    AllocationProfile(const AllocationProfile&);
+    AllocationProfile& operator=(const AllocationProfile&);
+};
+
+class AllocationProfilePlugin : public TestPlugin
+{
+public:
+    AllocationProfilePlugin(const SimpleString& name, AllocationProfile* profile);
+    virtual ~AllocationProfilePlugin();
+
+    virtual void preTestAction(UtestShell& test, TestResult& result) _override;
+    virtual void postTestAction(UtestShell& test, TestResult& result) _override;
+
+private:
+    AllocationProfile* profile_;
+
+    AllocationProfilePlugin(const AllocationProfilePlugin&);
+    AllocationProfilePlugin& operator=(const AllocationProfilePlugin&);
+};
+
+#endif
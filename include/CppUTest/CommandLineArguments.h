@@ -42,40 +42,67 @@ public:
 
     bool parse(TestPlugin* plugin);
     bool isVerbose() const;
+    bool isPrintingPeakMemory() const;
     bool isColor() const;
+    bool isBufferedOutput() const;
+    bool isInstallingCrashHandler() const;
+    bool isWritingCrashBacktrace() const;
     bool isListingTestGroupNames() const;
     bool isListingTestGroupAndCaseNames() const;
+    bool isListingTestManifest() const;
+    bool isProfilingAllocations() const;
+    bool isCollapsedAllocationProfile() const;
+    bool isFailingEachAllocation() const;
     int getRepeatCount() const;
+    bool isShuffling() const;
+    unsigned long getShuffleSeed() const;
     const TestFilter* getGroupFilters() const;
     const TestFilter* getNameFilters() const;
     bool isJUnitOutput() const;
+    bool isJUnitSingleFileOutput() const;
+    bool isJsonOutput() const;
     bool isEclipseOutput() const;
     bool runTestsInSeperateProcess() const;
     const SimpleString& getPackageName() const;
+    bool isResuming() const;
+    SimpleString getJournalFileName() const;
     const char* usage() const;
 
 private:
 
     enum OutputType
     {
-        OUTPUT_ECLIPSE, OUTPUT_JUNIT
+        OUTPUT_ECLIPSE, OUTPUT_JUNIT, OUTPUT_JUNIT_SINGLE_FILE, OUTPUT_JSON
     };
     int ac_;
     const char** av_;
 
     bool verbose_;
+    bool peakMemory_;
     bool color_;
+    bool bufferedOutput_;
+    bool crashHandler_;
+    bool crashBacktrace_;
     bool runTestsAsSeperateProcess_;
     bool listTestGroupNames_;
     bool listTestGroupAndCaseNames_;
+    bool listTestManifest_;
+    bool resume_;
+    bool allocationProfile_;
+    bool collapsedAllocationProfile_;
+    bool failEachAllocation_;
     int repeat_;
+    bool shuffle_;
+    unsigned long shuffleSeed_;
     TestFilter* groupFilters_;
     TestFilter* nameFilters_;
     OutputType outputType_;
     SimpleString packageName_;
+    SimpleString journalFileName_;
 
     SimpleString getParameterField(int ac, const char** av, int& i, const SimpleString& parameterName);
     void SetRepeatCount(int ac, const char** av, int& index);
+    void SetShuffleSeed(int ac, const char** av, int& index);
     void AddGroupFilter(int ac, const char** av, int& index);
     void AddStrictGroupFilter(int ac, const char** av, int& index);
     void AddNameFilter(int ac, const char** av, int& index);
@@ -83,6 +110,7 @@ private:
     void AddTestToRunBasedOnVerboseOutput(int ac, const char** av, int& index, const char* parameterName);
     bool SetOutputType(int ac, const char** av, int& index);
     void SetPackageName(int ac, const char** av, int& index);
+    void SetJournalFileName(int ac, const char** av, int& index);
 
     CommandLineArguments(const CommandLineArguments&);
     CommandLineArguments& operator=(const CommandLineArguments&);
@@ -37,6 +37,7 @@ class TestRegistry;
 
 #define DEF_PLUGIN_MEM_LEAK "MemoryLeakPlugin"
 #define DEF_PLUGIN_SET_POINTER "SetPointerPlugin"
+#define DEF_PLUGIN_ALLOCATION_PROFILE "AllocationProfilePlugin"
 
 class CommandLineTestRunner
 {
@@ -52,6 +53,7 @@ public:
 protected:
     virtual TestOutput* createJUnitOutput(const SimpleString& packageName);
     virtual TestOutput* createConsoleOutput();
+    virtual TestOutput* createJsonOutput();
     virtual TestOutput* createCompositeOutput(TestOutput* outputOne, TestOutput* outputTwo);
 
     TestOutput* output_;
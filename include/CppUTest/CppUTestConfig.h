@@ -85,6 +85,86 @@
  #endif
 #endif
 
+/* Does the compiler use the C++14 sized and the C++17 aligned operator new/delete?
+ *   When it does, these are overloaded for memory leak detection too. Otherwise they would
+ *   bypass the memory leak detector. Aligned new needs std::align_val_t from <new>.
+ */
+
+#ifndef CPPUTEST_USE_SIZED_DEALLOCATION
+ #if defined(__cpp_sized_deallocation)
+  #define CPPUTEST_USE_SIZED_DEALLOCATION 1
+ #else
+  #define CPPUTEST_USE_SIZED_DEALLOCATION 0
+ #endif
+#endif
+
+#ifndef CPPUTEST_USE_ALIGNED_NEW
+ #if CPPUTEST_USE_STD_CPP_LIB && defined(__cpp_aligned_new)
+  #define CPPUTEST_USE_ALIGNED_NEW 1
+ #else
+  #define CPPUTEST_USE_ALIGNED_NEW 0
+ #endif
+#endif
+
+/* Relaxed atomic add to an int, and exchange of an int for zero, used for counting the passed
+ *   checks of all threads and handing them to the test result. Without the atomic builtins of the
+ *   compiler the add is a plain add and the exchange is left undefined, so that the test result
+ *   takes the counter with plain operations. That is fine as long as only one thread does checks.
+ */
+
+#ifndef CPPUTEST_ATOMIC_ADD
+ #if defined(__ATOMIC_RELAXED)
+  #define CPPUTEST_ATOMIC_ADD(counter, amount) ((void) __atomic_fetch_add(&(counter), (amount), __ATOMIC_RELAXED))
+ #else
+  #define CPPUTEST_ATOMIC_ADD(counter, amount) ((void) ((counter) += (amount)))
+ #endif
+#endif
+
+#if !defined(CPPUTEST_ATOMIC_TAKE) && defined(__ATOMIC_RELAXED)
+ #define CPPUTEST_ATOMIC_TAKE(counter) __atomic_exchange_n(&(counter), 0, __ATOMIC_RELAXED)
+#endif
+
+/* Can a word be copied out of memory that need not be aligned with __builtin_memcpy?
+ *   gcc and clang turn such a copy into a single load. Without it, the word is put together
+ *   byte by byte.
+ */
+
+#ifndef CPPUTEST_HAVE_BUILTIN_MEMCPY
+ #if defined(__GNUC__)
+  #define CPPUTEST_HAVE_BUILTIN_MEMCPY 1
+ #else
+  #define CPPUTEST_HAVE_BUILTIN_MEMCPY 0
+ #endif
+#endif
+
+/* Is the test manifest enabled?
+ *   The test macros then also put a record of every test in the cpputest_manifest section of the
+ *   executable. It is constant data, so the tests can be listed from the executable file without
+ *   running it. The section needs the ELF format and gcc or clang.
+ */
+
+#ifndef CPPUTEST_USE_TEST_MANIFEST
+ #if defined(__ELF__) && defined(__GNUC__) && !defined(CPPUTEST_TEST_MANIFEST_DISABLED)
+  #define CPPUTEST_USE_TEST_MANIFEST 1
+ #else
+  #define CPPUTEST_USE_TEST_MANIFEST 0
+ #endif
+#endif
+
+/* Are the tests found through a linker section?
+ *   TEST and IGNORE_TEST then put a pointer to their descriptor in the cpputest_tests section instead
+ *   of running a static installer each. The default registry walks the section when it is first used.
+ *   The section needs the ELF format and gcc or clang.
+ */
+
+#ifndef CPPUTEST_USE_TEST_DESCRIPTOR_SECTION
+ #if defined(__ELF__) && defined(__GNUC__) && !defined(CPPUTEST_TEST_DESCRIPTOR_SECTION_DISABLED)
+  #define CPPUTEST_USE_TEST_DESCRIPTOR_SECTION 1
+ #else
+  #define CPPUTEST_USE_TEST_DESCRIPTOR_SECTION 0
+ #endif
+#endif
+
 /* Create a __no_return__ macro, which is used to flag a function as not returning.
  * Used for functions that always throws for instance.
  *
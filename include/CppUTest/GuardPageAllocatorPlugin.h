@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2007, Michael Feathers, James Grenning and Bas Vodde
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE EARLIER MENTIONED AUTHORS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <copyright holder> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef D_GuardPageAllocatorPlugin_h
+#define D_GuardPageAllocatorPlugin_h
+
+#include "CppUTest/TestPlugin.h"
+#include "CppUTest/TestMemoryAllocator.h"
+
+class TestFilter;
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// GuardPageAllocatorPlugin.h
+//
+// Runs the selected test groups with guard page allocators for malloc, new and
+// new []. Groups are selected with guardTestGroups or -pguardpages[=group],
+// -pguardsample=N guards only every Nth allocation and -pguardunderrun places
+// the guard page in front of the memory instead of behind it.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+class GuardPageAllocatorPlugin : public TestPlugin
+{
+public:
+    GuardPageAllocatorPlugin(const SimpleString& name = "GuardPageAllocatorPlugin");
+    virtual ~GuardPageAllocatorPlugin();
+
+    virtual void guardTestGroups(const SimpleString& groupFilter);
+    virtual void setSamplingInterval(unsigned interval);
+    virtual void setGuardPlacement(GuardPageMemoryAllocator::GuardPlacement placement);
+
+    virtual bool isGuarding(const SimpleString& group) const;
+
+    virtual void preTestAction(UtestShell& test, TestResult& result) _override;
+    virtual void postTestAction(UtestShell& test, TestResult& result) _override;
+    virtual bool parseArguments(int ac, const char** av, int index) _override;
+
+private:
+    TestFilter* groupFilters_;
+
+    GuardPageMemoryAllocator mallocAllocator_;
+    GuardPageMemoryAllocator newAllocator_;
+    GuardPageMemoryAllocator newArrayAllocator_;
+
+    TestMemoryAllocator* originalMallocAllocator_;
+    TestMemoryAllocator* originalNewAllocator_;
+    TestMemoryAllocator* originalNewArrayAllocator_;
+
+    void setGuardPageAllocators();
+    void removeGuardPageAllocators();
+
+    GuardPageAllocatorPlugin(const GuardPageAllocatorPlugin&);
+    GuardPageAllocatorPlugin& operator=(const GuardPageAllocatorPlugin&);
+};
+
+#endif
@@ -76,4 +76,39 @@ protected:
 
 };
 
+struct JUnitSingleFileTestOutputImpl;
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  JUnitSingleFileTestOutput
+//
+//  Writes all test groups as <testsuite> elements into one <testsuites>
+//  file. The test cases are formatted into a reused buffer so the file is
+//  written once per group without allocating per test case.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+class JUnitSingleFileTestOutput: public JUnitTestOutput
+{
+public:
+    JUnitSingleFileTestOutput();
+    virtual ~JUnitSingleFileTestOutput();
+
+    virtual void printTestsStarted() _override;
+    virtual void printTestsEnded(const TestResult& result) _override;
+    virtual void printCurrentTestStarted(const UtestShell& test) _override;
+    virtual void printCurrentTestEnded(const TestResult& res) _override;
+    virtual void printCurrentGroupStarted(const UtestShell& test) _override;
+    virtual void printCurrentGroupEnded(const TestResult& res) _override;
+
+    virtual void print(const char*) _override;
+    virtual void print(long) _override;
+    virtual void print(const TestFailure& failure) _override;
+
+    virtual SimpleString createSingleFileName();
+
+protected:
+    JUnitSingleFileTestOutputImpl* singleFileImpl_;
+};
+
 #endif
@@ -33,11 +33,13 @@ enum MemLeakPeriod
     mem_leak_period_all,
     mem_leak_period_disabled,
     mem_leak_period_enabled,
-    mem_leak_period_checking
+    mem_leak_period_checking,
+    mem_leak_period_test_group
 };
 
 class TestMemoryAllocator;
 class SimpleMutex;
+class AllocationProfile;
 
 class MemoryLeakFailure
 {
@@ -89,6 +91,10 @@ public:
     void reportDeallocateNonAllocatedMemoryFailure(const char* freeFile, int freeLine, TestMemoryAllocator* freeAllocator, MemoryLeakFailure* reporter);
     void reportMemoryCorruptionFailure(MemoryLeakDetectorNode* node, const char* freeFile, int freeLineNumber, TestMemoryAllocator* freeAllocator, MemoryLeakFailure* reporter);
     void reportAllocationDeallocationMismatchFailure(MemoryLeakDetectorNode* node, const char* freeFile, int freeLineNumber, TestMemoryAllocator* freeAllocator, MemoryLeakFailure* reporter);
+    void reportDeallocationSizeMismatchFailure(MemoryLeakDetectorNode* node, size_t freeSize, const char* freeFile, int freeLineNumber, TestMemoryAllocator* freeAllocator, MemoryLeakFailure* reporter);
+    void reportDeallocationAlignmentMismatchFailure(MemoryLeakDetectorNode* node, size_t freeAlignment, const char* freeFile, int freeLineNumber, TestMemoryAllocator* freeAllocator, MemoryLeakFailure* reporter);
+    void reportCorruptedMemory(MemoryLeakDetectorNode* node);
+    void reportWriteToFreedMemory(MemoryLeakDetectorNode* node);
     char* toString();
 
 private:
@@ -117,7 +123,9 @@ private:
 struct MemoryLeakDetectorNode
 {
     MemoryLeakDetectorNode() :
-        size_(0), number_(0), memory_(0), file_(0), line_(0), allocator_(0), period_(mem_leak_period_enabled), next_(0)
+        size_(0), number_(0), memory_(0), file_(0), line_(0), allocator_(0), period_(mem_leak_period_enabled),
+        alignment_(0), headRedzoneSize_(0), tailRedzoneSize_(0), redzonePattern_(0), allocatedSeperately_(false), freeFile_(0), freeLine_(0), freeAllocator_(0),
+        next_(0), previousInPeriod_(0), nextInPeriod_(0)
     {
     }
 
@@ -130,10 +138,24 @@ struct MemoryLeakDetectorNode
     int line_;
     TestMemoryAllocator* allocator_;
     MemLeakPeriod period_;
+    size_t alignment_; /* 0 unless allocated with allocAlignedMemory */
+    size_t headRedzoneSize_;
+    size_t tailRedzoneSize_;
+    unsigned char redzonePattern_;
+    bool allocatedSeperately_;
+
+    /* Only used while the memory is in quarantine */
+    const char* freeFile_;
+    int freeLine_;
+    TestMemoryAllocator* freeAllocator_;
 
 private:
     friend struct MemoryLeakDetectorList;
+    friend struct MemoryLeakDetectorTable;
+    friend class MemoryLeakDetector;
     MemoryLeakDetectorNode* next_;
+    MemoryLeakDetectorNode* previousInPeriod_;
+    MemoryLeakDetectorNode* nextInPeriod_;
 };
 
 struct MemoryLeakDetectorList
@@ -161,9 +183,17 @@ private:
     MemoryLeakDetectorNode* head_;
 };
 
+/*
+ * Next to the hash table, every node is kept in a list of the period it was
+ * allocated in, with a count per period. Counting and reporting the leaks of
+ * a period only visits the nodes of that period.
+ */
 struct MemoryLeakDetectorTable
 {
+    MemoryLeakDetectorTable();
+
     void clearAllAccounting(MemLeakPeriod period);
+    void moveLeaksToPeriod(MemLeakPeriod fromPeriod, MemLeakPeriod toPeriod);
 
     void addNewNode(MemoryLeakDetectorNode* node);
     MemoryLeakDetectorNode* retrieveNode(char* memory);
@@ -178,11 +208,19 @@ struct MemoryLeakDetectorTable
 private:
     unsigned long hash(char* memory);
 
+    void addToPeriodList(MemoryLeakDetectorNode* node);
+    void removeFromPeriodList(MemoryLeakDetectorNode* node);
+    MemoryLeakDetectorNode* getFirstLeakInPeriodListsFrom(int periodList, MemLeakPeriod period);
+    bool periodListIsInPeriod(int periodList, MemLeakPeriod period);
+
     enum
     {
-        hash_prime = MEMORY_LEAK_HASH_TABLE_SIZE
+        hash_prime = MEMORY_LEAK_HASH_TABLE_SIZE,
+        amount_of_periods = mem_leak_period_test_group + 1
     };
     MemoryLeakDetectorList table_[hash_prime];
+    MemoryLeakDetectorNode* periodLists_[amount_of_periods];
+    int periodCounts_[amount_of_periods];
 };
 
 class MemoryLeakDetector
@@ -200,7 +238,13 @@ public:
     void startChecking();
     void stopChecking();
 
+    /* What the setup of a test group allocates lives until its teardown. It is kept in a period
+     * of its own, so the checking periods of the tests in between do not see it. */
+    void startCheckingTestGroup();
+    void markTestGroupPeriodLeaksAsNonCheckingPeriod();
+
     const char* report(MemLeakPeriod period);
+    const char* reportCorruptedMemory(MemLeakPeriod period);
     void markCheckingPeriodLeaksAsNonCheckingPeriod();
     int totalMemoryLeaks(MemLeakPeriod period);
     void clearAllAccounting(MemLeakPeriod period);
@@ -212,13 +256,47 @@ public:
     void deallocMemory(TestMemoryAllocator* allocator, void* memory, const char* file, int line, bool allocatNodesSeperately = false);
     char* reallocMemory(TestMemoryAllocator* allocator, char* memory, size_t size, const char* file, int line, bool allocatNodesSeperately = false);
 
+    /* Over-aligned allocation and sized deallocation, as done by the C++17 and C++14 operator
+     * new and delete. The alignment is kept with the memory and has to be passed again when
+     * freeing it. A size or alignment that differs from the allocation is reported as a failure. */
+    char* allocAlignedMemory(TestMemoryAllocator* allocator, size_t size, size_t alignment);
+    char* allocAlignedMemory(TestMemoryAllocator* allocator, size_t size, size_t alignment, const char* file, int line);
+    void deallocAlignedMemory(TestMemoryAllocator* allocator, void* memory, size_t alignment);
+    void deallocAlignedMemory(TestMemoryAllocator* allocator, void* memory, size_t alignment, const char* file, int line);
+    void deallocSizedMemory(TestMemoryAllocator* allocator, void* memory, size_t size, size_t alignment);
+    void deallocSizedMemory(TestMemoryAllocator* allocator, void* memory, size_t size, size_t alignment, const char* file, int line);
+
     void invalidateMemory(char* memory);
     void removeMemoryLeakInformationWithoutCheckingOrDeallocatingTheMemoryButDeallocatingTheAccountInformation(TestMemoryAllocator* allocator, void* memory, bool allocatNodesSeperately);
     enum
     {
-        memory_corruption_buffer_size = 3
+        memory_corruption_buffer_size = 3,
+        default_redzone_pattern = 0xFD,
+        default_freed_memory_pattern = 0xCD
     };
 
+    /* Redzones are filled with the redzone pattern and checked when the memory is
+     * freed and by reportCorruptedMemory. The head redzone is rounded up so the
+     * memory stays aligned. Settings apply to memory allocated after the change. */
+    void setRedzoneSizes(size_t headRedzoneSize, size_t tailRedzoneSize);
+    void setPoisonPatterns(unsigned char redzonePattern, unsigned char freedMemoryPattern);
+
+    /* Memory freed while checking is poisoned and held back in a FIFO of at most
+     * maximumSize bytes instead of being freed. It is verified when it leaves the
+     * quarantine, which happens at the latest in flushQuarantine. 0 turns it off. */
+    void setQuarantineSize(size_t maximumSize);
+    const char* flushQuarantine();
+
+    /* Every allocation and deallocation is also passed to the profile, if any. */
+    void setAllocationProfile(AllocationProfile* profile);
+
+    /* Live memory allocated in the current (or last) checking period and its high
+     * water mark, in bytes and blocks. startChecking resets them. */
+    size_t getCurrentMemoryInUse();
+    size_t getCurrentBlocksInUse();
+    size_t getPeakMemoryInUse();
+    size_t getPeakBlocksInUse();
+
     unsigned getCurrentAllocationNumber();
 
     SimpleMutex* getMutex(void);
@@ -230,25 +308,45 @@ private:
     bool doAllocationTypeChecking_;
     unsigned allocationSequenceNumber_;
     SimpleMutex* mutex_;
-
-    char* allocateMemoryWithAccountingInformation(TestMemoryAllocator* allocator, size_t size, const char* file, int line, bool allocatNodesSeperately);
-    char* reallocateMemoryWithAccountingInformation(TestMemoryAllocator* allocator, char* memory, size_t size, const char* file, int line, bool allocatNodesSeperately);
-    MemoryLeakDetectorNode* createMemoryLeakAccountingInformation(TestMemoryAllocator* allocator, size_t size, char* memory, bool allocatNodesSeperately);
-
-
-    bool validMemoryCorruptionInformation(char* memory);
+    size_t headRedzoneSize_;
+    size_t tailRedzoneSize_;
+    unsigned char redzonePattern_;
+    unsigned char freedMemoryPattern_;
+    size_t quarantineMaximumSize_;
+    size_t quarantineSize_;
+    MemoryLeakDetectorNode* quarantineHead_;
+    MemoryLeakDetectorNode* quarantineTail_;
+    AllocationProfile* allocationProfile_;
+    size_t currentMemoryInUse_;
+    size_t currentBlocksInUse_;
+    size_t peakMemoryInUse_;
+    size_t peakBlocksInUse_;
+
+    char* allocateMemoryWithAccountingInformation(TestMemoryAllocator* allocator, size_t size, size_t headRedzoneSize, const char* file, int line, bool allocatNodesSeperately);
+    char* reallocateMemoryWithAccountingInformation(TestMemoryAllocator* allocator, char* memory, size_t size, size_t headRedzoneSize, const char* file, int line, bool allocatNodesSeperately);
+    MemoryLeakDetectorNode* createMemoryLeakAccountingInformation(TestMemoryAllocator* allocator, size_t size, char* memory, size_t headRedzoneSize, bool allocatNodesSeperately);
+
+
+    bool validMemoryCorruptionInformation(MemoryLeakDetectorNode* node);
     bool matchingAllocation(TestMemoryAllocator *alloc_allocator, TestMemoryAllocator *free_allocator);
 
-    void storeLeakInformation(MemoryLeakDetectorNode * node, char *new_memory, size_t size, TestMemoryAllocator *allocator, const char *file, int line);
+    void storeLeakInformation(MemoryLeakDetectorNode * node, char *new_memory, size_t size, size_t alignment, size_t headRedzoneSize, TestMemoryAllocator *allocator, const char *file, int line, bool allocatedSeperately);
+    void checkAndDeallocMemory(TestMemoryAllocator* allocator, void* memory, size_t size, size_t alignment, const char* file, int line);
+    void countAllocation(MemoryLeakDetectorNode* node);
+    void countDeallocation(MemoryLeakDetectorNode* node);
     void ConstructMemoryLeakReport(MemLeakPeriod period);
 
-    size_t sizeOfMemoryWithCorruptionInfo(size_t size);
-    MemoryLeakDetectorNode* getNodeFromMemoryPointer(char* memory, size_t size);
+    size_t headRedzoneSizeFor(TestMemoryAllocator* allocator);
+    size_t sizeOfMemoryWithCorruptionInfo(TestMemoryAllocator* allocator, size_t size);
+    MemoryLeakDetectorNode* getNodeFromMemoryPointer(TestMemoryAllocator* allocator, char* memory, size_t size, size_t headRedzoneSize);
 
-    char* reallocateMemoryAndLeakInformation(TestMemoryAllocator* allocator, char* memory, size_t size, const char* file, int line, bool allocatNodesSeperately);
+    void addMemoryCorruptionInformation(MemoryLeakDetectorNode* node);
+    bool checkForCorruption(MemoryLeakDetectorNode* node, size_t size, size_t alignment, const char* file, int line, TestMemoryAllocator* allocator);
 
-    void addMemoryCorruptionInformation(char* memory);
-    void checkForCorruption(MemoryLeakDetectorNode* node, const char* file, int line, TestMemoryAllocator* allocator, bool allocateNodesSeperately);
+    bool shouldQuarantine(MemoryLeakDetectorNode* node);
+    void addToQuarantine(MemoryLeakDetectorNode* node, TestMemoryAllocator* allocator, const char* file, int line);
+    MemoryLeakDetectorNode* removeOldestFromQuarantine();
+    bool releaseFromQuarantine(MemoryLeakDetectorNode* node);
 };
 
 #endif
@@ -43,6 +43,14 @@
     void operator delete(void* mem, const char* file, int line) UT_NOTHROW;
     void operator delete[](void* mem, const char* file, int line) UT_NOTHROW;
 
+    /* Over-aligned types look for the aligned version of the new macro first */
+    #if CPPUTEST_USE_ALIGNED_NEW
+    void* operator new(size_t size, std::align_val_t alignment, const char* file, int line) UT_THROW (std::bad_alloc);
+    void* operator new[](size_t size, std::align_val_t alignment, const char* file, int line) UT_THROW (std::bad_alloc);
+    void operator delete(void* mem, std::align_val_t alignment, const char* file, int line) UT_NOTHROW;
+    void operator delete[](void* mem, std::align_val_t alignment, const char* file, int line) UT_NOTHROW;
+    #endif
+
 #endif
 
 #define new new(__FILE__, __LINE__)
@@ -39,6 +39,13 @@ extern void crash_on_allocation_number(unsigned alloc_number);
 class MemoryLeakDetector;
 class MemoryLeakFailure;
 
+struct MemoryAllocationStatistics
+{
+    size_t allocations;
+    size_t deallocations;
+    size_t bytesAllocated;
+};
+
 class MemoryLeakWarningPlugin: public TestPlugin
 {
 public:
@@ -47,6 +54,8 @@ public:
 
     virtual void preTestAction(UtestShell& test, TestResult& result) _override;
     virtual void postTestAction(UtestShell& test, TestResult& result) _override;
+    virtual void preTestGroupFixtureAction(TestGroupFixtureShell& fixture, TestResult& result) _override;
+    virtual void postTestGroupFixtureAction(TestGroupFixtureShell& fixture, TestResult& result) _override;
 
     virtual const char* FinalReport(int toBeDeletedLeaks = 0);
 
@@ -67,7 +76,11 @@ public:
     static void turnOffNewDeleteOverloads();
     static void turnOnNewDeleteOverloads();
     static void turnOnThreadSafeNewDeleteOverloads();
+    static void turnOnStatisticsOnlyNewDeleteOverloads();
     static bool areNewDeleteOverloaded();
+
+    static MemoryAllocationStatistics getAllocationStatistics();
+    static void resetAllocationStatistics();
 private:
     MemoryLeakDetector* memLeakDetector_;
     bool ignoreAllWarnings_;
@@ -64,9 +64,12 @@ typedef void* PlatformSpecificFile;
 extern PlatformSpecificFile (*PlatformSpecificFOpen)(const char* filename, const char* flag);
 extern void (*PlatformSpecificFPuts)(const char* str, PlatformSpecificFile file);
 extern void (*PlatformSpecificFClose)(PlatformSpecificFile file);
+extern char* (*PlatformSpecificFGets)(char* str, int size, PlatformSpecificFile file);
+extern void (*PlatformSpecificFFlush)(PlatformSpecificFile file);
 
 extern int (*PlatformSpecificPutchar)(int c);
 extern void (*PlatformSpecificFlush)(void);
+extern void (*PlatformSpecificWrite)(const char* buffer, size_t size);
 
 /* Dynamic Memory operations */
 extern void* (*PlatformSpecificMalloc)(size_t size);
@@ -75,12 +78,29 @@ extern void (*PlatformSpecificFree)(void* memory);
 extern void* (*PlatformSpecificMemCpy)(void* s1, const void* s2, size_t size);
 extern void* (*PlatformSpecificMemset)(void* mem, int c, size_t size);
 
+/* Crash handling. The handler is called from a signal handler and may only
+ * use async-signal-safe functions such as PlatformSpecificWrite */
+extern void (*PlatformSpecificInstallCrashHandler)(void (*crashHandler)(const char* signalName));
+extern void (*PlatformSpecificUninstallCrashHandler)(void);
+/* Writes the stack of the caller to stderr, and may be called from the crash handler */
+extern void (*PlatformSpecificWriteBacktrace)(void);
+
+/* Page operations for guard page allocation. PlatformSpecificPageSize returns 0
+ * when the platform cannot allocate and protect pages */
+extern size_t (*PlatformSpecificPageSize)(void);
+extern void* (*PlatformSpecificAllocatePages)(size_t size);
+extern void (*PlatformSpecificFreePages)(void* memory, size_t size);
+extern void (*PlatformSpecificProtectPages)(void* memory, size_t size);
+
 typedef void* PlatformSpecificMutex;
 extern PlatformSpecificMutex (*PlatformSpecificMutexCreate)(void);
 extern void (*PlatformSpecificMutexLock)(PlatformSpecificMutex mtx);
 extern void (*PlatformSpecificMutexUnlock)(PlatformSpecificMutex mtx);
 extern void (*PlatformSpecificMutexDestroy)(PlatformSpecificMutex mtx);
 
+/* Adds amount to value without a lock and returns the new value */
+extern size_t (*PlatformSpecificAtomicAdd)(volatile size_t* value, size_t amount);
+
 #ifdef __cplusplus
 }
 #endif
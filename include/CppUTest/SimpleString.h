@@ -91,13 +91,19 @@ public:
 
     static char* allocStringBuffer(size_t size);
     static int AtoI(const char*str);
+    static unsigned long AtoU(const char*str);
     static int StrCmp(const char* s1, const char* s2);
+    static int StrCmpNoCase(const char* s1, const char* s2);
     static size_t StrLen(const char*);
+    static size_t StrHash(const char*);
     static int StrNCmp(const char* s1, const char* s2, size_t n);
     static char* StrNCpy(char* s1, const char* s2, size_t n);
     static char* StrStr(const char* s1, const char* s2);
+    static char* StrStrNoCase(const char* s1, const char* s2);
     static char ToLower(char ch);
     static int MemCmp(const void* s1, const void *s2, size_t n);
+    static size_t MemFirstDifference(const void* s1, const void *s2, size_t n);
+    static size_t MemCountDifferences(const void* s1, const void *s2, size_t n);
     static void deallocStringBuffer(char* str);
 private:
     char *buffer_;
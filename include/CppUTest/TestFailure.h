@@ -30,6 +30,10 @@
 // Failure is a class which holds information for a specific
 // test failure. It can be overriden for more complex failure messages
 //
+// Failures of the comparison checks keep the compared values and only
+// format their message when it is asked for. Copying a failure formats
+// the message, so the copy does not depend on the compared values.
+//
 ///////////////////////////////////////////////////////////////////////////////
 
 
@@ -68,8 +72,8 @@ protected:
         DIFFERENCE_STRING, DIFFERENCE_BINARY
     };
 
-    SimpleString createButWasString(const SimpleString& expected, const SimpleString& actual);
-    SimpleString createDifferenceAtPosString(const SimpleString& actual, size_t position, DifferenceFormat format = DIFFERENCE_STRING);
+    SimpleString createButWasString(const SimpleString& expected, const SimpleString& actual) const;
+    SimpleString createDifferenceAtPosString(const SimpleString& actual, size_t position, DifferenceFormat format = DIFFERENCE_STRING, size_t reportedOffset = 0) const;
 
     SimpleString testName_;
     SimpleString fileName_;
@@ -93,12 +97,21 @@ class DoublesEqualFailure: public TestFailure
 {
 public:
     DoublesEqualFailure(UtestShell*, const char* fileName, int lineNumber, double expected, double actual, double threshold);
+    virtual SimpleString getMessage() const _override;
+private:
+    double expected_;
+    double actual_;
+    double threshold_;
 };
 
 class CheckEqualFailure : public TestFailure
 {
 public:
     CheckEqualFailure(UtestShell* test, const char* fileName, int lineNumber, const SimpleString& expected, const SimpleString& actual);
+    virtual SimpleString getMessage() const _override;
+private:
+    SimpleString expected_;
+    SimpleString actual_;
 };
 
 class ContainsFailure: public TestFailure
@@ -124,36 +137,86 @@ class LongsEqualFailure : public TestFailure
 {
 public:
     LongsEqualFailure(UtestShell* test, const char* fileName, int lineNumber, long expected, long actual);
+    virtual SimpleString getMessage() const _override;
+private:
+    long expected_;
+    long actual_;
 };
 
 class UnsignedLongsEqualFailure : public TestFailure
 {
 public:
     UnsignedLongsEqualFailure(UtestShell* test, const char* fileName, int lineNumber, unsigned long expected, unsigned long actual);
+    virtual SimpleString getMessage() const _override;
+private:
+    unsigned long expected_;
+    unsigned long actual_;
 };
 
 class StringEqualFailure : public TestFailure
 {
 public:
     StringEqualFailure(UtestShell* test, const char* fileName, int lineNumber, const char* expected, const char* actual);
+    virtual SimpleString getMessage() const _override;
+private:
+    SimpleString expected_;
+    SimpleString actual_;
+    size_t failStart_;
 };
 
 class StringEqualNoCaseFailure : public TestFailure
 {
 public:
     StringEqualNoCaseFailure(UtestShell* test, const char* fileName, int lineNumber, const char* expected, const char* actual);
+    virtual SimpleString getMessage() const _override;
+private:
+    SimpleString expected_;
+    SimpleString actual_;
+    size_t failStart_;
 };
 
 class BinaryEqualFailure : public TestFailure
 {
 public:
 	BinaryEqualFailure(UtestShell* test, const char* fileName, int lineNumber, const unsigned char* expected, const unsigned char* actual, size_t size);
+	virtual SimpleString getMessage() const _override;
+private:
+	enum { WINDOW_SIZE = 32, WINDOW_BYTES_BEFORE_DIFFERENCE = 8 };
+
+	SimpleString StringFromWindow(const unsigned char* window, bool isNull) const;
+
+	unsigned char expected_[WINDOW_SIZE];
+	unsigned char actual_[WINDOW_SIZE];
+	bool expectedIsNull_;
+	bool actualIsNull_;
+	size_t size_;
+	size_t windowStart_;
+	size_t windowSize_;
+	size_t failStart_;
+	size_t differences_;
 };
 
 class BitsEqualFailure : public TestFailure
 {
 public:
 	BitsEqualFailure(UtestShell* test, const char* fileName, int lineNumber, unsigned long expected, unsigned long actual, unsigned long mask, size_t byteCount);
+	virtual SimpleString getMessage() const _override;
+private:
+	unsigned long expected_;
+	unsigned long actual_;
+	unsigned long mask_;
+	size_t byteCount_;
+};
+
+class PeakMemoryFailure : public TestFailure
+{
+public:
+    PeakMemoryFailure(UtestShell* test, const char* fileName, int lineNumber, size_t limit, size_t peakMemory, size_t peakBlocks);
+    virtual SimpleString getMessage() const _override;
+private:
+    size_t limit_;
+    size_t peakMemory_;
+    size_t peakBlocks_;
 };
 
 #endif
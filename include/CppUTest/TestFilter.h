@@ -50,6 +50,8 @@ public:
 
     SimpleString asString() const;
 private:
+    bool matchesRowOfParameterizedTest(const SimpleString& name) const;
+
     SimpleString filter_;
     bool strictMatching_;
     TestFilter* next_;
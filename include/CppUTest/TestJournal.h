@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2007, Michael Feathers, James Grenning and Bas Vodde
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE EARLIER MENTIONED AUTHORS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <copyright holder> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// TestJournal records the outcome of every test in a file while the tests
+// run, so a later run can resume after a crash without repeating the tests
+// that already passed.
+//
+// Each test writes a START line before it runs and a PASS or FAIL line
+// after it ran. A START line without an outcome means the test crashed.
+// A test that was not run because its group setup failed writes a SKIP line.
+//
+
+#ifndef D_TestJournal_h
+#define D_TestJournal_h
+
+#include "SimpleString.h"
+#include "PlatformSpecificFunctions.h"
+
+class UtestShell;
+
+struct TestJournalEntry;
+
+class TestJournal
+{
+public:
+    explicit TestJournal(const SimpleString& fileName);
+    virtual ~TestJournal();
+
+    virtual void loadPreviousRun();
+    virtual void open(bool append);
+    virtual void close();
+
+    virtual bool hasPassedBefore(const UtestShell& test);
+    virtual bool hasCrashedBefore(const UtestShell& test);
+
+    virtual void testStarted(const UtestShell& test);
+    virtual void testEnded(const UtestShell& test, bool failed);
+    virtual void testCrashedBefore(const UtestShell& test);
+    virtual void testSkipped(const UtestShell& test);
+
+private:
+    enum TestJournalState
+    {
+        JOURNAL_STARTED, JOURNAL_PASSED, JOURNAL_FAILED, JOURNAL_CRASHED, JOURNAL_SKIPPED
+    };
+
+    void writeRecord(const char* state, const UtestShell& test);
+    void addRecord(const SimpleString& line);
+    TestJournalEntry* findEntry(const SimpleString& group, const SimpleString& name);
+    TestJournalEntry* findEntry(const UtestShell& test);
+    void indexEntry(TestJournalEntry* entry);
+    size_t bucketOf(const SimpleString& group, const SimpleString& name) const;
+
+    SimpleString fileName_;
+    PlatformSpecificFile file_;
+    TestJournalEntry* firstEntry_;
+    TestJournalEntry* lastEntry_;
+    TestJournalEntry** buckets_;
+    size_t numberOfBuckets_;
+    size_t numberOfEntries_;
+
+    TestJournal(const TestJournal&);
+    TestJournal& operator=(const TestJournal&);
+};
+
+#endif
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2007, Michael Feathers, James Grenning and Bas Vodde
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE EARLIER MENTIONED AUTHORS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <copyright holder> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// TestManifest reads the records that the test macros put in the
+// cpputest_manifest section of an executable (see CPPUTEST_USE_TEST_MANIFEST).
+//
+// A record is the kind of test (TEST, TEST_P, IGNORE_TEST, ...), its group,
+// name, file and line, each ending in a zero. The compiler may pad records
+// with zeros. The records are constant data, so they can be read from the
+// executable file without running it.
+//
+
+#ifndef D_TestManifest_h
+#define D_TestManifest_h
+
+#include "SimpleString.h"
+
+struct TestManifestRecord
+{
+    const char* kind;
+    const char* group;
+    const char* name;
+    const char* file;
+    int lineNumber;
+};
+
+class TestManifest
+{
+public:
+    TestManifest(const char* begin, const char* end);
+    virtual ~TestManifest();
+
+    static TestManifest linkedIn();
+    static TestManifest fromElfImage(const unsigned char* image, size_t size);
+
+    bool isEmpty() const;
+    bool readRecord(size_t& offset, TestManifestRecord& record) const;
+
+    SimpleString listTestGroupNames() const;
+    SimpleString listTestGroupAndCaseNames() const;
+    SimpleString listRecords() const;
+
+private:
+    const char* begin_;
+    const char* end_;
+
+    const char* readString(const char*& position) const;
+};
+
+#endif
@@ -30,6 +30,8 @@
 
 struct MemoryLeakNode;
 class TestMemoryAllocator;
+class SizeClassMemoryPool;
+class UtestShell;
 
 extern void setCurrentNewAllocator(TestMemoryAllocator* allocator);
 extern TestMemoryAllocator* getCurrentNewAllocator();
@@ -46,6 +48,10 @@ extern TestMemoryAllocator* getCurrentMallocAllocator();
 extern void setCurrentMallocAllocatorToDefault();
 extern TestMemoryAllocator* defaultMallocAllocator();
 
+extern SizeClassMemoryPool* getTestMemoryPool();
+extern void setTestMemoryPoolEnabled(bool enabled);
+extern bool isTestMemoryPoolEnabled();
+
 class TestMemoryAllocator
 {
 public:
@@ -54,6 +60,7 @@ public:
     bool hasBeenDestroyed();
 
     virtual char* alloc_memory(size_t size, const char* file, int line);
+    virtual char* realloc_memory(char* memory, size_t size, const char* file, int line);
     virtual void free_memory(char* memory, const char* file, int line);
 
     virtual const char* name();
@@ -62,6 +69,10 @@ public:
 
     virtual bool isOfEqualType(TestMemoryAllocator* allocator);
 
+    /* True when touching memory outside a block traps. The leak detector then
+     * adds no redzones and keeps its node out of the block. */
+    virtual bool trapsAccessOutsideMemory();
+
     virtual char* allocMemoryLeakNode(size_t size);
     virtual void freeMemoryLeakNode(char* memory);
 
@@ -74,6 +85,62 @@ protected:
     bool hasBeenDestroyed_;
 };
 
+/*
+ * Serves allocations of up to 256 bytes from free lists per 16 byte size class,
+ * carved out of 16 KB slabs that are aligned so a block finds its slab without
+ * a header. The base TestMemoryAllocator allocates from the test memory pool
+ * while it is enabled and always returns pooled blocks to it, so the pool can
+ * be turned on and off at any time. reset() recycles every slab once no block
+ * is in use. Pooled memory must not be passed to the C library's free. The
+ * pool does not lock; the thread-safe overloads only call it with the leak
+ * detector's mutex held.
+ */
+class SizeClassMemoryPool
+{
+public:
+    enum { largestPooledSize = 256 };
+
+    SizeClassMemoryPool();
+    virtual ~SizeClassMemoryPool();
+
+    virtual char* allocate(size_t size);
+    virtual void deallocate(char* memory);
+    virtual bool owns(const char* memory) const;
+    virtual size_t getBlockSize(const char* memory) const;
+
+    virtual bool reset();
+    virtual size_t getBlocksInUse() const;
+    virtual size_t getNumberOfSlabs() const;
+
+private:
+    enum { numberOfSizeClasses = 16 };
+
+    struct Slab;
+    struct FreeBlock;
+
+    FreeBlock* freeLists_[numberOfSizeClasses];
+    Slab* currentSlabs_[numberOfSizeClasses];
+    Slab* spareSlabs_;
+    char** chunks_;
+    size_t numberOfChunks_;
+    char** slabTable_;
+    size_t slabTableSize_;
+    size_t numberOfSlabs_;
+    size_t blocksInUse_;
+
+    char* carveBlock(size_t sizeClass);
+    bool addChunk();
+    bool reserveSlabs(size_t slabs);
+    void addSlab(char* slab);
+    void addSpareSlabs(char* chunk);
+    static char* firstSlabOf(char* chunk);
+    Slab* findSlab(const char* memory) const;
+    void release();
+
+    SizeClassMemoryPool(const SizeClassMemoryPool&);
+    SizeClassMemoryPool& operator=(const SizeClassMemoryPool&);
+};
+
 class CrashOnAllocationAllocator : public TestMemoryAllocator
 {
     unsigned allocationToCrashOn_;
@@ -85,6 +152,130 @@ public:
     virtual char* alloc_memory(size_t size, const char* file, int line) _override;
 };
 
+/*
+ * Places every allocation directly against a page that is made inaccessible, so
+ * that an overrun (or, with guard_before_memory, an underrun) crashes at the
+ * faulty access instead of being found at free. A sampling interval of N guards
+ * only every Nth allocation and serves the others from the heap, which keeps the
+ * memory and mapping overhead low enough to run large parts of a suite with it.
+ * Memory is only byte aligned by default, so that it ends right at the guard page;
+ * setAlignment trades that for alignment.
+ * Memory must be freed by the allocator that allocated it. Platforms that cannot
+ * protect pages get heap memory for every allocation.
+ */
+class GuardPageMemoryAllocator : public TestMemoryAllocator
+{
+public:
+    enum GuardPlacement { guard_after_memory, guard_before_memory };
+
+    GuardPageMemoryAllocator(const char* name_str = "Guard Page Allocator", const char* alloc_name_str = "alloc", const char* free_name_str = "free");
+
+    virtual void setGuardPlacement(GuardPlacement placement);
+    virtual void setAlignment(size_t alignment);
+    virtual void setSamplingInterval(unsigned interval);
+
+    virtual unsigned getGuardedAllocations() const;
+
+    virtual char* alloc_memory(size_t size, const char* file, int line) _override;
+    virtual char* realloc_memory(char* memory, size_t size, const char* file, int line) _override;
+    virtual void free_memory(char* memory, const char* file, int line) _override;
+
+    virtual bool trapsAccessOutsideMemory() _override;
+
+    virtual char* allocMemoryLeakNode(size_t size) _override;
+    virtual void freeMemoryLeakNode(char* memory) _override;
+
+private:
+    struct BlockHeader;
+
+    GuardPlacement placement_;
+    size_t alignment_;
+    size_t pageSize_;
+    unsigned samplingInterval_;
+    unsigned allocationsUntilGuarded_;
+    unsigned guardedAllocations_;
+
+    bool shouldGuardNextAllocation();
+    size_t headerSpace() const;
+    char* allocGuarded(size_t size);
+    char* allocUnguarded(size_t size);
+    char* headerLocation(char* memory) const;
+};
+
+/*
+ * Decides which allocations fail. The schedules can be combined; an allocation
+ * fails when any of them says so. Allocation numbers count from 1 since the
+ * last reset, the random schedule is reproducible for a given seed. When
+ * restricted to a test, only allocations made while it is the current test
+ * (its setup, body and teardown) are counted and failed.
+ */
+class FaultInjectionSchedule
+{
+public:
+    FaultInjectionSchedule();
+
+    virtual void failAllocationNumber(unsigned number);
+    virtual void failEveryNthAllocation(unsigned interval);
+    virtual void failRandomly(double probability, unsigned long seed);
+    virtual void failAfterBytes(size_t bytes);
+    virtual void failAllocationsFrom(const char* file, int line = 0);
+    virtual void restrictToTest(UtestShell* test);
+
+    virtual bool shouldFail(size_t size, const char* file, int line);
+
+    virtual unsigned getAllocationCount() const;
+    virtual unsigned getFailedAllocationCount() const;
+
+    virtual void resetCounters();
+    virtual void clear();
+
+private:
+    unsigned allocationNumberToFail_;
+    unsigned failureInterval_;
+    double failureProbability_;
+    unsigned long randomState_;
+    bool limitBytes_;
+    size_t byteLimit_;
+    const char* failingFile_;
+    int failingLine_;
+    UtestShell* restrictedTest_;
+
+    unsigned allocationCount_;
+    unsigned failedAllocationCount_;
+    size_t allocatedBytes_;
+
+    bool isFailingCallSite(const char* file, int line) const;
+    double nextRandom();
+};
+
+/*
+ * Returns NULL for the allocations the schedule fails, which the operator new
+ * overloads turn into std::bad_alloc. All other calls go to the original
+ * allocator, whose names it takes so memory can be freed by either of them.
+ */
+class FaultInjectionMemoryAllocator : public TestMemoryAllocator
+{
+public:
+    FaultInjectionMemoryAllocator(FaultInjectionSchedule* schedule, TestMemoryAllocator* originalAllocator);
+
+    virtual void setOriginalAllocator(TestMemoryAllocator* originalAllocator);
+    virtual TestMemoryAllocator* getOriginalAllocator();
+
+    virtual char* alloc_memory(size_t size, const char* file, int line) _override;
+    virtual char* realloc_memory(char* memory, size_t size, const char* file, int line) _override;
+    virtual void free_memory(char* memory, const char* file, int line) _override;
+
+    virtual const char* name() _override;
+    virtual const char* alloc_name() _override;
+    virtual const char* free_name() _override;
+
+    virtual char* allocMemoryLeakNode(size_t size) _override;
+    virtual void freeMemoryLeakNode(char* memory) _override;
+
+private:
+    FaultInjectionSchedule* schedule_;
+    TestMemoryAllocator* originalAllocator_;
+};
 
 class NullUnknownAllocator: public TestMemoryAllocator
 {
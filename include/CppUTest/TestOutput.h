@@ -55,6 +55,7 @@ public:
     virtual void printCurrentGroupEnded(const TestResult& res);
 
     virtual void verbose();
+    virtual void peakMemory();
     virtual void color();
     virtual void printBuffer(const char*)=0;
     virtual void print(const char*);
@@ -88,6 +89,7 @@ protected:
 
     int dotCount_;
     bool verbose_;
+    bool peakMemory_;
     bool color_;
     const char* progressIndication_;
 
@@ -123,6 +125,52 @@ private:
     ConsoleTestOutput& operator=(const ConsoleTestOutput&);
 };
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  BufferedConsoleTestOutput.h
+//
+//  Collects the console output in a block and writes it all at once.
+//  The block is written when it is full, on failures, at the end and
+//  when the crash handler reports a crash.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+class BufferedConsoleTestOutput: public ConsoleTestOutput
+{
+public:
+    enum
+    {
+        DEFAULT_BUFFER_SIZE = 65536
+    };
+
+    explicit BufferedConsoleTestOutput(size_t bufferSize = DEFAULT_BUFFER_SIZE);
+    virtual ~BufferedConsoleTestOutput();
+
+    virtual void printTestsEnded(const TestResult& result) _override;
+    using ConsoleTestOutput::print;
+    virtual void print(const TestFailure& failure) _override;
+
+    virtual void printBuffer(const char* s) _override;
+    virtual void flush() _override;
+
+    /* Writes the block of the latest output that still exists. It only writes, so the crash handler
+     * can call it. A test run in a separate process calls it before the fork, so the block is not written twice. */
+    static void writeLatestBuffer();
+
+private:
+    void writeBuffer();
+
+    char* buffer_;
+    size_t bufferSize_;
+    size_t bufferUsed_;
+    BufferedConsoleTestOutput* previousOutput_;
+
+    static BufferedConsoleTestOutput* latestOutput_;
+
+    BufferedConsoleTestOutput(const BufferedConsoleTestOutput&);
+    BufferedConsoleTestOutput& operator=(const BufferedConsoleTestOutput&);
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  StringBufferTestOutput.h
@@ -183,6 +231,7 @@ public:
     virtual void printCurrentGroupEnded(const TestResult& res);
 
     virtual void verbose();
+    virtual void peakMemory();
     virtual void color();
     virtual void printBuffer(const char*);
     virtual void print(const char*);
@@ -29,6 +29,7 @@
 #define D_TestPlugin_h
 
 class UtestShell;
+class TestGroupFixtureShell;
 class TestResult;
 
 class TestPlugin
@@ -46,6 +47,15 @@ public:
     {
     }
 
+    /* Around the TEST_GROUP_SETUP and TEST_GROUP_TEARDOWN of a group, which run outside of its tests */
+    virtual void preTestGroupFixtureAction(TestGroupFixtureShell&, TestResult&)
+    {
+    }
+
+    virtual void postTestGroupFixtureAction(TestGroupFixtureShell&, TestResult&)
+    {
+    }
+
     virtual bool parseArguments(int /* ac */, const char** /* av */, int /* index */ )
     {
         return false;
@@ -53,6 +63,8 @@ public:
 
     virtual void runAllPreTestAction(UtestShell&, TestResult&);
     virtual void runAllPostTestAction(UtestShell&, TestResult&);
+    virtual void runAllPreTestGroupFixtureAction(TestGroupFixtureShell&, TestResult&);
+    virtual void runAllPostTestGroupFixtureAction(TestGroupFixtureShell&, TestResult&);
     virtual bool parseAllArguments(int ac, const char** av, int index);
     virtual bool parseAllArguments(int ac, char** av, int index);
 
@@ -114,6 +126,8 @@ public:
 
     virtual void runAllPreTestAction(UtestShell& test, TestResult& result) _override;
     virtual void runAllPostTestAction(UtestShell& test, TestResult& result) _override;
+    virtual void runAllPreTestGroupFixtureAction(TestGroupFixtureShell& fixture, TestResult& result) _override;
+    virtual void runAllPostTestGroupFixtureAction(TestGroupFixtureShell& fixture, TestResult& result) _override;
 
     static NullTestPlugin* instance();
 };
@@ -37,8 +37,12 @@
 #include "TestFilter.h"
 
 class UtestShell;
+struct TestDescriptor;
+class TestGroupFixtureInstaller;
 class TestResult;
 class TestPlugin;
+class TestJournal;
+class AllocationFailureRunner;
 
 class TestRegistry
 {
@@ -48,6 +52,17 @@ public:
 
     virtual void addTest(UtestShell *test);
     virtual void unDoLastAddTest();
+    /* Adds the test in front of next, behind the tests from descriptors that run before next. A NULL next adds it last. */
+    virtual void addTestBefore(UtestShell* test, UtestShell* next);
+
+    /* The shell of a test from a descriptor is made when the test passes the filters of a run, or is looked for */
+    virtual void addTestDescriptor(TestDescriptor* descriptor);
+    /* Adds the descriptors of whole files in the order of their lines, among the tests of their files added already */
+    virtual void addTestDescriptors(TestDescriptor* const* begin, TestDescriptor* const* end);
+    virtual void unDoLastAddTestDescriptor();
+
+    /* The setup of a group runs before the first of its tests that runs, and its teardown after the last one */
+    virtual void addTestGroupFixture(TestGroupFixtureInstaller* fixture);
     virtual int countTests();
     virtual void runAllTests(TestResult& result);
     virtual void listTestGroupNames(TestResult& result);
@@ -72,20 +87,45 @@ public:
     virtual void setCurrentRegistry(TestRegistry* registry);
 
     virtual void setRunTestsInSeperateProcess();
+    virtual void setJournal(TestJournal* journal);
+    virtual void setAllocationFailureRunner(AllocationFailureRunner* runner);
     int getCurrentRepetition();
 
+    /* A nonzero seed runs the groups, and the tests in each group, in an order shuffled with it.
+     * Every run moves on to a new seed derived from the last one. */
+    virtual void setShuffleSeed(unsigned long seed);
+    unsigned long getShuffleSeed() const;
+
 private:
 
     bool testShouldRun(UtestShell* test, TestResult& result);
-    bool endOfGroup(UtestShell* test);
+    void addTestsFromDescriptors(const TestFilter* groupFilters, const TestFilter* nameFilters);
+    void moveTestDescriptorsRunningBefore(UtestShell* test, UtestShell* newTest);
+    void addLinkedInTestDescriptors();
+    UtestShell* firstTestKeepingItsOrder() const;
+    UtestShell* newestTestOfFile(const char* fileName) const;
+    UtestShell* testAddedBefore(const TestDescriptor& descriptor) const;
+    bool runTestGroupFixture(UtestShell* test, bool isSetup, TestResult& result);
+    void skipTestOfFailedGroupSetup(UtestShell* test, TestResult& result);
+    bool endOfGroup(UtestShell* test, UtestShell* next);
+    UtestShell** createShuffledOrder();
+    void runOneTestWithJournal(UtestShell* test, TestResult& result);
+    void runOneTest(UtestShell* test, TestResult& result);
 
     UtestShell * tests_;
+    TestDescriptor* descriptors_;
+    TestGroupFixtureInstaller* groupFixtures_;
     const TestFilter* nameFilters_;
     const TestFilter* groupFilters_;
     TestPlugin* firstPlugin_;
     static TestRegistry* currentRegistry_;
     bool runInSeperateProcess_;
     int currentRepetition_;
+    unsigned long shuffleSeed_;
+    TestJournal* journal_;
+    AllocationFailureRunner* allocationFailureRunner_;
+    TestDescriptor* const* linkedInDescriptorsBegin_;
+    TestDescriptor* const* linkedInDescriptorsEnd_;
 
 };
 
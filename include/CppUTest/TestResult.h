@@ -54,8 +54,11 @@ public:
 
     virtual void countTest();
     virtual void countRun();
+    virtual void countRerun();
     virtual void countCheck();
+    virtual void countChecks(int amount);
     virtual void countFilteredOut();
+    virtual void countPassedBefore();
     virtual void countIgnored();
     virtual void addFailure(const TestFailure& failure);
     virtual void print(const char* text);
@@ -68,6 +71,10 @@ public:
     {
         return runCount_;
     }
+    int getRerunCount() const
+    {
+        return rerunCount_;
+    }
     int getCheckCount() const
     {
         return checkCount_;
@@ -76,6 +83,10 @@ public:
     {
         return filteredOutCount_;
     }
+    int getPassedBeforeCount() const
+    {
+        return passedBeforeCount_;
+    }
     int getIgnoredCount() const
     {
         return ignoredCount_;
@@ -90,14 +101,20 @@ public:
 
     long getCurrentTestTotalExecutionTime() const;
     long getCurrentGroupTotalExecutionTime() const;
+
+    void setCurrentTestPeakMemory(size_t bytes, size_t blocks);
+    size_t getCurrentTestPeakMemory() const;
+    size_t getCurrentTestPeakBlocks() const;
 private:
 
     TestOutput& output_;
     int testCount_;
     int runCount_;
+    int rerunCount_;
     int checkCount_;
     int failureCount_;
     int filteredOutCount_;
+    int passedBeforeCount_;
     int ignoredCount_;
     long totalExecutionTime_;
     long timeStarted_;
@@ -105,6 +122,8 @@ private:
     long currentTestTotalExecutionTime_;
     long currentGroupTimeStarted_;
     long currentGroupTotalExecutionTime_;
+    size_t currentTestPeakMemory_;
+    size_t currentTestPeakBlocks_;
 };
 
 #endif
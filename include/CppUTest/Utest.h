@@ -95,8 +95,16 @@ public:
     virtual UtestShell *getNext() const;
     virtual int countTests();
 
+    /* A test runs once for each of its rows. Only parameterized tests have more than one. */
+    virtual size_t countRows() const;
+    virtual void selectRow(size_t row);
+
+    /* Tests that depend on the order they run in keep it, with their group, when tests are shuffled */
+    virtual bool keepsItsOrder() const;
+
     bool shouldRun(const TestFilter* groupFilters, const TestFilter* nameFilters) const;
     const SimpleString getName() const;
+    const char* getNameAsCharString() const;
     const SimpleString getGroup() const;
     virtual SimpleString getFormattedName() const;
     const SimpleString getFile() const;
@@ -119,8 +127,82 @@ public:
     virtual void assertEquals(bool failed, const char* expected, const char* actual, const char* file, int line, const TestTerminator& testTerminator = NormalTestTerminator());
     virtual void assertBinaryEqual(const void *expected, const void *actual, size_t length, const char *fileName, int lineNumber, const TestTerminator& testTerminator = NormalTestTerminator());
     virtual void assertBitsEqual(unsigned long expected, unsigned long actual, unsigned long mask, size_t byteCount, const char *fileName, int lineNumber, const TestTerminator& testTerminator = NormalTestTerminator());
+    virtual void assertPeakMemoryBelow(size_t limit, const char *fileName, int lineNumber, const TestTerminator& testTerminator = NormalTestTerminator());
     virtual void fail(const char *text, const char *fileName, int lineNumber, const TestTerminator& testTerminator = NormalTestTerminator());
 
+    /* Inline fast paths used by the checking macros. A passing check only adds to a counter that
+     * all threads share, which is added to the test result whenever the current test result changes.
+     * Only a failing check calls the assert method of the current test to report it. */
+    static void countPassedCheck()
+    {
+        CPPUTEST_ATOMIC_ADD(passedChecks_, 1);
+    }
+    static void checkTrue(bool condition, const char *checkString, const char *conditionString, const char *fileName, int lineNumber)
+    {
+        if (condition) CPPUTEST_ATOMIC_ADD(passedChecks_, 1);
+        else getCurrent()->assertTrue(condition, checkString, conditionString, fileName, lineNumber);
+    }
+    static void checkTrue(bool condition, const char *checkString, const char *conditionString, const char* text, const char *fileName, int lineNumber)
+    {
+        if (condition) CPPUTEST_ATOMIC_ADD(passedChecks_, 1);
+        else getCurrent()->assertTrueText(condition, checkString, conditionString, text, fileName, lineNumber);
+    }
+    static void checkLongsEqual(long expected, long actual, const char *fileName, int lineNumber)
+    {
+        if (expected == actual) CPPUTEST_ATOMIC_ADD(passedChecks_, 1);
+        else getCurrent()->assertLongsEqual(expected, actual, fileName, lineNumber);
+    }
+    static void checkUnsignedLongsEqual(unsigned long expected, unsigned long actual, const char *fileName, int lineNumber)
+    {
+        if (expected == actual) CPPUTEST_ATOMIC_ADD(passedChecks_, 1);
+        else getCurrent()->assertUnsignedLongsEqual(expected, actual, fileName, lineNumber);
+    }
+    static void checkPointersEqual(const void *expected, const void *actual, const char *fileName, int lineNumber)
+    {
+        if (expected == actual) CPPUTEST_ATOMIC_ADD(passedChecks_, 1);
+        else getCurrent()->assertPointersEqual(expected, actual, fileName, lineNumber);
+    }
+    static void checkDoublesEqual(double expected, double actual, double threshold, const char *fileName, int lineNumber)
+    {
+        if (doubles_equal(expected, actual, threshold)) CPPUTEST_ATOMIC_ADD(passedChecks_, 1);
+        else getCurrent()->assertDoublesEqual(expected, actual, threshold, fileName, lineNumber);
+    }
+    static void checkBinaryEqual(const void *expected, const void *actual, size_t length, const char *fileName, int lineNumber)
+    {
+        if (expected == actual || (expected && actual && SimpleString::MemCmp(expected, actual, length) == 0)) CPPUTEST_ATOMIC_ADD(passedChecks_, 1);
+        else getCurrent()->assertBinaryEqual(expected, actual, length, fileName, lineNumber);
+    }
+    static void checkBitsEqual(unsigned long expected, unsigned long actual, unsigned long mask, size_t byteCount, const char *fileName, int lineNumber)
+    {
+        if ((expected & mask) == (actual & mask)) CPPUTEST_ATOMIC_ADD(passedChecks_, 1);
+        else getCurrent()->assertBitsEqual(expected, actual, mask, byteCount, fileName, lineNumber);
+    }
+    static void checkCstrEqual(const char *expected, const char *actual, const char *fileName, int lineNumber)
+    {
+        if (expected == actual || (expected && actual && SimpleString::StrCmp(expected, actual) == 0)) CPPUTEST_ATOMIC_ADD(passedChecks_, 1);
+        else getCurrent()->assertCstrEqual(expected, actual, fileName, lineNumber);
+    }
+    static void checkCstrNEqual(const char *expected, const char *actual, size_t length, const char *fileName, int lineNumber)
+    {
+        if (expected == actual || (expected && actual && SimpleString::StrNCmp(expected, actual, length) == 0)) CPPUTEST_ATOMIC_ADD(passedChecks_, 1);
+        else getCurrent()->assertCstrNEqual(expected, actual, length, fileName, lineNumber);
+    }
+    static void checkCstrNoCaseEqual(const char *expected, const char *actual, const char *fileName, int lineNumber)
+    {
+        if (expected == actual || (expected && actual && SimpleString::StrCmpNoCase(expected, actual) == 0)) CPPUTEST_ATOMIC_ADD(passedChecks_, 1);
+        else getCurrent()->assertCstrNoCaseEqual(expected, actual, fileName, lineNumber);
+    }
+    static void checkCstrContains(const char *expected, const char *actual, const char *fileName, int lineNumber)
+    {
+        if (expected == actual || (expected && actual && SimpleString::StrStr(actual, expected))) CPPUTEST_ATOMIC_ADD(passedChecks_, 1);
+        else getCurrent()->assertCstrContains(expected, actual, fileName, lineNumber);
+    }
+    static void checkCstrNoCaseContains(const char *expected, const char *actual, const char *fileName, int lineNumber)
+    {
+        if (expected == actual || (expected && actual && SimpleString::StrStrNoCase(actual, expected))) CPPUTEST_ATOMIC_ADD(passedChecks_, 1);
+        else getCurrent()->assertCstrNoCaseContains(expected, actual, fileName, lineNumber);
+    }
+
     virtual void print(const char *text, const char *fileName, int lineNumber);
     virtual void print(const SimpleString & text, const char *fileName, int lineNumber);
 
@@ -133,6 +215,9 @@ public:
     static void setCrashMethod(void (*crashme)());
     static void resetCrashMethod();
 
+    static void reportCrashOfCurrentTest(const char* signalName);
+    static void reportCrashOfCurrentTestWithBacktrace(const char* signalName);
+
     virtual bool isRunInSeperateProcess() const;
     virtual void setRunInSeperateProcess();
 
@@ -151,6 +236,9 @@ protected:
 
     virtual SimpleString getMacroName() const;
     TestResult *getTestResult();
+    void setTestResult(TestResult* result);
+    void setCurrentTest(UtestShell* test);
+    void runTestInCurrentProcess(TestPlugin* plugin, TestResult& result, bool countAsRun);
 private:
     const char *group_;
     const char *name_;
@@ -160,12 +248,11 @@ private:
     bool isRunAsSeperateProcess_;
     bool hasFailed_;
 
-    void setTestResult(TestResult* result);
-    void setCurrentTest(UtestShell* test);
     bool match(const char* target, const TestFilter* filters) const;
 
     static UtestShell* currentTest_;
     static TestResult* testResult_;
+    static int passedChecks_;
 
 };
 
@@ -230,6 +317,56 @@ private:
 
 };
 
+//////////////////// ParameterizedUtestShell
+
+class ParameterizedUtestShell : public UtestShell
+{
+public:
+    ParameterizedUtestShell(const char* testName, size_t rowCount);
+    virtual ~ParameterizedUtestShell();
+
+    virtual size_t countRows() const _override;
+    virtual void selectRow(size_t row) _override;
+    size_t getCurrentRow() const;
+protected:
+    virtual SimpleString getMacroName() const _override;
+
+private:
+    const char* baseName_;
+    size_t rowCount_;
+    size_t currentRow_;
+    SimpleString rowName_;
+
+    ParameterizedUtestShell(const ParameterizedUtestShell&);
+    ParameterizedUtestShell& operator=(const ParameterizedUtestShell&);
+};
+
+//////////////////// TestGroupFixtureShell
+
+/* Runs the TEST_GROUP_SETUP or TEST_GROUP_TEARDOWN of a group outside of any test. Failures are
+ * reported to the result as failures of the fixture, and the run is not counted as a test. */
+class TestGroupFixtureShell : public UtestShell
+{
+public:
+    TestGroupFixtureShell(const char* groupName, bool isSetup, void (*fixture)(), const char* fileName, int lineNumber);
+    virtual ~TestGroupFixtureShell();
+
+    bool isSetup() const;
+    bool runFixture(TestResult& result);
+
+    virtual Utest* createTest() _override;
+    virtual SimpleString getFormattedName() const _override;
+protected:
+    virtual SimpleString getMacroName() const _override;
+
+private:
+    bool isSetup_;
+    void (*fixture_)();
+
+    TestGroupFixtureShell(const TestGroupFixtureShell&);
+    TestGroupFixtureShell& operator=(const TestGroupFixtureShell&);
+};
+
 //////////////////// TestInstaller
 
 class TestInstaller
@@ -248,4 +385,69 @@ private:
 
 };
 
+//////////////////// TestDescriptorInstaller
+
+/* A test whose shell is only made when the test passes the filters of a run. The last three fields
+ * are kept by the registry the test is added to, and start out NULL. */
+struct TestDescriptor
+{
+    const char* groupName;
+    const char* testName;
+    const char* fileName;
+    int lineNumber;
+    UtestShell& (*makeShell)();
+
+    /* Added tests run in front of the test that was added last before them */
+    TestDescriptor* next;
+    UtestShell* runsBefore;
+    UtestShell* installedShell;
+
+    bool shouldRun(const TestFilter* groupFilters, const TestFilter* nameFilters) const;
+    UtestShell& getShell();
+};
+
+/* Adds a descriptor to the current registry when the linker section of descriptors is not used */
+class TestDescriptorInstaller
+{
+public:
+    explicit TestDescriptorInstaller(TestDescriptor& descriptor);
+    virtual ~TestDescriptorInstaller();
+
+    void unDo();
+
+private:
+
+    TestDescriptorInstaller(const TestDescriptorInstaller&);
+    TestDescriptorInstaller& operator=(const TestDescriptorInstaller&);
+
+};
+
+//////////////////// TestGroupFixtureInstaller
+
+class TestGroupFixtureInstaller
+{
+public:
+    explicit TestGroupFixtureInstaller(const char* groupName, void (*setup)(), void (*teardown)(), const char* fileName, int lineNumber);
+    virtual ~TestGroupFixtureInstaller();
+
+    TestGroupFixtureInstaller* addTestGroupFixture(TestGroupFixtureInstaller* next);
+    TestGroupFixtureInstaller* getNext() const;
+
+    const char* getGroupName() const;
+    bool hasFixture(bool isSetup) const;
+    TestGroupFixtureShell* createFixtureShell(bool isSetup) const;
+
+private:
+    const char* groupName_;
+    void (*setup_)();
+    void (*teardown_)();
+    const char* fileName_;
+    int lineNumber_;
+    TestGroupFixtureInstaller* next_;
+
+    TestGroupFixtureInstaller(const TestGroupFixtureInstaller&);
+    TestGroupFixtureInstaller& operator=(const TestGroupFixtureInstaller&);
+
+};
+
 #endif
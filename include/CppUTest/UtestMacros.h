@@ -55,32 +55,98 @@
 #define TEST_TEARDOWN() \
   virtual void teardown()
 
+/* Opt in to a fixture shared by the tests of a group. The setup runs once before the first test of the
+ * group that runs, and the teardown once after the last. What the setup allocates is not a leak of the
+ * tests, but has to be freed by the teardown. */
+#define TEST_GROUP_SETUP(testGroup) \
+  static void TEST_GROUP_SETUP_##testGroup(); \
+  static TestGroupFixtureInstaller TEST_GROUP_SETUP_##testGroup##_Installer(#testGroup, TEST_GROUP_SETUP_##testGroup, NULL, __FILE__, __LINE__); \
+  static void TEST_GROUP_SETUP_##testGroup()
+
+#define TEST_GROUP_TEARDOWN(testGroup) \
+  static void TEST_GROUP_TEARDOWN_##testGroup(); \
+  static TestGroupFixtureInstaller TEST_GROUP_TEARDOWN_##testGroup##_Installer(#testGroup, NULL, TEST_GROUP_TEARDOWN_##testGroup, __FILE__, __LINE__); \
+  static void TEST_GROUP_TEARDOWN_##testGroup()
+
+/* A manifest record is "kind\0group\0name\0file\0line\0", see TestManifest.h */
+#if CPPUTEST_USE_TEST_MANIFEST
+#define TEST_MANIFEST_RECORD(kind, prefix, testGroup, testName) \
+  static const char prefix##testGroup##_##testName##_ManifestRecord[] __attribute__((section("cpputest_manifest"), used)) = \
+    kind "\0" #testGroup "\0" #testName "\0" __FILE__ "\0" TEST_MANIFEST_LINE(__LINE__);
+#define TEST_MANIFEST_LINE(line) TEST_MANIFEST_STRING(line)
+#define TEST_MANIFEST_STRING(text) #text
+#else
+#define TEST_MANIFEST_RECORD(kind, prefix, testGroup, testName)
+#endif
+
+/* The descriptor of a test goes into the cpputest_tests section, which the default registry walks.
+ * Without the section, a static installer adds the descriptor to the current registry. */
+#if CPPUTEST_USE_TEST_DESCRIPTOR_SECTION
+#define TEST_DESCRIPTOR_INSTALL(prefix, testGroup, testName) \
+  static TestDescriptor* const prefix##testGroup##_##testName##_DescriptorInSection __attribute__((section("cpputest_tests"), used)) = \
+    &prefix##testGroup##_##testName##_Descriptor;
+#else
+#define TEST_DESCRIPTOR_INSTALL(prefix, testGroup, testName) \
+  static TestDescriptorInstaller prefix##testGroup##_##testName##_Installer(prefix##testGroup##_##testName##_Descriptor);
+#endif
+
+/* A TEST is installed as a descriptor. Its shell is only made when the test passes the filters of a run.
+ * There is no global TEST_group_name_TestShell_instance object any more: the shell is a function-local static,
+ * returned by TEST_group_name_MakeTestShell(). Code that took the address of the old object calls it instead. */
 #define TEST(testGroup, testName) \
-  /* External declarations for strict compilers */ \
-  class TEST_##testGroup##_##testName##_TestShell; \
-  extern TEST_##testGroup##_##testName##_TestShell TEST_##testGroup##_##testName##_TestShell_instance; \
-  \
   class TEST_##testGroup##_##testName##_Test : public TEST_GROUP_##CppUTestGroup##testGroup \
 { public: TEST_##testGroup##_##testName##_Test () : TEST_GROUP_##CppUTestGroup##testGroup () {} \
        void testBody(); }; \
   class TEST_##testGroup##_##testName##_TestShell : public UtestShell { \
       virtual Utest* createTest() _override { return new TEST_##testGroup##_##testName##_Test; } \
+  }; \
+  static UtestShell& TEST_##testGroup##_##testName##_MakeTestShell() \
+  { static TEST_##testGroup##_##testName##_TestShell shell; return shell; } \
+  static TestDescriptor TEST_##testGroup##_##testName##_Descriptor = \
+    { #testGroup, #testName, __FILE__, __LINE__, TEST_##testGroup##_##testName##_MakeTestShell, NULL, NULL, NULL }; \
+  TEST_DESCRIPTOR_INSTALL(TEST_, testGroup, testName) \
+  TEST_MANIFEST_RECORD("TEST", TEST_, testGroup, testName) \
+    void TEST_##testGroup##_##testName##_Test::testBody()
+
+/* A parameterized test runs its body once for every row of a table, with the row in "param".
+ * Each row is a test of its own called testName/index, but all rows share one test shell. */
+#define TEST_P(testGroup, testName, rowType, rows) \
+  TEST_P_FROM(testGroup, testName, rowType, sizeof(rows) / sizeof((rows)[0]), (rows)[row])
+
+/* As TEST_P, with the rows made by calling "rowType generateRow(size_t index)" */
+#define TEST_P_GENERATED(testGroup, testName, rowType, rowCount, generateRow) \
+  TEST_P_FROM(testGroup, testName, rowType, rowCount, generateRow(row))
+
+#define TEST_P_FROM(testGroup, testName, rowType, rowCount, rowExpression) \
+  /* External declarations for strict compilers */ \
+  class TEST_##testGroup##_##testName##_TestShell; \
+  extern TEST_##testGroup##_##testName##_TestShell TEST_##testGroup##_##testName##_TestShell_instance; \
+  \
+  class TEST_##testGroup##_##testName##_Test : public TEST_GROUP_##CppUTestGroup##testGroup \
+{ public: TEST_##testGroup##_##testName##_Test (const rowType& row) : TEST_GROUP_##CppUTestGroup##testGroup (), param(row) {} \
+       void testBody(); \
+       const rowType param; }; \
+  class TEST_##testGroup##_##testName##_TestShell : public ParameterizedUtestShell { \
+  public: TEST_##testGroup##_##testName##_TestShell () : ParameterizedUtestShell(#testName, rowCount) {} \
+      virtual Utest* createTest() _override { size_t row = getCurrentRow(); return new TEST_##testGroup##_##testName##_Test(rowExpression); } \
   } TEST_##testGroup##_##testName##_TestShell_instance; \
   static TestInstaller TEST_##testGroup##_##testName##_Installer(TEST_##testGroup##_##testName##_TestShell_instance, #testGroup, #testName, __FILE__,__LINE__); \
+  TEST_MANIFEST_RECORD("TEST_P", TEST_, testGroup, testName) \
     void TEST_##testGroup##_##testName##_Test::testBody()
 
 #define IGNORE_TEST(testGroup, testName)\
-  /* External declarations for strict compilers */ \
-  class IGNORE##testGroup##_##testName##_TestShell; \
-  extern IGNORE##testGroup##_##testName##_TestShell IGNORE##testGroup##_##testName##_TestShell_instance; \
-  \
   class IGNORE##testGroup##_##testName##_Test : public TEST_GROUP_##CppUTestGroup##testGroup \
 { public: IGNORE##testGroup##_##testName##_Test () : TEST_GROUP_##CppUTestGroup##testGroup () {} \
   public: void testBodyThatNeverRuns (); }; \
   class IGNORE##testGroup##_##testName##_TestShell : public IgnoredUtestShell { \
       virtual Utest* createTest() _override { return new IGNORE##testGroup##_##testName##_Test; } \
-  } IGNORE##testGroup##_##testName##_TestShell_instance; \
-   static TestInstaller TEST_##testGroup##testName##_Installer(IGNORE##testGroup##_##testName##_TestShell_instance, #testGroup, #testName, __FILE__,__LINE__); \
+  }; \
+  static UtestShell& IGNORE##testGroup##_##testName##_MakeTestShell() \
+  { static IGNORE##testGroup##_##testName##_TestShell shell; return shell; } \
+  static TestDescriptor IGNORE##testGroup##_##testName##_Descriptor = \
+    { #testGroup, #testName, __FILE__, __LINE__, IGNORE##testGroup##_##testName##_MakeTestShell, NULL, NULL, NULL }; \
+  TEST_DESCRIPTOR_INSTALL(IGNORE, testGroup, testName) \
+  TEST_MANIFEST_RECORD("IGNORE_TEST", IGNORE, testGroup, testName) \
     void IGNORE##testGroup##_##testName##_Test::testBodyThatNeverRuns ()
 
 #define IMPORT_TEST_GROUP(testGroup) \
@@ -103,13 +169,13 @@
   CHECK_LOCATION_FALSE(condition, "CHECK_FALSE", #condition, __FILE__, __LINE__)
 
 #define CHECK_LOCATION_TEXT(condition, checkString, conditionString, text, file, line) \
-    { UtestShell::getCurrent()->assertTrueText((condition) != 0, checkString, conditionString, text, file, line); }
+    { UtestShell::checkTrue((condition) != 0, checkString, conditionString, text, file, line); }
 
 #define CHECK_LOCATION_TRUE(condition, checkString, conditionString, file, line)\
-  { UtestShell::getCurrent()->assertTrue((condition) != 0, checkString, conditionString, file, line); }
+  { UtestShell::checkTrue((condition) != 0, checkString, conditionString, file, line); }
 
 #define CHECK_LOCATION_FALSE(condition, checkString, conditionString, file, line)\
-  { UtestShell::getCurrent()->assertTrue((condition) == 0, checkString, conditionString, file, line); }
+  { UtestShell::checkTrue((condition) == 0, checkString, conditionString, file, line); }
 
 //This check needs the operator!=(), and a StringFrom(YourType) function
 #define CHECK_EQUAL(expected,actual)\
@@ -125,7 +191,7 @@
   } \
   else \
   { \
-    UtestShell::getCurrent()->assertLongsEqual((long)0, (long)0, file, line); \
+    UtestShell::countPassedCheck(); \
   } }
 
 //This check checks for char* string equality using strcmp.
@@ -134,31 +200,31 @@
   STRCMP_EQUAL_LOCATION(expected, actual, __FILE__, __LINE__)
 
 #define STRCMP_EQUAL_LOCATION(expected,actual, file, line)\
-  { UtestShell::getCurrent()->assertCstrEqual(expected, actual, file, line); }
+  { UtestShell::checkCstrEqual(expected, actual, file, line); }
 
 #define STRNCMP_EQUAL(expected, actual, length)\
   STRNCMP_EQUAL_LOCATION(expected, actual, length, __FILE__, __LINE__)
 
 #define STRNCMP_EQUAL_LOCATION(expected, actual, length, file, line)\
-  { UtestShell::getCurrent()->assertCstrNEqual(expected, actual, length, file, line); }
+  { UtestShell::checkCstrNEqual(expected, actual, length, file, line); }
 
 #define STRCMP_NOCASE_EQUAL(expected,actual)\
   STRCMP_NOCASE_EQUAL_LOCATION(expected, actual, __FILE__, __LINE__)
 
 #define STRCMP_NOCASE_EQUAL_LOCATION(expected,actual, file, line)\
-  { UtestShell::getCurrent()->assertCstrNoCaseEqual(expected, actual, file, line); }
+  { UtestShell::checkCstrNoCaseEqual(expected, actual, file, line); }
 
 #define STRCMP_CONTAINS(expected,actual)\
   STRCMP_CONTAINS_LOCATION(expected, actual, __FILE__, __LINE__)
 
 #define STRCMP_CONTAINS_LOCATION(expected,actual, file, line)\
-  { UtestShell::getCurrent()->assertCstrContains(expected, actual, file, line); }
+  { UtestShell::checkCstrContains(expected, actual, file, line); }
 
 #define STRCMP_NOCASE_CONTAINS(expected,actual)\
   STRCMP_NOCASE_CONTAINS_LOCATION(expected, actual, __FILE__, __LINE__)
 
 #define STRCMP_NOCASE_CONTAINS_LOCATION(expected,actual, file, line)\
-  { UtestShell::getCurrent()->assertCstrNoCaseContains(expected, actual, file, line); }
+  { UtestShell::checkCstrNoCaseContains(expected, actual, file, line); }
 
 //Check two long integers for equality
 #define LONGS_EQUAL(expected,actual)\
@@ -168,10 +234,10 @@
   UNSIGNED_LONGS_EQUAL_LOCATION(expected,actual,__FILE__, __LINE__)
 
 #define LONGS_EQUAL_LOCATION(expected,actual,file,line)\
-  { UtestShell::getCurrent()->assertLongsEqual((long)expected, (long)actual,  file, line); }
+  { UtestShell::checkLongsEqual((long)expected, (long)actual,  file, line); }
 
 #define UNSIGNED_LONGS_EQUAL_LOCATION(expected,actual,file,line)\
-  { UtestShell::getCurrent()->assertUnsignedLongsEqual((unsigned long)expected, (unsigned long)actual,  file, line); }
+  { UtestShell::checkUnsignedLongsEqual((unsigned long)expected, (unsigned long)actual,  file, line); }
 
 #define BYTES_EQUAL(expected, actual)\
     LONGS_EQUAL((expected) & 0xff,(actual) & 0xff)
@@ -180,26 +246,33 @@
     POINTERS_EQUAL_LOCATION((expected),(actual), __FILE__, __LINE__)
 
 #define POINTERS_EQUAL_LOCATION(expected,actual,file,line)\
-  { UtestShell::getCurrent()->assertPointersEqual((void *)expected, (void *)actual,  file, line); }
+  { UtestShell::checkPointersEqual((void *)expected, (void *)actual,  file, line); }
 
 //Check two doubles for equality within a tolerance threshold
 #define DOUBLES_EQUAL(expected,actual,threshold)\
   DOUBLES_EQUAL_LOCATION(expected,actual,threshold,__FILE__,__LINE__)
 
 #define DOUBLES_EQUAL_LOCATION(expected,actual,threshold,file,line)\
-  { UtestShell::getCurrent()->assertDoublesEqual(expected, actual, threshold,  file, line); }
+  { UtestShell::checkDoublesEqual(expected, actual, threshold,  file, line); }
 
 #define MEMCMP_EQUAL(expected,actual,size)\
   MEMCMP_EQUAL_LOCATION(expected,actual,size,__FILE__,__LINE__)
 
 #define MEMCMP_EQUAL_LOCATION(expected,actual,size,file,line)\
-  { UtestShell::getCurrent()->assertBinaryEqual(expected, actual, size, file, line); }
+  { UtestShell::checkBinaryEqual(expected, actual, size, file, line); }
 
 #define BITS_EQUAL(expected,actual,mask)\
   BITS_LOCATION(expected,actual,mask,__FILE__,__LINE__)
 
 #define BITS_LOCATION(expected,actual,mask,file,line)\
-  { UtestShell::getCurrent()->assertBitsEqual(expected, actual, mask, sizeof(actual), file, line); }
+  { UtestShell::checkBitsEqual(expected, actual, mask, sizeof(actual), file, line); }
+
+//Fails when the memory allocated during the test so far peaked at limit bytes or more
+#define CHECK_PEAK_MEMORY_BELOW(limit)\
+  CHECK_PEAK_MEMORY_BELOW_LOCATION(limit,__FILE__,__LINE__)
+
+#define CHECK_PEAK_MEMORY_BELOW_LOCATION(limit,file,line)\
+  { UtestShell::getCurrent()->assertPeakMemoryBelow((size_t)(limit), file, line); }
 
 //Fail if you get to this macro
 //The macro FAIL may already be taken, so allow FAIL_TEST too
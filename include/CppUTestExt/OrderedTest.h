@@ -36,6 +36,7 @@ public:
 
    virtual OrderedTestShell* addOrderedTest(OrderedTestShell* test);
    virtual OrderedTestShell* getNextOrderedTest();
+   virtual bool keepsItsOrder() const _override;
 
    int getLevel();
    void setLevel(int level);
@@ -76,6 +77,7 @@ class OrderedTestInstaller
        virtual Utest* createTest() _override { return new TEST_##testGroup##_##testName##_Test; } \
   }  TEST_##testGroup##_##testName##_Instance; \
   static OrderedTestInstaller TEST_##testGroup##_##testName##_Installer(TEST_##testGroup##_##testName##_Instance, #testGroup, #testName, __FILE__,__LINE__, testLevel); \
+  TEST_MANIFEST_RECORD("TEST_ORDERED", TEST_, testGroup, testName) \
    void TEST_##testGroup##_##testName##_Test::testBody()
 
 #endif
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2007, Michael Feathers, James Grenning and Bas Vodde
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE EARLIER MENTIONED AUTHORS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <copyright holder> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef D_PropertyCheck_h
+#define D_PropertyCheck_h
+
+#include "CppUTest/TestHarness.h"
+
+/*
+ * Property based testing. A property is a function that draws its input from a PropertyCase
+ * and checks it with the normal checking macros. CHECK_PROPERTY runs it for many random cases.
+ * When a case fails, it is shrunk to the smallest input that still fails, which is reported with
+ * the seed of the run.
+ *
+ * Every value a case draws is recorded as a choice. Shrinking works on these choices, so values
+ * made by composing the generators below shrink without further support.
+ */
+
+class PropertyCase
+{
+public:
+    PropertyCase();
+    virtual ~PropertyCase();
+
+    bool anyBool();
+    int anyInt(int min, int max);
+    long anyLong(long min, long max);
+    unsigned long anyUnsignedLong(unsigned long max);
+    double anyDouble(double min, double max);
+    size_t anyIndex(size_t count);
+
+    /* Strings and byte buffers live until the next case starts */
+    const char* anyCString(size_t maxLength);
+    SimpleString anyString(size_t maxLength);
+    const unsigned char* anyBytes(size_t maxLength, size_t& length);
+
+    void setSeed(unsigned long seed);
+    void startRandomCase();
+    void startReplay(const unsigned long* choices, size_t choiceCount, bool describe);
+    const unsigned long* getChoices() const;
+    size_t getChoiceCount() const;
+    SimpleString getDescription() const;
+
+private:
+    unsigned long randomState_;
+
+    const unsigned long* replayChoices_;
+    size_t replayChoiceCount_;
+    bool describing_;
+    SimpleString description_;
+
+    unsigned long* choices_;
+    size_t choiceCount_;
+    size_t choiceCapacity_;
+
+    char* arena_;
+    size_t arenaSize_;
+    size_t arenaUsed_;
+    char* overflowBlocks_;
+    size_t overflowSize_;
+
+    unsigned long draw(unsigned long bound);
+    unsigned long randomValue(unsigned long bound);
+    unsigned long nextRandom();
+    void recordChoice(unsigned long choice);
+    char* allocate(size_t size);
+    void resetArena();
+    void describe(const SimpleString& value);
+
+    PropertyCase(const PropertyCase&);
+    PropertyCase& operator=(const PropertyCase&);
+};
+
+typedef void (*PropertyFunction)(PropertyCase& propertyCase);
+
+class PropertyCaseResult;
+
+class PropertyChecker
+{
+public:
+    explicit PropertyChecker(PropertyFunction property);
+    virtual ~PropertyChecker();
+
+    void setCases(unsigned long cases);
+    void setSeed(unsigned long seed);
+    void setMaximumShrinkRuns(unsigned long runs);
+
+    virtual void check(const char* fileName, int lineNumber);
+
+    /* The seed used when a check sets none. Zero takes a new seed from the clock for every check. */
+    static void setDefaultSeed(unsigned long seed);
+
+private:
+    PropertyFunction property_;
+    unsigned long cases_;
+    unsigned long seed_;
+    unsigned long maximumShrinkRuns_;
+    PropertyCase propertyCase_;
+    UtestShell* caseShell_;
+    PropertyCaseResult* caseResult_;
+
+    unsigned long* smallest_;
+    size_t smallestCount_;
+    unsigned long* candidate_;
+    size_t capacity_;
+    unsigned long shrinkRuns_;
+    unsigned long shrinks_;
+
+    static unsigned long defaultSeed_;
+
+    bool runCase();
+    void keepSmallest(const unsigned long* choices, size_t count);
+    bool shrinkTo(size_t count);
+    void shrink();
+    void reportFailure(unsigned long seed, unsigned long failingCase, const char* fileName, int lineNumber);
+    void runProperty();
+
+    friend class PropertyCaseTestShell;
+    PropertyChecker(const PropertyChecker&);
+    PropertyChecker& operator=(const PropertyChecker&);
+};
+
+#define CHECK_PROPERTY(property)\
+  CHECK_PROPERTY_CASES(property, 100)
+
+#define CHECK_PROPERTY_CASES(property, cases)\
+  { PropertyChecker propertyChecker(property); propertyChecker.setCases(cases); propertyChecker.check(__FILE__, __LINE__); }
+
+#define CHECK_PROPERTY_WITH_SEED(property, cases, seed)\
+  { PropertyChecker propertyChecker(property); propertyChecker.setCases(cases); propertyChecker.setSeed(seed); propertyChecker.check(__FILE__, __LINE__); }
+
+#endif
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2007, Michael Feathers, James Grenning and Bas Vodde
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE EARLIER MENTIONED AUTHORS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <copyright holder> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/AllocationFailureRunner.h"
+#include "CppUTest/TestPlugin.h"
+
+AllocationFailureRunner::AllocationFailureRunner()
+    : mallocAllocator_(&schedule_, NULL), newAllocator_(&schedule_, NULL), newArrayAllocator_(&schedule_, NULL)
+{
+}
+
+AllocationFailureRunner::~AllocationFailureRunner()
+{
+}
+
+void AllocationFailureRunner::installAllocators(UtestShell& test, unsigned allocationToFail)
+{
+    schedule_.clear();
+    schedule_.restrictToTest(&test);
+    if (allocationToFail) schedule_.failAllocationNumber(allocationToFail);
+
+    mallocAllocator_.setOriginalAllocator(getCurrentMallocAllocator());
+    newAllocator_.setOriginalAllocator(getCurrentNewAllocator());
+    newArrayAllocator_.setOriginalAllocator(getCurrentNewArrayAllocator());
+    setCurrentMallocAllocator(&mallocAllocator_);
+    setCurrentNewAllocator(&newAllocator_);
+    setCurrentNewArrayAllocator(&newArrayAllocator_);
+}
+
+void AllocationFailureRunner::removeAllocators()
+{
+    setCurrentMallocAllocator(mallocAllocator_.getOriginalAllocator());
+    setCurrentNewAllocator(newAllocator_.getOriginalAllocator());
+    setCurrentNewArrayAllocator(newArrayAllocator_.getOriginalAllocator());
+}
+
+/* Stands in for a test, under its names, so the runner can run it its own way */
+class AllocationFailureRunnerShell : public UtestShell
+{
+public:
+    AllocationFailureRunnerShell(AllocationFailureRunner& runner, UtestShell& test)
+        : runner_(runner), test_(test), group_(test.getGroup()), name_(test.getName()), file_(test.getFile())
+    {
+        setGroupName(group_.asCharString());
+        setTestName(name_.asCharString());
+        setFileName(file_.asCharString());
+        setLineNumber(test.getLineNumber());
+    }
+
+    virtual SimpleString getFormattedName() const _override
+    {
+        return test_.getFormattedName();
+    }
+
+protected:
+    AllocationFailureRunner& runner_;
+    UtestShell& test_;
+
+private:
+    SimpleString group_;
+    SimpleString name_;
+    SimpleString file_;
+};
+
+/* Runs the counting run and all reruns of a test in one separate process */
+class AllocationFailureSeparateProcessShell : public AllocationFailureRunnerShell
+{
+public:
+    AllocationFailureSeparateProcessShell(AllocationFailureRunner& runner, UtestShell& test)
+        : AllocationFailureRunnerShell(runner, test)
+    {
+        setRunInSeperateProcess();
+    }
+
+    virtual void runOneTestInCurrentProcess(TestPlugin* plugin, TestResult& result) _override
+    {
+        runner_.runOneTestInCurrentProcess(test_, plugin, result);
+    }
+};
+
+/* Runs a test once, with the allocators of the runner in place only while its fixture exists */
+class AllocationFailureAttemptShell : public AllocationFailureRunnerShell
+{
+public:
+    AllocationFailureAttemptShell(AllocationFailureRunner& runner, UtestShell& test, unsigned allocationToFail)
+        : AllocationFailureRunnerShell(runner, test), allocationToFail_(allocationToFail)
+    {
+    }
+
+    virtual Utest* createTest() _override
+    {
+        Utest* test = test_.createTest();
+        runner_.installAllocators(*this, allocationToFail_);
+        return test;
+    }
+
+    virtual void destroyTest(Utest* test) _override
+    {
+        runner_.removeAllocators();
+        test_.destroyTest(test);
+    }
+
+    void run(TestPlugin* plugin, TestResult& result)
+    {
+        runTestInCurrentProcess(plugin, result, allocationToFail_ == 0);
+    }
+
+private:
+    unsigned allocationToFail_;
+};
+
+void AllocationFailureRunner::runOneTest(UtestShell& test, TestPlugin* plugin, TestResult& result)
+{
+    if (test.isRunInSeperateProcess()) {
+        AllocationFailureSeparateProcessShell shell(*this, test);
+        shell.runOneTest(plugin, result);
+    }
+    else
+        runOneTestInCurrentProcess(test, plugin, result);
+}
+
+/* Only the first run counts as a run, the runs failing an allocation are counted as reruns */
+void AllocationFailureRunner::runOneTestInCurrentProcess(UtestShell& test, TestPlugin* plugin, TestResult& result)
+{
+    int failuresBeforeTest = result.getFailureCount();
+
+    AllocationFailureAttemptShell(*this, test, 0).run(plugin, result);
+
+    unsigned allocations = schedule_.getAllocationCount();
+    if (result.getFailureCount() != failuresBeforeTest) return;
+
+    for (unsigned allocation = 1; allocation <= allocations; allocation++) {
+        AllocationFailureAttemptShell(*this, test, allocation).run(plugin, result);
+        result.countRerun();
+
+        if (result.getFailureCount() != failuresBeforeTest) {
+            result.addFailure(TestFailure(&test, StringFromFormat("Failed while failing allocation %u of %u", allocation, allocations)));
+            return;
+        }
+    }
+}
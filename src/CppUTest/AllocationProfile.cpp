@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2007, Michael Feathers, James Grenning and Bas Vodde
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE EARLIER MENTIONED AUTHORS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <copyright holder> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/AllocationProfile.h"
+#include "CppUTest/PlatformSpecificFunctions.h"
+
+static const char* unknownCallSiteFile = "<unknown>";
+static const char* unknownName = "<unknown>";
+
+AllocationProfile::AllocationProfile()
+    : sites_(NULL), capacity_(0), numberOfSites_(0), names_(NULL), namesCapacity_(0), numberOfNames_(0), currentTest_(NULL), currentGroup_(NULL)
+{
+}
+
+AllocationProfile::~AllocationProfile()
+{
+    forgetNames();
+    PlatformSpecificFree(sites_);
+}
+
+size_t AllocationProfile::indexOf(const char* file, int line) const
+{
+    size_t hash = ((size_t) file >> 3) ^ ((size_t) line * 2654435761u);
+    return hash & (capacity_ - 1);
+}
+
+AllocationCallSite* AllocationProfile::findSite(const char* file, int line) const
+{
+    if (capacity_ == 0) return NULL;
+
+    for (size_t i = indexOf(file, line); sites_[i].file_ != NULL; i = (i + 1) & (capacity_ - 1))
+        if (sites_[i].file_ == file && sites_[i].line_ == line)
+            return &sites_[i];
+    return NULL;
+}
+
+bool AllocationProfile::grow()
+{
+    size_t newCapacity = (capacity_ == 0) ? 256 : capacity_ * 2;
+    AllocationCallSite* newSites = (AllocationCallSite*) PlatformSpecificMalloc(newCapacity * sizeof(AllocationCallSite));
+    if (newSites == NULL) return false;
+    PlatformSpecificMemset(newSites, 0, newCapacity * sizeof(AllocationCallSite));
+
+    AllocationCallSite* oldSites = sites_;
+    size_t oldCapacity = capacity_;
+    sites_ = newSites;
+    capacity_ = newCapacity;
+
+    for (size_t i = 0; i < oldCapacity; i++) {
+        if (oldSites[i].file_ == NULL) continue;
+        size_t index = indexOf(oldSites[i].file_, oldSites[i].line_);
+        while (sites_[index].file_ != NULL)
+            index = (index + 1) & (capacity_ - 1);
+        sites_[index] = oldSites[i];
+    }
+    PlatformSpecificFree(oldSites);
+    return true;
+}
+
+AllocationCallSite* AllocationProfile::findOrAddSite(const char* file, int line)
+{
+    AllocationCallSite* site = findSite(file, line);
+    if (site) return site;
+
+    if ((numberOfSites_ + 1) * 4 > capacity_ * 3 && !grow()) return NULL;
+
+    size_t index = indexOf(file, line);
+    while (sites_[index].file_ != NULL)
+        index = (index + 1) & (capacity_ - 1);
+    sites_[index].file_ = file;
+    sites_[index].line_ = line;
+    numberOfSites_++;
+    return &sites_[index];
+}
+
+const char* AllocationProfile::keepName(const SimpleString& name)
+{
+    if (numberOfNames_ == namesCapacity_) {
+        size_t newCapacity = (namesCapacity_ == 0) ? 64 : namesCapacity_ * 2;
+        char** newNames = (char**) PlatformSpecificRealloc(names_, newCapacity * sizeof(char*));
+        if (newNames == NULL) return unknownName;
+        names_ = newNames;
+        namesCapacity_ = newCapacity;
+    }
+
+    char* copy = (char*) PlatformSpecificMalloc(name.size() + 1);
+    if (copy == NULL) return unknownName;
+    name.copyToBuffer(copy, name.size() + 1);
+    names_[numberOfNames_++] = copy;
+    return copy;
+}
+
+void AllocationProfile::forgetNames()
+{
+    for (size_t i = 0; i < numberOfNames_; i++)
+        PlatformSpecificFree(names_[i]);
+    PlatformSpecificFree(names_);
+    names_ = NULL;
+    namesCapacity_ = 0;
+    numberOfNames_ = 0;
+}
+
+void AllocationProfile::allocated(const char* file, int line, size_t size)
+{
+    AllocationCallSite* site = findOrAddSite((file) ? file : unknownCallSiteFile, line);
+    if (site == NULL) return;
+
+    site->allocations_++;
+    site->bytes_ += size;
+    site->liveBytes_ += size;
+    if (site->liveBytes_ > site->peakLiveBytes_) site->peakLiveBytes_ = site->liveBytes_;
+    if (currentTest_) site->testBytes_ += size;
+    if (currentGroup_) site->groupBytes_ += size;
+}
+
+void AllocationProfile::freed(const char* file, int line, size_t size)
+{
+    AllocationCallSite* site = findSite((file) ? file : unknownCallSiteFile, line);
+    if (site == NULL) return;
+
+    site->liveBytes_ = (site->liveBytes_ > size) ? site->liveBytes_ - size : 0;
+}
+
+void AllocationProfile::startTest(UtestShell& test)
+{
+    SimpleString group = test.getGroup();
+    if (currentGroup_ && group != currentGroup_) endGroup();
+    if (currentGroup_ == NULL) currentGroup_ = keepName(group);
+    currentTest_ = keepName(test.getFormattedName());
+}
+
+void AllocationProfile::endTest()
+{
+    for (size_t i = 0; i < capacity_; i++) {
+        AllocationCallSite& site = sites_[i];
+        if (site.file_ == NULL || site.testBytes_ == 0) continue;
+        if (site.testBytes_ > site.heaviestTestBytes_) {
+            site.heaviestTestBytes_ = site.testBytes_;
+            site.heaviestTest_ = currentTest_;
+        }
+        site.testBytes_ = 0;
+    }
+    currentTest_ = NULL;
+}
+
+void AllocationProfile::endGroup()
+{
+    for (size_t i = 0; i < capacity_; i++) {
+        AllocationCallSite& site = sites_[i];
+        if (site.file_ == NULL || site.groupBytes_ == 0) continue;
+        if (site.groupBytes_ > site.heaviestGroupBytes_) {
+            site.heaviestGroupBytes_ = site.groupBytes_;
+            site.heaviestGroup_ = currentGroup_;
+        }
+        site.groupBytes_ = 0;
+    }
+    currentGroup_ = NULL;
+}
+
+void AllocationProfile::clear()
+{
+    if (sites_) PlatformSpecificMemset(sites_, 0, capacity_ * sizeof(AllocationCallSite));
+    forgetNames();
+    numberOfSites_ = 0;
+    currentTest_ = NULL;
+    currentGroup_ = NULL;
+}
+
+size_t AllocationProfile::getNumberOfCallSites() const
+{
+    return numberOfSites_;
+}
+
+const AllocationCallSite* AllocationProfile::getCallSite(const char* file, int line) const
+{
+    return findSite(file, line);
+}
+
+static SimpleString callSiteAsString(const AllocationCallSite& site, AllocationProfile::ProfileFormat format)
+{
+    if (format == AllocationProfile::profile_collapsed)
+        return StringFromFormat("%s:%d %lu\n", site.file_, site.line_, (unsigned long) site.bytes_);
+
+    SimpleString result = StringFromFormat("%s:%d: %lu bytes in %lu allocations, peak %lu bytes live",
+        site.file_, site.line_, (unsigned long) site.bytes_, (unsigned long) site.allocations_, (unsigned long) site.peakLiveBytes_);
+    if (site.heaviestTest_)
+        result += StringFromFormat(", most by %s (%lu bytes)", site.heaviestTest_, (unsigned long) site.heaviestTestBytes_);
+    if (site.heaviestGroup_)
+        result += StringFromFormat(", most by group %s (%lu bytes)", site.heaviestGroup_, (unsigned long) site.heaviestGroupBytes_);
+    return result + "\n";
+}
+
+/*
+ * The sites are copied before sorting because building the report allocates,
+ * which may add sites to the table while it is attached to a detector.
+ */
+SimpleString AllocationProfile::asString(ProfileFormat format) const
+{
+    size_t count = numberOfSites_;
+    AllocationCallSite* sorted = (AllocationCallSite*) PlatformSpecificMalloc((count + 1) * sizeof(AllocationCallSite));
+    if (sorted == NULL) return "";
+
+    size_t used = 0;
+    for (size_t i = 0; i < capacity_ && used < count; i++) {
+        if (sites_[i].file_ == NULL) continue;
+        AllocationCallSite site = sites_[i];
+        size_t position = used++;
+        for (; position > 0 && sorted[position - 1].bytes_ < site.bytes_; position--)
+            sorted[position] = sorted[position - 1];
+        sorted[position] = site;
+    }
+
+    SimpleString result;
+    if (format == profile_table)
+        result = StringFromFormat("Allocation profile: %lu call sites, sorted by bytes allocated\n", (unsigned long) used);
+    for (size_t i = 0; i < used; i++)
+        result += callSiteAsString(sorted[i], format);
+
+    PlatformSpecificFree(sorted);
+    return result;
+}
+
+AllocationProfilePlugin::AllocationProfilePlugin(const SimpleString& name, AllocationProfile* profile)
+    : TestPlugin(name), profile_(profile)
+{
+}
+
+AllocationProfilePlugin::~AllocationProfilePlugin()
+{
+}
+
+void AllocationProfilePlugin::preTestAction(UtestShell& test, TestResult&)
+{
+    profile_->startTest(test);
+}
+
+void AllocationProfilePlugin::postTestAction(UtestShell&, TestResult&)
+{
+    profile_->endTest();
+}
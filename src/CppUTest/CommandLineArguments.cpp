@@ -30,7 +30,7 @@
 #include "CppUTest/PlatformSpecificFunctions.h"
 
 CommandLineArguments::CommandLineArguments(int ac, const char** av) :
-    ac_(ac), av_(av), verbose_(false), color_(false), runTestsAsSeperateProcess_(false), listTestGroupNames_(false), listTestGroupAndCaseNames_(false), repeat_(1), groupFilters_(NULL), nameFilters_(NULL), outputType_(OUTPUT_ECLIPSE)
+    ac_(ac), av_(av), verbose_(false), peakMemory_(false), color_(false), bufferedOutput_(false), crashHandler_(false), crashBacktrace_(false), runTestsAsSeperateProcess_(false), listTestGroupNames_(false), listTestGroupAndCaseNames_(false), listTestManifest_(false), resume_(false), allocationProfile_(false), collapsedAllocationProfile_(false), failEachAllocation_(false), repeat_(1), shuffle_(false), shuffleSeed_(0), groupFilters_(NULL), nameFilters_(NULL), outputType_(OUTPUT_ECLIPSE)
 {
 }
 
@@ -55,11 +55,21 @@ bool CommandLineArguments::parse(TestPlugin* plugin)
         SimpleString argument = av_[i];
         
         if      (argument == "-v") verbose_ = true;
+        else if (argument == "-vm") verbose_ = peakMemory_ = true;
         else if (argument == "-c") color_ = true;
+        else if (argument == "-b") bufferedOutput_ = true;
         else if (argument == "-p") runTestsAsSeperateProcess_ = true;
+        else if (argument == "-s") crashHandler_ = true;
+        else if (argument == "-sb") crashHandler_ = crashBacktrace_ = true;
         else if (argument == "-lg") listTestGroupNames_ = true;
         else if (argument == "-ln") listTestGroupAndCaseNames_ = true;
+        else if (argument == "-lm") listTestManifest_ = true;
+        else if (argument == "--resume") resume_ = true;
+        else if (argument == "-ap") allocationProfile_ = true;
+        else if (argument == "-apcollapsed") allocationProfile_ = collapsedAllocationProfile_ = true;
+        else if (argument == "-fa") failEachAllocation_ = true;
         else if (argument.startsWith("-r")) SetRepeatCount(ac_, av_, i);
+        else if (argument.startsWith("-z")) SetShuffleSeed(ac_, av_, i);
         else if (argument.startsWith("-g")) AddGroupFilter(ac_, av_, i);
         else if (argument.startsWith("-sg")) AddStrictGroupFilter(ac_, av_, i);
         else if (argument.startsWith("-n")) AddNameFilter(ac_, av_, i);
@@ -69,6 +79,7 @@ bool CommandLineArguments::parse(TestPlugin* plugin)
         else if (argument.startsWith("-o")) correctParameters = SetOutputType(ac_, av_, i);
         else if (argument.startsWith("-p")) correctParameters = plugin->parseAllArguments(ac_, av_, i);
         else if (argument.startsWith("-k")) SetPackageName(ac_, av_, i);
+        else if (argument.startsWith("-j")) SetJournalFileName(ac_, av_, i);
         else correctParameters = false;
 
         if (correctParameters == false) {
@@ -80,7 +91,7 @@ bool CommandLineArguments::parse(TestPlugin* plugin)
 
 const char* CommandLineArguments::usage() const
 {
-    return "usage [-v] [-c] [-p] [-lg] [-ln] [-r#] [-g|sg groupName]... [-n|sn testName]... [\"TEST(groupName, testName)\"]... [-o{normal, junit}] [-k packageName]\n";
+    return "usage [-v|vm] [-c] [-b] [-p] [-s|sb] [-lg] [-ln] [-lm] [-ap|apcollapsed] [-fa] [-r#] [-z[seed]] [-g|sg groupName]... [-n|sn testName]... [\"TEST(groupName, testName)\"]... [-o{normal, junit, junitsingle, json}] [-k packageName] [-j journalFile] [--resume]\n";
 }
 
 bool CommandLineArguments::isVerbose() const
@@ -88,11 +99,31 @@ bool CommandLineArguments::isVerbose() const
     return verbose_;
 }
 
+bool CommandLineArguments::isPrintingPeakMemory() const
+{
+    return peakMemory_;
+}
+
 bool CommandLineArguments::isColor() const
 {
     return color_;
 }
 
+bool CommandLineArguments::isBufferedOutput() const
+{
+    return bufferedOutput_;
+}
+
+bool CommandLineArguments::isInstallingCrashHandler() const
+{
+    return crashHandler_;
+}
+
+bool CommandLineArguments::isWritingCrashBacktrace() const
+{
+    return crashBacktrace_;
+}
+
 bool CommandLineArguments::isListingTestGroupNames() const
 {
     return listTestGroupNames_;
@@ -103,6 +134,26 @@ bool CommandLineArguments::isListingTestGroupAndCaseNames() const
     return listTestGroupAndCaseNames_;
 }
 
+bool CommandLineArguments::isListingTestManifest() const
+{
+    return listTestManifest_;
+}
+
+bool CommandLineArguments::isProfilingAllocations() const
+{
+    return allocationProfile_;
+}
+
+bool CommandLineArguments::isCollapsedAllocationProfile() const
+{
+    return collapsedAllocationProfile_;
+}
+
+bool CommandLineArguments::isFailingEachAllocation() const
+{
+    return failEachAllocation_;
+}
+
 bool CommandLineArguments::runTestsInSeperateProcess() const
 {
     return runTestsAsSeperateProcess_;
@@ -114,6 +165,16 @@ int CommandLineArguments::getRepeatCount() const
     return repeat_;
 }
 
+bool CommandLineArguments::isShuffling() const
+{
+    return shuffle_;
+}
+
+unsigned long CommandLineArguments::getShuffleSeed() const
+{
+    return shuffleSeed_;
+}
+
 const TestFilter* CommandLineArguments::getGroupFilters() const
 {
     return groupFilters_;
@@ -139,6 +200,19 @@ void CommandLineArguments::SetRepeatCount(int ac, const char** av, int& i)
 
 }
 
+void CommandLineArguments::SetShuffleSeed(int ac, const char** av, int& i)
+{
+    shuffle_ = true;
+    shuffleSeed_ = 0;
+
+    SimpleString shuffleParameter(av[i]);
+    if (shuffleParameter.size() > 2) shuffleSeed_ = SimpleString::AtoU(av[i] + 2);
+    else if (i + 1 < ac) {
+        shuffleSeed_ = SimpleString::AtoU(av[i + 1]);
+        if (shuffleSeed_ != 0) i++;
+    }
+}
+
 SimpleString CommandLineArguments::getParameterField(int ac, const char** av, int& i, const SimpleString& parameterName)
 {
     size_t parameterLength = parameterName.size();
@@ -195,6 +269,14 @@ void CommandLineArguments::SetPackageName(int ac, const char** av, int& i)
     packageName_ = packageName;
 }
 
+void CommandLineArguments::SetJournalFileName(int ac, const char** av, int& i)
+{
+    SimpleString journalFileName = getParameterField(ac, av, i, "-j");
+    if (journalFileName.size() == 0) return;
+
+    journalFileName_ = journalFileName;
+}
+
 bool CommandLineArguments::SetOutputType(int ac, const char** av, int& i)
 {
     SimpleString outputType = getParameterField(ac, av, i, "-o");
@@ -208,6 +290,14 @@ bool CommandLineArguments::SetOutputType(int ac, const char** av, int& i)
         outputType_ = OUTPUT_JUNIT;
         return true;
     }
+    if (outputType == "junitsingle") {
+        outputType_ = OUTPUT_JUNIT_SINGLE_FILE;
+        return true;
+    }
+    if (outputType == "json") {
+        outputType_ = OUTPUT_JSON;
+        return true;
+    }
     return false;
 }
 
@@ -218,7 +308,17 @@ bool CommandLineArguments::isEclipseOutput() const
 
 bool CommandLineArguments::isJUnitOutput() const
 {
-    return outputType_ == OUTPUT_JUNIT;
+    return outputType_ == OUTPUT_JUNIT || outputType_ == OUTPUT_JUNIT_SINGLE_FILE;
+}
+
+bool CommandLineArguments::isJUnitSingleFileOutput() const
+{
+    return outputType_ == OUTPUT_JUNIT_SINGLE_FILE;
+}
+
+bool CommandLineArguments::isJsonOutput() const
+{
+    return outputType_ == OUTPUT_JSON;
 }
 
 const SimpleString& CommandLineArguments::getPackageName() const
@@ -226,3 +326,15 @@ const SimpleString& CommandLineArguments::getPackageName() const
     return packageName_;
 }
 
+bool CommandLineArguments::isResuming() const
+{
+    return resume_;
+}
+
+SimpleString CommandLineArguments::getJournalFileName() const
+{
+    if (journalFileName_.isEmpty() && resume_)
+        return "cpputest_journal.txt";
+    return journalFileName_;
+}
+
@@ -29,7 +29,14 @@
 #include "CppUTest/CommandLineTestRunner.h"
 #include "CppUTest/TestOutput.h"
 #include "CppUTest/JUnitTestOutput.h"
+#include "CppUTest/JsonTestOutput.h"
 #include "CppUTest/TestRegistry.h"
+#include "CppUTest/TestJournal.h"
+#include "CppUTest/TestManifest.h"
+#include "CppUTest/AllocationProfile.h"
+#include "CppUTest/AllocationFailureRunner.h"
+#include "CppUTest/MemoryLeakDetector.h"
+#include "CppUTest/PlatformSpecificFunctions.h"
 
 int CommandLineTestRunner::RunAllTests(int ac, char** av)
 {
@@ -88,6 +95,7 @@ void CommandLineTestRunner::initializeTestRun()
     registry_->setGroupFilters(arguments_->getGroupFilters());
     registry_->setNameFilters(arguments_->getNameFilters());
     if (arguments_->isVerbose()) output_->verbose();
+    if (arguments_->isPrintingPeakMemory()) output_->peakMemory();
     if (arguments_->isColor()) output_->color();
     if (arguments_->runTestsInSeperateProcess()) registry_->setRunTestsInSeperateProcess();
 }
@@ -113,19 +121,72 @@ int CommandLineTestRunner::runAllTests()
         return 0;
     }
 
+    if (arguments_->isListingTestManifest())
+    {
+        output_->print(TestManifest::linkedIn().listRecords().asCharString());
+        return 0;
+    }
+
+    TestJournal journal(arguments_->getJournalFileName());
+    if (!arguments_->getJournalFileName().isEmpty()) {
+        if (arguments_->isResuming()) journal.loadPreviousRun();
+        journal.open(arguments_->isResuming());
+        registry_->setJournal(&journal);
+    }
+
+    AllocationFailureRunner allocationFailureRunner;
+    if (arguments_->isFailingEachAllocation())
+        registry_->setAllocationFailureRunner(&allocationFailureRunner);
+
+    if (arguments_->isWritingCrashBacktrace())
+        PlatformSpecificInstallCrashHandler(UtestShell::reportCrashOfCurrentTestWithBacktrace);
+    else if (arguments_->isInstallingCrashHandler())
+        PlatformSpecificInstallCrashHandler(UtestShell::reportCrashOfCurrentTest);
+
+    AllocationProfile profile;
+    AllocationProfilePlugin profilePlugin(DEF_PLUGIN_ALLOCATION_PROFILE, &profile);
+    if (arguments_->isProfilingAllocations()) {
+        registry_->installPlugin(&profilePlugin);
+        MemoryLeakWarningPlugin::getGlobalDetector()->setAllocationProfile(&profile);
+    }
+
+    if (arguments_->isShuffling()) {
+        unsigned long seed = arguments_->getShuffleSeed();
+        if (seed == 0) seed = ((unsigned long) GetPlatformSpecificTimeInMillis() & 0xFFFFFFFFUL) | 1;
+        registry_->setShuffleSeed(seed);
+    }
+
     while (loopCount++ < repeat_) {
         output_->printTestRun(loopCount, repeat_);
+        if (arguments_->isShuffling())
+            output_->print(StringFromFormat("Shuffling tests with seed %lu\n", registry_->getShuffleSeed()).asCharString());
         TestResult tr(*output_);
         registry_->runAllTests(tr);
         failureCount += tr.getFailureCount();
     }
 
+    if (arguments_->isProfilingAllocations()) {
+        MemoryLeakWarningPlugin::getGlobalDetector()->setAllocationProfile(NULL);
+        registry_->removePluginByName(DEF_PLUGIN_ALLOCATION_PROFILE);
+        profile.endGroup();
+        output_->print(profile.asString(arguments_->isCollapsedAllocationProfile() ? AllocationProfile::profile_collapsed : AllocationProfile::profile_table).asCharString());
+    }
+
+    if (arguments_->isInstallingCrashHandler())
+        PlatformSpecificUninstallCrashHandler();
+    registry_->setJournal(NULL);
+    registry_->setAllocationFailureRunner(NULL);
+    registry_->setShuffleSeed(0);
     return failureCount;
 }
 
 TestOutput* CommandLineTestRunner::createJUnitOutput(const SimpleString& packageName)
 {
-    JUnitTestOutput* junitOutput = new JUnitTestOutput;
+    JUnitTestOutput* junitOutput;
+    if (arguments_->isJUnitSingleFileOutput())
+        junitOutput = new JUnitSingleFileTestOutput;
+    else
+        junitOutput = new JUnitTestOutput;
     if (junitOutput != NULL) {
       junitOutput->setPackageName(packageName);
     }
@@ -134,9 +195,16 @@ TestOutput* CommandLineTestRunner::createJUnitOutput(const SimpleString& package
 
 TestOutput* CommandLineTestRunner::createConsoleOutput()
 {
+    if (arguments_->isBufferedOutput())
+        return new BufferedConsoleTestOutput;
     return new ConsoleTestOutput;
 }
 
+TestOutput* CommandLineTestRunner::createJsonOutput()
+{
+    return new JsonTestOutput;
+}
+
 TestOutput* CommandLineTestRunner::createCompositeOutput(TestOutput* outputOne, TestOutput* outputTwo)
 {
   CompositeTestOutput* composite = new CompositeTestOutput;
@@ -158,6 +226,8 @@ bool CommandLineTestRunner::parseArguments(TestPlugin* plugin)
     if (arguments_->isVerbose())
       output_ = createCompositeOutput(output_, createConsoleOutput());
   }
+  else if (arguments_->isJsonOutput())
+    output_ = createJsonOutput();
   else
     output_ = createConsoleOutput();
   return true;
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2007, Michael Feathers, James Grenning and Bas Vodde
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE EARLIER MENTIONED AUTHORS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <copyright holder> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/GuardPageAllocatorPlugin.h"
+#include "CppUTest/TestFilter.h"
+
+GuardPageAllocatorPlugin::GuardPageAllocatorPlugin(const SimpleString& name)
+    : TestPlugin(name), groupFilters_(NULL),
+      mallocAllocator_("Guard Page Malloc Allocator", "malloc", "free"),
+      newAllocator_("Guard Page New Allocator", "new", "delete"),
+      newArrayAllocator_("Guard Page New [] Allocator", "new []", "delete []"),
+      originalMallocAllocator_(NULL), originalNewAllocator_(NULL), originalNewArrayAllocator_(NULL)
+{
+}
+
+GuardPageAllocatorPlugin::~GuardPageAllocatorPlugin()
+{
+    removeGuardPageAllocators();
+    while (groupFilters_) {
+        TestFilter* current = groupFilters_;
+        groupFilters_ = groupFilters_->getNext();
+        delete current;
+    }
+}
+
+void GuardPageAllocatorPlugin::guardTestGroups(const SimpleString& groupFilter)
+{
+    TestFilter* filter = new TestFilter(groupFilter);
+    groupFilters_ = filter->add(groupFilters_);
+}
+
+void GuardPageAllocatorPlugin::setSamplingInterval(unsigned interval)
+{
+    mallocAllocator_.setSamplingInterval(interval);
+    newAllocator_.setSamplingInterval(interval);
+    newArrayAllocator_.setSamplingInterval(interval);
+}
+
+void GuardPageAllocatorPlugin::setGuardPlacement(GuardPageMemoryAllocator::GuardPlacement placement)
+{
+    mallocAllocator_.setGuardPlacement(placement);
+    newAllocator_.setGuardPlacement(placement);
+    newArrayAllocator_.setGuardPlacement(placement);
+}
+
+bool GuardPageAllocatorPlugin::isGuarding(const SimpleString& group) const
+{
+    for (const TestFilter* filter = groupFilters_; filter; filter = filter->getNext())
+        if (filter->match(group)) return true;
+    return false;
+}
+
+void GuardPageAllocatorPlugin::setGuardPageAllocators()
+{
+    originalMallocAllocator_ = getCurrentMallocAllocator();
+    setCurrentMallocAllocator(&mallocAllocator_);
+
+    originalNewAllocator_ = getCurrentNewAllocator();
+    setCurrentNewAllocator(&newAllocator_);
+
+    originalNewArrayAllocator_ = getCurrentNewArrayAllocator();
+    setCurrentNewArrayAllocator(&newArrayAllocator_);
+}
+
+void GuardPageAllocatorPlugin::removeGuardPageAllocators()
+{
+    if (getCurrentMallocAllocator() == &mallocAllocator_)
+        setCurrentMallocAllocator(originalMallocAllocator_);
+
+    if (getCurrentNewAllocator() == &newAllocator_)
+        setCurrentNewAllocator(originalNewAllocator_);
+
+    if (getCurrentNewArrayAllocator() == &newArrayAllocator_)
+        setCurrentNewArrayAllocator(originalNewArrayAllocator_);
+}
+
+void GuardPageAllocatorPlugin::preTestAction(UtestShell& test, TestResult&)
+{
+    if (isGuarding(test.getGroup()))
+        setGuardPageAllocators();
+}
+
+void GuardPageAllocatorPlugin::postTestAction(UtestShell&, TestResult&)
+{
+    removeGuardPageAllocators();
+}
+
+bool GuardPageAllocatorPlugin::parseArguments(int /* ac */, const char** av, int index)
+{
+    SimpleString argument (av[index]);
+    if (argument == "-pguardpages") {
+        guardTestGroups("");
+        return true;
+    }
+    if (argument.startsWith("-pguardpages=")) {
+        argument.replace("-pguardpages=", "");
+        guardTestGroups(argument);
+        return true;
+    }
+    if (argument.startsWith("-pguardsample=")) {
+        argument.replace("-pguardsample=", "");
+        setSamplingInterval((unsigned) SimpleString::AtoI(argument.asCharString()));
+        return true;
+    }
+    if (argument == "-pguardunderrun") {
+        setGuardPlacement(GuardPageMemoryAllocator::guard_before_memory);
+        return true;
+    }
+    return false;
+}
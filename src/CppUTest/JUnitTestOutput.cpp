@@ -34,12 +34,14 @@
 struct JUnitTestCaseResultNode
 {
     JUnitTestCaseResultNode() :
-        execTime_(0), failure_(0), ignored_(false), next_(0)
+        execTime_(0), peakMemory_(0), peakBlocks_(0), failure_(0), ignored_(false), next_(0)
     {
     }
 
     SimpleString name_;
     long execTime_;
+    size_t peakMemory_;
+    size_t peakBlocks_;
     TestFailure* failure_;
     bool ignored_;
     JUnitTestCaseResultNode* next_;
@@ -108,6 +110,8 @@ void JUnitTestOutput::printCurrentTestEnded(const TestResult& result)
 {
     impl_->results_.tail_->execTime_
             = result.getCurrentTestTotalExecutionTime();
+    impl_->results_.tail_->peakMemory_ = result.getCurrentTestPeakMemory();
+    impl_->results_.tail_->peakBlocks_ = result.getCurrentTestPeakBlocks();
 }
 
 void JUnitTestOutput::printTestsEnded(const TestResult& /*result*/)
@@ -182,6 +186,12 @@ void JUnitTestOutput::writeProperties()
     writeToFile("</properties>\n");
 }
 
+static const char* peakMemoryPropertiesFormat =
+        "<properties>\n"
+        "<property name=\"peak_memory_bytes\" value=\"%lu\"/>\n"
+        "<property name=\"peak_memory_blocks\" value=\"%lu\"/>\n"
+        "</properties>\n";
+
 void JUnitTestOutput::writeTestCases()
 {
     JUnitTestCaseResultNode* cur = impl_->results_.head_;
@@ -193,6 +203,8 @@ void JUnitTestOutput::writeTestCases()
                 impl_->results_.group_.asCharString(),
                 cur->name_.asCharString(), (int) (cur->execTime_ / 1000), (int)(cur->execTime_ % 1000));
         writeToFile(buf.asCharString());
+        if (cur->peakMemory_ > 0)
+            writeToFile(StringFromFormat(peakMemoryPropertiesFormat, (unsigned long) cur->peakMemory_, (unsigned long) cur->peakBlocks_));
 
         if (cur->failure_) {
             writeFailure(cur);
@@ -281,3 +293,244 @@ void JUnitTestOutput::closeFile()
 {
     PlatformSpecificFClose(impl_->file_);
 }
+
+////////////////////////////////////////////////////////////////////
+
+class JUnitXmlBuffer
+{
+public:
+    JUnitXmlBuffer() : buffer_(0), size_(0), used_(0)
+    {
+    }
+
+    ~JUnitXmlBuffer()
+    {
+        PlatformSpecificFree(buffer_);
+    }
+
+    void clear()
+    {
+        used_ = 0;
+        if (buffer_) buffer_[0] = '\0';
+    }
+
+    bool isEmpty() const
+    {
+        return used_ == 0;
+    }
+
+    const char* asCharString()
+    {
+        return (reserve(0)) ? buffer_ : "";
+    }
+
+    void add(const char* str)
+    {
+        size_t length = SimpleString::StrLen(str);
+        if (!reserve(length)) return;
+        PlatformSpecificMemCpy(buffer_ + used_, str, length + 1);
+        used_ += length;
+    }
+
+    void addXmlAttributeText(const char* str)
+    {
+        for (; *str; str++) {
+            switch (*str) {
+            case '"': addCharacter('\''); break;
+            case '<': addCharacter('['); break;
+            case '>': addCharacter(']'); break;
+            case '&': add("&amp;"); break;
+            case '\n': add("{newline}"); break;
+            default: addCharacter(*str); break;
+            }
+        }
+    }
+
+    void addFormat(const char* format, ...) __check_format__(printf, 2, 3)
+    {
+        va_list arguments;
+        if (!reserve(FORMAT_GUESS)) return;
+        va_start(arguments, format);
+        int count = PlatformSpecificVSNprintf(buffer_ + used_, size_ - used_, format, arguments);
+        va_end(arguments);
+        if (count < 0) {
+            buffer_[used_] = '\0';
+            return;
+        }
+
+        if ((size_t) count >= size_ - used_) {
+            if (!reserve((size_t) count)) {
+                buffer_[used_] = '\0';
+                return;
+            }
+            va_start(arguments, format);
+            PlatformSpecificVSNprintf(buffer_ + used_, size_ - used_, format, arguments);
+            va_end(arguments);
+        }
+        used_ += (size_t) count;
+    }
+
+private:
+    enum
+    {
+        FORMAT_GUESS = 256
+    };
+
+    void addCharacter(char ch)
+    {
+        if (!reserve(1)) return;
+        buffer_[used_++] = ch;
+        buffer_[used_] = '\0';
+    }
+
+    /* When the buffer cannot grow, it keeps what it has and the text that does not fit is left out */
+    bool reserve(size_t additional)
+    {
+        size_t needed = used_ + additional + 1;
+        if (needed <= size_) return true;
+
+        size_t newSize = (size_ == 0) ? 1024 : size_;
+        while (newSize < needed) newSize *= 2;
+        char* newBuffer = (char*) PlatformSpecificRealloc(buffer_, newSize);
+        if (newBuffer == NULL) return false;
+        buffer_ = newBuffer;
+        buffer_[used_] = '\0';
+        size_ = newSize;
+        return true;
+    }
+
+    char* buffer_;
+    size_t size_;
+    size_t used_;
+
+    JUnitXmlBuffer(const JUnitXmlBuffer&);
+    JUnitXmlBuffer& operator=(const JUnitXmlBuffer&);
+};
+
+struct JUnitSingleFileTestOutputImpl
+{
+    JUnitSingleFileTestOutputImpl() :
+        file_(0), testCount_(0), failureCount_(0), currentTest_(0)
+    {
+    }
+
+    PlatformSpecificFile file_;
+    int testCount_;
+    int failureCount_;
+    SimpleString group_;
+    const UtestShell* currentTest_;
+    JUnitXmlBuffer failure_;
+    JUnitXmlBuffer testCases_;
+    JUnitXmlBuffer testSuite_;
+};
+
+JUnitSingleFileTestOutput::JUnitSingleFileTestOutput() :
+    singleFileImpl_(new JUnitSingleFileTestOutputImpl)
+{
+}
+
+JUnitSingleFileTestOutput::~JUnitSingleFileTestOutput()
+{
+    if (singleFileImpl_->file_) PlatformSpecificFClose(singleFileImpl_->file_);
+    delete singleFileImpl_;
+}
+
+SimpleString JUnitSingleFileTestOutput::createSingleFileName()
+{
+    return "cpputest.xml";
+}
+
+void JUnitSingleFileTestOutput::printTestsStarted()
+{
+    singleFileImpl_->file_ = PlatformSpecificFOpen(createSingleFileName().asCharString(), "w");
+    if (singleFileImpl_->file_ == 0) return;
+    PlatformSpecificFPuts("<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n", singleFileImpl_->file_);
+    PlatformSpecificFPuts("<testsuites>\n", singleFileImpl_->file_);
+}
+
+void JUnitSingleFileTestOutput::printTestsEnded(const TestResult& /*result*/)
+{
+    if (singleFileImpl_->file_ == 0) return;
+    PlatformSpecificFPuts("</testsuites>\n", singleFileImpl_->file_);
+    PlatformSpecificFClose(singleFileImpl_->file_);
+    singleFileImpl_->file_ = 0;
+}
+
+void JUnitSingleFileTestOutput::printCurrentGroupStarted(const UtestShell& test)
+{
+    singleFileImpl_->testCount_ = 0;
+    singleFileImpl_->failureCount_ = 0;
+    singleFileImpl_->group_ = test.getGroup();
+    singleFileImpl_->testCases_.clear();
+}
+
+void JUnitSingleFileTestOutput::printCurrentTestStarted(const UtestShell& test)
+{
+    singleFileImpl_->testCount_++;
+    singleFileImpl_->currentTest_ = &test;
+    singleFileImpl_->failure_.clear();
+}
+
+void JUnitSingleFileTestOutput::print(const TestFailure& failure)
+{
+    if (!singleFileImpl_->failure_.isEmpty()) return;
+
+    singleFileImpl_->failureCount_++;
+    singleFileImpl_->failure_.addFormat("<failure message=\"%s:%d: ", failure.getFileName().asCharString(), failure.getFailureLineNumber());
+    singleFileImpl_->failure_.addXmlAttributeText(failure.getMessage().asCharString());
+    singleFileImpl_->failure_.add("\" type=\"AssertionFailedError\">\n</failure>\n");
+}
+
+void JUnitSingleFileTestOutput::printCurrentTestEnded(const TestResult& result)
+{
+    long execTime = result.getCurrentTestTotalExecutionTime();
+    JUnitXmlBuffer& testCases = singleFileImpl_->testCases_;
+
+    testCases.addFormat("<testcase classname=\"%s%s%s\" name=\"%s\" time=\"%d.%03d\">\n",
+            impl_->package_.asCharString(),
+            impl_->package_.isEmpty() ? "" : ".",
+            singleFileImpl_->group_.asCharString(),
+            singleFileImpl_->currentTest_->getNameAsCharString(),
+            (int) (execTime / 1000), (int) (execTime % 1000));
+    if (result.getCurrentTestPeakMemory() > 0)
+        testCases.addFormat(peakMemoryPropertiesFormat, (unsigned long) result.getCurrentTestPeakMemory(), (unsigned long) result.getCurrentTestPeakBlocks());
+
+    if (!singleFileImpl_->failure_.isEmpty())
+        testCases.add(singleFileImpl_->failure_.asCharString());
+    else if (!singleFileImpl_->currentTest_->willRun())
+        testCases.add("<skipped />\n");
+    testCases.add("</testcase>\n");
+}
+
+void JUnitSingleFileTestOutput::printCurrentGroupEnded(const TestResult& result)
+{
+    if (singleFileImpl_->testCount_ == 0 || singleFileImpl_->file_ == 0) return;
+
+    long groupExecTime = result.getCurrentGroupTotalExecutionTime();
+    JUnitXmlBuffer& testSuite = singleFileImpl_->testSuite_;
+
+    testSuite.clear();
+    testSuite.addFormat("<testsuite errors=\"0\" failures=\"%d\" hostname=\"localhost\" name=\"%s\" tests=\"%d\" time=\"%d.%03d\" timestamp=\"%s\">\n",
+            singleFileImpl_->failureCount_,
+            singleFileImpl_->group_.asCharString(),
+            singleFileImpl_->testCount_,
+            (int) (groupExecTime / 1000), (int) (groupExecTime % 1000),
+            GetPlatformSpecificTimeString());
+    testSuite.add("<properties>\n</properties>\n");
+
+    PlatformSpecificFPuts(testSuite.asCharString(), singleFileImpl_->file_);
+    PlatformSpecificFPuts(singleFileImpl_->testCases_.asCharString(), singleFileImpl_->file_);
+    PlatformSpecificFPuts("<system-out></system-out>\n<system-err></system-err>\n</testsuite>\n", singleFileImpl_->file_);
+}
+
+// LCOV_EXCL_START
+
+void JUnitSingleFileTestOutput::print(const char*)
+{
+}
+
+void JUnitSingleFileTestOutput::print(long)
+{
+}
+
+// LCOV_EXCL_STOP
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2007, Michael Feathers, James Grenning and Bas Vodde
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE EARLIER MENTIONED AUTHORS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <copyright holder> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/JsonTestOutput.h"
+#include "CppUTest/TestResult.h"
+#include "CppUTest/TestFailure.h"
+#include "CppUTest/MemoryLeakWarningPlugin.h"
+#include "CppUTest/MemoryLeakDetector.h"
+
+JsonTestOutput::JsonTestOutput() :
+    currentTestFailed_(false), currentTestIgnored_(false), checkCountAtTestStart_(0), allocationNumberAtTestStart_(0)
+{
+}
+
+JsonTestOutput::~JsonTestOutput()
+{
+}
+
+void JsonTestOutput::printTestsStarted()
+{
+    checkCountAtTestStart_ = 0;
+    printBuffer("{\"event\":\"tests_started\"}\n");
+}
+
+void JsonTestOutput::printTestsEnded(const TestResult& result)
+{
+    printBuffer("{\"event\":\"tests_ended\",\"tests\":");
+    printJsonNumber(result.getTestCount());
+    printBuffer(",\"ran\":");
+    printJsonNumber(result.getRunCount());
+    printBuffer(",\"checks\":");
+    printJsonNumber(result.getCheckCount());
+    printBuffer(",\"ignored\":");
+    printJsonNumber(result.getIgnoredCount());
+    printBuffer(",\"filtered_out\":");
+    printJsonNumber(result.getFilteredOutCount());
+    printBuffer(",\"failures\":");
+    printJsonNumber(result.getFailureCount());
+    printBuffer(",\"duration_ns\":");
+    printJsonDurationInNanos(result.getTotalExecutionTime());
+    printBuffer("}\n");
+    flush();
+}
+
+void JsonTestOutput::printCurrentGroupStarted(const UtestShell& test)
+{
+    group_ = test.getGroup();
+    printBuffer("{\"event\":\"group_start\",\"group\":");
+    printJsonString(group_.asCharString());
+    printBuffer("}\n");
+}
+
+void JsonTestOutput::printCurrentGroupEnded(const TestResult& res)
+{
+    printBuffer("{\"event\":\"group_end\",\"group\":");
+    printJsonString(group_.asCharString());
+    printBuffer(",\"duration_ns\":");
+    printJsonDurationInNanos(res.getCurrentGroupTotalExecutionTime());
+    printBuffer("}\n");
+}
+
+void JsonTestOutput::printCurrentTestStarted(const UtestShell& test)
+{
+    group_ = test.getGroup();
+    name_ = test.getName();
+    currentTestFailed_ = false;
+    currentTestIgnored_ = !test.willRun();
+
+    printBuffer("{\"event\":\"test_start\",");
+    printJsonTestNames();
+    printBuffer(",\"file\":");
+    printJsonString(test.getFile().asCharString());
+    printBuffer(",\"line\":");
+    printJsonNumber((long) test.getLineNumber());
+    printBuffer("}\n");
+
+    allocationNumberAtTestStart_ = MemoryLeakWarningPlugin::getGlobalDetector()->getCurrentAllocationNumber();
+}
+
+void JsonTestOutput::printCurrentTestEnded(const TestResult& res)
+{
+    unsigned allocations = MemoryLeakWarningPlugin::getGlobalDetector()->getCurrentAllocationNumber() - allocationNumberAtTestStart_;
+    const char* outcome = currentTestFailed_ ? "failed" : (currentTestIgnored_ ? "ignored" : "passed");
+
+    printBuffer("{\"event\":\"test_end\",");
+    printJsonTestNames();
+    printBuffer(",\"result\":\"");
+    printBuffer(outcome);
+    printBuffer("\",\"duration_ns\":");
+    printJsonDurationInNanos(res.getCurrentTestTotalExecutionTime());
+    printBuffer(",\"checks\":");
+    printJsonNumber((long) (res.getCheckCount() - checkCountAtTestStart_));
+    printBuffer(",\"allocations\":");
+    printJsonNumber((long) allocations);
+    printBuffer(",\"peak_memory_bytes\":");
+    printJsonNumber((long) res.getCurrentTestPeakMemory());
+    printBuffer(",\"peak_memory_blocks\":");
+    printJsonNumber((long) res.getCurrentTestPeakBlocks());
+    printBuffer("}\n");
+
+    checkCountAtTestStart_ = res.getCheckCount();
+}
+
+void JsonTestOutput::print(const TestFailure& failure)
+{
+    currentTestFailed_ = true;
+
+    printBuffer("{\"event\":\"test_failure\",");
+    printJsonTestNames();
+    printBuffer(",\"file\":");
+    printJsonString(failure.getFileName().asCharString());
+    printBuffer(",\"line\":");
+    printJsonNumber((long) failure.getFailureLineNumber());
+    printBuffer(",\"message\":");
+    printJsonString(failure.getMessage().asCharString());
+    printBuffer("}\n");
+}
+
+void JsonTestOutput::printTestRun(int number, int total)
+{
+    printBuffer("{\"event\":\"run_start\",\"run\":");
+    printJsonNumber((long) number);
+    printBuffer(",\"of\":");
+    printJsonNumber((long) total);
+    printBuffer("}\n");
+}
+
+/* Text that is printed outside of the events, such as UT_PRINT, is a record of its own */
+void JsonTestOutput::print(const char* str)
+{
+    printBuffer("{\"event\":\"print\",\"text\":");
+    printJsonString(str);
+    printBuffer("}\n");
+}
+
+void JsonTestOutput::printJsonNumber(long number)
+{
+    printBuffer(StringFrom(number).asCharString());
+}
+
+void JsonTestOutput::printJsonTestNames()
+{
+    printBuffer("\"group\":");
+    printJsonString(group_.asCharString());
+    printBuffer(",\"name\":");
+    printJsonString(name_.asCharString());
+}
+
+/*
+ * The platform timer has millisecond resolution. The zeros are printed
+ * rather than multiplied in so a 32 bit long does not overflow.
+ */
+void JsonTestOutput::printJsonDurationInNanos(long milliseconds)
+{
+    printJsonNumber(milliseconds);
+    if (milliseconds != 0)
+        printBuffer("000000");
+}
+
+void JsonTestOutput::printJsonString(const char* str)
+{
+    static const char hexDigits[] = "0123456789abcdef";
+    char escaped[128];
+    size_t used = 0;
+
+    escaped[used++] = '"';
+    for (; *str; str++) {
+        if (used > sizeof(escaped) - 8) {
+            escaped[used] = '\0';
+            printBuffer(escaped);
+            used = 0;
+        }
+
+        unsigned char ch = (unsigned char) *str;
+        switch (ch) {
+        case '"': escaped[used++] = '\\'; escaped[used++] = '"'; break;
+        case '\\': escaped[used++] = '\\'; escaped[used++] = '\\'; break;
+        case '\n': escaped[used++] = '\\'; escaped[used++] = 'n'; break;
+        case '\r': escaped[used++] = '\\'; escaped[used++] = 'r'; break;
+        case '\t': escaped[used++] = '\\'; escaped[used++] = 't'; break;
+        default:
+            if (ch < 0x20) {
+                escaped[used++] = '\\';
+                escaped[used++] = 'u';
+                escaped[used++] = '0';
+                escaped[used++] = '0';
+                escaped[used++] = hexDigits[ch >> 4];
+                escaped[used++] = hexDigits[ch & 0xf];
+            }
+            else
+                escaped[used++] = (char) ch;
+            break;
+        }
+    }
+    escaped[used++] = '"';
+    escaped[used] = '\0';
+    printBuffer(escaped);
+}
@@ -29,8 +29,10 @@
 #include "CppUTest/TestMemoryAllocator.h"
 #include "CppUTest/PlatformSpecificFunctions.h"
 #include "CppUTest/SimpleMutex.h"
+#include "CppUTest/AllocationProfile.h"
 
 #define UNKNOWN ((char*)("<unknown>"))
+#define UNKNOWN_SIZE ((size_t) -1)
 
 SimpleStringBuffer::SimpleStringBuffer() :
     positions_filled_(0), write_limit_(SIMPLE_STRING_BUFFER_LEN-1)
@@ -225,11 +227,40 @@ void MemoryLeakOutputStringBuffer::reportAllocationDeallocationMismatchFailure(M
     reportFailure("Allocation/deallocation type mismatch\n", node->file_, node->line_, node->size_, node->allocator_, freeFile, freeLineNumber, freeAllocator, reporter);
 }
 
+void MemoryLeakOutputStringBuffer::reportDeallocationSizeMismatchFailure(MemoryLeakDetectorNode* node, size_t freeSize, const char* freeFile, int freeLineNumber, TestMemoryAllocator* freeAllocator, MemoryLeakFailure* reporter)
+{
+    outputBuffer_.add("Deallocation size mismatch: deallocated as %lu bytes\n", (unsigned long) freeSize);
+    addAllocationLocation(node->file_, node->line_, node->size_, node->allocator_);
+    addDeallocationLocation(freeFile, freeLineNumber, freeAllocator);
+    reporter->fail(toString());
+}
+
+void MemoryLeakOutputStringBuffer::reportDeallocationAlignmentMismatchFailure(MemoryLeakDetectorNode* node, size_t freeAlignment, const char* freeFile, int freeLineNumber, TestMemoryAllocator* freeAllocator, MemoryLeakFailure* reporter)
+{
+    outputBuffer_.add("Deallocation alignment mismatch: allocated with alignment %lu, deallocated with alignment %lu\n", (unsigned long) node->alignment_, (unsigned long) freeAlignment);
+    addAllocationLocation(node->file_, node->line_, node->size_, node->allocator_);
+    addDeallocationLocation(freeFile, freeLineNumber, freeAllocator);
+    reporter->fail(toString());
+}
+
 void MemoryLeakOutputStringBuffer::reportMemoryCorruptionFailure(MemoryLeakDetectorNode* node, const char* freeFile, int freeLineNumber, TestMemoryAllocator* freeAllocator, MemoryLeakFailure* reporter)
 {
         reportFailure("Memory corruption (written out of bounds?)\n", node->file_, node->line_, node->size_, node->allocator_, freeFile, freeLineNumber, freeAllocator, reporter);
 }
 
+void MemoryLeakOutputStringBuffer::reportCorruptedMemory(MemoryLeakDetectorNode* node)
+{
+    outputBuffer_.add("Memory corruption (written out of bounds?) found at the end of the test\n");
+    addAllocationLocation(node->file_, node->line_, node->size_, node->allocator_);
+}
+
+void MemoryLeakOutputStringBuffer::reportWriteToFreedMemory(MemoryLeakDetectorNode* node)
+{
+    outputBuffer_.add("Write to freed memory (used after free?)\n");
+    addAllocationLocation(node->file_, node->line_, node->size_, node->allocator_);
+    addDeallocationLocation(node->freeFile_, node->freeLine_, node->freeAllocator_);
+}
+
 void MemoryLeakOutputStringBuffer::reportFailure(const char* message, const char* allocFile, int allocLine, size_t allocSize, TestMemoryAllocator* allocAllocator, const char* freeFile, int freeLine,
         TestMemoryAllocator* freeAllocator, MemoryLeakFailure* reporter)
 {
@@ -358,25 +389,78 @@ int MemoryLeakDetectorList::getTotalLeaks(MemLeakPeriod period)
 
 /////////////////////////////////////////////////////////////
 
+MemoryLeakDetectorTable::MemoryLeakDetectorTable()
+{
+    for (int i = 0; i < amount_of_periods; i++) {
+        periodLists_[i] = 0;
+        periodCounts_[i] = 0;
+    }
+}
+
 unsigned long MemoryLeakDetectorTable::hash(char* memory)
 {
     return (unsigned long)((size_t)memory % hash_prime);
 }
 
+void MemoryLeakDetectorTable::addToPeriodList(MemoryLeakDetectorNode* node)
+{
+    node->previousInPeriod_ = 0;
+    node->nextInPeriod_ = periodLists_[node->period_];
+    if (node->nextInPeriod_) node->nextInPeriod_->previousInPeriod_ = node;
+    periodLists_[node->period_] = node;
+    periodCounts_[node->period_]++;
+}
+
+void MemoryLeakDetectorTable::removeFromPeriodList(MemoryLeakDetectorNode* node)
+{
+    if (node->previousInPeriod_) node->previousInPeriod_->nextInPeriod_ = node->nextInPeriod_;
+    else periodLists_[node->period_] = node->nextInPeriod_;
+    if (node->nextInPeriod_) node->nextInPeriod_->previousInPeriod_ = node->previousInPeriod_;
+    periodCounts_[node->period_]--;
+}
+
+bool MemoryLeakDetectorTable::periodListIsInPeriod(int periodList, MemLeakPeriod period)
+{
+    if (period == mem_leak_period_all) return true;
+    if (period == mem_leak_period_enabled) return periodList != mem_leak_period_disabled;
+    return periodList == period;
+}
+
 void MemoryLeakDetectorTable::clearAllAccounting(MemLeakPeriod period)
 {
-    for (int i = 0; i < hash_prime; i++)
-        table_[i].clearAllAccounting(period);
+    for (int periodList = mem_leak_period_disabled; periodList < amount_of_periods; periodList++) {
+        if (!periodListIsInPeriod(periodList, period)) continue;
+
+        for (MemoryLeakDetectorNode* node = periodLists_[periodList]; node; node = node->nextInPeriod_)
+            table_[hash(node->memory_)].removeNode(node->memory_);
+        periodLists_[periodList] = 0;
+        periodCounts_[periodList] = 0;
+    }
+}
+
+void MemoryLeakDetectorTable::moveLeaksToPeriod(MemLeakPeriod fromPeriod, MemLeakPeriod toPeriod)
+{
+    MemoryLeakDetectorNode* node = periodLists_[fromPeriod];
+    while (node) {
+        MemoryLeakDetectorNode* next = node->nextInPeriod_;
+        removeFromPeriodList(node);
+        node->period_ = toPeriod;
+        addToPeriodList(node);
+        node = next;
+    }
 }
 
 void MemoryLeakDetectorTable::addNewNode(MemoryLeakDetectorNode* node)
 {
     table_[hash(node->memory_)].addNewNode(node);
+    addToPeriodList(node);
 }
 
 MemoryLeakDetectorNode* MemoryLeakDetectorTable::removeNode(char* memory)
 {
-    return table_[hash(memory)].removeNode(memory);
+    MemoryLeakDetectorNode* node = table_[hash(memory)].removeNode(memory);
+    if (node) removeFromPeriodList(node);
+    return node;
 }
 
 MemoryLeakDetectorNode* MemoryLeakDetectorTable::retrieveNode(char* memory)
@@ -387,31 +471,27 @@ MemoryLeakDetectorNode* MemoryLeakDetectorTable::retrieveNode(char* memory)
 int MemoryLeakDetectorTable::getTotalLeaks(MemLeakPeriod period)
 {
     int total_leaks = 0;
-    for (int i = 0; i < hash_prime; i++)
-        total_leaks += table_[i].getTotalLeaks(period);
+    for (int periodList = mem_leak_period_disabled; periodList < amount_of_periods; periodList++)
+        if (periodListIsInPeriod(periodList, period)) total_leaks += periodCounts_[periodList];
     return total_leaks;
 }
 
-MemoryLeakDetectorNode* MemoryLeakDetectorTable::getFirstLeak(MemLeakPeriod period)
+MemoryLeakDetectorNode* MemoryLeakDetectorTable::getFirstLeakInPeriodListsFrom(int periodList, MemLeakPeriod period)
 {
-    for (int i = 0; i < hash_prime; i++) {
-        MemoryLeakDetectorNode* node = table_[i].getFirstLeak(period);
-        if (node) return node;
-    }
+    for (; periodList < amount_of_periods; periodList++)
+        if (periodListIsInPeriod(periodList, period) && periodLists_[periodList]) return periodLists_[periodList];
     return 0;
 }
 
-MemoryLeakDetectorNode* MemoryLeakDetectorTable::getNextLeak(MemoryLeakDetectorNode* leak, MemLeakPeriod period)
+MemoryLeakDetectorNode* MemoryLeakDetectorTable::getFirstLeak(MemLeakPeriod period)
 {
-    unsigned long i = hash(leak->memory_);
-    MemoryLeakDetectorNode* node = table_[i].getNextLeak(leak, period);
-    if (node) return node;
+    return getFirstLeakInPeriodListsFrom(mem_leak_period_disabled, period);
+}
 
-    for (++i; i < hash_prime; i++) {
-        node = table_[i].getFirstLeak(period);
-        if (node) return node;
-    }
-    return 0;
+MemoryLeakDetectorNode* MemoryLeakDetectorTable::getNextLeak(MemoryLeakDetectorNode* leak, MemLeakPeriod period)
+{
+    if (leak->nextInPeriod_) return leak->nextInPeriod_;
+    return getFirstLeakInPeriodListsFrom(leak->period_ + 1, period);
 }
 
 /////////////////////////////////////////////////////////////
@@ -423,10 +503,26 @@ MemoryLeakDetector::MemoryLeakDetector(MemoryLeakFailure* reporter)
     current_period_ = mem_leak_period_disabled;
     reporter_ = reporter;
     mutex_ = new SimpleMutex;
+    headRedzoneSize_ = 0;
+    tailRedzoneSize_ = memory_corruption_buffer_size;
+    redzonePattern_ = default_redzone_pattern;
+    freedMemoryPattern_ = default_freed_memory_pattern;
+    quarantineMaximumSize_ = 0;
+    quarantineSize_ = 0;
+    allocationProfile_ = NULL;
+    currentMemoryInUse_ = 0;
+    currentBlocksInUse_ = 0;
+    peakMemoryInUse_ = 0;
+    peakBlocksInUse_ = 0;
+    quarantineHead_ = NULL;
+    quarantineTail_ = NULL;
 }
 
 MemoryLeakDetector::~MemoryLeakDetector()
 {
+    while (quarantineHead_)
+        releaseFromQuarantine(removeOldestFromQuarantine());
+
     if (mutex_)
     {
         delete mutex_;
@@ -442,6 +538,10 @@ void MemoryLeakDetector::startChecking()
 {
     outputBuffer_.clear();
     current_period_ = mem_leak_period_checking;
+    currentMemoryInUse_ = 0;
+    currentBlocksInUse_ = 0;
+    peakMemoryInUse_ = 0;
+    peakBlocksInUse_ = 0;
 }
 
 void MemoryLeakDetector::stopChecking()
@@ -449,6 +549,12 @@ void MemoryLeakDetector::stopChecking()
     current_period_ = mem_leak_period_enabled;
 }
 
+void MemoryLeakDetector::startCheckingTestGroup()
+{
+    outputBuffer_.clear();
+    current_period_ = mem_leak_period_test_group;
+}
+
 void MemoryLeakDetector::enable()
 {
     current_period_ = mem_leak_period_enabled;
@@ -469,6 +575,24 @@ void MemoryLeakDetector::enableAllocationTypeChecking()
     doAllocationTypeChecking_ = true;
 }
 
+static size_t calculateMaximumAlignedSize(size_t size)
+{
+    const size_t alignment = 2 * sizeof(void*);
+    return ((size + alignment - 1) / alignment) * alignment;
+}
+
+void MemoryLeakDetector::setRedzoneSizes(size_t headRedzoneSize, size_t tailRedzoneSize)
+{
+    headRedzoneSize_ = calculateMaximumAlignedSize(headRedzoneSize);
+    tailRedzoneSize_ = tailRedzoneSize;
+}
+
+void MemoryLeakDetector::setPoisonPatterns(unsigned char redzonePattern, unsigned char freedMemoryPattern)
+{
+    redzonePattern_ = redzonePattern;
+    freedMemoryPattern_ = freedMemoryPattern;
+}
+
 unsigned MemoryLeakDetector::getCurrentAllocationNumber()
 {
     return allocationSequenceNumber_;
@@ -484,50 +608,150 @@ static size_t calculateVoidPointerAlignedSize(size_t size)
     return (sizeof(void*) - (size % sizeof(void*))) + size;
 }
 
-size_t MemoryLeakDetector::sizeOfMemoryWithCorruptionInfo(size_t size)
+/* An allocator that traps accesses outside a block gets its memory without redzones and with
+ * the node allocated separately, so that nothing sits between the memory and its guard. */
+static bool isNodeAllocatedSeperately(TestMemoryAllocator* allocator, bool allocatNodesSeperately)
+{
+    return allocatNodesSeperately || allocator->trapsAccessOutsideMemory();
+}
+
+size_t MemoryLeakDetector::headRedzoneSizeFor(TestMemoryAllocator* allocator)
 {
-    return calculateVoidPointerAlignedSize(size + memory_corruption_buffer_size);
+    return allocator->trapsAccessOutsideMemory() ? 0 : headRedzoneSize_;
 }
 
-MemoryLeakDetectorNode* MemoryLeakDetector::getNodeFromMemoryPointer(char* memory, size_t memory_size)
+size_t MemoryLeakDetector::sizeOfMemoryWithCorruptionInfo(TestMemoryAllocator* allocator, size_t size)
 {
-    return (MemoryLeakDetectorNode*) (void*) (memory + sizeOfMemoryWithCorruptionInfo(memory_size));
+    if (allocator->trapsAccessOutsideMemory()) return size;
+    return calculateVoidPointerAlignedSize(size + tailRedzoneSize_);
 }
 
-void MemoryLeakDetector::storeLeakInformation(MemoryLeakDetectorNode * node, char *new_memory, size_t size, TestMemoryAllocator *allocator, const char *file, int line)
+MemoryLeakDetectorNode* MemoryLeakDetector::getNodeFromMemoryPointer(TestMemoryAllocator* allocator, char* memory, size_t memory_size, size_t headRedzoneSize)
 {
-    node->init(new_memory, allocationSequenceNumber_++, size, allocator, current_period_, file, line);
-    addMemoryCorruptionInformation(node->memory_ + node->size_);
+    return (MemoryLeakDetectorNode*) (void*) (memory + headRedzoneSize + sizeOfMemoryWithCorruptionInfo(allocator, memory_size));
+}
+
+void MemoryLeakDetector::storeLeakInformation(MemoryLeakDetectorNode * node, char *new_memory, size_t size, size_t alignment, size_t headRedzoneSize, TestMemoryAllocator *allocator, const char *file, int line, bool allocatedSeperately)
+{
+    node->init(new_memory + headRedzoneSize, allocationSequenceNumber_++, size, allocator, current_period_, file, line);
+    node->alignment_ = alignment;
+    node->headRedzoneSize_ = headRedzoneSize;
+    node->tailRedzoneSize_ = sizeOfMemoryWithCorruptionInfo(allocator, size) - size;
+    node->redzonePattern_ = redzonePattern_;
+    node->allocatedSeperately_ = allocatedSeperately;
+    addMemoryCorruptionInformation(node);
     memoryTable_.addNewNode(node);
+    countAllocation(node);
 }
 
-char* MemoryLeakDetector::reallocateMemoryAndLeakInformation(TestMemoryAllocator* allocator, char* memory, size_t size, const char* file, int line, bool allocatNodesSeperately)
+void MemoryLeakDetector::countAllocation(MemoryLeakDetectorNode* node)
 {
-    char* new_memory = reallocateMemoryWithAccountingInformation(allocator, memory, size, file, line, allocatNodesSeperately);
-    if (new_memory == NULL) return NULL;
+    if (allocationProfile_) allocationProfile_->allocated(node->file_, node->line_, node->size_);
+    if (node->period_ != mem_leak_period_checking) return;
 
-    MemoryLeakDetectorNode *node = createMemoryLeakAccountingInformation(allocator, size, new_memory, allocatNodesSeperately);
-    storeLeakInformation(node, new_memory, size, allocator, file, line);
-    return node->memory_;
+    currentMemoryInUse_ += node->size_;
+    currentBlocksInUse_++;
+    if (currentMemoryInUse_ > peakMemoryInUse_) peakMemoryInUse_ = currentMemoryInUse_;
+    if (currentBlocksInUse_ > peakBlocksInUse_) peakBlocksInUse_ = currentBlocksInUse_;
+}
+
+void MemoryLeakDetector::countDeallocation(MemoryLeakDetectorNode* node)
+{
+    if (allocationProfile_) allocationProfile_->freed(node->file_, node->line_, node->size_);
+    if (node->period_ != mem_leak_period_checking || currentBlocksInUse_ == 0) return;
+
+    currentMemoryInUse_ = (currentMemoryInUse_ > node->size_) ? currentMemoryInUse_ - node->size_ : 0;
+    currentBlocksInUse_--;
+}
+
+/*
+ * Redzones and freed memory are filled and verified a word at a time, so large
+ * redzones stay cheap on platforms where memset works byte by byte.
+ */
+typedef unsigned long PatternWord;
+
+static PatternWord patternWordFrom(unsigned char pattern)
+{
+    PatternWord word = 0;
+    for (size_t i = 0; i < sizeof(PatternWord); i++)
+        word = (word << 8) | pattern;
+    return word;
+}
+
+static bool isPatternWordAligned(const char* memory)
+{
+    return ((size_t) memory % sizeof(PatternWord)) == 0;
+}
+
+/* Words go through memcpy, so the buffers are never accessed through a PatternWord lvalue */
+static void storePatternWord(char* memory, PatternWord word)
+{
+#if CPPUTEST_HAVE_BUILTIN_MEMCPY
+    __builtin_memcpy(memory, &word, sizeof(word));
+#else
+    PlatformSpecificMemCpy(memory, &word, sizeof(word));
+#endif
+}
+
+static PatternWord loadPatternWord(const char* memory)
+{
+    PatternWord word;
+#if CPPUTEST_HAVE_BUILTIN_MEMCPY
+    __builtin_memcpy(&word, memory, sizeof(word));
+#else
+    PlatformSpecificMemCpy(&word, memory, sizeof(word));
+#endif
+    return word;
+}
+
+static void fillWithPattern(char* memory, size_t size, unsigned char pattern)
+{
+    char* end = memory + size;
+    while (memory < end && !isPatternWordAligned(memory))
+        *memory++ = (char) pattern;
+
+    PatternWord word = patternWordFrom(pattern);
+    for (; (size_t) (end - memory) >= sizeof(PatternWord); memory += sizeof(PatternWord))
+        storePatternWord(memory, word);
+
+    while (memory < end)
+        *memory++ = (char) pattern;
+}
+
+static bool isFilledWithPattern(const char* memory, size_t size, unsigned char pattern)
+{
+    const char* end = memory + size;
+    while (memory < end && !isPatternWordAligned(memory))
+        if (*memory++ != (char) pattern) return false;
+
+    PatternWord word = patternWordFrom(pattern);
+    PatternWord difference = 0;
+    for (; (size_t) (end - memory) >= sizeof(PatternWord); memory += sizeof(PatternWord))
+        difference |= loadPatternWord(memory) ^ word;
+    if (difference) return false;
+
+    while (memory < end)
+        if (*memory++ != (char) pattern) return false;
+    return true;
 }
 
 void MemoryLeakDetector::invalidateMemory(char* memory)
 {
   MemoryLeakDetectorNode* node = memoryTable_.retrieveNode(memory);
   if (node)
-    PlatformSpecificMemset(memory, 0xCD, node->size_);
+    fillWithPattern(memory, node->size_, freedMemoryPattern_);
 }
 
-void MemoryLeakDetector::addMemoryCorruptionInformation(char* memory)
+void MemoryLeakDetector::addMemoryCorruptionInformation(MemoryLeakDetectorNode* node)
 {
-    memory[0] = 'B';
-    memory[1] = 'A';
-    memory[2] = 'S';
+    fillWithPattern(node->memory_ - node->headRedzoneSize_, node->headRedzoneSize_, node->redzonePattern_);
+    fillWithPattern(node->memory_ + node->size_, node->tailRedzoneSize_, node->redzonePattern_);
 }
 
-bool MemoryLeakDetector::validMemoryCorruptionInformation(char* memory)
+bool MemoryLeakDetector::validMemoryCorruptionInformation(MemoryLeakDetectorNode* node)
 {
-    return memory[0] == 'B' && memory[1] == 'A' && memory[2] == 'S';
+    return isFilledWithPattern(node->memory_ - node->headRedzoneSize_, node->headRedzoneSize_, node->redzonePattern_)
+        && isFilledWithPattern(node->memory_ + node->size_, node->tailRedzoneSize_, node->redzonePattern_);
 }
 
 bool MemoryLeakDetector::matchingAllocation(TestMemoryAllocator *alloc_allocator, TestMemoryAllocator *free_allocator)
@@ -537,14 +761,108 @@ bool MemoryLeakDetector::matchingAllocation(TestMemoryAllocator *alloc_allocator
     return free_allocator->isOfEqualType(alloc_allocator);
 }
 
-void MemoryLeakDetector::checkForCorruption(MemoryLeakDetectorNode* node, const char* file, int line, TestMemoryAllocator* allocator, bool allocateNodesSeperately)
+bool MemoryLeakDetector::checkForCorruption(MemoryLeakDetectorNode* node, size_t size, size_t alignment, const char* file, int line, TestMemoryAllocator* allocator)
 {
     if (!matchingAllocation(node->allocator_, allocator))
         outputBuffer_.reportAllocationDeallocationMismatchFailure(node, file, line, allocator, reporter_);
-    else if (!validMemoryCorruptionInformation(node->memory_ + node->size_))
+    else if (size != UNKNOWN_SIZE && size != node->size_)
+        outputBuffer_.reportDeallocationSizeMismatchFailure(node, size, file, line, allocator, reporter_);
+    else if (alignment != node->alignment_)
+        outputBuffer_.reportDeallocationAlignmentMismatchFailure(node, alignment, file, line, allocator, reporter_);
+    else if (!validMemoryCorruptionInformation(node))
         outputBuffer_.reportMemoryCorruptionFailure(node, file, line, allocator, reporter_);
-    else if (allocateNodesSeperately)
-        allocator->freeMemoryLeakNode((char*) node);
+    else
+        return true;
+    return false;
+}
+
+void MemoryLeakDetector::setQuarantineSize(size_t maximumSize)
+{
+    quarantineMaximumSize_ = maximumSize;
+}
+
+void MemoryLeakDetector::setAllocationProfile(AllocationProfile* profile)
+{
+    allocationProfile_ = profile;
+}
+
+size_t MemoryLeakDetector::getCurrentMemoryInUse()
+{
+    return currentMemoryInUse_;
+}
+
+size_t MemoryLeakDetector::getCurrentBlocksInUse()
+{
+    return currentBlocksInUse_;
+}
+
+size_t MemoryLeakDetector::getPeakMemoryInUse()
+{
+    return peakMemoryInUse_;
+}
+
+size_t MemoryLeakDetector::getPeakBlocksInUse()
+{
+    return peakBlocksInUse_;
+}
+
+bool MemoryLeakDetector::shouldQuarantine(MemoryLeakDetectorNode* node)
+{
+    return quarantineMaximumSize_ != 0 && current_period_ == mem_leak_period_checking && node->size_ <= quarantineMaximumSize_;
+}
+
+void MemoryLeakDetector::addToQuarantine(MemoryLeakDetectorNode* node, TestMemoryAllocator* allocator, const char* file, int line)
+{
+    fillWithPattern(node->memory_, node->size_, freedMemoryPattern_);
+    node->freeFile_ = file;
+    node->freeLine_ = line;
+    node->freeAllocator_ = allocator;
+
+    node->next_ = NULL;
+    if (quarantineTail_) quarantineTail_->next_ = node;
+    else quarantineHead_ = node;
+    quarantineTail_ = node;
+    quarantineSize_ += node->size_;
+
+    while (quarantineSize_ > quarantineMaximumSize_) {
+        MemoryLeakDetectorNode* oldest = removeOldestFromQuarantine();
+        if (!releaseFromQuarantine(oldest))
+            reporter_->fail(outputBuffer_.toString());
+    }
+}
+
+MemoryLeakDetectorNode* MemoryLeakDetector::removeOldestFromQuarantine()
+{
+    MemoryLeakDetectorNode* node = quarantineHead_;
+    quarantineHead_ = node->next_;
+    if (quarantineHead_ == NULL) quarantineTail_ = NULL;
+    quarantineSize_ -= node->size_;
+    return node;
+}
+
+bool MemoryLeakDetector::releaseFromQuarantine(MemoryLeakDetectorNode* node)
+{
+    bool untouched = isFilledWithPattern(node->memory_, node->size_, freedMemoryPattern_) && validMemoryCorruptionInformation(node);
+    if (!untouched)
+        outputBuffer_.reportWriteToFreedMemory(node);
+
+    TestMemoryAllocator* allocator = node->freeAllocator_;
+    if (allocator->hasBeenDestroyed()) return untouched;
+
+    char* allocatedMemory = node->memory_ - node->headRedzoneSize_;
+    const char* freeFile = node->freeFile_;
+    int freeLine = node->freeLine_;
+    if (node->allocatedSeperately_) allocator->freeMemoryLeakNode((char*) node);
+    allocator->free_memory(allocatedMemory, freeFile, freeLine);
+    return untouched;
+}
+
+const char* MemoryLeakDetector::flushQuarantine()
+{
+    outputBuffer_.clear();
+    while (quarantineHead_)
+        releaseFromQuarantine(removeOldestFromQuarantine());
+    return outputBuffer_.toString();
 }
 
 char* MemoryLeakDetector::allocMemory(TestMemoryAllocator* allocator, size_t size, bool allocatNodesSeperately)
@@ -552,22 +870,22 @@ char* MemoryLeakDetector::allocMemory(TestMemoryAllocator* allocator, size_t siz
     return allocMemory(allocator, size, UNKNOWN, 0, allocatNodesSeperately);
 }
 
-char* MemoryLeakDetector::allocateMemoryWithAccountingInformation(TestMemoryAllocator* allocator, size_t size, const char* file, int line, bool allocatNodesSeperately)
+char* MemoryLeakDetector::allocateMemoryWithAccountingInformation(TestMemoryAllocator* allocator, size_t size, size_t headRedzoneSize, const char* file, int line, bool allocatNodesSeperately)
 {
-    if (allocatNodesSeperately) return allocator->alloc_memory(sizeOfMemoryWithCorruptionInfo(size), file, line);
-    else return allocator->alloc_memory(sizeOfMemoryWithCorruptionInfo(size) + sizeof(MemoryLeakDetectorNode), file, line);
+    if (allocatNodesSeperately) return allocator->alloc_memory(headRedzoneSize + sizeOfMemoryWithCorruptionInfo(allocator, size), file, line);
+    else return allocator->alloc_memory(headRedzoneSize + sizeOfMemoryWithCorruptionInfo(allocator, size) + sizeof(MemoryLeakDetectorNode), file, line);
 }
 
-char* MemoryLeakDetector::reallocateMemoryWithAccountingInformation(TestMemoryAllocator* /*allocator*/, char* memory, size_t size, const char* /*file*/, int /*line*/, bool allocatNodesSeperately)
+char* MemoryLeakDetector::reallocateMemoryWithAccountingInformation(TestMemoryAllocator* allocator, char* memory, size_t size, size_t headRedzoneSize, const char* file, int line, bool allocatNodesSeperately)
 {
-    if (allocatNodesSeperately) return (char*) PlatformSpecificRealloc(memory, sizeOfMemoryWithCorruptionInfo(size));
-    else return (char*) PlatformSpecificRealloc(memory, sizeOfMemoryWithCorruptionInfo(size) + sizeof(MemoryLeakDetectorNode));
+    if (allocatNodesSeperately) return allocator->realloc_memory(memory, headRedzoneSize + sizeOfMemoryWithCorruptionInfo(allocator, size), file, line);
+    else return allocator->realloc_memory(memory, headRedzoneSize + sizeOfMemoryWithCorruptionInfo(allocator, size) + sizeof(MemoryLeakDetectorNode), file, line);
 }
 
-MemoryLeakDetectorNode* MemoryLeakDetector::createMemoryLeakAccountingInformation(TestMemoryAllocator* allocator, size_t size, char* memory, bool allocatNodesSeperately)
+MemoryLeakDetectorNode* MemoryLeakDetector::createMemoryLeakAccountingInformation(TestMemoryAllocator* allocator, size_t size, char* memory, size_t headRedzoneSize, bool allocatNodesSeperately)
 {
     if (allocatNodesSeperately) return (MemoryLeakDetectorNode*) (void*) allocator->allocMemoryLeakNode(sizeof(MemoryLeakDetectorNode));
-    else return getNodeFromMemoryPointer(memory, size);
+    else return getNodeFromMemoryPointer(allocator, memory, size, headRedzoneSize);
 }
 
 char* MemoryLeakDetector::allocMemory(TestMemoryAllocator* allocator, size_t size, const char* file, int line, bool allocatNodesSeperately)
@@ -579,21 +897,75 @@ char* MemoryLeakDetector::allocMemory(TestMemoryAllocator* allocator, size_t siz
      * So, for malloc, we'll allocate the memory separately so we can detect this and give a proper error.
      */
 
-    char* memory = allocateMemoryWithAccountingInformation(allocator, size, file, line, allocatNodesSeperately);
+    bool seperateNode = isNodeAllocatedSeperately(allocator, allocatNodesSeperately);
+    size_t headRedzoneSize = headRedzoneSizeFor(allocator);
+    char* memory = allocateMemoryWithAccountingInformation(allocator, size, headRedzoneSize, file, line, seperateNode);
     if (memory == NULL) return NULL;
-    MemoryLeakDetectorNode* node = createMemoryLeakAccountingInformation(allocator, size, memory, allocatNodesSeperately);
+    MemoryLeakDetectorNode* node = createMemoryLeakAccountingInformation(allocator, size, memory, headRedzoneSize, seperateNode);
 
-    storeLeakInformation(node, memory, size, allocator, file, line);
+    storeLeakInformation(node, memory, size, 0, headRedzoneSize, allocator, file, line, seperateNode);
     return node->memory_;
 }
 
-void MemoryLeakDetector::removeMemoryLeakInformationWithoutCheckingOrDeallocatingTheMemoryButDeallocatingTheAccountInformation(TestMemoryAllocator* allocator, void* memory, bool allocatNodesSeperately)
+char* MemoryLeakDetector::allocAlignedMemory(TestMemoryAllocator* allocator, size_t size, size_t alignment)
+{
+    return allocAlignedMemory(allocator, size, alignment, UNKNOWN, 0);
+}
+
+static size_t paddingToAlignment(const char* memory, size_t alignment)
+{
+    size_t misalignment = (size_t) memory % alignment;
+    return (misalignment == 0) ? 0 : alignment - misalignment;
+}
+
+char* MemoryLeakDetector::allocAlignedMemory(TestMemoryAllocator* allocator, size_t size, size_t alignment, const char* file, int line)
+{
+    /* The allocator only guarantees the default alignment, so room for the padding is allocated
+     * too. The padding becomes part of the head redzone and is checked like the rest of it. */
+    bool seperateNode = isNodeAllocatedSeperately(allocator, false);
+    size_t headRedzoneSize = headRedzoneSizeFor(allocator);
+    char* memory = allocateMemoryWithAccountingInformation(allocator, size, headRedzoneSize + alignment, file, line, seperateNode);
+    if (memory == NULL) return NULL;
+    headRedzoneSize += paddingToAlignment(memory + headRedzoneSize, alignment);
+    MemoryLeakDetectorNode* node = createMemoryLeakAccountingInformation(allocator, size, memory, headRedzoneSize, seperateNode);
+
+    storeLeakInformation(node, memory, size, alignment, headRedzoneSize, allocator, file, line, seperateNode);
+    return node->memory_;
+}
+
+void MemoryLeakDetector::removeMemoryLeakInformationWithoutCheckingOrDeallocatingTheMemoryButDeallocatingTheAccountInformation(TestMemoryAllocator* allocator, void* memory, bool /* allocatNodesSeperately */)
 {
     MemoryLeakDetectorNode* node = memoryTable_.removeNode((char*) memory);
-    if (allocatNodesSeperately) allocator->freeMemoryLeakNode( (char*) node);
+    if (node) countDeallocation(node);
+    if (node && node->allocatedSeperately_) allocator->freeMemoryLeakNode( (char*) node);
+}
+
+void MemoryLeakDetector::deallocMemory(TestMemoryAllocator* allocator, void* memory, const char* file, int line, bool /* allocatNodesSeperately */)
+{
+    checkAndDeallocMemory(allocator, memory, UNKNOWN_SIZE, 0, file, line);
+}
+
+void MemoryLeakDetector::deallocAlignedMemory(TestMemoryAllocator* allocator, void* memory, size_t alignment)
+{
+    checkAndDeallocMemory(allocator, memory, UNKNOWN_SIZE, alignment, UNKNOWN, 0);
+}
+
+void MemoryLeakDetector::deallocAlignedMemory(TestMemoryAllocator* allocator, void* memory, size_t alignment, const char* file, int line)
+{
+    checkAndDeallocMemory(allocator, memory, UNKNOWN_SIZE, alignment, file, line);
+}
+
+void MemoryLeakDetector::deallocSizedMemory(TestMemoryAllocator* allocator, void* memory, size_t size, size_t alignment)
+{
+    checkAndDeallocMemory(allocator, memory, size, alignment, UNKNOWN, 0);
+}
+
+void MemoryLeakDetector::deallocSizedMemory(TestMemoryAllocator* allocator, void* memory, size_t size, size_t alignment, const char* file, int line)
+{
+    checkAndDeallocMemory(allocator, memory, size, alignment, file, line);
 }
 
-void MemoryLeakDetector::deallocMemory(TestMemoryAllocator* allocator, void* memory, const char* file, int line, bool allocatNodesSeperately)
+void MemoryLeakDetector::checkAndDeallocMemory(TestMemoryAllocator* allocator, void* memory, size_t size, size_t alignment, const char* file, int line)
 {
     if (memory == 0) return;
 
@@ -602,9 +974,16 @@ void MemoryLeakDetector::deallocMemory(TestMemoryAllocator* allocator, void* mem
         outputBuffer_.reportDeallocateNonAllocatedMemoryFailure(file, line, allocator, reporter_);
         return;
     }
+    countDeallocation(node);
     if (!allocator->hasBeenDestroyed()) {
-        checkForCorruption(node, file, line, allocator, allocatNodesSeperately);
-        allocator->free_memory((char*) memory, file, line);
+        char* allocatedMemory = (char*) memory - node->headRedzoneSize_;
+        bool intact = checkForCorruption(node, size, alignment, file, line, allocator);
+        if (intact && shouldQuarantine(node)) {
+            addToQuarantine(node, allocator, file, line);
+            return;
+        }
+        if (intact && node->allocatedSeperately_) allocator->freeMemoryLeakNode((char*) node);
+        allocator->free_memory(allocatedMemory, file, line);
     }
 }
 
@@ -615,15 +994,35 @@ void MemoryLeakDetector::deallocMemory(TestMemoryAllocator* allocator, void* mem
 
 char* MemoryLeakDetector::reallocMemory(TestMemoryAllocator* allocator, char* memory, size_t size, const char* file, int line, bool allocatNodesSeperately)
 {
+    bool seperateNode = isNodeAllocatedSeperately(allocator, allocatNodesSeperately);
+    size_t headRedzoneSize = headRedzoneSizeFor(allocator);
+    MemoryLeakDetectorNode* node = NULL;
+    MemoryLeakDetectorNode oldNode;
     if (memory) {
-        MemoryLeakDetectorNode* node = memoryTable_.removeNode(memory);
+        node = memoryTable_.removeNode(memory);
         if (node == NULL) {
             outputBuffer_.reportDeallocateNonAllocatedMemoryFailure(file, line, allocator, reporter_);
             return NULL;
         }
-        checkForCorruption(node, file, line, allocator, allocatNodesSeperately);
+        oldNode = *node;
+        headRedzoneSize = node->headRedzoneSize_;
+        memory -= headRedzoneSize;
+        if (!checkForCorruption(node, UNKNOWN_SIZE, 0, file, line, allocator)) node = NULL;
     }
-    return reallocateMemoryAndLeakInformation(allocator, memory, size, file, line, allocatNodesSeperately);
+
+    char* new_memory = reallocateMemoryWithAccountingInformation(allocator, memory, size, headRedzoneSize, file, line, seperateNode);
+    if (new_memory == NULL) {
+        /* The old memory is still allocated when the reallocation fails */
+        if (node) memoryTable_.addNewNode(node);
+        return NULL;
+    }
+
+    if (memory) countDeallocation(&oldNode);
+    if (node && oldNode.allocatedSeperately_) allocator->freeMemoryLeakNode((char*) node);
+
+    MemoryLeakDetectorNode* newNode = createMemoryLeakAccountingInformation(allocator, size, new_memory, headRedzoneSize, seperateNode);
+    storeLeakInformation(newNode, new_memory, size, 0, headRedzoneSize, allocator, file, line, seperateNode);
+    return newNode->memory_;
 }
 
 void MemoryLeakDetector::ConstructMemoryLeakReport(MemLeakPeriod period)
@@ -647,13 +1046,25 @@ const char* MemoryLeakDetector::report(MemLeakPeriod period)
     return outputBuffer_.toString();
 }
 
+const char* MemoryLeakDetector::reportCorruptedMemory(MemLeakPeriod period)
+{
+    outputBuffer_.clear();
+
+    for (MemoryLeakDetectorNode* node = memoryTable_.getFirstLeak(period); node; node = memoryTable_.getNextLeak(node, period))
+        if (!validMemoryCorruptionInformation(node))
+            outputBuffer_.reportCorruptedMemory(node);
+
+    return outputBuffer_.toString();
+}
+
 void MemoryLeakDetector::markCheckingPeriodLeaksAsNonCheckingPeriod()
 {
-    MemoryLeakDetectorNode* leak = memoryTable_.getFirstLeak(mem_leak_period_checking);
-    while (leak) {
-        if (leak->period_ == mem_leak_period_checking) leak->period_ = mem_leak_period_enabled;
-        leak = memoryTable_.getNextLeak(leak, mem_leak_period_checking);
-    }
+    memoryTable_.moveLeaksToPeriod(mem_leak_period_checking, mem_leak_period_enabled);
+}
+
+void MemoryLeakDetector::markTestGroupPeriodLeaksAsNonCheckingPeriod()
+{
+    memoryTable_.moveLeaksToPeriod(mem_leak_period_test_group, mem_leak_period_enabled);
 }
 
 int MemoryLeakDetector::totalMemoryLeaks(MemLeakPeriod period)
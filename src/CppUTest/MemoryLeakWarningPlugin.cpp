@@ -80,6 +80,45 @@ static void* mem_leak_realloc(void* memory, size_t size, const char* file, int l
     return MemoryLeakWarningPlugin::getGlobalDetector()->reallocMemory(getCurrentMallocAllocator(), (char*) memory, size, file, line, true);
 }
 
+/* The statistics-only overloads neither lock nor track, they only count */
+
+static volatile size_t statisticsAllocations = 0;
+static volatile size_t statisticsDeallocations = 0;
+static volatile size_t statisticsBytesAllocated = 0;
+
+static void countAllocation(void* memory, size_t size)
+{
+    if (memory == NULL) return;
+    PlatformSpecificAtomicAdd(&statisticsAllocations, 1);
+    PlatformSpecificAtomicAdd(&statisticsBytesAllocated, size);
+}
+
+static void countDeallocation(void* memory)
+{
+    if (memory) PlatformSpecificAtomicAdd(&statisticsDeallocations, 1);
+}
+
+static void* statistics_malloc(size_t size, const char*, int)
+{
+    void* memory = PlatformSpecificMalloc(size);
+    countAllocation(memory, size);
+    return memory;
+}
+
+static void statistics_free(void* buffer, const char*, int)
+{
+    countDeallocation(buffer);
+    PlatformSpecificFree(buffer);
+}
+
+static void* statistics_realloc(void* memory, size_t size, const char*, int)
+{
+    void* newMemory = PlatformSpecificRealloc(memory, size);
+    if (newMemory) countDeallocation(memory);
+    countAllocation(newMemory, size);
+    return newMemory;
+}
+
 #endif
 
 static void* normal_malloc(size_t size, const char*, int)
@@ -290,6 +329,299 @@ static void normal_operator_delete_array (void* mem) UT_NOTHROW
     PlatformSpecificFree(mem);
 }
 
+static void* statistics_operator_new (size_t size) UT_THROW(std::bad_alloc)
+{
+    void* memory = statistics_malloc(size, NULL, 0);
+    UT_THROW_BAD_ALLOC_WHEN_NULL(memory);
+    return memory;
+}
+
+static void* statistics_operator_new_nothrow (size_t size) UT_NOTHROW
+{
+    return statistics_malloc(size, NULL, 0);
+}
+
+static void* statistics_operator_new_debug (size_t size, const char* /*file*/, int /*line*/) UT_THROW(std::bad_alloc)
+{
+    return statistics_operator_new(size);
+}
+
+static void statistics_operator_delete (void* mem) UT_NOTHROW
+{
+    statistics_free(mem, NULL, 0);
+}
+
+/********** C++14 sized delete and C++17 aligned new/delete *************/
+
+#if CPPUTEST_USE_SIZED_DEALLOCATION
+
+static void threadsafe_mem_leak_operator_delete_sized (void* mem, size_t size) UT_NOTHROW
+{
+    MemLeakScopedMutex lock;
+    MemoryLeakWarningPlugin::getGlobalDetector()->invalidateMemory((char*) mem);
+    MemoryLeakWarningPlugin::getGlobalDetector()->deallocSizedMemory(getCurrentNewAllocator(), (char*) mem, size, 0);
+}
+
+static void threadsafe_mem_leak_operator_delete_array_sized (void* mem, size_t size) UT_NOTHROW
+{
+    MemLeakScopedMutex lock;
+    MemoryLeakWarningPlugin::getGlobalDetector()->invalidateMemory((char*) mem);
+    MemoryLeakWarningPlugin::getGlobalDetector()->deallocSizedMemory(getCurrentNewArrayAllocator(), (char*) mem, size, 0);
+}
+
+static void mem_leak_operator_delete_sized (void* mem, size_t size) UT_NOTHROW
+{
+    MemoryLeakWarningPlugin::getGlobalDetector()->invalidateMemory((char*) mem);
+    MemoryLeakWarningPlugin::getGlobalDetector()->deallocSizedMemory(getCurrentNewAllocator(), (char*) mem, size, 0);
+}
+
+static void mem_leak_operator_delete_array_sized (void* mem, size_t size) UT_NOTHROW
+{
+    MemoryLeakWarningPlugin::getGlobalDetector()->invalidateMemory((char*) mem);
+    MemoryLeakWarningPlugin::getGlobalDetector()->deallocSizedMemory(getCurrentNewArrayAllocator(), (char*) mem, size, 0);
+}
+
+static void normal_operator_delete_sized (void* mem, size_t /*size*/) UT_NOTHROW
+{
+    PlatformSpecificFree(mem);
+}
+
+static void statistics_operator_delete_sized (void* mem, size_t /*size*/) UT_NOTHROW
+{
+    statistics_free(mem, NULL, 0);
+}
+
+static void (*operator_delete_sized_fptr)(void* mem, size_t size) UT_NOTHROW = mem_leak_operator_delete_sized;
+static void (*operator_delete_array_sized_fptr)(void* mem, size_t size) UT_NOTHROW = mem_leak_operator_delete_array_sized;
+
+#endif
+
+#if CPPUTEST_USE_ALIGNED_NEW
+
+static void* threadsafe_mem_leak_operator_new_aligned (size_t size, size_t alignment) UT_THROW(std::bad_alloc)
+{
+    MemLeakScopedMutex lock;
+    void* memory = MemoryLeakWarningPlugin::getGlobalDetector()->allocAlignedMemory(getCurrentNewAllocator(), size, alignment);
+    UT_THROW_BAD_ALLOC_WHEN_NULL(memory);
+    return memory;
+}
+
+static void* threadsafe_mem_leak_operator_new_aligned_nothrow (size_t size, size_t alignment) UT_NOTHROW
+{
+    MemLeakScopedMutex lock;
+    return MemoryLeakWarningPlugin::getGlobalDetector()->allocAlignedMemory(getCurrentNewAllocator(), size, alignment);
+}
+
+static void* threadsafe_mem_leak_operator_new_aligned_debug (size_t size, size_t alignment, const char* file, int line) UT_THROW(std::bad_alloc)
+{
+    MemLeakScopedMutex lock;
+    void* memory = MemoryLeakWarningPlugin::getGlobalDetector()->allocAlignedMemory(getCurrentNewAllocator(), size, alignment, file, line);
+    UT_THROW_BAD_ALLOC_WHEN_NULL(memory);
+    return memory;
+}
+
+static void* threadsafe_mem_leak_operator_new_array_aligned (size_t size, size_t alignment) UT_THROW(std::bad_alloc)
+{
+    MemLeakScopedMutex lock;
+    void* memory = MemoryLeakWarningPlugin::getGlobalDetector()->allocAlignedMemory(getCurrentNewArrayAllocator(), size, alignment);
+    UT_THROW_BAD_ALLOC_WHEN_NULL(memory);
+    return memory;
+}
+
+static void* threadsafe_mem_leak_operator_new_array_aligned_nothrow (size_t size, size_t alignment) UT_NOTHROW
+{
+    MemLeakScopedMutex lock;
+    return MemoryLeakWarningPlugin::getGlobalDetector()->allocAlignedMemory(getCurrentNewArrayAllocator(), size, alignment);
+}
+
+static void* threadsafe_mem_leak_operator_new_array_aligned_debug (size_t size, size_t alignment, const char* file, int line) UT_THROW(std::bad_alloc)
+{
+    MemLeakScopedMutex lock;
+    void* memory = MemoryLeakWarningPlugin::getGlobalDetector()->allocAlignedMemory(getCurrentNewArrayAllocator(), size, alignment, file, line);
+    UT_THROW_BAD_ALLOC_WHEN_NULL(memory);
+    return memory;
+}
+
+static void threadsafe_mem_leak_operator_delete_aligned (void* mem, size_t alignment) UT_NOTHROW
+{
+    MemLeakScopedMutex lock;
+    MemoryLeakWarningPlugin::getGlobalDetector()->invalidateMemory((char*) mem);
+    MemoryLeakWarningPlugin::getGlobalDetector()->deallocAlignedMemory(getCurrentNewAllocator(), (char*) mem, alignment);
+}
+
+static void threadsafe_mem_leak_operator_delete_array_aligned (void* mem, size_t alignment) UT_NOTHROW
+{
+    MemLeakScopedMutex lock;
+    MemoryLeakWarningPlugin::getGlobalDetector()->invalidateMemory((char*) mem);
+    MemoryLeakWarningPlugin::getGlobalDetector()->deallocAlignedMemory(getCurrentNewArrayAllocator(), (char*) mem, alignment);
+}
+
+static void threadsafe_mem_leak_operator_delete_sized_aligned (void* mem, size_t size, size_t alignment) UT_NOTHROW
+{
+    MemLeakScopedMutex lock;
+    MemoryLeakWarningPlugin::getGlobalDetector()->invalidateMemory((char*) mem);
+    MemoryLeakWarningPlugin::getGlobalDetector()->deallocSizedMemory(getCurrentNewAllocator(), (char*) mem, size, alignment);
+}
+
+static void threadsafe_mem_leak_operator_delete_array_sized_aligned (void* mem, size_t size, size_t alignment) UT_NOTHROW
+{
+    MemLeakScopedMutex lock;
+    MemoryLeakWarningPlugin::getGlobalDetector()->invalidateMemory((char*) mem);
+    MemoryLeakWarningPlugin::getGlobalDetector()->deallocSizedMemory(getCurrentNewArrayAllocator(), (char*) mem, size, alignment);
+}
+
+static void* mem_leak_operator_new_aligned (size_t size, size_t alignment) UT_THROW(std::bad_alloc)
+{
+    void* memory = MemoryLeakWarningPlugin::getGlobalDetector()->allocAlignedMemory(getCurrentNewAllocator(), size, alignment);
+    UT_THROW_BAD_ALLOC_WHEN_NULL(memory);
+    return memory;
+}
+
+static void* mem_leak_operator_new_aligned_nothrow (size_t size, size_t alignment) UT_NOTHROW
+{
+    return MemoryLeakWarningPlugin::getGlobalDetector()->allocAlignedMemory(getCurrentNewAllocator(), size, alignment);
+}
+
+static void* mem_leak_operator_new_aligned_debug (size_t size, size_t alignment, const char* file, int line) UT_THROW(std::bad_alloc)
+{
+    void* memory = MemoryLeakWarningPlugin::getGlobalDetector()->allocAlignedMemory(getCurrentNewAllocator(), size, alignment, file, line);
+    UT_THROW_BAD_ALLOC_WHEN_NULL(memory);
+    return memory;
+}
+
+static void* mem_leak_operator_new_array_aligned (size_t size, size_t alignment) UT_THROW(std::bad_alloc)
+{
+    void* memory = MemoryLeakWarningPlugin::getGlobalDetector()->allocAlignedMemory(getCurrentNewArrayAllocator(), size, alignment);
+    UT_THROW_BAD_ALLOC_WHEN_NULL(memory);
+    return memory;
+}
+
+static void* mem_leak_operator_new_array_aligned_nothrow (size_t size, size_t alignment) UT_NOTHROW
+{
+    return MemoryLeakWarningPlugin::getGlobalDetector()->allocAlignedMemory(getCurrentNewArrayAllocator(), size, alignment);
+}
+
+static void* mem_leak_operator_new_array_aligned_debug (size_t size, size_t alignment, const char* file, int line) UT_THROW(std::bad_alloc)
+{
+    void* memory = MemoryLeakWarningPlugin::getGlobalDetector()->allocAlignedMemory(getCurrentNewArrayAllocator(), size, alignment, file, line);
+    UT_THROW_BAD_ALLOC_WHEN_NULL(memory);
+    return memory;
+}
+
+static void mem_leak_operator_delete_aligned (void* mem, size_t alignment) UT_NOTHROW
+{
+    MemoryLeakWarningPlugin::getGlobalDetector()->invalidateMemory((char*) mem);
+    MemoryLeakWarningPlugin::getGlobalDetector()->deallocAlignedMemory(getCurrentNewAllocator(), (char*) mem, alignment);
+}
+
+static void mem_leak_operator_delete_array_aligned (void* mem, size_t alignment) UT_NOTHROW
+{
+    MemoryLeakWarningPlugin::getGlobalDetector()->invalidateMemory((char*) mem);
+    MemoryLeakWarningPlugin::getGlobalDetector()->deallocAlignedMemory(getCurrentNewArrayAllocator(), (char*) mem, alignment);
+}
+
+static void mem_leak_operator_delete_sized_aligned (void* mem, size_t size, size_t alignment) UT_NOTHROW
+{
+    MemoryLeakWarningPlugin::getGlobalDetector()->invalidateMemory((char*) mem);
+    MemoryLeakWarningPlugin::getGlobalDetector()->deallocSizedMemory(getCurrentNewAllocator(), (char*) mem, size, alignment);
+}
+
+static void mem_leak_operator_delete_array_sized_aligned (void* mem, size_t size, size_t alignment) UT_NOTHROW
+{
+    MemoryLeakWarningPlugin::getGlobalDetector()->invalidateMemory((char*) mem);
+    MemoryLeakWarningPlugin::getGlobalDetector()->deallocSizedMemory(getCurrentNewArrayAllocator(), (char*) mem, size, alignment);
+}
+
+/* Without the detector, the pointer to free is stored just in front of the aligned memory */
+
+static void* platform_aligned_malloc(size_t size, size_t alignment)
+{
+    if (alignment < sizeof(void*)) alignment = sizeof(void*);
+    char* memory = (char*) PlatformSpecificMalloc(size + alignment + sizeof(void*));
+    if (memory == NULL) return NULL;
+
+    size_t misalignment = (size_t) (memory + sizeof(void*)) % alignment;
+    char* alignedMemory = memory + sizeof(void*) + ((misalignment == 0) ? 0 : alignment - misalignment);
+    ((void**) (void*) alignedMemory)[-1] = memory;
+    return alignedMemory;
+}
+
+static void platform_aligned_free(void* mem)
+{
+    if (mem) PlatformSpecificFree(((void**) mem)[-1]);
+}
+
+static void* normal_operator_new_aligned (size_t size, size_t alignment) UT_THROW(std::bad_alloc)
+{
+    void* memory = platform_aligned_malloc(size, alignment);
+    UT_THROW_BAD_ALLOC_WHEN_NULL(memory);
+    return memory;
+}
+
+static void* normal_operator_new_aligned_nothrow (size_t size, size_t alignment) UT_NOTHROW
+{
+    return platform_aligned_malloc(size, alignment);
+}
+
+static void* normal_operator_new_aligned_debug (size_t size, size_t alignment, const char* /*file*/, int /*line*/) UT_THROW(std::bad_alloc)
+{
+    return normal_operator_new_aligned(size, alignment);
+}
+
+static void normal_operator_delete_aligned (void* mem, size_t /*alignment*/) UT_NOTHROW
+{
+    platform_aligned_free(mem);
+}
+
+static void normal_operator_delete_sized_aligned (void* mem, size_t /*size*/, size_t /*alignment*/) UT_NOTHROW
+{
+    platform_aligned_free(mem);
+}
+
+static void* statistics_operator_new_aligned (size_t size, size_t alignment) UT_THROW(std::bad_alloc)
+{
+    void* memory = platform_aligned_malloc(size, alignment);
+    countAllocation(memory, size);
+    UT_THROW_BAD_ALLOC_WHEN_NULL(memory);
+    return memory;
+}
+
+static void* statistics_operator_new_aligned_nothrow (size_t size, size_t alignment) UT_NOTHROW
+{
+    void* memory = platform_aligned_malloc(size, alignment);
+    countAllocation(memory, size);
+    return memory;
+}
+
+static void* statistics_operator_new_aligned_debug (size_t size, size_t alignment, const char* /*file*/, int /*line*/) UT_THROW(std::bad_alloc)
+{
+    return statistics_operator_new_aligned(size, alignment);
+}
+
+static void statistics_operator_delete_aligned (void* mem, size_t /*alignment*/) UT_NOTHROW
+{
+    countDeallocation(mem);
+    platform_aligned_free(mem);
+}
+
+static void statistics_operator_delete_sized_aligned (void* mem, size_t /*size*/, size_t alignment) UT_NOTHROW
+{
+    statistics_operator_delete_aligned(mem, alignment);
+}
+
+static void *(*operator_new_aligned_fptr)(size_t size, size_t alignment) UT_THROW(std::bad_alloc) = mem_leak_operator_new_aligned;
+static void *(*operator_new_aligned_nothrow_fptr)(size_t size, size_t alignment) UT_NOTHROW = mem_leak_operator_new_aligned_nothrow;
+static void *(*operator_new_aligned_debug_fptr)(size_t size, size_t alignment, const char* file, int line) UT_THROW(std::bad_alloc) = mem_leak_operator_new_aligned_debug;
+static void *(*operator_new_array_aligned_fptr)(size_t size, size_t alignment) UT_THROW(std::bad_alloc) = mem_leak_operator_new_array_aligned;
+static void *(*operator_new_array_aligned_nothrow_fptr)(size_t size, size_t alignment) UT_NOTHROW = mem_leak_operator_new_array_aligned_nothrow;
+static void *(*operator_new_array_aligned_debug_fptr)(size_t size, size_t alignment, const char* file, int line) UT_THROW(std::bad_alloc) = mem_leak_operator_new_array_aligned_debug;
+static void (*operator_delete_aligned_fptr)(void* mem, size_t alignment) UT_NOTHROW = mem_leak_operator_delete_aligned;
+static void (*operator_delete_array_aligned_fptr)(void* mem, size_t alignment) UT_NOTHROW = mem_leak_operator_delete_array_aligned;
+static void (*operator_delete_sized_aligned_fptr)(void* mem, size_t size, size_t alignment) UT_NOTHROW = mem_leak_operator_delete_sized_aligned;
+static void (*operator_delete_array_sized_aligned_fptr)(void* mem, size_t size, size_t alignment) UT_NOTHROW = mem_leak_operator_delete_array_sized_aligned;
+
+#endif
+
 static void *(*operator_new_fptr)(size_t size) UT_THROW(std::bad_alloc) = mem_leak_operator_new;
 static void *(*operator_new_nothrow_fptr)(size_t size) UT_NOTHROW = mem_leak_operator_new_nothrow;
 static void *(*operator_new_debug_fptr)(size_t size, const char* file, int line) UT_THROW(std::bad_alloc) = mem_leak_operator_new_debug;
@@ -339,6 +671,94 @@ void operator delete[](void* mem, const char*, int) UT_NOTHROW
      operator_delete_array_fptr(mem);
 }
 
+#if CPPUTEST_USE_SIZED_DEALLOCATION
+
+void operator delete(void* mem, size_t size) UT_NOTHROW
+{
+    operator_delete_sized_fptr(mem, size);
+}
+
+void operator delete[](void* mem, size_t size) UT_NOTHROW
+{
+    operator_delete_array_sized_fptr(mem, size);
+}
+
+#endif
+
+#if CPPUTEST_USE_ALIGNED_NEW
+
+void* operator new(size_t size, std::align_val_t alignment) UT_THROW(std::bad_alloc)
+{
+    return operator_new_aligned_fptr(size, (size_t) alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) UT_NOTHROW
+{
+    return operator_new_aligned_nothrow_fptr(size, (size_t) alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const char* file, int line) UT_THROW(std::bad_alloc)
+{
+    return operator_new_aligned_debug_fptr(size, (size_t) alignment, file, line);
+}
+
+void operator delete(void* mem, std::align_val_t alignment) UT_NOTHROW
+{
+    operator_delete_aligned_fptr(mem, (size_t) alignment);
+}
+
+void operator delete(void* mem, std::align_val_t alignment, const std::nothrow_t&) UT_NOTHROW
+{
+    operator_delete_aligned_fptr(mem, (size_t) alignment);
+}
+
+void operator delete(void* mem, std::align_val_t alignment, const char*, int) UT_NOTHROW
+{
+    operator_delete_aligned_fptr(mem, (size_t) alignment);
+}
+
+void operator delete(void* mem, size_t size, std::align_val_t alignment) UT_NOTHROW
+{
+    operator_delete_sized_aligned_fptr(mem, size, (size_t) alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) UT_THROW(std::bad_alloc)
+{
+    return operator_new_array_aligned_fptr(size, (size_t) alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) UT_NOTHROW
+{
+    return operator_new_array_aligned_nothrow_fptr(size, (size_t) alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const char* file, int line) UT_THROW(std::bad_alloc)
+{
+    return operator_new_array_aligned_debug_fptr(size, (size_t) alignment, file, line);
+}
+
+void operator delete[](void* mem, std::align_val_t alignment) UT_NOTHROW
+{
+    operator_delete_array_aligned_fptr(mem, (size_t) alignment);
+}
+
+void operator delete[](void* mem, std::align_val_t alignment, const std::nothrow_t&) UT_NOTHROW
+{
+    operator_delete_array_aligned_fptr(mem, (size_t) alignment);
+}
+
+void operator delete[](void* mem, std::align_val_t alignment, const char*, int) UT_NOTHROW
+{
+    operator_delete_array_aligned_fptr(mem, (size_t) alignment);
+}
+
+void operator delete[](void* mem, size_t size, std::align_val_t alignment) UT_NOTHROW
+{
+    operator_delete_array_sized_aligned_fptr(mem, size, (size_t) alignment);
+}
+
+#endif
+
 
 #if CPPUTEST_USE_STD_CPP_LIB
 
@@ -352,6 +772,16 @@ void* operator new[](size_t size, const std::nothrow_t&) UT_NOTHROW
     return operator_new_array_nothrow_fptr(size);
 }
 
+void operator delete(void* mem, const std::nothrow_t&) UT_NOTHROW
+{
+    operator_delete_fptr(mem);
+}
+
+void operator delete[](void* mem, const std::nothrow_t&) UT_NOTHROW
+{
+    operator_delete_array_fptr(mem);
+}
+
 #else
 
 /* Have a similar method. This avoid unused operator_new_nothrow_fptr warning */
@@ -386,6 +816,22 @@ void MemoryLeakWarningPlugin::turnOffNewDeleteOverloads()
     malloc_fptr = normal_malloc;
     realloc_fptr = normal_realloc;
     free_fptr = normal_free;
+#if CPPUTEST_USE_SIZED_DEALLOCATION
+    operator_delete_sized_fptr = normal_operator_delete_sized;
+    operator_delete_array_sized_fptr = normal_operator_delete_sized;
+#endif
+#if CPPUTEST_USE_ALIGNED_NEW
+    operator_new_aligned_fptr = normal_operator_new_aligned;
+    operator_new_aligned_nothrow_fptr = normal_operator_new_aligned_nothrow;
+    operator_new_aligned_debug_fptr = normal_operator_new_aligned_debug;
+    operator_new_array_aligned_fptr = normal_operator_new_aligned;
+    operator_new_array_aligned_nothrow_fptr = normal_operator_new_aligned_nothrow;
+    operator_new_array_aligned_debug_fptr = normal_operator_new_aligned_debug;
+    operator_delete_aligned_fptr = normal_operator_delete_aligned;
+    operator_delete_array_aligned_fptr = normal_operator_delete_aligned;
+    operator_delete_sized_aligned_fptr = normal_operator_delete_sized_aligned;
+    operator_delete_array_sized_aligned_fptr = normal_operator_delete_sized_aligned;
+#endif
 
 #endif
 }
@@ -404,6 +850,22 @@ void MemoryLeakWarningPlugin::turnOnNewDeleteOverloads()
     malloc_fptr = mem_leak_malloc;
     realloc_fptr = mem_leak_realloc;
     free_fptr = mem_leak_free;
+#if CPPUTEST_USE_SIZED_DEALLOCATION
+    operator_delete_sized_fptr = mem_leak_operator_delete_sized;
+    operator_delete_array_sized_fptr = mem_leak_operator_delete_array_sized;
+#endif
+#if CPPUTEST_USE_ALIGNED_NEW
+    operator_new_aligned_fptr = mem_leak_operator_new_aligned;
+    operator_new_aligned_nothrow_fptr = mem_leak_operator_new_aligned_nothrow;
+    operator_new_aligned_debug_fptr = mem_leak_operator_new_aligned_debug;
+    operator_new_array_aligned_fptr = mem_leak_operator_new_array_aligned;
+    operator_new_array_aligned_nothrow_fptr = mem_leak_operator_new_array_aligned_nothrow;
+    operator_new_array_aligned_debug_fptr = mem_leak_operator_new_array_aligned_debug;
+    operator_delete_aligned_fptr = mem_leak_operator_delete_aligned;
+    operator_delete_array_aligned_fptr = mem_leak_operator_delete_array_aligned;
+    operator_delete_sized_aligned_fptr = mem_leak_operator_delete_sized_aligned;
+    operator_delete_array_sized_aligned_fptr = mem_leak_operator_delete_array_sized_aligned;
+#endif
 #endif
 }
 
@@ -430,6 +892,75 @@ void MemoryLeakWarningPlugin::turnOnThreadSafeNewDeleteOverloads()
     malloc_fptr = threadsafe_mem_leak_malloc;
     realloc_fptr = threadsafe_mem_leak_realloc;
     free_fptr = threadsafe_mem_leak_free;
+#if CPPUTEST_USE_SIZED_DEALLOCATION
+    operator_delete_sized_fptr = threadsafe_mem_leak_operator_delete_sized;
+    operator_delete_array_sized_fptr = threadsafe_mem_leak_operator_delete_array_sized;
+#endif
+#if CPPUTEST_USE_ALIGNED_NEW
+    operator_new_aligned_fptr = threadsafe_mem_leak_operator_new_aligned;
+    operator_new_aligned_nothrow_fptr = threadsafe_mem_leak_operator_new_aligned_nothrow;
+    operator_new_aligned_debug_fptr = threadsafe_mem_leak_operator_new_aligned_debug;
+    operator_new_array_aligned_fptr = threadsafe_mem_leak_operator_new_array_aligned;
+    operator_new_array_aligned_nothrow_fptr = threadsafe_mem_leak_operator_new_array_aligned_nothrow;
+    operator_new_array_aligned_debug_fptr = threadsafe_mem_leak_operator_new_array_aligned_debug;
+    operator_delete_aligned_fptr = threadsafe_mem_leak_operator_delete_aligned;
+    operator_delete_array_aligned_fptr = threadsafe_mem_leak_operator_delete_array_aligned;
+    operator_delete_sized_aligned_fptr = threadsafe_mem_leak_operator_delete_sized_aligned;
+    operator_delete_array_sized_aligned_fptr = threadsafe_mem_leak_operator_delete_array_sized_aligned;
+#endif
+#endif
+}
+
+void MemoryLeakWarningPlugin::turnOnStatisticsOnlyNewDeleteOverloads()
+{
+#if CPPUTEST_USE_MEM_LEAK_DETECTION
+    operator_new_fptr = statistics_operator_new;
+    operator_new_nothrow_fptr = statistics_operator_new_nothrow;
+    operator_new_debug_fptr = statistics_operator_new_debug;
+    operator_new_array_fptr = statistics_operator_new;
+    operator_new_array_nothrow_fptr = statistics_operator_new_nothrow;
+    operator_new_array_debug_fptr = statistics_operator_new_debug;
+    operator_delete_fptr = statistics_operator_delete;
+    operator_delete_array_fptr = statistics_operator_delete;
+    malloc_fptr = statistics_malloc;
+    realloc_fptr = statistics_realloc;
+    free_fptr = statistics_free;
+#if CPPUTEST_USE_SIZED_DEALLOCATION
+    operator_delete_sized_fptr = statistics_operator_delete_sized;
+    operator_delete_array_sized_fptr = statistics_operator_delete_sized;
+#endif
+#if CPPUTEST_USE_ALIGNED_NEW
+    operator_new_aligned_fptr = statistics_operator_new_aligned;
+    operator_new_aligned_nothrow_fptr = statistics_operator_new_aligned_nothrow;
+    operator_new_aligned_debug_fptr = statistics_operator_new_aligned_debug;
+    operator_new_array_aligned_fptr = statistics_operator_new_aligned;
+    operator_new_array_aligned_nothrow_fptr = statistics_operator_new_aligned_nothrow;
+    operator_new_array_aligned_debug_fptr = statistics_operator_new_aligned_debug;
+    operator_delete_aligned_fptr = statistics_operator_delete_aligned;
+    operator_delete_array_aligned_fptr = statistics_operator_delete_aligned;
+    operator_delete_sized_aligned_fptr = statistics_operator_delete_sized_aligned;
+    operator_delete_array_sized_aligned_fptr = statistics_operator_delete_sized_aligned;
+#endif
+#endif
+}
+
+MemoryAllocationStatistics MemoryLeakWarningPlugin::getAllocationStatistics()
+{
+    MemoryAllocationStatistics statistics = { 0, 0, 0 };
+#if CPPUTEST_USE_MEM_LEAK_DETECTION
+    statistics.allocations = statisticsAllocations;
+    statistics.deallocations = statisticsDeallocations;
+    statistics.bytesAllocated = statisticsBytesAllocated;
+#endif
+    return statistics;
+}
+
+void MemoryLeakWarningPlugin::resetAllocationStatistics()
+{
+#if CPPUTEST_USE_MEM_LEAK_DETECTION
+    statisticsAllocations = 0;
+    statisticsDeallocations = 0;
+    statisticsBytesAllocated = 0;
 #endif
 }
 
@@ -548,6 +1079,20 @@ void MemoryLeakWarningPlugin::preTestAction(UtestShell& /*test*/, TestResult& re
 void MemoryLeakWarningPlugin::postTestAction(UtestShell& test, TestResult& result)
 {
     memLeakDetector_->stopChecking();
+    result.setCurrentTestPeakMemory(memLeakDetector_->getPeakMemoryInUse(), memLeakDetector_->getPeakBlocksInUse());
+
+    const char* corruption = memLeakDetector_->reportCorruptedMemory(mem_leak_period_checking);
+    if (*corruption) {
+        TestFailure f(&test, corruption);
+        result.addFailure(f);
+    }
+
+    const char* writesToFreedMemory = memLeakDetector_->flushQuarantine();
+    if (*writesToFreedMemory) {
+        TestFailure f(&test, writesToFreedMemory);
+        result.addFailure(f);
+    }
+
     int leaks = memLeakDetector_->totalMemoryLeaks(mem_leak_period_checking);
 
     if (!ignoreAllWarnings_ && expectedLeaks_ != leaks && failureCount_ == result.getFailureCount()) {
@@ -559,6 +1104,26 @@ void MemoryLeakWarningPlugin::postTestAction(UtestShell& test, TestResult& resul
     expectedLeaks_ = 0;
 }
 
+void MemoryLeakWarningPlugin::preTestGroupFixtureAction(TestGroupFixtureShell& /*fixture*/, TestResult& result)
+{
+    memLeakDetector_->startCheckingTestGroup();
+    failureCount_ = result.getFailureCount();
+}
+
+/* What the setup of a group allocated may live on until the teardown, which has to free it */
+void MemoryLeakWarningPlugin::postTestGroupFixtureAction(TestGroupFixtureShell& fixture, TestResult& result)
+{
+    memLeakDetector_->stopChecking();
+    if (fixture.isSetup()) return;
+
+    int leaks = memLeakDetector_->totalMemoryLeaks(mem_leak_period_test_group);
+    if (leaks && failureCount_ == result.getFailureCount()) {
+        TestFailure f(&fixture, memLeakDetector_->report(mem_leak_period_test_group));
+        result.addFailure(f);
+    }
+    memLeakDetector_->markTestGroupPeriodLeaksAsNonCheckingPeriod();
+}
+
 const char* MemoryLeakWarningPlugin::FinalReport(int toBeDeletedLeaks)
 {
     int leaks = memLeakDetector_->totalMemoryLeaks(mem_leak_period_enabled);
@@ -78,6 +78,117 @@ int SimpleString::AtoI(const char* str)
     return (first_char == '-') ? -result : result;
 }
 
+unsigned long SimpleString::AtoU(const char* str)
+{
+    while (isSpace(*str)) str++;
+
+    unsigned long result = 0;
+    for(; isDigit(*str); str++)
+    {
+        result *= 10;
+        result += (unsigned long) (*str - '0');
+    }
+    return result;
+}
+
+/* Memory compares process a word at a time. A word is copied out of the memory, which reads
+ * nothing outside the compared memory and needs no alignment. The order of its bytes does not
+ * matter, as words are only compared and their bytes counted. */
+typedef unsigned long MemoryWord;
+
+static const MemoryWord lowBitOfEachByte = ((MemoryWord) -1) / 0xFF;
+static const MemoryWord highBitOfEachByte = lowBitOfEachByte * 0x80;
+
+static MemoryWord loadMemoryWord(const unsigned char* memory)
+{
+#if CPPUTEST_HAVE_BUILTIN_MEMCPY
+    MemoryWord word;
+    __builtin_memcpy(&word, memory, sizeof(word));
+#else
+    MemoryWord word = 0;
+    for (size_t i = 0; i < sizeof(MemoryWord); i++)
+        word = (word << 8) | memory[i];
+#endif
+    return word;
+}
+
+static size_t differingBytesIn(MemoryWord difference)
+{
+    MemoryWord nonZeroBytes = (((difference & ~highBitOfEachByte) + ~highBitOfEachByte) | difference) & highBitOfEachByte;
+    return (size_t) (((nonZeroBytes >> 7) * lowBitOfEachByte) >> (8 * (sizeof(MemoryWord) - 1)));
+}
+
+static size_t compareMemory(const unsigned char* p1, const unsigned char* p2, size_t n, size_t* differenceCount)
+{
+    size_t firstDifference = n;
+    size_t count = 0;
+    size_t i = 0;
+
+    for (; n - i >= sizeof(MemoryWord); i += sizeof(MemoryWord)) {
+        MemoryWord difference = loadMemoryWord(p1 + i) ^ loadMemoryWord(p2 + i);
+        if (difference == 0) continue;
+        if (firstDifference == n) {
+            firstDifference = i;
+            while (p1[firstDifference] == p2[firstDifference]) firstDifference++;
+        }
+        if (differenceCount == NULL) return firstDifference;
+        count += differingBytesIn(difference);
+    }
+    for (; i < n; i++) {
+        if (p1[i] == p2[i]) continue;
+        if (firstDifference == n) firstDifference = i;
+        if (differenceCount == NULL) return firstDifference;
+        count++;
+    }
+    if (differenceCount) *differenceCount = count;
+    return firstDifference;
+}
+
+/* Lowers the ASCII capitals in all bytes of a word at once, as ToLower does for one */
+static MemoryWord foldCaseOfWord(MemoryWord word)
+{
+    MemoryWord sevenBits = word & ~highBitOfEachByte;
+    MemoryWord fromA = sevenBits + lowBitOfEachByte * (0x80 - 'A');
+    MemoryWord pastZ = sevenBits + lowBitOfEachByte * (0x80 - 'Z' - 1);
+    MemoryWord capitals = (fromA ^ pastZ) & ~word & highBitOfEachByte;
+    return word | (capitals >> 2);
+}
+
+static MemoryWord loadWordNoCase(const char* str)
+{
+    return foldCaseOfWord(loadMemoryWord((const unsigned char*) str));
+}
+
+/* Returns where the first n characters first differ, ignoring their case, or n */
+static size_t compareNoCase(const char* s1, const char* s2, size_t n)
+{
+    size_t i = 0;
+
+    for (; n - i >= sizeof(MemoryWord); i += sizeof(MemoryWord))
+        if (loadWordNoCase(s1 + i) != loadWordNoCase(s2 + i)) break;
+    for (; i < n; i++)
+        if (SimpleString::ToLower(s1[i]) != SimpleString::ToLower(s2[i])) return i;
+    return n;
+}
+
+/* The string is only checked for its end as far as a candidate needs, so a match near its start is found early */
+static const char* findStringNoCase(const char* str, const char* substr)
+{
+    size_t length = SimpleString::StrLen(substr);
+    if (length == 0) return str;
+
+    char first = SimpleString::ToLower(*substr);
+    const char* checked = str;
+    for (; *str; str++) {
+        if (SimpleString::ToLower(*str) != first) continue;
+        if (checked < str) checked = str;
+        while ((size_t) (checked - str) < length && *checked) checked++;
+        if ((size_t) (checked - str) < length) return NULL;
+        if (compareNoCase(str + 1, substr + 1, length - 1) == length - 1) return str;
+    }
+    return NULL;
+}
+
 int SimpleString::StrCmp(const char* s1, const char* s2)
 {
    while(*s1 && *s1 == *s2)
@@ -85,6 +196,14 @@ int SimpleString::StrCmp(const char* s1, const char* s2)
    return *(unsigned char *) s1 - *(unsigned char *) s2;
 }
 
+/* Bytewise, as reading a word at a time would first have to check each of its bytes for the end */
+int SimpleString::StrCmpNoCase(const char* s1, const char* s2)
+{
+    while (*s1 && ToLower(*s1) == ToLower(*s2))
+        s1++, s2++;
+    return (unsigned char) ToLower(*s1) - (unsigned char) ToLower(*s2);
+}
+
 size_t SimpleString::StrLen(const char* str)
 {
     size_t n = (size_t)-1;
@@ -92,6 +211,14 @@ size_t SimpleString::StrLen(const char* str)
     return n;
 }
 
+/* FNV-1a, for hashing names */
+size_t SimpleString::StrHash(const char* str)
+{
+    size_t hash = 2166136261u;
+    while (*str) hash = (hash ^ (unsigned char) *str++) * 16777619u;
+    return hash;
+}
+
 int SimpleString::StrNCmp(const char* s1, const char* s2, size_t n)
 {
     while (n && *s1 && *s1 == *s2) {
@@ -114,12 +241,21 @@ char* SimpleString::StrNCpy(char* s1, const char* s2, size_t n)
 char* SimpleString::StrStr(const char* s1, const char* s2)
 {
     if(!*s2) return (char*) s1;
-    for (; *s1; s1++)
-        if (StrNCmp(s1, s2, StrLen(s2)) == 0)
-            return (char*) s1;
+    for (; *s1; s1++) {
+        const char* s = s1;
+        const char* prefix = s2;
+        while (*prefix && *s == *prefix)
+            s++, prefix++;
+        if (*prefix == '\0') return (char*) s1;
+    }
     return NULL;
 }
 
+char* SimpleString::StrStrNoCase(const char* s1, const char* s2)
+{
+    return (char*) findStringNoCase(s1, s2);
+}
+
 char SimpleString::ToLower(char ch)
 {
     return isUpper(ch) ? (char)((int)ch + ('a' - 'A')) : ch;
@@ -130,12 +266,20 @@ int SimpleString::MemCmp(const void* s1, const void *s2, size_t n)
     const unsigned char* p1 = (const unsigned char*) s1;
     const unsigned char* p2 = (const unsigned char*) s2;
 
-    while (n--)
-        if (*p1 != *p2)
-            return *p1 - *p2;
-        else
-            p1++, p2++;
-    return 0;
+    size_t position = compareMemory(p1, p2, n, NULL);
+    return (position == n) ? 0 : p1[position] - p2[position];
+}
+
+size_t SimpleString::MemFirstDifference(const void* s1, const void *s2, size_t n)
+{
+    return compareMemory((const unsigned char*) s1, (const unsigned char*) s2, n, NULL);
+}
+
+size_t SimpleString::MemCountDifferences(const void* s1, const void *s2, size_t n)
+{
+    size_t count;
+    compareMemory((const unsigned char*) s1, (const unsigned char*) s2, n, &count);
+    return count;
 }
 
 SimpleString::SimpleString(const char *otherBuffer)
@@ -182,7 +326,7 @@ bool SimpleString::contains(const SimpleString& other) const
 
 bool SimpleString::containsNoCase(const SimpleString& other) const
 {
-    return lowerCase().contains(other.lowerCase());
+    return StrStrNoCase(buffer_, other.buffer_) != 0;
 }
 
 bool SimpleString::startsWith(const SimpleString& other) const
@@ -312,7 +456,7 @@ bool operator==(const SimpleString& left, const SimpleString& right)
 
 bool SimpleString::equalsNoCase(const SimpleString& str) const
 {
-    return lowerCase() == str.lowerCase();
+    return StrCmpNoCase(buffer_, str.buffer_) == 0;
 }
 
 
@@ -571,13 +715,19 @@ SimpleString VStringFromFormat(const char* format, va_list args)
 
 SimpleString StringFromBinary(const unsigned char* value, size_t size)
 {
-    SimpleString result;
+    if (size == 0) return "";
 
+    static const char hexDigits[] = "0123456789ABCDEF";
+    char* buffer = SimpleString::allocStringBuffer(size * 3);
     for (size_t i = 0; i < size; i++) {
-        result += StringFromFormat("%02X ", value[i]);
+        buffer[i * 3] = hexDigits[value[i] >> 4];
+        buffer[i * 3 + 1] = hexDigits[value[i] & 0x0F];
+        buffer[i * 3 + 2] = ' ';
     }
-    result = result.subString(0, result.size() - 1);
+    buffer[size * 3 - 1] = '\0';
 
+    SimpleString result(buffer);
+    SimpleString::deallocStringBuffer(buffer);
     return result;
 }
 
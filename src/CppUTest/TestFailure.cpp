@@ -76,7 +76,7 @@ TestFailure::TestFailure(UtestShell* test, const char* fileName, int lineNum) :
 }
 
 TestFailure::TestFailure(const TestFailure& f) :
-    testName_(f.testName_), fileName_(f.fileName_), lineNumber_(f.lineNumber_), testFileName_(f.testFileName_), testLineNumber_(f.testLineNumber_), message_(f.message_)
+    testName_(f.testName_), fileName_(f.fileName_), lineNumber_(f.lineNumber_), testFileName_(f.testFileName_), testLineNumber_(f.testLineNumber_), message_(f.getMessage())
 {
 }
 
@@ -125,12 +125,12 @@ bool TestFailure::isInHelperFunction() const
     return lineNumber_ < testLineNumber_;
 }
 
-SimpleString TestFailure::createButWasString(const SimpleString& expected, const SimpleString& actual)
+SimpleString TestFailure::createButWasString(const SimpleString& expected, const SimpleString& actual) const
 {
     return StringFromFormat("expected <%s>\n\tbut was  <%s>", expected.asCharString(), actual.asCharString());
 }
 
-SimpleString TestFailure::createDifferenceAtPosString(const SimpleString& actual, size_t position, DifferenceFormat format)
+SimpleString TestFailure::createDifferenceAtPosString(const SimpleString& actual, size_t position, DifferenceFormat format, size_t reportedOffset) const
 {
     SimpleString result;
     const size_t extraCharactersWindow = 20;
@@ -139,7 +139,7 @@ SimpleString TestFailure::createDifferenceAtPosString(const SimpleString& actual
 
     SimpleString paddingForPreventingOutOfBounds (" ", halfOfExtraCharactersWindow);
     SimpleString actualString = paddingForPreventingOutOfBounds + actual + paddingForPreventingOutOfBounds;
-    SimpleString differentString = StringFromFormat("difference starts at position %lu at: <", (unsigned long) position);
+    SimpleString differentString = StringFromFormat("difference starts at position %lu at: <", (unsigned long) (position + reportedOffset));
 
     result += "\n";
     result += StringFromFormat("\t%s%s>\n", differentString.asCharString(), actualString.subString(actualOffset, extraCharactersWindow).asCharString());
@@ -171,25 +171,36 @@ static SimpleString StringFromOrNan(double d)
     return StringFrom(d);
 }
 
-DoublesEqualFailure::DoublesEqualFailure(UtestShell* test, const char* fileName, int lineNumber, double expected, double actual, double threshold)  : TestFailure(test, fileName, lineNumber)
+DoublesEqualFailure::DoublesEqualFailure(UtestShell* test, const char* fileName, int lineNumber, double expected, double actual, double threshold)  : TestFailure(test, fileName, lineNumber),
+    expected_(expected), actual_(actual), threshold_(threshold)
 {
-    message_ = createButWasString(StringFromOrNan(expected), StringFromOrNan(actual));
-    message_ += " threshold used was <";
-    message_ += StringFromOrNan(threshold);
-    message_ += ">";
+}
 
-    if (PlatformSpecificIsNan(expected) || PlatformSpecificIsNan(actual) || PlatformSpecificIsNan(threshold))
-        message_ += "\n\tCannot make comparisons with Nan";
+SimpleString DoublesEqualFailure::getMessage() const
+{
+    SimpleString message = createButWasString(StringFromOrNan(expected_), StringFromOrNan(actual_));
+    message += " threshold used was <";
+    message += StringFromOrNan(threshold_);
+    message += ">";
+
+    if (PlatformSpecificIsNan(expected_) || PlatformSpecificIsNan(actual_) || PlatformSpecificIsNan(threshold_))
+        message += "\n\tCannot make comparisons with Nan";
+    return message;
+}
+
+CheckEqualFailure::CheckEqualFailure(UtestShell* test, const char* fileName, int lineNumber, const SimpleString& expected, const SimpleString& actual) : TestFailure(test, fileName, lineNumber),
+    expected_(expected), actual_(actual)
+{
 }
 
-CheckEqualFailure::CheckEqualFailure(UtestShell* test, const char* fileName, int lineNumber, const SimpleString& expected, const SimpleString& actual) : TestFailure(test, fileName, lineNumber)
+SimpleString CheckEqualFailure::getMessage() const
 {
     size_t failStart;
-    for (failStart = 0; actual.asCharString()[failStart] == expected.asCharString()[failStart]; failStart++)
+    for (failStart = 0; actual_.asCharString()[failStart] == expected_.asCharString()[failStart]; failStart++)
         ;
-    message_ = createButWasString(expected, actual);
-    message_ += createDifferenceAtPosString(actual, failStart);
-
+    SimpleString message = createButWasString(expected_, actual_);
+    message += createDifferenceAtPosString(actual_, failStart);
+    return message;
 }
 
 ContainsFailure::ContainsFailure(UtestShell* test, const char* fileName, int lineNumber, const SimpleString& expected, const SimpleString& actual) :
@@ -217,75 +228,134 @@ FailFailure::FailFailure(UtestShell* test, const char* fileName, int lineNumber,
     message_ = message;
 }
 
-LongsEqualFailure::LongsEqualFailure(UtestShell* test, const char* fileName, int lineNumber, long expected, long actual) : TestFailure(test, fileName, lineNumber)
+LongsEqualFailure::LongsEqualFailure(UtestShell* test, const char* fileName, int lineNumber, long expected, long actual) : TestFailure(test, fileName, lineNumber),
+    expected_(expected), actual_(actual)
+{
+}
+
+SimpleString LongsEqualFailure::getMessage() const
 {
-    SimpleString aDecimal = StringFrom(actual);
-    SimpleString aHex = HexStringFrom(actual);
-    SimpleString eDecimal = StringFrom(expected);
-    SimpleString eHex = HexStringFrom(expected);
+    SimpleString aDecimal = StringFrom(actual_);
+    SimpleString aHex = HexStringFrom(actual_);
+    SimpleString eDecimal = StringFrom(expected_);
+    SimpleString eHex = HexStringFrom(expected_);
 
     SimpleString::padStringsToSameLength(aDecimal, eDecimal, ' ');
     SimpleString::padStringsToSameLength(aHex, eHex, '0');
 
     SimpleString actualReported = aDecimal + " 0x" + aHex;
     SimpleString expectedReported = eDecimal + " 0x" + eHex;
-    message_ = createButWasString(expectedReported, actualReported);
+    return createButWasString(expectedReported, actualReported);
 }
 
-UnsignedLongsEqualFailure::UnsignedLongsEqualFailure(UtestShell* test, const char* fileName, int lineNumber, unsigned long expected, unsigned long actual) : TestFailure(test, fileName, lineNumber)
+UnsignedLongsEqualFailure::UnsignedLongsEqualFailure(UtestShell* test, const char* fileName, int lineNumber, unsigned long expected, unsigned long actual) : TestFailure(test, fileName, lineNumber),
+    expected_(expected), actual_(actual)
 {
-    SimpleString aDecimal = StringFrom(actual);
-    SimpleString aHex = HexStringFrom(actual);
-    SimpleString eDecimal = StringFrom(expected);
-    SimpleString eHex = HexStringFrom(expected);
+}
+
+SimpleString UnsignedLongsEqualFailure::getMessage() const
+{
+    SimpleString aDecimal = StringFrom(actual_);
+    SimpleString aHex = HexStringFrom(actual_);
+    SimpleString eDecimal = StringFrom(expected_);
+    SimpleString eHex = HexStringFrom(expected_);
 
     SimpleString::padStringsToSameLength(aDecimal, eDecimal, ' ');
     SimpleString::padStringsToSameLength(aHex, eHex, '0');
 
     SimpleString actualReported = aDecimal + " 0x" + aHex;
     SimpleString expectedReported = eDecimal + " 0x" + eHex;
-    message_ = createButWasString(expectedReported, actualReported);
+    return createButWasString(expectedReported, actualReported);
 }
 
-StringEqualFailure::StringEqualFailure(UtestShell* test, const char* fileName, int lineNumber, const char* expected, const char* actual) : TestFailure(test, fileName, lineNumber)
+/* The compared strings are copied, as they may be gone by the time the message is asked for */
+StringEqualFailure::StringEqualFailure(UtestShell* test, const char* fileName, int lineNumber, const char* expected, const char* actual) : TestFailure(test, fileName, lineNumber),
+    expected_(StringFromOrNull(expected)), actual_(StringFromOrNull(actual)), failStart_(0)
 {
-    message_ = createButWasString(StringFromOrNull(expected), StringFromOrNull(actual));
-    if((expected) && (actual))
-    {
-        size_t failStart;
-        for (failStart = 0; actual[failStart] == expected[failStart]; failStart++)
+    if ((expected) && (actual))
+        for (; actual[failStart_] == expected[failStart_]; failStart_++)
             ;
-        message_ += createDifferenceAtPosString(actual, failStart);
-    }
+    else
+        failStart_ = actual_.size() + 1; /* no difference is shown when one of them is NULL */
 }
 
-StringEqualNoCaseFailure::StringEqualNoCaseFailure(UtestShell* test, const char* fileName, int lineNumber, const char* expected, const char* actual) : TestFailure(test, fileName, lineNumber)
+SimpleString StringEqualFailure::getMessage() const
 {
-    message_ = createButWasString(StringFromOrNull(expected), StringFromOrNull(actual));
-    if((expected) && (actual))
-    {
-        size_t failStart;
-        for (failStart = 0; SimpleString::ToLower(actual[failStart]) == SimpleString::ToLower(expected[failStart]); failStart++)
+    SimpleString message = createButWasString(expected_, actual_);
+    if (failStart_ <= actual_.size())
+        message += createDifferenceAtPosString(actual_, failStart_);
+    return message;
+}
+
+StringEqualNoCaseFailure::StringEqualNoCaseFailure(UtestShell* test, const char* fileName, int lineNumber, const char* expected, const char* actual) : TestFailure(test, fileName, lineNumber),
+    expected_(StringFromOrNull(expected)), actual_(StringFromOrNull(actual)), failStart_(0)
+{
+    if ((expected) && (actual))
+        for (; SimpleString::ToLower(actual[failStart_]) == SimpleString::ToLower(expected[failStart_]); failStart_++)
             ;
-        message_ += createDifferenceAtPosString(actual, failStart);
-    }
+    else
+        failStart_ = actual_.size() + 1;
 }
 
+SimpleString StringEqualNoCaseFailure::getMessage() const
+{
+    SimpleString message = createButWasString(expected_, actual_);
+    if (failStart_ <= actual_.size())
+        message += createDifferenceAtPosString(actual_, failStart_);
+    return message;
+}
+
+/* Only a window of at most WINDOW_SIZE bytes around the first difference is copied and shown */
 BinaryEqualFailure::BinaryEqualFailure(UtestShell* test, const char* fileName, int lineNumber, const unsigned char* expected, const unsigned char* actual, size_t size) :
-		TestFailure(test, fileName, lineNumber)
-{
-	message_ = createButWasString(StringFromBinaryOrNull(expected, size), StringFromBinaryOrNull(actual, size));
-	if ((expected) && (actual))
-	{
-		size_t failStart;
-		for (failStart = 0; actual[failStart] == expected[failStart]; failStart++)
-			;
-		message_ += createDifferenceAtPosString(StringFromBinary(actual, size), failStart, DIFFERENCE_BINARY);
+		TestFailure(test, fileName, lineNumber), expectedIsNull_(expected == NULL), actualIsNull_(actual == NULL), size_(size),
+		windowStart_(0), windowSize_((size < WINDOW_SIZE) ? size : (size_t) WINDOW_SIZE), failStart_(size), differences_(0)
+{
+	if (expected && actual) {
+		failStart_ = SimpleString::MemFirstDifference(expected, actual, size_);
+		differences_ = SimpleString::MemCountDifferences(expected, actual, size_);
+		windowStart_ = (failStart_ < WINDOW_BYTES_BEFORE_DIFFERENCE) ? 0 : failStart_ - WINDOW_BYTES_BEFORE_DIFFERENCE;
+		if (windowStart_ > size_ - windowSize_) windowStart_ = size_ - windowSize_;
 	}
+	if (expected) PlatformSpecificMemCpy(expected_, expected + windowStart_, windowSize_);
+	if (actual) PlatformSpecificMemCpy(actual_, actual + windowStart_, windowSize_);
+}
+
+SimpleString BinaryEqualFailure::StringFromWindow(const unsigned char* window, bool isNull) const
+{
+	if (isNull) return "(null)";
+	SimpleString result = (windowStart_ > 0) ? "... " : "";
+	result += StringFromBinary(window, windowSize_);
+	if (windowStart_ + windowSize_ < size_) result += " ...";
+	return result;
+}
+
+SimpleString BinaryEqualFailure::getMessage() const
+{
+	SimpleString message = createButWasString(StringFromWindow(expected_, expectedIsNull_), StringFromWindow(actual_, actualIsNull_));
+	if (failStart_ < size_)
+		message += createDifferenceAtPosString(StringFromBinary(actual_, windowSize_), failStart_ - windowStart_, DIFFERENCE_BINARY, windowStart_);
+	if (size_ > WINDOW_SIZE && !expectedIsNull_ && !actualIsNull_)
+		message += StringFromFormat("\n\t%lu of %lu bytes differ", (unsigned long) differences_, (unsigned long) size_);
+	return message;
 }
 
 BitsEqualFailure::BitsEqualFailure(UtestShell* test, const char* fileName, int lineNumber, unsigned long expected, unsigned long actual, unsigned long mask, size_t byteCount) :
-        TestFailure(test, fileName, lineNumber)
+        TestFailure(test, fileName, lineNumber), expected_(expected), actual_(actual), mask_(mask), byteCount_(byteCount)
+{
+}
+
+SimpleString BitsEqualFailure::getMessage() const
+{
+    return createButWasString(StringFromMaskedBits(expected_, mask_, byteCount_), StringFromMaskedBits(actual_, mask_, byteCount_));
+}
+
+PeakMemoryFailure::PeakMemoryFailure(UtestShell* test, const char* fileName, int lineNumber, size_t limit, size_t peakMemory, size_t peakBlocks) :
+        TestFailure(test, fileName, lineNumber), limit_(limit), peakMemory_(peakMemory), peakBlocks_(peakBlocks)
+{
+}
+
+SimpleString PeakMemoryFailure::getMessage() const
 {
-    message_ = createButWasString(StringFromMaskedBits(expected, mask, byteCount), StringFromMaskedBits(actual, mask, byteCount));
+    return createButWasString(StringFromFormat("peak memory below %lu bytes", (unsigned long) limit_),
+        StringFromFormat("%lu bytes in %lu blocks", (unsigned long) peakMemory_, (unsigned long) peakBlocks_));
 }
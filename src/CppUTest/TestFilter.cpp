@@ -58,10 +58,23 @@ void TestFilter::strictMatching()
     strictMatching_ = true;
 }
 
+// A strict filter "name/*" matches the rows of TEST_P(group, name), which are named name/0, name/1, ...
+bool TestFilter::matchesRowOfParameterizedTest(const SimpleString& name) const
+{
+    if (!filter_.endsWith("/*")) return false;
+
+    size_t baseLength = filter_.size() - 1;
+    if (name.size() <= baseLength || SimpleString::StrNCmp(name.asCharString(), filter_.asCharString(), baseLength) != 0)
+        return false;
+    for (const char* row = name.asCharString() + baseLength; *row; row++)
+        if (*row < '0' || *row > '9') return false;
+    return true;
+}
+
 bool TestFilter::match(const SimpleString& name) const
 {
     if(strictMatching_)
-        return name == filter_;
+        return name == filter_ || matchesRowOfParameterizedTest(name);
     return name.contains(filter_);
 }
 
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2007, Michael Feathers, James Grenning and Bas Vodde
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE EARLIER MENTIONED AUTHORS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <copyright holder> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/TestJournal.h"
+
+struct TestJournalEntry
+{
+    TestJournalEntry(const SimpleString& group, const SimpleString& name) :
+        group_(group), name_(name), state_(0), next_(0), nextInBucket_(0)
+    {
+    }
+
+    SimpleString group_;
+    SimpleString name_;
+    int state_;
+    TestJournalEntry* next_;
+    TestJournalEntry* nextInBucket_;
+};
+
+TestJournal::TestJournal(const SimpleString& fileName) :
+    fileName_(fileName), file_(0), firstEntry_(0), lastEntry_(0), buckets_(0), numberOfBuckets_(0), numberOfEntries_(0)
+{
+}
+
+TestJournal::~TestJournal()
+{
+    close();
+    while (firstEntry_) {
+        TestJournalEntry* entry = firstEntry_;
+        firstEntry_ = firstEntry_->next_;
+        delete entry;
+    }
+    delete [] buckets_;
+}
+
+void TestJournal::loadPreviousRun()
+{
+    PlatformSpecificFile file = PlatformSpecificFOpen(fileName_.asCharString(), "r");
+    if (file == 0) return;
+
+    char line[512];
+    SimpleString record;
+    while (PlatformSpecificFGets(line, sizeof(line), file)) {
+        record += line;
+        if (!record.endsWith("\n")) continue;
+        addRecord(record);
+        record = "";
+    }
+    if (record.size()) addRecord(record);
+    PlatformSpecificFClose(file);
+
+    for (TestJournalEntry* entry = firstEntry_; entry; entry = entry->next_)
+        if (entry->state_ == JOURNAL_STARTED) entry->state_ = JOURNAL_CRASHED;
+}
+
+void TestJournal::addRecord(const SimpleString& line)
+{
+    int firstSpace = line.find(' ');
+    if (firstSpace < 0) return;
+    int secondSpace = line.findFrom((size_t) firstSpace + 1, ' ');
+    if (secondSpace < 0) return;
+
+    size_t nameEnd = line.size();
+    while (nameEnd > (size_t) secondSpace + 1 && (line.asCharString()[nameEnd - 1] == '\n' || line.asCharString()[nameEnd - 1] == '\r'))
+        nameEnd--;
+
+    SimpleString state = line.subString(0, (size_t) firstSpace);
+    SimpleString group = line.subString((size_t) firstSpace + 1, (size_t) (secondSpace - firstSpace - 1));
+    SimpleString name = line.subString((size_t) secondSpace + 1, nameEnd - (size_t) secondSpace - 1);
+
+    TestJournalEntry* entry = findEntry(group, name);
+    if (entry == 0) {
+        entry = new TestJournalEntry(group, name);
+        if (lastEntry_) lastEntry_->next_ = entry;
+        else firstEntry_ = entry;
+        lastEntry_ = entry;
+        indexEntry(entry);
+    }
+
+    if (state == "START") entry->state_ = JOURNAL_STARTED;
+    else if (state == "PASS") entry->state_ = JOURNAL_PASSED;
+    else if (state == "FAIL") entry->state_ = JOURNAL_FAILED;
+    else if (state == "CRASH") entry->state_ = JOURNAL_CRASHED;
+    else if (state == "SKIP") entry->state_ = JOURNAL_SKIPPED;
+}
+
+size_t TestJournal::bucketOf(const SimpleString& group, const SimpleString& name) const
+{
+    size_t hash = SimpleString::StrHash(group.asCharString()) * 31 + SimpleString::StrHash(name.asCharString());
+    return hash & (numberOfBuckets_ - 1);
+}
+
+/*
+ * The entries are indexed on their group and name, so loading a journal
+ * and looking up every test stays linear in the number of tests.
+ */
+void TestJournal::indexEntry(TestJournalEntry* entry)
+{
+    if (numberOfEntries_ >= numberOfBuckets_) {
+        delete [] buckets_;
+        numberOfBuckets_ = numberOfBuckets_ ? numberOfBuckets_ * 2 : 64;
+        buckets_ = new TestJournalEntry*[numberOfBuckets_];
+        for (size_t i = 0; i < numberOfBuckets_; i++)
+            buckets_[i] = 0;
+        numberOfEntries_ = 0;
+        for (TestJournalEntry* indexed = firstEntry_; indexed != entry; indexed = indexed->next_)
+            indexEntry(indexed);
+    }
+
+    size_t bucket = bucketOf(entry->group_, entry->name_);
+    entry->nextInBucket_ = buckets_[bucket];
+    buckets_[bucket] = entry;
+    numberOfEntries_++;
+}
+
+TestJournalEntry* TestJournal::findEntry(const SimpleString& group, const SimpleString& name)
+{
+    if (numberOfBuckets_ == 0) return 0;
+
+    for (TestJournalEntry* entry = buckets_[bucketOf(group, name)]; entry; entry = entry->nextInBucket_)
+        if (entry->name_ == name && entry->group_ == group)
+            return entry;
+    return 0;
+}
+
+TestJournalEntry* TestJournal::findEntry(const UtestShell& test)
+{
+    if (firstEntry_ == 0) return 0;
+    return findEntry(test.getGroup(), test.getName());
+}
+
+bool TestJournal::hasPassedBefore(const UtestShell& test)
+{
+    TestJournalEntry* entry = findEntry(test);
+    return entry && entry->state_ == JOURNAL_PASSED;
+}
+
+bool TestJournal::hasCrashedBefore(const UtestShell& test)
+{
+    TestJournalEntry* entry = findEntry(test);
+    return entry && entry->state_ == JOURNAL_CRASHED;
+}
+
+void TestJournal::open(bool append)
+{
+    file_ = PlatformSpecificFOpen(fileName_.asCharString(), append ? "a" : "w");
+}
+
+void TestJournal::close()
+{
+    if (file_) PlatformSpecificFClose(file_);
+    file_ = 0;
+}
+
+void TestJournal::writeRecord(const char* state, const UtestShell& test)
+{
+    if (file_ == 0) return;
+
+    SimpleString record(state);
+    record += " ";
+    record += test.getGroup();
+    record += " ";
+    record += test.getName();
+    record += "\n";
+    PlatformSpecificFPuts(record.asCharString(), file_);
+    PlatformSpecificFFlush(file_);
+}
+
+void TestJournal::testStarted(const UtestShell& test)
+{
+    writeRecord("START", test);
+}
+
+void TestJournal::testEnded(const UtestShell& test, bool failed)
+{
+    writeRecord(failed ? "FAIL" : "PASS", test);
+}
+
+void TestJournal::testCrashedBefore(const UtestShell& test)
+{
+    writeRecord("CRASH", test);
+}
+
+void TestJournal::testSkipped(const UtestShell& test)
+{
+    writeRecord("SKIP", test);
+}
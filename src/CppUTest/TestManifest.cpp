@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2007, Michael Feathers, James Grenning and Bas Vodde
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE EARLIER MENTIONED AUTHORS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <copyright holder> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/TestManifest.h"
+
+#if CPPUTEST_USE_TEST_MANIFEST
+/* Defined by the linker around the section, when an object of the executable has the section */
+extern "C" {
+    extern const char __start_cpputest_manifest[] __attribute__((weak));
+    extern const char __stop_cpputest_manifest[] __attribute__((weak));
+}
+#endif
+
+TestManifest::TestManifest(const char* begin, const char* end) :
+    begin_(begin), end_(end)
+{
+}
+
+TestManifest::~TestManifest()
+{
+}
+
+TestManifest TestManifest::linkedIn()
+{
+#if CPPUTEST_USE_TEST_MANIFEST
+    return TestManifest(__start_cpputest_manifest, __stop_cpputest_manifest);
+#else
+    return TestManifest(NULL, NULL);
+#endif
+}
+
+bool TestManifest::isEmpty() const
+{
+    size_t offset = 0;
+    TestManifestRecord record;
+    return !readRecord(offset, record);
+}
+
+const char* TestManifest::readString(const char*& position) const
+{
+    const char* string = position;
+    while (position < end_ && *position != '\0')
+        position++;
+    if (position == end_ || position == string) return NULL;
+    position++;
+    return string;
+}
+
+bool TestManifest::readRecord(size_t& offset, TestManifestRecord& record) const
+{
+    if (begin_ == NULL || end_ <= begin_) return false;
+
+    const char* position = begin_ + offset;
+    while (position < end_ && *position == '\0')
+        position++;
+
+    const char* kind = readString(position);
+    const char* group = readString(position);
+    const char* name = readString(position);
+    const char* file = readString(position);
+    const char* line = readString(position);
+    if (!kind || !group || !name || !file || !line) return false;
+
+    record.kind = kind;
+    record.group = group;
+    record.name = name;
+    record.file = file;
+    record.lineNumber = SimpleString::AtoI(line);
+    offset = (size_t) (position - begin_);
+    return true;
+}
+
+/* Records of a group are usually next to each other, so only a change of group needs a search */
+SimpleString TestManifest::listTestGroupNames() const
+{
+    SimpleString groupList = " ";
+    const char* lastGroup = "";
+    size_t offset = 0;
+    TestManifestRecord record;
+    while (readRecord(offset, record)) {
+        if (SimpleString::StrCmp(record.group, lastGroup) == 0) continue;
+        lastGroup = record.group;
+        SimpleString group = StringFromFormat(" %s ", record.group);
+        if (!groupList.contains(group)) {
+            groupList += record.group;
+            groupList += " ";
+        }
+    }
+    return groupList.subString(1, (groupList.size() > 1) ? groupList.size() - 2 : 0);
+}
+
+/* The rows of a parameterized test are only known when it runs, so its rows are listed as a single wildcard row */
+SimpleString TestManifest::listTestGroupAndCaseNames() const
+{
+    SimpleString groupAndNameList;
+    size_t offset = 0;
+    TestManifestRecord record;
+    while (readRecord(offset, record)) {
+        if (!groupAndNameList.isEmpty()) groupAndNameList += " ";
+        groupAndNameList += StringFromFormat("%s.%s", record.group, record.name);
+        if (SimpleString::StrCmp(record.kind, "TEST_P") == 0) groupAndNameList += "/*";
+    }
+    return groupAndNameList;
+}
+
+SimpleString TestManifest::listRecords() const
+{
+    SimpleString records;
+    size_t offset = 0;
+    TestManifestRecord record;
+    while (readRecord(offset, record))
+        records += StringFromFormat("%s %s %s %s:%d\n", record.kind, record.group, record.name, record.file, record.lineNumber);
+    return records;
+}
+
+static const unsigned char elfMagic[] = { 0x7F, 'E', 'L', 'F' };
+
+/* Reads an ELF field of width bytes, false when it lies outside the image or does not fit in a size_t */
+static bool readElfField(const unsigned char* image, size_t size, size_t offset, size_t width, bool bigEndian, size_t& value)
+{
+    if (offset > size || width > size - offset) return false;
+    value = 0;
+    for (size_t i = 0; i < width; i++) {
+        size_t byte = image[offset + (bigEndian ? i : width - 1 - i)];
+        if (value > (((size_t) -1) >> 8)) return false;
+        value = (value << 8) | byte;
+    }
+    return true;
+}
+
+TestManifest TestManifest::fromElfImage(const unsigned char* image, size_t size)
+{
+    TestManifest noManifest(NULL, NULL);
+    if (size < 16 || SimpleString::MemCmp(image, elfMagic, sizeof(elfMagic)) != 0) return noManifest;
+
+    bool elf64 = image[4] == 2;
+    bool bigEndian = image[5] == 2;
+    size_t address = elf64 ? 8 : 4;
+
+    size_t sectionHeaders, sectionHeaderSize, sectionCount, namesIndex;
+    if (!readElfField(image, size, elf64 ? 0x28 : 0x20, address, bigEndian, sectionHeaders) ||
+        !readElfField(image, size, elf64 ? 0x3A : 0x2E, 2, bigEndian, sectionHeaderSize) ||
+        !readElfField(image, size, elf64 ? 0x3C : 0x30, 2, bigEndian, sectionCount) ||
+        !readElfField(image, size, elf64 ? 0x3E : 0x32, 2, bigEndian, namesIndex))
+        return noManifest;
+
+    size_t offsetField = elf64 ? 0x18 : 0x10;
+    size_t sizeField = elf64 ? 0x20 : 0x14;
+
+    size_t namesOffset, namesSize;
+    size_t namesHeader = sectionHeaders + namesIndex * sectionHeaderSize;
+    if (!readElfField(image, size, namesHeader + offsetField, address, bigEndian, namesOffset) ||
+        !readElfField(image, size, namesHeader + sizeField, address, bigEndian, namesSize) ||
+        namesOffset > size || namesSize > size - namesOffset)
+        return noManifest;
+
+    static const char sectionName[] = "cpputest_manifest";
+    for (size_t section = 0; section < sectionCount; section++) {
+        size_t header = sectionHeaders + section * sectionHeaderSize;
+        size_t nameOffset, sectionOffset, sectionSize;
+        if (!readElfField(image, size, header, 4, bigEndian, nameOffset) ||
+            !readElfField(image, size, header + offsetField, address, bigEndian, sectionOffset) ||
+            !readElfField(image, size, header + sizeField, address, bigEndian, sectionSize))
+            return noManifest;
+
+        if (nameOffset >= namesSize || namesSize - nameOffset < sizeof(sectionName)) continue;
+        if (SimpleString::MemCmp(image + namesOffset + nameOffset, sectionName, sizeof(sectionName)) != 0) continue;
+        if (sectionOffset > size || sectionSize > size - sectionOffset) return noManifest;
+
+        const char* begin = (const char*) (const void*) (image + sectionOffset);
+        return TestManifest(begin, begin + sectionSize);
+    }
+    return noManifest;
+}
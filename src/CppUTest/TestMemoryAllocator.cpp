@@ -108,6 +108,24 @@ TestMemoryAllocator* defaultMallocAllocator()
     return &allocator;
 }
 
+static bool testMemoryPoolEnabled = false;
+
+SizeClassMemoryPool* getTestMemoryPool()
+{
+    static SizeClassMemoryPool pool;
+    return &pool;
+}
+
+void setTestMemoryPoolEnabled(bool enabled)
+{
+    testMemoryPoolEnabled = enabled;
+}
+
+bool isTestMemoryPoolEnabled()
+{
+    return testMemoryPoolEnabled;
+}
+
 /////////////////////////////////////////////
 
 TestMemoryAllocator::TestMemoryAllocator(const char* name_str, const char* alloc_name_str, const char* free_name_str)
@@ -130,6 +148,11 @@ bool TestMemoryAllocator::isOfEqualType(TestMemoryAllocator* allocator)
     return SimpleString::StrCmp(this->name(), allocator->name()) == 0;
 }
 
+bool TestMemoryAllocator::trapsAccessOutsideMemory()
+{
+    return false;
+}
+
 char* TestMemoryAllocator::allocMemoryLeakNode(size_t size)
 {
     return alloc_memory(size, "MemoryLeakNode", 1);
@@ -142,12 +165,36 @@ void TestMemoryAllocator::freeMemoryLeakNode(char* memory)
 
 char* TestMemoryAllocator::alloc_memory(size_t size, const char*, int)
 {
+    if (testMemoryPoolEnabled) {
+        char* memory = getTestMemoryPool()->allocate(size);
+        if (memory) return memory;
+    }
     return checkedMalloc(size);
 }
 
+char* TestMemoryAllocator::realloc_memory(char* memory, size_t size, const char*, int)
+{
+    SizeClassMemoryPool* pool = getTestMemoryPool();
+    if (!pool->owns(memory))
+        return (char*) PlatformSpecificRealloc(memory, size);
+
+    size_t blockSize = pool->getBlockSize(memory);
+    if (size <= blockSize) return memory;
+
+    char* newMemory = (char*) PlatformSpecificMalloc(size);
+    if (newMemory == NULL) return NULL;
+    PlatformSpecificMemCpy(newMemory, memory, blockSize);
+    pool->deallocate(memory);
+    return newMemory;
+}
+
 void TestMemoryAllocator::free_memory(char* memory, const char*, int)
 {
-    PlatformSpecificFree(memory);
+    SizeClassMemoryPool* pool = getTestMemoryPool();
+    if (pool->owns(memory))
+        pool->deallocate(memory);
+    else
+        PlatformSpecificFree(memory);
 }
 const char* TestMemoryAllocator::name()
 {
@@ -164,6 +211,210 @@ const char* TestMemoryAllocator::free_name()
     return free_name_;
 }
 
+static const size_t poolSlabSize = 16384;
+static const size_t poolSlabsPerChunk = 16;
+static const size_t poolSlabHeaderSize = 32;
+static const size_t poolSizeClassGranularity = 16;
+
+struct SizeClassMemoryPool::Slab
+{
+    Slab* nextSpare;
+    size_t blockSize;
+    size_t used;
+};
+
+struct SizeClassMemoryPool::FreeBlock
+{
+    FreeBlock* next;
+};
+
+static size_t slabTableIndex(const char* slab, size_t tableSize)
+{
+    return (((size_t) slab / poolSlabSize) * 2654435761u) & (tableSize - 1);
+}
+
+SizeClassMemoryPool::SizeClassMemoryPool()
+    : spareSlabs_(NULL), chunks_(NULL), numberOfChunks_(0), slabTable_(NULL), slabTableSize_(0), numberOfSlabs_(0), blocksInUse_(0)
+{
+    for (size_t i = 0; i < numberOfSizeClasses; i++) {
+        freeLists_[i] = NULL;
+        currentSlabs_[i] = NULL;
+    }
+}
+
+SizeClassMemoryPool::~SizeClassMemoryPool()
+{
+    /* Blocks still in use, e.g. by statics destroyed later, keep their slabs */
+    if (blocksInUse_ == 0) release();
+}
+
+void SizeClassMemoryPool::release()
+{
+    for (size_t i = 0; i < numberOfChunks_; i++)
+        PlatformSpecificFree(chunks_[i]);
+    PlatformSpecificFree(chunks_);
+    PlatformSpecificFree(slabTable_);
+    chunks_ = NULL;
+    slabTable_ = NULL;
+    numberOfChunks_ = slabTableSize_ = numberOfSlabs_ = 0;
+    spareSlabs_ = NULL;
+    for (size_t i = 0; i < numberOfSizeClasses; i++) {
+        freeLists_[i] = NULL;
+        currentSlabs_[i] = NULL;
+    }
+}
+
+bool SizeClassMemoryPool::reserveSlabs(size_t slabs)
+{
+    if ((numberOfSlabs_ + slabs) * 4 <= slabTableSize_ * 3) return true;
+
+    size_t newTableSize = slabTableSize_ ? slabTableSize_ * 2 : 64;
+    while ((numberOfSlabs_ + slabs) * 4 > newTableSize * 3) newTableSize *= 2;
+    char** newTable = (char**) PlatformSpecificMalloc(newTableSize * sizeof(char*));
+    if (newTable == NULL) return false;
+    PlatformSpecificMemset(newTable, 0, newTableSize * sizeof(char*));
+
+    for (size_t i = 0; i < slabTableSize_; i++) {
+        if (slabTable_[i] == NULL) continue;
+        size_t index = slabTableIndex(slabTable_[i], newTableSize);
+        while (newTable[index]) index = (index + 1) & (newTableSize - 1);
+        newTable[index] = slabTable_[i];
+    }
+    PlatformSpecificFree(slabTable_);
+    slabTable_ = newTable;
+    slabTableSize_ = newTableSize;
+    return true;
+}
+
+void SizeClassMemoryPool::addSlab(char* slab)
+{
+    size_t index = slabTableIndex(slab, slabTableSize_);
+    while (slabTable_[index]) index = (index + 1) & (slabTableSize_ - 1);
+    slabTable_[index] = slab;
+    numberOfSlabs_++;
+}
+
+/* When the platform malloc fails the pool keeps what it has and the caller falls back to the heap */
+bool SizeClassMemoryPool::addChunk()
+{
+    if (!reserveSlabs(poolSlabsPerChunk)) return false;
+
+    char* chunk = (char*) PlatformSpecificMalloc(poolSlabSize * (poolSlabsPerChunk + 1));
+    if (chunk == NULL) return false;
+
+    char** newChunks = (char**) PlatformSpecificRealloc(chunks_, (numberOfChunks_ + 1) * sizeof(char*));
+    if (newChunks == NULL) {
+        PlatformSpecificFree(chunk);
+        return false;
+    }
+    chunks_ = newChunks;
+    chunks_[numberOfChunks_++] = chunk;
+
+    for (size_t i = 0; i < poolSlabsPerChunk; i++)
+        addSlab(firstSlabOf(chunk) + i * poolSlabSize);
+    addSpareSlabs(chunk);
+    return true;
+}
+
+char* SizeClassMemoryPool::firstSlabOf(char* chunk)
+{
+    return chunk + (poolSlabSize - (size_t) chunk % poolSlabSize);
+}
+
+void SizeClassMemoryPool::addSpareSlabs(char* chunk)
+{
+    for (size_t i = poolSlabsPerChunk; i > 0; i--) {
+        Slab* slab = (Slab*) (void*) (firstSlabOf(chunk) + (i - 1) * poolSlabSize);
+        slab->nextSpare = spareSlabs_;
+        spareSlabs_ = slab;
+    }
+}
+
+SizeClassMemoryPool::Slab* SizeClassMemoryPool::findSlab(const char* memory) const
+{
+    if (numberOfSlabs_ == 0 || memory == NULL) return NULL;
+
+    const char* slab = memory - (size_t) memory % poolSlabSize;
+    for (size_t index = slabTableIndex(slab, slabTableSize_); slabTable_[index]; index = (index + 1) & (slabTableSize_ - 1))
+        if (slabTable_[index] == slab) return (Slab*) (void*) slabTable_[index];
+    return NULL;
+}
+
+char* SizeClassMemoryPool::carveBlock(size_t sizeClass)
+{
+    size_t blockSize = (sizeClass + 1) * poolSizeClassGranularity;
+    Slab* slab = currentSlabs_[sizeClass];
+    if (slab == NULL || slab->used + blockSize > poolSlabSize) {
+        if (spareSlabs_ == NULL && !addChunk()) return NULL;
+        slab = spareSlabs_;
+        spareSlabs_ = slab->nextSpare;
+        slab->blockSize = blockSize;
+        slab->used = poolSlabHeaderSize;
+        currentSlabs_[sizeClass] = slab;
+    }
+    char* memory = (char*) slab + slab->used;
+    slab->used += blockSize;
+    return memory;
+}
+
+char* SizeClassMemoryPool::allocate(size_t size)
+{
+    if (size > largestPooledSize) return NULL;
+
+    size_t sizeClass = (size == 0) ? 0 : (size - 1) / poolSizeClassGranularity;
+    char* memory = (char*) freeLists_[sizeClass];
+    if (memory)
+        freeLists_[sizeClass] = freeLists_[sizeClass]->next;
+    else
+        memory = carveBlock(sizeClass);
+
+    if (memory) blocksInUse_++;
+    return memory;
+}
+
+void SizeClassMemoryPool::deallocate(char* memory)
+{
+    size_t sizeClass = findSlab(memory)->blockSize / poolSizeClassGranularity - 1;
+    FreeBlock* block = (FreeBlock*) (void*) memory;
+    block->next = freeLists_[sizeClass];
+    freeLists_[sizeClass] = block;
+    blocksInUse_--;
+}
+
+bool SizeClassMemoryPool::owns(const char* memory) const
+{
+    return findSlab(memory) != NULL;
+}
+
+size_t SizeClassMemoryPool::getBlockSize(const char* memory) const
+{
+    return findSlab(memory)->blockSize;
+}
+
+bool SizeClassMemoryPool::reset()
+{
+    if (blocksInUse_ != 0) return false;
+
+    for (size_t i = 0; i < numberOfSizeClasses; i++) {
+        freeLists_[i] = NULL;
+        currentSlabs_[i] = NULL;
+    }
+    spareSlabs_ = NULL;
+    for (size_t i = numberOfChunks_; i > 0; i--)
+        addSpareSlabs(chunks_[i - 1]);
+    return true;
+}
+
+size_t SizeClassMemoryPool::getBlocksInUse() const
+{
+    return blocksInUse_;
+}
+
+size_t SizeClassMemoryPool::getNumberOfSlabs() const
+{
+    return numberOfSlabs_;
+}
+
 CrashOnAllocationAllocator::CrashOnAllocationAllocator() : allocationToCrashOn_(0)
 {
 }
@@ -181,6 +432,333 @@ char* CrashOnAllocationAllocator::alloc_memory(size_t size, const char* file, in
     return TestMemoryAllocator::alloc_memory(size, file, line);
 }
 
+struct GuardPageMemoryAllocator::BlockHeader
+{
+    unsigned long magic;
+    char* base;
+    size_t mappedSize;
+    size_t size;
+};
+
+static const unsigned long guardPageBlockMagic = 0x47554152UL;
+
+static size_t roundUp(size_t size, size_t multiple)
+{
+    return ((size + multiple - 1) / multiple) * multiple;
+}
+
+GuardPageMemoryAllocator::GuardPageMemoryAllocator(const char* name_str, const char* alloc_name_str, const char* free_name_str)
+    : TestMemoryAllocator(name_str, alloc_name_str, free_name_str), placement_(guard_after_memory), alignment_(1),
+      pageSize_(0), samplingInterval_(1), allocationsUntilGuarded_(1), guardedAllocations_(0)
+{
+    if (PlatformSpecificPageSize) pageSize_ = PlatformSpecificPageSize();
+}
+
+void GuardPageMemoryAllocator::setGuardPlacement(GuardPlacement placement)
+{
+    placement_ = placement;
+}
+
+void GuardPageMemoryAllocator::setAlignment(size_t alignment)
+{
+    alignment_ = (alignment == 0) ? 1 : alignment;
+}
+
+void GuardPageMemoryAllocator::setSamplingInterval(unsigned interval)
+{
+    samplingInterval_ = (interval == 0) ? 1 : interval;
+    allocationsUntilGuarded_ = samplingInterval_;
+}
+
+unsigned GuardPageMemoryAllocator::getGuardedAllocations() const
+{
+    return guardedAllocations_;
+}
+
+bool GuardPageMemoryAllocator::shouldGuardNextAllocation()
+{
+    if (pageSize_ == 0) return false;
+    if (--allocationsUntilGuarded_ != 0) return false;
+    allocationsUntilGuarded_ = samplingInterval_;
+    return true;
+}
+
+size_t GuardPageMemoryAllocator::headerSpace() const
+{
+    return roundUp(sizeof(BlockHeader), alignment_);
+}
+
+/*
+ * guard_after_memory:  [ header | memory ][ guard page ]
+ * guard_before_memory: [ header page ][ guard page ][ memory ]
+ * Unguarded memory:    [ header | memory ], never page aligned for guard_before_memory
+ * The header is copied in and out as it is not necessarily aligned.
+ */
+char* GuardPageMemoryAllocator::allocGuarded(size_t size)
+{
+    BlockHeader header;
+    char* memory;
+
+    if (placement_ == guard_after_memory) {
+        size_t alignedSize = roundUp(size, alignment_);
+        header.mappedSize = roundUp(headerSpace() + alignedSize, pageSize_) + pageSize_;
+        header.base = (char*) PlatformSpecificAllocatePages(header.mappedSize);
+        if (header.base == NULL) return NULL;
+        char* guard = header.base + header.mappedSize - pageSize_;
+        PlatformSpecificProtectPages(guard, pageSize_);
+        memory = guard - alignedSize;
+    }
+    else {
+        header.mappedSize = 2 * pageSize_ + roundUp(size, pageSize_);
+        header.base = (char*) PlatformSpecificAllocatePages(header.mappedSize);
+        if (header.base == NULL) return NULL;
+        PlatformSpecificProtectPages(header.base + pageSize_, pageSize_);
+        memory = header.base + 2 * pageSize_;
+    }
+
+    header.magic = guardPageBlockMagic;
+    header.size = size;
+    PlatformSpecificMemCpy(headerLocation(memory), &header, sizeof(header));
+    guardedAllocations_++;
+    return memory;
+}
+
+char* GuardPageMemoryAllocator::allocUnguarded(size_t size)
+{
+    BlockHeader header;
+    header.magic = guardPageBlockMagic;
+    header.mappedSize = 0;
+    header.size = size;
+    header.base = checkedMalloc(headerSpace() + size + alignment_);
+
+    char* memory = header.base + headerSpace();
+    if (placement_ == guard_before_memory && pageSize_ && ((size_t) memory % pageSize_) == 0)
+        memory += alignment_;
+
+    PlatformSpecificMemCpy(headerLocation(memory), &header, sizeof(header));
+    return memory;
+}
+
+char* GuardPageMemoryAllocator::headerLocation(char* memory) const
+{
+    if (placement_ == guard_before_memory && pageSize_ && ((size_t) memory % pageSize_) == 0)
+        return memory - 2 * pageSize_;
+    return memory - headerSpace();
+}
+
+char* GuardPageMemoryAllocator::alloc_memory(size_t size, const char*, int)
+{
+    char* memory = NULL;
+    if (shouldGuardNextAllocation())
+        memory = allocGuarded(size);
+    if (memory == NULL)
+        memory = allocUnguarded(size);
+    return memory;
+}
+
+char* GuardPageMemoryAllocator::realloc_memory(char* memory, size_t size, const char* file, int line)
+{
+    char* newMemory = alloc_memory(size, file, line);
+    if (memory) {
+        BlockHeader header;
+        PlatformSpecificMemCpy(&header, headerLocation(memory), sizeof(header));
+        PlatformSpecificMemCpy(newMemory, memory, (header.size < size) ? header.size : size);
+        free_memory(memory, file, line);
+    }
+    return newMemory;
+}
+
+void GuardPageMemoryAllocator::free_memory(char* memory, const char* file, int line)
+{
+    if (memory == NULL) return;
+
+    BlockHeader header;
+    PlatformSpecificMemCpy(&header, headerLocation(memory), sizeof(header));
+    if (header.magic != guardPageBlockMagic)
+        TestMemoryAllocator::free_memory(memory, file, line);
+    else if (header.mappedSize)
+        PlatformSpecificFreePages(header.base, header.mappedSize);
+    else
+        PlatformSpecificFree(header.base);
+}
+
+bool GuardPageMemoryAllocator::trapsAccessOutsideMemory()
+{
+    return pageSize_ != 0;
+}
+
+char* GuardPageMemoryAllocator::allocMemoryLeakNode(size_t size)
+{
+    return checkedMalloc(size);
+}
+
+void GuardPageMemoryAllocator::freeMemoryLeakNode(char* memory)
+{
+    PlatformSpecificFree(memory);
+}
+
+FaultInjectionSchedule::FaultInjectionSchedule()
+{
+    clear();
+}
+
+void FaultInjectionSchedule::failAllocationNumber(unsigned number)
+{
+    allocationNumberToFail_ = number;
+}
+
+void FaultInjectionSchedule::failEveryNthAllocation(unsigned interval)
+{
+    failureInterval_ = interval;
+}
+
+void FaultInjectionSchedule::failRandomly(double probability, unsigned long seed)
+{
+    failureProbability_ = probability;
+    randomState_ = (seed & 0xFFFFFFFFUL) ? (seed & 0xFFFFFFFFUL) : 0x9E3779B9UL;
+}
+
+void FaultInjectionSchedule::failAfterBytes(size_t bytes)
+{
+    limitBytes_ = true;
+    byteLimit_ = bytes;
+}
+
+void FaultInjectionSchedule::failAllocationsFrom(const char* file, int line)
+{
+    failingFile_ = file;
+    failingLine_ = line;
+}
+
+void FaultInjectionSchedule::restrictToTest(UtestShell* test)
+{
+    restrictedTest_ = test;
+}
+
+/* xorshift32, so a seed fails the same allocations on every platform */
+double FaultInjectionSchedule::nextRandom()
+{
+    randomState_ ^= (randomState_ << 13) & 0xFFFFFFFFUL;
+    randomState_ ^= randomState_ >> 17;
+    randomState_ ^= (randomState_ << 5) & 0xFFFFFFFFUL;
+    return (double) randomState_ / 4294967296.0;
+}
+
+bool FaultInjectionSchedule::isFailingCallSite(const char* file, int line) const
+{
+    if (failingFile_ == NULL || file == NULL) return false;
+    if (failingLine_ != 0 && failingLine_ != line) return false;
+
+    size_t fileLength = SimpleString::StrLen(file);
+    size_t failingFileLength = SimpleString::StrLen(failingFile_);
+    if (failingFileLength > fileLength) return false;
+    return SimpleString::StrCmp(file + fileLength - failingFileLength, failingFile_) == 0;
+}
+
+bool FaultInjectionSchedule::shouldFail(size_t size, const char* file, int line)
+{
+    if (restrictedTest_ && UtestShell::getCurrent() != restrictedTest_) return false;
+    allocationCount_++;
+
+    bool fail = false;
+    if (failureProbability_ > 0.0 && nextRandom() < failureProbability_) fail = true;
+    if (allocationNumberToFail_ == allocationCount_) fail = true;
+    if (failureInterval_ && allocationCount_ % failureInterval_ == 0) fail = true;
+    if (limitBytes_ && allocatedBytes_ + size > byteLimit_) fail = true;
+    if (isFailingCallSite(file, line)) fail = true;
+
+    if (fail) failedAllocationCount_++;
+    else allocatedBytes_ += size;
+    return fail;
+}
+
+unsigned FaultInjectionSchedule::getAllocationCount() const
+{
+    return allocationCount_;
+}
+
+unsigned FaultInjectionSchedule::getFailedAllocationCount() const
+{
+    return failedAllocationCount_;
+}
+
+void FaultInjectionSchedule::resetCounters()
+{
+    allocationCount_ = 0;
+    failedAllocationCount_ = 0;
+    allocatedBytes_ = 0;
+}
+
+void FaultInjectionSchedule::clear()
+{
+    allocationNumberToFail_ = 0;
+    failureInterval_ = 0;
+    failureProbability_ = 0.0;
+    randomState_ = 0x9E3779B9UL;
+    limitBytes_ = false;
+    byteLimit_ = 0;
+    failingFile_ = NULL;
+    failingLine_ = 0;
+    restrictedTest_ = NULL;
+    resetCounters();
+}
+
+FaultInjectionMemoryAllocator::FaultInjectionMemoryAllocator(FaultInjectionSchedule* schedule, TestMemoryAllocator* originalAllocator)
+    : schedule_(schedule), originalAllocator_(originalAllocator)
+{
+}
+
+void FaultInjectionMemoryAllocator::setOriginalAllocator(TestMemoryAllocator* originalAllocator)
+{
+    originalAllocator_ = originalAllocator;
+}
+
+TestMemoryAllocator* FaultInjectionMemoryAllocator::getOriginalAllocator()
+{
+    return originalAllocator_;
+}
+
+char* FaultInjectionMemoryAllocator::alloc_memory(size_t size, const char* file, int line)
+{
+    if (schedule_->shouldFail(size, file, line)) return NULL;
+    return originalAllocator_->alloc_memory(size, file, line);
+}
+
+char* FaultInjectionMemoryAllocator::realloc_memory(char* memory, size_t size, const char* file, int line)
+{
+    if (schedule_->shouldFail(size, file, line)) return NULL;
+    return originalAllocator_->realloc_memory(memory, size, file, line);
+}
+
+void FaultInjectionMemoryAllocator::free_memory(char* memory, const char* file, int line)
+{
+    originalAllocator_->free_memory(memory, file, line);
+}
+
+const char* FaultInjectionMemoryAllocator::name()
+{
+    return originalAllocator_->name();
+}
+
+const char* FaultInjectionMemoryAllocator::alloc_name()
+{
+    return originalAllocator_->alloc_name();
+}
+
+const char* FaultInjectionMemoryAllocator::free_name()
+{
+    return originalAllocator_->free_name();
+}
+
+char* FaultInjectionMemoryAllocator::allocMemoryLeakNode(size_t size)
+{
+    return originalAllocator_->allocMemoryLeakNode(size);
+}
+
+void FaultInjectionMemoryAllocator::freeMemoryLeakNode(char* memory)
+{
+    originalAllocator_->freeMemoryLeakNode(memory);
+}
 
 char* NullUnknownAllocator::alloc_memory(size_t /*size*/, const char*, int)
 {
@@ -45,7 +45,7 @@ TestOutput::WorkingEnvironment TestOutput::getWorkingEnvironment()
 
 
 TestOutput::TestOutput() :
-    dotCount_(0), verbose_(false), color_(false), progressIndication_(".")
+    dotCount_(0), verbose_(false), peakMemory_(false), color_(false), progressIndication_(".")
 {
 }
 
@@ -58,6 +58,12 @@ void TestOutput::verbose()
     verbose_ = true;
 }
 
+/* With verbose, each test also gets the peak of its memory use */
+void TestOutput::peakMemory()
+{
+    peakMemory_ = true;
+}
+
 void TestOutput::color()
 {
     color_ = true;
@@ -107,7 +113,15 @@ void TestOutput::printCurrentTestEnded(const TestResult& res)
     if (verbose_) {
         print(" - ");
         print(res.getCurrentTestTotalExecutionTime());
-        print(" ms\n");
+        print(" ms");
+        if (peakMemory_ && res.getCurrentTestPeakMemory() > 0) {
+            print(", peak ");
+            print((long) res.getCurrentTestPeakMemory());
+            print(" bytes in ");
+            print((long) res.getCurrentTestPeakBlocks());
+            print(" blocks");
+        }
+        print("\n");
     }
     else {
         printProgressIndicator();
@@ -158,12 +172,20 @@ void TestOutput::printTestsEnded(const TestResult& result)
     print(" tests, ");
     print(result.getRunCount());
     print(" ran, ");
+    if (result.getRerunCount()) {
+        print(result.getRerunCount());
+        print(" reruns, ");
+    }
     print(result.getCheckCount());
     print(" checks, ");
     print(result.getIgnoredCount());
     print(" ignored, ");
     print(result.getFilteredOutCount());
     print(" filtered out, ");
+    if (result.getPassedBeforeCount()) {
+        print(result.getPassedBeforeCount());
+        print(" passed before, ");
+    }
     print(result.getTotalExecutionTime());
     print(" ms)");
     if (color_) {
@@ -262,6 +284,75 @@ void ConsoleTestOutput::flush()
     PlatformSpecificFlush();
 }
 
+BufferedConsoleTestOutput* BufferedConsoleTestOutput::latestOutput_ = NULL;
+
+BufferedConsoleTestOutput::BufferedConsoleTestOutput(size_t bufferSize)
+    : buffer_(new char[bufferSize]), bufferSize_(bufferSize), bufferUsed_(0), previousOutput_(latestOutput_)
+{
+    latestOutput_ = this;
+}
+
+BufferedConsoleTestOutput::~BufferedConsoleTestOutput()
+{
+    flush();
+
+    BufferedConsoleTestOutput** link = &latestOutput_;
+    while (*link && *link != this) link = &(*link)->previousOutput_;
+    if (*link) *link = previousOutput_;
+
+    delete [] buffer_;
+}
+
+void BufferedConsoleTestOutput::printTestsEnded(const TestResult& result)
+{
+    ConsoleTestOutput::printTestsEnded(result);
+    flush();
+}
+
+void BufferedConsoleTestOutput::print(const TestFailure& failure)
+{
+    ConsoleTestOutput::print(failure);
+    flush();
+}
+
+void BufferedConsoleTestOutput::printBuffer(const char* s)
+{
+    size_t length = SimpleString::StrLen(s);
+
+    if (bufferUsed_ + length > bufferSize_)
+        flush();
+
+    if (length > bufferSize_) {
+        PlatformSpecificFlush();
+        PlatformSpecificWrite(s, length);
+        return;
+    }
+
+    PlatformSpecificMemCpy(buffer_ + bufferUsed_, s, length);
+    bufferUsed_ += length;
+}
+
+/* Text that went through stdio goes out first, so it stays in front of the block */
+void BufferedConsoleTestOutput::flush()
+{
+    if (bufferUsed_ == 0) return;
+
+    PlatformSpecificFlush();
+    writeBuffer();
+}
+
+void BufferedConsoleTestOutput::writeBuffer()
+{
+    PlatformSpecificWrite(buffer_, bufferUsed_);
+    bufferUsed_ = 0;
+}
+
+void BufferedConsoleTestOutput::writeLatestBuffer()
+{
+    if (latestOutput_ && latestOutput_->bufferUsed_ != 0)
+        latestOutput_->writeBuffer();
+}
+
 StringBufferTestOutput::~StringBufferTestOutput()
 {
 }
@@ -331,6 +422,12 @@ void CompositeTestOutput::verbose()
   if (outputTwo_) outputTwo_->verbose();
 }
 
+void CompositeTestOutput::peakMemory()
+{
+  if (outputOne_) outputOne_->peakMemory();
+  if (outputTwo_) outputTwo_->peakMemory();
+}
+
 void CompositeTestOutput::color()
 {
   if (outputOne_) outputOne_->color();
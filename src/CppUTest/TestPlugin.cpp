@@ -60,6 +60,18 @@ void TestPlugin::runAllPostTestAction(UtestShell& test, TestResult& result)
     if (enabled_) postTestAction(test, result);
 }
 
+void TestPlugin::runAllPreTestGroupFixtureAction(TestGroupFixtureShell& fixture, TestResult& result)
+{
+    if (enabled_) preTestGroupFixtureAction(fixture, result);
+    next_->runAllPreTestGroupFixtureAction(fixture, result);
+}
+
+void TestPlugin::runAllPostTestGroupFixtureAction(TestGroupFixtureShell& fixture, TestResult& result)
+{
+    next_->runAllPostTestGroupFixtureAction(fixture, result);
+    if (enabled_) postTestGroupFixtureAction(fixture, result);
+}
+
 bool TestPlugin::parseAllArguments(int ac, char** av, int index)
 {
     return parseAllArguments(ac, const_cast<const char**> (av), index);
@@ -171,3 +183,11 @@ void NullTestPlugin::runAllPreTestAction(UtestShell&, TestResult&)
 void NullTestPlugin::runAllPostTestAction(UtestShell&, TestResult&)
 {
 }
+
+void NullTestPlugin::runAllPreTestGroupFixtureAction(TestGroupFixtureShell&, TestResult&)
+{
+}
+
+void NullTestPlugin::runAllPostTestGroupFixtureAction(TestGroupFixtureShell&, TestResult&)
+{
+}
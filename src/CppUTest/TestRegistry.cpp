@@ -27,9 +27,11 @@
 
 #include "CppUTest/TestHarness.h"
 #include "CppUTest/TestRegistry.h"
+#include "CppUTest/TestJournal.h"
+#include "CppUTest/AllocationFailureRunner.h"
 
 TestRegistry::TestRegistry() :
-    tests_(NULL), nameFilters_(NULL), groupFilters_(NULL), firstPlugin_(NullTestPlugin::instance()), runInSeperateProcess_(false), currentRepetition_(0)
+    tests_(NULL), descriptors_(NULL), groupFixtures_(NULL), nameFilters_(NULL), groupFilters_(NULL), firstPlugin_(NullTestPlugin::instance()), runInSeperateProcess_(false), currentRepetition_(0), shuffleSeed_(0), journal_(NULL), allocationFailureRunner_(NULL), linkedInDescriptorsBegin_(NULL), linkedInDescriptorsEnd_(NULL)
 
 {
 }
@@ -43,12 +45,171 @@ void TestRegistry::addTest(UtestShell *test)
     tests_ = test->addTest(tests_);
 }
 
+void TestRegistry::addTestBefore(UtestShell* test, UtestShell* next)
+{
+    if (tests_ == next)
+        tests_ = test->addTest(tests_);
+    else {
+        getTestWithNext(next)->addTest(test);
+        test->addTest(next);
+    }
+    moveTestDescriptorsRunningBefore(next, test);
+}
+
+void TestRegistry::addTestDescriptor(TestDescriptor* descriptor)
+{
+    descriptor->next = descriptors_;
+    descriptor->runsBefore = tests_;
+    descriptor->installedShell = NULL;
+    descriptors_ = descriptor;
+}
+
+/*
+ * The descriptors of a file are added in the order of their lines, even when they are given in reverse. Each one
+ * runs before the test of its file, such as a TEST_P of its group, that was added last before its line, so a group
+ * that mixes descriptors and installed tests still runs as one. The descriptors of a file without added tests run
+ * before the newest test of the files before it. Tests that keep their order were not added in front and sit behind
+ * all others, so they are left out.
+ */
+void TestRegistry::addTestDescriptors(TestDescriptor* const* begin, TestDescriptor* const* end)
+{
+    UtestShell* runsBefore = firstTestKeepingItsOrder();
+    while (begin < end) {
+        TestDescriptor* const* endOfFile = begin + 1;
+        while (endOfFile < end && SimpleString::StrCmp((*endOfFile)->fileName, (*begin)->fileName) == 0)
+            endOfFile++;
+
+        bool descending = (*begin)->lineNumber > endOfFile[-1]->lineNumber;
+        UtestShell* newestOfFile = newestTestOfFile((*begin)->fileName);
+        for (TestDescriptor* const* position = begin; position < endOfFile; position++) {
+            TestDescriptor* descriptor = (descending) ? *(endOfFile - 1 - (position - begin)) : *position;
+            if (newestOfFile) runsBefore = testAddedBefore(*descriptor);
+            addTestDescriptor(descriptor);
+            descriptor->runsBefore = runsBefore;
+        }
+        if (newestOfFile) runsBefore = newestOfFile;
+        begin = endOfFile;
+    }
+}
+
+/* The descriptors in the linker section are only added once the installers of the other tests have run */
+void TestRegistry::addLinkedInTestDescriptors()
+{
+    TestDescriptor* const* begin = linkedInDescriptorsBegin_;
+    TestDescriptor* const* end = linkedInDescriptorsEnd_;
+    linkedInDescriptorsBegin_ = linkedInDescriptorsEnd_ = NULL;
+    if (begin < end) addTestDescriptors(begin, end);
+}
+
+UtestShell* TestRegistry::firstTestKeepingItsOrder() const
+{
+    for (UtestShell* test = tests_; test != NULL; test = test->getNext())
+        if (test->keepsItsOrder()) return test;
+    return NULL;
+}
+
+UtestShell* TestRegistry::newestTestOfFile(const char* fileName) const
+{
+    for (UtestShell* test = tests_; test != NULL; test = test->getNext())
+        if (!test->keepsItsOrder() && test->getFile() == fileName) return test;
+    return NULL;
+}
+
+/* Tests are kept newest first, so the tests of a file come with their highest line first */
+UtestShell* TestRegistry::testAddedBefore(const TestDescriptor& descriptor) const
+{
+    UtestShell* oldestOfFile = NULL;
+    for (UtestShell* test = tests_; test != NULL; test = test->getNext()) {
+        if (test->keepsItsOrder() || test->getFile() != descriptor.fileName) continue;
+        if (test->getLineNumber() <= descriptor.lineNumber) return test;
+        oldestOfFile = test;
+    }
+    return (oldestOfFile) ? oldestOfFile->getNext() : NULL;
+}
+
+void TestRegistry::unDoLastAddTestDescriptor()
+{
+    descriptors_ = descriptors_ ? descriptors_->next : NULL;
+}
+
+void TestRegistry::addTestGroupFixture(TestGroupFixtureInstaller* fixture)
+{
+    groupFixtures_ = fixture->addTestGroupFixture(groupFixtures_);
+}
+
+void TestRegistry::moveTestDescriptorsRunningBefore(UtestShell* test, UtestShell* newTest)
+{
+    for (TestDescriptor* descriptor = descriptors_; descriptor != NULL; descriptor = descriptor->next)
+        if (descriptor->runsBefore == test) descriptor->runsBefore = newTest;
+}
+
+static TestDescriptor* nextTestDescriptorWithShell(TestDescriptor* descriptor)
+{
+    while (descriptor && descriptor->installedShell == NULL)
+        descriptor = descriptor->next;
+    return descriptor;
+}
+
+/*
+ * The shell of a test from a descriptor goes where it would have been had it been installed right away:
+ * in front of the test it runs before, and behind the shells of the descriptors installed after it.
+ * Descriptors and tests are both kept newest first, so one walk along the two finds every place.
+ */
+void TestRegistry::addTestsFromDescriptors(const TestFilter* groupFilters, const TestFilter* nameFilters)
+{
+    addLinkedInTestDescriptors();
+    UtestShell* previous = NULL;
+    UtestShell* current = tests_;
+    TestDescriptor* nextWithShell = nextTestDescriptorWithShell(descriptors_);
+
+    for (TestDescriptor* descriptor = descriptors_; descriptor != NULL; descriptor = descriptor->next) {
+        if (descriptor == nextWithShell) {
+            while (current && current != descriptor->installedShell) {
+                previous = current;
+                current = current->getNext();
+            }
+            if (current) {
+                previous = current;
+                current = current->getNext();
+            }
+            nextWithShell = nextTestDescriptorWithShell(descriptor->next);
+        }
+        else if (descriptor->shouldRun(groupFilters, nameFilters)) {
+            UtestShell* stop = (nextWithShell) ? nextWithShell->installedShell : NULL;
+            while (current && current != descriptor->runsBefore && current != stop) {
+                previous = current;
+                current = current->getNext();
+            }
+            descriptor->installedShell = &descriptor->getShell();
+            UtestShell* shell = descriptor->installedShell->addTest(current);
+            if (previous) previous->addTest(shell);
+            else tests_ = shell;
+            previous = shell;
+        }
+    }
+}
+
 void TestRegistry::runAllTests(TestResult& result)
 {
+    addTestsFromDescriptors(groupFilters_, nameFilters_);
+
     bool groupStart = true;
+    bool groupIsSetUp = false;
+    bool groupSetupPassed = true;
+    UtestShell** shuffled = (shuffleSeed_) ? createShuffledOrder() : NULL;
+    size_t position = 0;
 
     result.testsStarted();
-    for (UtestShell *test = tests_; test != NULL; test = test->getNext()) {
+    for (TestDescriptor* descriptor = descriptors_; descriptor != NULL; descriptor = descriptor->next) {
+        if (descriptor->installedShell == NULL) {
+            result.countTest();
+            result.countFilteredOut();
+        }
+    }
+
+    UtestShell* next;
+    for (UtestShell *test = (shuffled) ? shuffled[0] : tests_; test != NULL; test = next) {
+        next = (shuffled) ? shuffled[++position] : test->getNext();
         if (runInSeperateProcess_) test->setRunInSeperateProcess();
 
         if (groupStart) {
@@ -56,24 +217,230 @@ void TestRegistry::runAllTests(TestResult& result)
             groupStart = false;
         }
 
-        result.countTest();
-        if (testShouldRun(test, result)) {
-            result.currentTestStarted(test);
-            test->runOneTest(firstPlugin_, result);
-            result.currentTestEnded(test);
+        for (size_t row = 0; row < test->countRows(); row++) {
+            test->selectRow(row);
+            result.countTest();
+            if (testShouldRun(test, result)) {
+                if (!groupIsSetUp) {
+                    groupSetupPassed = runTestGroupFixture(test, true, result);
+                    groupIsSetUp = true;
+                }
+                if (!groupSetupPassed) {
+                    skipTestOfFailedGroupSetup(test, result);
+                    continue;
+                }
+
+                if (journal_)
+                    runOneTestWithJournal(test, result);
+                else {
+                    result.currentTestStarted(test);
+                    runOneTest(test, result);
+                    result.currentTestEnded(test);
+                }
+            }
         }
 
-        if (endOfGroup(test)) {
+        if (endOfGroup(test, next)) {
+            if (groupIsSetUp) runTestGroupFixture(test, false, result);
+            groupIsSetUp = false;
             groupStart = true;
             result.currentGroupEnded(test);
         }
     }
     result.testsEnded();
     currentRepetition_++;
+
+    if (shuffled) {
+        delete [] shuffled;
+        shuffleSeed_ = (shuffleSeed_ * 69069UL + 1) & 0xFFFFFFFFUL;
+        if (shuffleSeed_ == 0) shuffleSeed_ = 1;
+    }
+}
+
+/*
+ * A group with a TEST_GROUP_SETUP or TEST_GROUP_TEARDOWN runs both, once for every run of its tests.
+ * When the setup fails, the tests of the group are not run. The plugins' group fixture actions
+ * run around both, so the leak detector keeps what the setup allocates apart from the tests.
+ */
+bool TestRegistry::runTestGroupFixture(UtestShell* test, bool isSetup, TestResult& result)
+{
+    SimpleString group = test->getGroup();
+    TestGroupFixtureInstaller* found = NULL;
+    for (TestGroupFixtureInstaller* fixture = groupFixtures_; fixture != NULL; fixture = fixture->getNext()) {
+        if (SimpleString::StrCmp(group.asCharString(), fixture->getGroupName()) != 0) continue;
+        if (found == NULL || fixture->hasFixture(isSetup)) found = fixture;
+        if (found->hasFixture(isSetup)) break;
+    }
+    if (found == NULL) return true;
+
+    TestGroupFixtureShell* shell = found->createFixtureShell(isSetup);
+    firstPlugin_->runAllPreTestGroupFixtureAction(*shell, result);
+    bool passed = shell->runFixture(result);
+    firstPlugin_->runAllPostTestGroupFixtureAction(*shell, result);
+    delete shell;
+    return passed;
+}
+
+/*
+ * A test that is not run because the setup of its group failed is reported as ignored, with the reason.
+ * The journal records it as skipped, so a resumed run runs it again.
+ */
+void TestRegistry::skipTestOfFailedGroupSetup(UtestShell* test, TestResult& result)
+{
+    SimpleString group = test->getGroup();
+    SimpleString name = test->getName();
+    SimpleString file = test->getFile();
+    IgnoredUtestShell skipped(group.asCharString(), name.asCharString(), file.asCharString(), test->getLineNumber());
+
+    result.currentTestStarted(&skipped);
+    result.print(StringFromFormat("\n%s:%d Not run, because TEST_GROUP_SETUP(%s) failed\n",
+        file.asCharString(), test->getLineNumber(), group.asCharString()).asCharString());
+    result.countIgnored();
+    if (journal_) journal_->testSkipped(skipped);
+    result.currentTestEnded(&skipped);
+}
+
+static const unsigned long largestShuffleValue = 0xFFFFFFFFUL;
+
+static unsigned long nextShuffleRandom(unsigned long& state)
+{
+    state ^= (state << 13) & largestShuffleValue;
+    state ^= state >> 17;
+    state ^= (state << 5) & largestShuffleValue;
+    return state;
+}
+
+static void shuffleIndexes(size_t* indexes, size_t count, unsigned long& state)
+{
+    for (size_t i = count; i > 1; i--) {
+        size_t j = (size_t) (nextShuffleRandom(state) % i);
+        size_t index = indexes[i - 1];
+        indexes[i - 1] = indexes[j];
+        indexes[j] = index;
+    }
+}
+
+/*
+ * The tests of a group are run together, so every group is still set up and ended once. Groups with
+ * tests that keep their order are not shuffled inside, and keep their order among each other.
+ * The group of each test is found through a hash table of the group names.
+ */
+UtestShell** TestRegistry::createShuffledOrder()
+{
+    size_t count = 0;
+    for (UtestShell* test = tests_; test != NULL; test = test->getNext())
+        count++;
+
+    UtestShell** registered = new UtestShell*[count + 1];
+    size_t* groupOfTest = new size_t[count + 1];
+    SimpleString* groupNames = new SimpleString[count + 1];
+    size_t* groupStarts = new size_t[count + 2];
+    bool* groupKeepsItsOrder = new bool[count + 1];
+    size_t groupCount = 0;
+
+    size_t tableSize = 1;
+    while (tableSize < 2 * (count + 1)) tableSize *= 2;
+    size_t* groupTable = new size_t[tableSize];
+    for (size_t slot = 0; slot < tableSize; slot++)
+        groupTable[slot] = 0;
+
+    size_t i = 0;
+    for (UtestShell* test = tests_; test != NULL; test = test->getNext(), i++) {
+        SimpleString name = test->getGroup();
+        size_t slot = SimpleString::StrHash(name.asCharString()) & (tableSize - 1);
+        while (groupTable[slot] && groupNames[groupTable[slot] - 1] != name)
+            slot = (slot + 1) & (tableSize - 1);
+        if (groupTable[slot] == 0) {
+            groupNames[groupCount] = name;
+            groupKeepsItsOrder[groupCount] = false;
+            groupStarts[groupCount++] = 0;
+            groupTable[slot] = groupCount;
+        }
+        size_t group = groupTable[slot] - 1;
+        if (test->keepsItsOrder()) groupKeepsItsOrder[group] = true;
+        groupStarts[group]++;
+        groupOfTest[i] = group;
+        registered[i] = test;
+    }
+
+    size_t start = 0;
+    for (size_t group = 0; group <= groupCount; group++) {
+        size_t size = (group < groupCount) ? groupStarts[group] : 0;
+        groupStarts[group] = start;
+        start += size;
+    }
+
+    size_t* testOrder = new size_t[count + 1];
+    size_t* groupFill = new size_t[groupCount + 1];
+    for (size_t group = 0; group < groupCount; group++)
+        groupFill[group] = groupStarts[group];
+    for (i = 0; i < count; i++)
+        testOrder[groupFill[groupOfTest[i]]++] = i;
+
+    unsigned long state = shuffleSeed_ & largestShuffleValue;
+    if (state == 0) state = 1;
+
+    size_t* groupOrder = new size_t[groupCount + 1];
+    for (size_t group = 0; group < groupCount; group++) {
+        groupOrder[group] = group;
+        if (!groupKeepsItsOrder[group])
+            shuffleIndexes(testOrder + groupStarts[group], groupStarts[group + 1] - groupStarts[group], state);
+    }
+    shuffleIndexes(groupOrder, groupCount, state);
+
+    size_t nextGroupKeepingItsOrder = 0;
+    for (size_t slot = 0; slot < groupCount; slot++) {
+        if (!groupKeepsItsOrder[groupOrder[slot]]) continue;
+        while (!groupKeepsItsOrder[nextGroupKeepingItsOrder]) nextGroupKeepingItsOrder++;
+        groupOrder[slot] = nextGroupKeepingItsOrder++;
+    }
+
+    UtestShell** shuffled = new UtestShell*[count + 1];
+    size_t position = 0;
+    for (size_t slot = 0; slot < groupCount; slot++)
+        for (size_t test = groupStarts[groupOrder[slot]]; test < groupStarts[groupOrder[slot] + 1]; test++)
+            shuffled[position++] = registered[testOrder[test]];
+    shuffled[count] = NULL;
+
+    delete [] groupOrder;
+    delete [] groupFill;
+    delete [] testOrder;
+    delete [] groupKeepsItsOrder;
+    delete [] groupTable;
+    delete [] groupStarts;
+    delete [] groupNames;
+    delete [] groupOfTest;
+    delete [] registered;
+    return shuffled;
+}
+
+void TestRegistry::runOneTestWithJournal(UtestShell* test, TestResult& result)
+{
+    result.currentTestStarted(test);
+    if (journal_->hasCrashedBefore(*test)) {
+        result.addFailure(TestFailure(test, "Test crashed in a previous run and is not run again"));
+        journal_->testCrashedBefore(*test);
+    }
+    else {
+        int failuresBeforeTest = result.getFailureCount();
+        journal_->testStarted(*test);
+        runOneTest(test, result);
+        journal_->testEnded(*test, result.getFailureCount() != failuresBeforeTest);
+    }
+    result.currentTestEnded(test);
+}
+
+void TestRegistry::runOneTest(UtestShell* test, TestResult& result)
+{
+    if (allocationFailureRunner_)
+        allocationFailureRunner_->runOneTest(*test, firstPlugin_, result);
+    else
+        test->runOneTest(firstPlugin_, result);
 }
 
 void TestRegistry::listTestGroupNames(TestResult& result)
 {
+    addTestsFromDescriptors(NULL, NULL);
     SimpleString groupList;
 
     for (UtestShell *test = tests_; test != NULL; test = test->getNext()) {
@@ -97,20 +464,24 @@ void TestRegistry::listTestGroupNames(TestResult& result)
 
 void TestRegistry::listTestGroupAndCaseNames(TestResult& result)
 {
+    addTestsFromDescriptors(groupFilters_, nameFilters_);
     SimpleString groupAndNameList;
 
     for (UtestShell *test = tests_; test != NULL; test = test->getNext()) {
-        if (testShouldRun(test, result)) {
-            SimpleString groupAndName;
-            groupAndName += "#";
-            groupAndName += test->getGroup();
-            groupAndName += ".";
-            groupAndName += test->getName();
-            groupAndName += "#";
-
-            if (!groupAndNameList.contains(groupAndName)) {
-                groupAndNameList += groupAndName;
-                groupAndNameList += " ";
+        for (size_t row = 0; row < test->countRows(); row++) {
+            test->selectRow(row);
+            if (testShouldRun(test, result)) {
+                SimpleString groupAndName;
+                groupAndName += "#";
+                groupAndName += test->getGroup();
+                groupAndName += ".";
+                groupAndName += test->getName();
+                groupAndName += "#";
+
+                if (!groupAndNameList.contains(groupAndName)) {
+                    groupAndNameList += groupAndName;
+                    groupAndNameList += " ";
+                }
             }
         }
     }
@@ -122,21 +493,42 @@ void TestRegistry::listTestGroupAndCaseNames(TestResult& result)
     result.print(groupAndNameList.asCharString());
 }
 
-bool TestRegistry::endOfGroup(UtestShell* test)
+bool TestRegistry::endOfGroup(UtestShell* test, UtestShell* next)
 {
-    return (!test || !test->getNext() || test->getGroup() != test->getNext()->getGroup());
+    return (!test || !next || test->getGroup() != next->getGroup());
 }
 
 int TestRegistry::countTests()
 {
-    return tests_ ? tests_->countTests() : 0;
+    addLinkedInTestDescriptors();
+    int count = tests_ ? tests_->countTests() : 0;
+    for (TestDescriptor* descriptor = descriptors_; descriptor != NULL; descriptor = descriptor->next)
+        if (descriptor->installedShell == NULL) count++;
+    return count;
 }
 
 TestRegistry* TestRegistry::currentRegistry_ = 0;
 
+#if CPPUTEST_USE_TEST_DESCRIPTOR_SECTION
+/* Defined by the linker around the section, when an object of the executable has the section */
+extern "C" {
+    extern TestDescriptor* const __start_cpputest_tests[] __attribute__((weak));
+    extern TestDescriptor* const __stop_cpputest_tests[] __attribute__((weak));
+}
+#endif
+
+/* The tests in the linker section go to the default registry, when it is first used to run or list tests */
 TestRegistry* TestRegistry::getCurrentRegistry()
 {
     static TestRegistry registry;
+#if CPPUTEST_USE_TEST_DESCRIPTOR_SECTION
+    static bool linkedInTestsAdded = false;
+    if (!linkedInTestsAdded) {
+        linkedInTestsAdded = true;
+        registry.linkedInDescriptorsBegin_ = __start_cpputest_tests;
+        registry.linkedInDescriptorsEnd_ = __stop_cpputest_tests;
+    }
+#endif
     return (currentRegistry_ == 0) ? &registry : currentRegistry_;
 }
 
@@ -147,8 +539,9 @@ void TestRegistry::setCurrentRegistry(TestRegistry* registry)
 
 void TestRegistry::unDoLastAddTest()
 {
+    UtestShell* undone = tests_;
     tests_ = tests_ ? tests_->getNext() : NULL;
-
+    moveTestDescriptorsRunningBefore(undone, tests_);
 }
 
 void TestRegistry::setNameFilters(const TestFilter* filters)
@@ -166,18 +559,42 @@ void TestRegistry::setRunTestsInSeperateProcess()
     runInSeperateProcess_ = true;
 }
 
+void TestRegistry::setJournal(TestJournal* journal)
+{
+    journal_ = journal;
+}
+
+void TestRegistry::setAllocationFailureRunner(AllocationFailureRunner* runner)
+{
+    allocationFailureRunner_ = runner;
+}
+
 int TestRegistry::getCurrentRepetition()
 {
     return currentRepetition_;
 }
 
+void TestRegistry::setShuffleSeed(unsigned long seed)
+{
+    shuffleSeed_ = seed;
+}
+
+unsigned long TestRegistry::getShuffleSeed() const
+{
+    return shuffleSeed_;
+}
+
 bool TestRegistry::testShouldRun(UtestShell* test, TestResult& result)
 {
-    if (test->shouldRun(groupFilters_, nameFilters_)) return true;
-    else {
+    if (!test->shouldRun(groupFilters_, nameFilters_)) {
         result.countFilteredOut();
         return false;
     }
+    if (journal_ && journal_->hasPassedBefore(*test)) {
+        result.countPassedBefore();
+        return false;
+    }
+    return true;
 }
 
 void TestRegistry::resetPlugins()
@@ -231,6 +648,7 @@ UtestShell* TestRegistry::getTestWithNext(UtestShell* test)
 
 UtestShell* TestRegistry::findTestWithName(const SimpleString& name)
 {
+    addTestsFromDescriptors(NULL, NULL);
     UtestShell* current = tests_;
     while (current) {
         if (current->getName() == name)
@@ -242,6 +660,7 @@ UtestShell* TestRegistry::findTestWithName(const SimpleString& name)
 
 UtestShell* TestRegistry::findTestWithGroup(const SimpleString& group)
 {
+    addTestsFromDescriptors(NULL, NULL);
     UtestShell* current = tests_;
     while (current) {
         if (current->getGroup() == group)
@@ -32,8 +32,8 @@
 #include "CppUTest/PlatformSpecificFunctions.h"
 
 TestResult::TestResult(TestOutput& p) :
-    output_(p), testCount_(0), runCount_(0), checkCount_(0), failureCount_(0), filteredOutCount_(0), ignoredCount_(0), totalExecutionTime_(0), timeStarted_(0), currentTestTimeStarted_(0),
-            currentTestTotalExecutionTime_(0), currentGroupTimeStarted_(0), currentGroupTotalExecutionTime_(0)
+    output_(p), testCount_(0), runCount_(0), rerunCount_(0), checkCount_(0), failureCount_(0), filteredOutCount_(0), passedBeforeCount_(0), ignoredCount_(0), totalExecutionTime_(0), timeStarted_(0), currentTestTimeStarted_(0),
+            currentTestTotalExecutionTime_(0), currentGroupTimeStarted_(0), currentGroupTotalExecutionTime_(0), currentTestPeakMemory_(0), currentTestPeakBlocks_(0)
 {
 }
 
@@ -57,6 +57,8 @@ void TestResult::currentTestStarted(UtestShell* test)
 {
     output_.printCurrentTestStarted(*test);
     currentTestTimeStarted_ = GetPlatformSpecificTimeInMillis();
+    currentTestPeakMemory_ = 0;
+    currentTestPeakBlocks_ = 0;
 }
 
 void TestResult::print(const char* text)
@@ -87,16 +89,33 @@ void TestResult::countRun()
     runCount_++;
 }
 
+/* A rerun of a test that ran already, which is not counted as a run */
+void TestResult::countRerun()
+{
+    rerunCount_++;
+}
+
 void TestResult::countCheck()
 {
     checkCount_++;
 }
 
+void TestResult::countChecks(int amount)
+{
+    checkCount_ += amount;
+}
+
 void TestResult::countFilteredOut()
 {
     filteredOutCount_++;
 }
 
+/* A test that is skipped when resuming, as the journal has it passing before */
+void TestResult::countPassedBefore()
+{
+    passedBeforeCount_++;
+}
+
 void TestResult::countIgnored()
 {
     ignoredCount_++;
@@ -135,3 +154,18 @@ long TestResult::getCurrentGroupTotalExecutionTime() const
     return currentGroupTotalExecutionTime_;
 }
 
+void TestResult::setCurrentTestPeakMemory(size_t bytes, size_t blocks)
+{
+    currentTestPeakMemory_ = bytes;
+    currentTestPeakBlocks_ = blocks;
+}
+
+size_t TestResult::getCurrentTestPeakMemory() const
+{
+    return currentTestPeakMemory_;
+}
+
+size_t TestResult::getCurrentTestPeakBlocks() const
+{
+    return currentTestPeakBlocks_;
+}
@@ -29,6 +29,11 @@
 #include "CppUTest/TestRegistry.h"
 #include "CppUTest/PlatformSpecificFunctions.h"
 #include "CppUTest/TestOutput.h"
+#include "CppUTest/MemoryLeakDetector.h"
+
+#if CPPUTEST_USE_STD_CPP_LIB
+#include <new>
+#endif
 
 bool doubles_equal(double d1, double d2, double threshold)
 {
@@ -118,6 +123,7 @@ extern "C" {
         UtestShell* shell = runInfo->shell_;
         TestPlugin* plugin = runInfo->plugin_;
         TestResult* result = runInfo->result_;
+        BufferedConsoleTestOutput::writeLatestBuffer();
         PlatformSpecificRunTestInASeperateProcess(shell, plugin, result);
     }
 
@@ -168,6 +174,60 @@ void UtestShell::crash()
     pleaseCrashMeRightNow();
 }
 
+static void writeCrashReport(const char* text)
+{
+    PlatformSpecificWrite(text, SimpleString::StrLen(text));
+}
+
+static void writeCrashReport(int number)
+{
+    char digits[16];
+    char* start = digits + sizeof(digits) - 1;
+    unsigned long value = (number < 0) ? (unsigned long) -(long) number : (unsigned long) number;
+
+    *start = '\0';
+    do {
+        *--start = (char) ('0' + (value % 10));
+        value /= 10;
+    } while (value);
+    if (number < 0) *--start = '-';
+    writeCrashReport(start);
+}
+
+/*
+ * Called from a signal handler, so it only writes the plain strings of the
+ * current test and does not allocate. Buffered output is written first, so
+ * the report follows the output of the tests that ran before.
+ */
+void UtestShell::reportCrashOfCurrentTest(const char* signalName)
+{
+    BufferedConsoleTestOutput::writeLatestBuffer();
+    writeCrashReport("\n");
+    if (currentTest_ == NULL) {
+        writeCrashReport("Crashed with ");
+        writeCrashReport(signalName);
+        writeCrashReport(" outside of a test\n");
+        return;
+    }
+
+    writeCrashReport(currentTest_->file_);
+    writeCrashReport(":");
+    writeCrashReport(currentTest_->lineNumber_);
+    writeCrashReport(": error: Crashed with ");
+    writeCrashReport(signalName);
+    writeCrashReport(" in TEST(");
+    writeCrashReport(currentTest_->group_);
+    writeCrashReport(", ");
+    writeCrashReport(currentTest_->name_);
+    writeCrashReport(")\n");
+}
+
+void UtestShell::reportCrashOfCurrentTestWithBacktrace(const char* signalName)
+{
+    reportCrashOfCurrentTest(signalName);
+    PlatformSpecificWriteBacktrace();
+}
+
 void UtestShell::runOneTest(TestPlugin* plugin, TestResult& result)
 {
     HelperTestRunInfo runInfo(this, plugin, &result);
@@ -188,6 +248,12 @@ void UtestShell::destroyTest(Utest* test)
 }
 
 void UtestShell::runOneTestInCurrentProcess(TestPlugin* plugin, TestResult& result)
+{
+    runTestInCurrentProcess(plugin, result, true);
+}
+
+/* A run that is not counted reruns a test that ran already */
+void UtestShell::runTestInCurrentProcess(TestPlugin* plugin, TestResult& result, bool countAsRun)
 {
     plugin->runAllPreTestAction(*this, result);
 
@@ -195,7 +261,7 @@ void UtestShell::runOneTestInCurrentProcess(TestPlugin* plugin, TestResult& resu
     UtestShell* savedTest = UtestShell::getCurrent();
     TestResult* savedResult = UtestShell::getTestResult();
 
-    result.countRun();
+    if (countAsRun) result.countRun();
     UtestShell::setTestResult(&result);
     UtestShell::setCurrentTest(this);
 
@@ -222,7 +288,21 @@ UtestShell* UtestShell::addTest(UtestShell *test)
 
 int UtestShell::countTests()
 {
-    return next_ ? next_->countTests() + 1 : 1;
+    return (int) countRows() + (next_ ? next_->countTests() : 0);
+}
+
+size_t UtestShell::countRows() const
+{
+    return 1;
+}
+
+void UtestShell::selectRow(size_t)
+{
+}
+
+bool UtestShell::keepsItsOrder() const
+{
+    return false;
 }
 
 SimpleString UtestShell::getMacroName() const
@@ -235,6 +315,11 @@ const SimpleString UtestShell::getName() const
     return SimpleString(name_);
 }
 
+const char* UtestShell::getNameAsCharString() const
+{
+    return (name_) ? name_ : "";
+}
+
 const SimpleString UtestShell::getGroup() const
 {
     return SimpleString(group_);
@@ -308,7 +393,7 @@ int UtestShell::getLineNumber() const
     return lineNumber_;
 }
 
-bool UtestShell::match(const char* target, const TestFilter* filters) const
+static bool matchesAnyFilter(const char* target, const TestFilter* filters)
 {
     if(filters == NULL) return true;
 
@@ -318,6 +403,11 @@ bool UtestShell::match(const char* target, const TestFilter* filters) const
     return false;
 }
 
+bool UtestShell::match(const char* target, const TestFilter* filters) const
+{
+    return matchesAnyFilter(target, filters);
+}
+
 bool UtestShell::shouldRun(const TestFilter* groupFilters, const TestFilter* nameFilters) const
 {
     return match(group_, groupFilters) && match(name_, nameFilters);
@@ -379,7 +469,7 @@ void UtestShell::assertCstrNoCaseEqual(const char* expected, const char* actual,
     if (actual == 0 && expected == 0) return;
     if (actual == 0 || expected == 0)
         failWith(StringEqualNoCaseFailure(this, fileName, lineNumber, expected, actual));
-    if (!SimpleString(expected).equalsNoCase(actual))
+    if (SimpleString::StrCmpNoCase(expected, actual) != 0)
         failWith(StringEqualNoCaseFailure(this, fileName, lineNumber, expected, actual));
 }
 
@@ -389,7 +479,7 @@ void UtestShell::assertCstrContains(const char* expected, const char* actual, co
     if (actual == 0 && expected == 0) return;
     if(actual == 0 || expected == 0)
     	failWith(ContainsFailure(this, fileName, lineNumber, expected, actual));
-    if (!SimpleString(actual).contains(expected))
+    if (SimpleString::StrStr(actual, expected) == 0)
     	failWith(ContainsFailure(this, fileName, lineNumber, expected, actual));
 }
 
@@ -399,7 +489,7 @@ void UtestShell::assertCstrNoCaseContains(const char* expected, const char* actu
     if (actual == 0 && expected == 0) return;
     if(actual == 0 || expected == 0)
     	failWith(ContainsFailure(this, fileName, lineNumber, expected, actual));
-    if (!SimpleString(actual).containsNoCase(expected))
+    if (SimpleString::StrStrNoCase(actual, expected) == 0)
     	failWith(ContainsFailure(this, fileName, lineNumber, expected, actual));
 }
 
@@ -448,6 +538,14 @@ void UtestShell::assertBitsEqual(unsigned long expected, unsigned long actual, u
         failWith(BitsEqualFailure(this, fileName, lineNumber, expected, actual, mask, byteCount), testTerminator);
 }
 
+void UtestShell::assertPeakMemoryBelow(size_t limit, const char *fileName, int lineNumber, const TestTerminator& testTerminator)
+{
+    getTestResult()->countCheck();
+    MemoryLeakDetector* detector = MemoryLeakWarningPlugin::getGlobalDetector();
+    if (detector->getPeakMemoryInUse() >= limit)
+        failWith(PeakMemoryFailure(this, fileName, lineNumber, limit, detector->getPeakMemoryInUse(), detector->getPeakBlocksInUse()), testTerminator);
+}
+
 void UtestShell::assertEquals(bool failed, const char* expected, const char* actual, const char* file, int line, const TestTerminator& testTerminator)
 {
     getTestResult()->countCheck();
@@ -474,9 +572,25 @@ void UtestShell::print(const SimpleString& text, const char* fileName, int lineN
 
 TestResult* UtestShell::testResult_ = NULL;
 UtestShell* UtestShell::currentTest_ = NULL;
+int UtestShell::passedChecks_ = 0;
+
+static int takePassedChecks(int& counter)
+{
+#ifdef CPPUTEST_ATOMIC_TAKE
+    return CPPUTEST_ATOMIC_TAKE(counter);
+#else
+    int passedChecks = counter;
+    counter = 0;
+    return passedChecks;
+#endif
+}
 
+/* The counter is taken in one exchange, so checks that other threads pass meanwhile go to the next result */
 void UtestShell::setTestResult(TestResult* result)
 {
+    int passedChecks = takePassedChecks(passedChecks_);
+    if (passedChecks)
+        getTestResult()->countChecks(passedChecks);
     testResult_ = result;
 }
 
@@ -516,6 +630,24 @@ Utest::~Utest()
 
 #if CPPUTEST_USE_STD_CPP_LIB
 
+class ContinueTestTerminator : public TestTerminator
+{
+public:
+    virtual void exitCurrentTest() const _override
+    {
+    }
+};
+
+/* A std::bad_alloc that escapes the test, for example one caused by a
+ * FaultInjectionMemoryAllocator, fails the test instead of ending the run. */
+static void failOnUnexpectedBadAlloc()
+{
+    PlatformSpecificRestoreJumpBuffer();
+    UtestShell* current = UtestShell::getCurrent();
+    current->failWith(FailFailure(current, current->getFile().asCharString(), current->getLineNumber(),
+        "Unexpected std::bad_alloc was thrown (out of memory)"), ContinueTestTerminator());
+}
+
 void Utest::run()
 {
     try {
@@ -527,6 +659,10 @@ void Utest::run()
     {
         PlatformSpecificRestoreJumpBuffer();
     }
+    catch (std::bad_alloc&)
+    {
+        failOnUnexpectedBadAlloc();
+    }
 
     try {
         PlatformSpecificSetJmp(helperDoTestTeardown, this);
@@ -535,6 +671,10 @@ void Utest::run()
     {
         PlatformSpecificRestoreJumpBuffer();
     }
+    catch (std::bad_alloc&)
+    {
+        failOnUnexpectedBadAlloc();
+    }
 
 }
 #else
@@ -641,6 +781,106 @@ void IgnoredUtestShell::runOneTest(TestPlugin* /* plugin */, TestResult& result)
     result.countIgnored();
 }
 
+////////////// ParameterizedUtestShell ////////////
+
+ParameterizedUtestShell::ParameterizedUtestShell(const char* testName, size_t rowCount) :
+    baseName_(testName), rowCount_(rowCount), currentRow_(0)
+{
+}
+
+ParameterizedUtestShell::~ParameterizedUtestShell()
+{
+}
+
+size_t ParameterizedUtestShell::countRows() const
+{
+    return rowCount_;
+}
+
+void ParameterizedUtestShell::selectRow(size_t row)
+{
+    currentRow_ = row;
+    rowName_ = StringFromFormat("%s/%lu", baseName_, (unsigned long) row);
+    setTestName(rowName_.asCharString());
+}
+
+size_t ParameterizedUtestShell::getCurrentRow() const
+{
+    return currentRow_;
+}
+
+SimpleString ParameterizedUtestShell::getMacroName() const
+{
+    return "TEST_P";
+}
+
+////////////// TestGroupFixtureShell ////////////
+
+class TestGroupFixtureTest : public Utest
+{
+public:
+    TestGroupFixtureTest(void (*fixture)()) : fixture_(fixture)
+    {
+    }
+    void testBody()
+    {
+        if (fixture_) fixture_();
+    }
+private:
+    void (*fixture_)();
+};
+
+TestGroupFixtureShell::TestGroupFixtureShell(const char* groupName, bool isSetup, void (*fixture)(), const char* fileName, int lineNumber) :
+    UtestShell(groupName, isSetup ? "setup" : "teardown", fileName, lineNumber), isSetup_(isSetup), fixture_(fixture)
+{
+}
+
+TestGroupFixtureShell::~TestGroupFixtureShell()
+{
+}
+
+bool TestGroupFixtureShell::isSetup() const
+{
+    return isSetup_;
+}
+
+bool TestGroupFixtureShell::runFixture(TestResult& result)
+{
+    UtestShell* savedTest = UtestShell::getCurrent();
+    TestResult* savedResult = UtestShell::getTestResult();
+    int failuresBefore = result.getFailureCount();
+
+    Utest* fixture = createTest();
+    UtestShell::setTestResult(&result);
+    UtestShell::setCurrentTest(this);
+
+    fixture->run();
+
+    UtestShell::setCurrentTest(savedTest);
+    UtestShell::setTestResult(savedResult);
+    destroyTest(fixture);
+
+    return result.getFailureCount() == failuresBefore;
+}
+
+Utest* TestGroupFixtureShell::createTest()
+{
+    return new TestGroupFixtureTest(fixture_);
+}
+
+SimpleString TestGroupFixtureShell::getFormattedName() const
+{
+    SimpleString formattedName(getMacroName());
+    formattedName += "(";
+    formattedName += getGroup();
+    formattedName += ")";
+    return formattedName;
+}
+
+SimpleString TestGroupFixtureShell::getMacroName() const
+{
+    return isSetup_ ? "TEST_GROUP_SETUP" : "TEST_GROUP_TEARDOWN";
+}
 
 ////////////// TestInstaller ////////////
 
@@ -661,3 +901,74 @@ void TestInstaller::unDo()
 {
     TestRegistry::getCurrentRegistry()->unDoLastAddTest();
 }
+
+////////////// TestDescriptor ////////////
+
+bool TestDescriptor::shouldRun(const TestFilter* groupFilters, const TestFilter* nameFilters) const
+{
+    return matchesAnyFilter(groupName, groupFilters) && matchesAnyFilter(testName, nameFilters);
+}
+
+UtestShell& TestDescriptor::getShell()
+{
+    UtestShell& shell = makeShell();
+    shell.setGroupName(groupName);
+    shell.setTestName(testName);
+    shell.setFileName(fileName);
+    shell.setLineNumber(lineNumber);
+    return shell;
+}
+
+////////////// TestDescriptorInstaller ////////////
+
+TestDescriptorInstaller::TestDescriptorInstaller(TestDescriptor& descriptor)
+{
+    TestRegistry::getCurrentRegistry()->addTestDescriptor(&descriptor);
+}
+
+TestDescriptorInstaller::~TestDescriptorInstaller()
+{
+}
+
+void TestDescriptorInstaller::unDo()
+{
+    TestRegistry::getCurrentRegistry()->unDoLastAddTestDescriptor();
+}
+
+////////////// TestGroupFixtureInstaller ////////////
+
+TestGroupFixtureInstaller::TestGroupFixtureInstaller(const char* groupName, void (*setup)(), void (*teardown)(), const char* fileName, int lineNumber) :
+    groupName_(groupName), setup_(setup), teardown_(teardown), fileName_(fileName), lineNumber_(lineNumber), next_(NULL)
+{
+    TestRegistry::getCurrentRegistry()->addTestGroupFixture(this);
+}
+
+TestGroupFixtureInstaller::~TestGroupFixtureInstaller()
+{
+}
+
+TestGroupFixtureInstaller* TestGroupFixtureInstaller::addTestGroupFixture(TestGroupFixtureInstaller* next)
+{
+    next_ = next;
+    return this;
+}
+
+TestGroupFixtureInstaller* TestGroupFixtureInstaller::getNext() const
+{
+    return next_;
+}
+
+const char* TestGroupFixtureInstaller::getGroupName() const
+{
+    return groupName_;
+}
+
+bool TestGroupFixtureInstaller::hasFixture(bool isSetup) const
+{
+    return (isSetup ? setup_ : teardown_) != NULL;
+}
+
+TestGroupFixtureShell* TestGroupFixtureInstaller::createFixtureShell(bool isSetup) const
+{
+    return new TestGroupFixtureShell(groupName_, isSetup, isSetup ? setup_ : teardown_, fileName_, lineNumber_);
+}
@@ -40,6 +40,11 @@ OrderedTestShell::~OrderedTestShell()
 {
 }
 
+bool OrderedTestShell::keepsItsOrder() const
+{
+    return true;
+}
+
 int OrderedTestShell::getLevel()
 {
     return _level;
@@ -74,16 +79,7 @@ OrderedTestShell* OrderedTestShell::addOrderedTest(OrderedTestShell* test)
 
 void OrderedTestShell::addOrderedTestToHead(OrderedTestShell* test)
 {
-    TestRegistry *reg = TestRegistry::getCurrentRegistry();
-    UtestShell* head = getOrderedTestHead();
-
-    if (NULL == reg->getFirstTest() || head == reg->getFirstTest()) {
-        reg->addTest(test);
-    }
-    else {
-        reg->getTestWithNext(head)->addTest(test);
-        test->addTest(head);
-    }
+    TestRegistry::getCurrentRegistry()->addTestBefore(test, getOrderedTestHead());
 
     test->_nextOrderedTest = getOrderedTestHead();
     setOrderedTestHead(test);
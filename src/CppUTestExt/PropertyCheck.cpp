@@ -0,0 +1,483 @@
+/*
+ * Copyright (c) 2007, Michael Feathers, James Grenning and Bas Vodde
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE EARLIER MENTIONED AUTHORS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <copyright holder> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/TestOutput.h"
+#include "CppUTest/PlatformSpecificFunctions.h"
+#include "CppUTestExt/PropertyCheck.h"
+
+static const char propertyStringAlphabet[] =
+    "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 !\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~";
+
+static const unsigned long largestRandomValue = 0xFFFFFFFFUL;
+
+PropertyCase::PropertyCase() :
+    randomState_(0x9E3779B9UL), replayChoices_(NULL), replayChoiceCount_(0), describing_(false),
+    choices_(NULL), choiceCount_(0), choiceCapacity_(0),
+    arena_(NULL), arenaSize_(0), arenaUsed_(0), overflowBlocks_(NULL), overflowSize_(0)
+{
+}
+
+PropertyCase::~PropertyCase()
+{
+    resetArena();
+    delete [] arena_;
+    delete [] choices_;
+}
+
+void PropertyCase::setSeed(unsigned long seed)
+{
+    randomState_ = (seed & largestRandomValue) ? (seed & largestRandomValue) : 0x9E3779B9UL;
+}
+
+void PropertyCase::startRandomCase()
+{
+    startReplay(NULL, 0, false);
+}
+
+void PropertyCase::startReplay(const unsigned long* choices, size_t choiceCount, bool describe)
+{
+    replayChoices_ = choices;
+    replayChoiceCount_ = choiceCount;
+    describing_ = describe;
+    description_ = "";
+    choiceCount_ = 0;
+    resetArena();
+}
+
+const unsigned long* PropertyCase::getChoices() const
+{
+    return choices_;
+}
+
+size_t PropertyCase::getChoiceCount() const
+{
+    return choiceCount_;
+}
+
+SimpleString PropertyCase::getDescription() const
+{
+    return description_;
+}
+
+/* xorshift32, so a seed makes the same cases on every platform */
+unsigned long PropertyCase::nextRandom()
+{
+    randomState_ ^= (randomState_ << 13) & largestRandomValue;
+    randomState_ ^= randomState_ >> 17;
+    randomState_ ^= (randomState_ << 5) & largestRandomValue;
+    return randomState_;
+}
+
+unsigned long PropertyCase::randomValue(unsigned long bound)
+{
+    unsigned long value = nextRandom();
+    if (bound > largestRandomValue)
+        value = (((value << 16) << 16) | nextRandom());
+    if (bound == (unsigned long) -1 || bound == largestRandomValue)
+        return value;
+    return value % (bound + 1);
+}
+
+/* Random cases favour the bounds and small values, which is where most bugs are found */
+unsigned long PropertyCase::draw(unsigned long bound)
+{
+    unsigned long choice;
+    if (replayChoices_ != NULL || describing_) {
+        choice = (choiceCount_ < replayChoiceCount_) ? replayChoices_[choiceCount_] : 0;
+        if (choice > bound) choice = bound;
+    }
+    else {
+        switch (nextRandom() & 0xF) {
+        case 0: choice = bound; break;
+        case 1: choice = randomValue((bound < 16) ? bound : 16); break;
+        default: choice = randomValue(bound); break;
+        }
+    }
+    recordChoice(choice);
+    return choice;
+}
+
+void PropertyCase::recordChoice(unsigned long choice)
+{
+    if (choiceCount_ == choiceCapacity_) {
+        size_t newCapacity = (choiceCapacity_ == 0) ? 64 : choiceCapacity_ * 2;
+        unsigned long* newChoices = new unsigned long[newCapacity];
+        for (size_t i = 0; i < choiceCount_; i++)
+            newChoices[i] = choices_[i];
+        delete [] choices_;
+        choices_ = newChoices;
+        choiceCapacity_ = newCapacity;
+    }
+    choices_[choiceCount_++] = choice;
+}
+
+/*
+ * Strings and buffers come from an arena that is reused by every case. What does not fit goes
+ * into blocks of its own, and the arena grows to hold all of it when the next case starts.
+ */
+char* PropertyCase::allocate(size_t size)
+{
+    if (arenaUsed_ + size <= arenaSize_) {
+        char* memory = arena_ + arenaUsed_;
+        arenaUsed_ += size;
+        return memory;
+    }
+    char* block = new char[sizeof(char*) + size];
+    *(char**) (void*) block = overflowBlocks_;
+    overflowBlocks_ = block;
+    overflowSize_ += size;
+    return block + sizeof(char*);
+}
+
+void PropertyCase::resetArena()
+{
+    while (overflowBlocks_) {
+        char* next = *(char**) (void*) overflowBlocks_;
+        delete [] overflowBlocks_;
+        overflowBlocks_ = next;
+    }
+    if (overflowSize_) {
+        arenaSize_ = 2 * (arenaUsed_ + overflowSize_);
+        delete [] arena_;
+        arena_ = new char[arenaSize_];
+        overflowSize_ = 0;
+    }
+    arenaUsed_ = 0;
+}
+
+void PropertyCase::describe(const SimpleString& value)
+{
+    if (!description_.isEmpty()) description_ += ", ";
+    description_ += value;
+}
+
+bool PropertyCase::anyBool()
+{
+    bool value = draw(1) != 0;
+    if (describing_) describe(StringFrom(value));
+    return value;
+}
+
+int PropertyCase::anyInt(int min, int max)
+{
+    return (int) anyLong(min, max);
+}
+
+/* Values shrink towards zero, or towards the bound nearest to it */
+long PropertyCase::anyLong(long min, long max)
+{
+    long value;
+    if (min >= 0)
+        value = min + (long) draw((unsigned long) max - (unsigned long) min);
+    else if (max <= 0)
+        value = max - (long) draw((unsigned long) max - (unsigned long) min);
+    else if (draw(1) == 0)
+        value = (long) draw((unsigned long) max);
+    else
+        value = -1 - (long) draw((unsigned long) -(min + 1));
+    if (describing_) describe(StringFrom(value));
+    return value;
+}
+
+unsigned long PropertyCase::anyUnsignedLong(unsigned long max)
+{
+    unsigned long value = draw(max);
+    if (describing_) describe(StringFrom(value));
+    return value;
+}
+
+double PropertyCase::anyDouble(double min, double max)
+{
+    double fraction = (double) draw(largestRandomValue) / (double) largestRandomValue;
+    double value;
+    if (min >= 0.0)
+        value = min + fraction * (max - min);
+    else if (max <= 0.0)
+        value = max - fraction * (max - min);
+    else if (draw(1) == 0)
+        value = fraction * max;
+    else
+        value = fraction * min;
+    if (describing_) describe(StringFrom(value, 17));
+    return value;
+}
+
+size_t PropertyCase::anyIndex(size_t count)
+{
+    size_t value = (count > 1) ? (size_t) draw((unsigned long) (count - 1)) : 0;
+    if (describing_) describe(StringFromFormat("[%lu]", (unsigned long) value));
+    return value;
+}
+
+const char* PropertyCase::anyCString(size_t maxLength)
+{
+    size_t length = (size_t) draw((unsigned long) maxLength);
+    char* value = allocate(length + 1);
+    for (size_t i = 0; i < length; i++)
+        value[i] = propertyStringAlphabet[draw(sizeof(propertyStringAlphabet) - 2)];
+    value[length] = '\0';
+    if (describing_) describe(StringFromFormat("\"%s\"", value));
+    return value;
+}
+
+SimpleString PropertyCase::anyString(size_t maxLength)
+{
+    return anyCString(maxLength);
+}
+
+const unsigned char* PropertyCase::anyBytes(size_t maxLength, size_t& length)
+{
+    length = (size_t) draw((unsigned long) maxLength);
+    unsigned char* value = (unsigned char*) allocate((length) ? length : 1);
+    for (size_t i = 0; i < length; i++)
+        value[i] = (unsigned char) draw(0xFF);
+    if (describing_) describe(StringFromFormat("<%s>", StringFromBinary(value, length).asCharString()));
+    return value;
+}
+
+/* Runs one case as a test of its own, so that a failing check ends the case and not the test */
+class PropertyCaseResult : public TestResult
+{
+public:
+    PropertyCaseResult(TestOutput& output) : TestResult(output), failed_(false), failureLineNumber_(0)
+    {
+    }
+
+    virtual void addFailure(const TestFailure& failure) _override
+    {
+        if (failed_) return;
+        failed_ = true;
+        failureMessage_ = failure.getMessage();
+        failureFileName_ = failure.getFileName();
+        failureLineNumber_ = failure.getFailureLineNumber();
+    }
+
+    bool failed_;
+    SimpleString failureMessage_;
+    SimpleString failureFileName_;
+    int failureLineNumber_;
+};
+
+class PropertyCaseTest : public Utest
+{
+public:
+    PropertyCaseTest(PropertyChecker& checker) : checker_(checker)
+    {
+    }
+    virtual void testBody() _override;
+private:
+    PropertyChecker& checker_;
+};
+
+class PropertyCaseTestShell : public UtestShell
+{
+public:
+    PropertyCaseTestShell(PropertyChecker& checker) : test_(checker)
+    {
+    }
+    virtual Utest* createTest() _override
+    {
+        return &test_;
+    }
+    virtual void destroyTest(Utest*) _override
+    {
+    }
+    static void runProperty(PropertyChecker& checker)
+    {
+        checker.runProperty();
+    }
+private:
+    PropertyCaseTest test_;
+};
+
+void PropertyCaseTest::testBody()
+{
+    PropertyCaseTestShell::runProperty(checker_);
+}
+
+unsigned long PropertyChecker::defaultSeed_ = 0;
+
+void PropertyChecker::setDefaultSeed(unsigned long seed)
+{
+    defaultSeed_ = seed;
+}
+
+PropertyChecker::PropertyChecker(PropertyFunction property) :
+    property_(property), cases_(100), seed_(0), maximumShrinkRuns_(10000), caseShell_(NULL), caseResult_(NULL),
+    smallest_(NULL), smallestCount_(0), candidate_(NULL), capacity_(0), shrinkRuns_(0), shrinks_(0)
+{
+}
+
+PropertyChecker::~PropertyChecker()
+{
+    delete [] smallest_;
+    delete [] candidate_;
+}
+
+void PropertyChecker::setCases(unsigned long cases)
+{
+    cases_ = cases;
+}
+
+void PropertyChecker::setSeed(unsigned long seed)
+{
+    seed_ = seed;
+}
+
+void PropertyChecker::setMaximumShrinkRuns(unsigned long runs)
+{
+    maximumShrinkRuns_ = runs;
+}
+
+void PropertyChecker::runProperty()
+{
+    property_(propertyCase_);
+}
+
+bool PropertyChecker::runCase()
+{
+    caseResult_->failed_ = false;
+    caseShell_->runOneTestInCurrentProcess(NullTestPlugin::instance(), *caseResult_);
+    return caseResult_->failed_;
+}
+
+void PropertyChecker::check(const char* fileName, int lineNumber)
+{
+    unsigned long seed = (seed_) ? seed_ : defaultSeed_;
+    if (seed == 0) seed = ((unsigned long) GetPlatformSpecificTimeInMillis() & largestRandomValue) | 1;
+    propertyCase_.setSeed(seed);
+
+    StringBufferTestOutput output;
+    PropertyCaseResult result(output);
+    PropertyCaseTestShell shell(*this);
+    caseShell_ = &shell;
+    caseResult_ = &result;
+
+    for (unsigned long testCase = 1; testCase <= cases_; testCase++) {
+        propertyCase_.startRandomCase();
+        if (runCase()) {
+            keepSmallest(propertyCase_.getChoices(), propertyCase_.getChoiceCount());
+            shrink();
+            reportFailure(seed, testCase, fileName, lineNumber);
+            return;
+        }
+    }
+    caseShell_ = NULL;
+    caseResult_ = NULL;
+    UtestShell::getCurrent()->countCheck();
+}
+
+void PropertyChecker::keepSmallest(const unsigned long* choices, size_t count)
+{
+    if (count > capacity_) {
+        delete [] smallest_;
+        delete [] candidate_;
+        capacity_ = count;
+        smallest_ = new unsigned long[capacity_];
+        candidate_ = new unsigned long[capacity_];
+    }
+    for (size_t i = 0; i < count; i++)
+        smallest_[i] = choices[i];
+    smallestCount_ = count;
+}
+
+static bool choicesAreSmaller(const unsigned long* choices, size_t count, const unsigned long* than, size_t thanCount)
+{
+    if (count != thanCount) return count < thanCount;
+    for (size_t i = 0; i < count; i++)
+        if (choices[i] != than[i]) return choices[i] < than[i];
+    return false;
+}
+
+/* Replays the first count candidate choices and keeps them when the case still fails with less */
+bool PropertyChecker::shrinkTo(size_t count)
+{
+    if (shrinkRuns_ >= maximumShrinkRuns_) return false;
+    shrinkRuns_++;
+
+    propertyCase_.startReplay(candidate_, count, false);
+    if (!runCase()) return false;
+    if (!choicesAreSmaller(propertyCase_.getChoices(), propertyCase_.getChoiceCount(), smallest_, smallestCount_)) return false;
+
+    keepSmallest(propertyCase_.getChoices(), propertyCase_.getChoiceCount());
+    shrinks_++;
+    return true;
+}
+
+/*
+ * Shrinks the choices of the failing case by deleting runs of them and by lowering each one.
+ * Every kept candidate is smaller than the one before, so shrinking always ends.
+ */
+void PropertyChecker::shrink()
+{
+    bool shrunk = true;
+    while (shrunk && shrinkRuns_ < maximumShrinkRuns_) {
+        shrunk = false;
+
+        for (size_t run = 8; run > 0; run /= 2) {
+            for (size_t start = 0; start + run <= smallestCount_; ) {
+                size_t count = 0;
+                for (size_t i = 0; i < smallestCount_; i++)
+                    if (i < start || i >= start + run) candidate_[count++] = smallest_[i];
+                if (shrinkTo(count)) shrunk = true;
+                else start++;
+            }
+        }
+
+        for (size_t i = 0; i < smallestCount_ && shrinkRuns_ < maximumShrinkRuns_; i++) {
+            unsigned long passing = 0;
+            while (i < smallestCount_ && smallest_[i] > passing && shrinkRuns_ < maximumShrinkRuns_) {
+                unsigned long tried = (smallest_[i] - passing == 1) ? passing : passing + (smallest_[i] - passing) / 2;
+                for (size_t j = 0; j < smallestCount_; j++)
+                    candidate_[j] = smallest_[j];
+                candidate_[i] = tried;
+                if (shrinkTo(smallestCount_)) shrunk = true;
+                else if (tried == passing) break;
+                else passing = tried;
+            }
+        }
+    }
+}
+
+void PropertyChecker::reportFailure(unsigned long seed, unsigned long failingCase, const char* fileName, int lineNumber)
+{
+    propertyCase_.startReplay(smallest_, smallestCount_, true);
+    runCase();
+
+    SimpleString message = StringFromFormat("Property failed on case %lu with seed %lu, shrunk %lu times to the input:\n\t",
+        failingCase, seed, shrinks_);
+    message += propertyCase_.getDescription();
+    message += StringFromFormat("\n\twhich failed at %s:%d\n\t", caseResult_->failureFileName_.asCharString(), caseResult_->failureLineNumber_);
+    message += caseResult_->failureMessage_;
+
+    caseShell_ = NULL;
+    caseResult_ = NULL;
+    UtestShell* test = UtestShell::getCurrent();
+    test->failWith(FailFailure(test, fileName, lineNumber, message));
+}
@@ -143,9 +143,21 @@ static void C2000FClose(PlatformSpecificFile file)
    fclose((FILE*)file);
 }
 
+static char* C2000FGets(char* str, int size, PlatformSpecificFile file)
+{
+   return fgets(str, size, (FILE*)file);
+}
+
+static void C2000FFlush(PlatformSpecificFile file)
+{
+   fflush((FILE*)file);
+}
+
 PlatformSpecificFile (*PlatformSpecificFOpen)(const char* filename, const char* flag) = C2000FOpen;
 void (*PlatformSpecificFPuts)(const char* str, PlatformSpecificFile file) = C2000FPuts;
 void (*PlatformSpecificFClose)(PlatformSpecificFile file) = C2000FClose;
+char* (*PlatformSpecificFGets)(char* str, int size, PlatformSpecificFile file) = C2000FGets;
+void (*PlatformSpecificFFlush)(PlatformSpecificFile file) = C2000FFlush;
 
 static int CL2000Putchar(int c)
 {
@@ -169,8 +181,14 @@ static void CL2000Flush()
   fflush(stdout);
 }
 
+static void CL2000Write(const char* buffer, size_t size)
+{
+    while (size--) CL2000Putchar(*buffer++);
+}
+
 extern int (*PlatformSpecificPutchar)(int c) = CL2000Putchar;
 extern void (*PlatformSpecificFlush)(void) = CL2000Flush;
+extern void (*PlatformSpecificWrite)(const char* buffer, size_t size) = CL2000Write;
 
 static void* C2000Malloc(size_t size)
 {
@@ -243,4 +261,52 @@ void (*PlatformSpecificMutexLock)(PlatformSpecificMutex) = DummyMutexLock;
 void (*PlatformSpecificMutexUnlock)(PlatformSpecificMutex) = DummyMutexUnlock;
 void (*PlatformSpecificMutexDestroy)(PlatformSpecificMutex) = DummyMutexDestroy;
 
+/* Not atomic, only safe when a single thread allocates */
+static size_t DummyAtomicAdd(volatile size_t* value, size_t amount)
+{
+    *value += amount;
+    return *value;
+}
+
+size_t (*PlatformSpecificAtomicAdd)(volatile size_t*, size_t) = DummyAtomicAdd;
+
+static void DummyInstallCrashHandler(void (*)(const char*))
+{
+}
+
+static void DummyUninstallCrashHandler(void)
+{
+}
+
+static void DummyWriteBacktrace(void)
+{
+}
+
+void (*PlatformSpecificInstallCrashHandler)(void (*)(const char*)) = DummyInstallCrashHandler;
+void (*PlatformSpecificUninstallCrashHandler)(void) = DummyUninstallCrashHandler;
+void (*PlatformSpecificWriteBacktrace)(void) = DummyWriteBacktrace;
+
+static size_t DummyPageSize(void)
+{
+    return 0;
+}
+
+static void* DummyAllocatePages(size_t)
+{
+    return NULL;
+}
+
+static void DummyFreePages(void*, size_t)
+{
+}
+
+static void DummyProtectPages(void*, size_t)
+{
+}
+
+size_t (*PlatformSpecificPageSize)(void) = DummyPageSize;
+void* (*PlatformSpecificAllocatePages)(size_t) = DummyAllocatePages;
+void (*PlatformSpecificFreePages)(void*, size_t) = DummyFreePages;
+void (*PlatformSpecificProtectPages)(void*, size_t) = DummyProtectPages;
+
 }
\ No newline at end of file
@@ -44,9 +44,13 @@
 #include <signal.h>
 #ifndef __MINGW32__
 #include <sys/wait.h>
+#include <sys/mman.h>
 #include <errno.h>
 #endif
 #include <pthread.h>
+#ifdef __GLIBC__
+#include <execinfo.h>
+#endif
 
 #include "CppUTest/PlatformSpecificFunctions.h"
 
@@ -214,17 +218,56 @@ static void PlatformSpecificFCloseImplementation(PlatformSpecificFile file)
    fclose((FILE*)file);
 }
 
+static char* PlatformSpecificFGetsImplementation(char* str, int size, PlatformSpecificFile file)
+{
+   return fgets(str, size, (FILE*)file);
+}
+
+static void PlatformSpecificFFlushImplementation(PlatformSpecificFile file)
+{
+   fflush((FILE*)file);
+}
+
 static void PlatformSpecificFlushImplementation()
 {
   fflush(stdout);
 }
 
+#ifdef __MINGW32__
+
+static void PlatformSpecificWriteImplementation(const char* buffer, size_t size)
+{
+    fwrite(buffer, 1, size, stdout);
+    fflush(stdout);
+}
+
+#else
+
+/* Uses write() directly so a whole block goes out with a single system call */
+static void PlatformSpecificWriteImplementation(const char* buffer, size_t size)
+{
+    while (size > 0) {
+        ssize_t written = write(STDOUT_FILENO, buffer, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        buffer += written;
+        size -= (size_t) written;
+    }
+}
+
+#endif
+
 PlatformSpecificFile (*PlatformSpecificFOpen)(const char*, const char*) = PlatformSpecificFOpenImplementation;
 void (*PlatformSpecificFPuts)(const char*, PlatformSpecificFile) = PlatformSpecificFPutsImplementation;
 void (*PlatformSpecificFClose)(PlatformSpecificFile) = PlatformSpecificFCloseImplementation;
+char* (*PlatformSpecificFGets)(char*, int, PlatformSpecificFile) = PlatformSpecificFGetsImplementation;
+void (*PlatformSpecificFFlush)(PlatformSpecificFile) = PlatformSpecificFFlushImplementation;
 
 int (*PlatformSpecificPutchar)(int) = putchar;
 void (*PlatformSpecificFlush)() = PlatformSpecificFlushImplementation;
+void (*PlatformSpecificWrite)(const char*, size_t) = PlatformSpecificWriteImplementation;
 
 void* (*PlatformSpecificMalloc)(size_t size) = malloc;
 void* (*PlatformSpecificRealloc)(void*, size_t) = realloc;
@@ -272,4 +315,151 @@ void (*PlatformSpecificMutexLock)(PlatformSpecificMutex) = PThreadMutexLock;
 void (*PlatformSpecificMutexUnlock)(PlatformSpecificMutex) = PThreadMutexUnlock;
 void (*PlatformSpecificMutexDestroy)(PlatformSpecificMutex) = PThreadMutexDestroy;
 
+static size_t GccAtomicAdd(volatile size_t* value, size_t amount)
+{
+    return __sync_add_and_fetch(value, amount);
+}
+
+size_t (*PlatformSpecificAtomicAdd)(volatile size_t*, size_t) = GccAtomicAdd;
+
+///////////// Crash handler
+
+#ifdef __MINGW32__
+
+static void PlatformSpecificInstallCrashHandlerImplementation(void (*)(const char*))
+{
+}
+
+static void PlatformSpecificUninstallCrashHandlerImplementation()
+{
+}
+
+static void PlatformSpecificWriteBacktraceImplementation()
+{
+}
+
+#else
+
+static const int crashSignals[] = { SIGSEGV, SIGBUS, SIGFPE, SIGABRT };
+static const char* const crashSignalNames[] = { "SIGSEGV", "SIGBUS", "SIGFPE", "SIGABRT" };
+static const size_t amountOfCrashSignals = sizeof(crashSignals) / sizeof(crashSignals[0]);
+
+static void (*currentCrashHandler)(const char*) = NULL;
+static struct sigaction savedCrashActions[amountOfCrashSignals];
+static char crashHandlerStack[65536];
+
+static void CrashSignalHandler(int signalNumber)
+{
+    const char* signalName = "signal";
+    for (size_t i = 0; i < amountOfCrashSignals; i++)
+        if (crashSignals[i] == signalNumber) signalName = crashSignalNames[i];
+
+    if (currentCrashHandler) currentCrashHandler(signalName);
+
+    /* SA_RESETHAND restored the default action, so this terminates as the crash would have */
+    raise(signalNumber);
+}
+
+static void PlatformSpecificInstallCrashHandlerImplementation(void (*crashHandler)(const char*))
+{
+#ifdef __GLIBC__
+    /* The first call loads libgcc, which allocates. Do it now rather than in the signal handler */
+    void* frame;
+    backtrace(&frame, 1);
+#endif
+
+    stack_t alternativeStack;
+    alternativeStack.ss_sp = crashHandlerStack;
+    alternativeStack.ss_size = sizeof(crashHandlerStack);
+    alternativeStack.ss_flags = 0;
+    sigaltstack(&alternativeStack, NULL);
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = CrashSignalHandler;
+    action.sa_flags = (int) (SA_RESETHAND | SA_ONSTACK);
+    sigemptyset(&action.sa_mask);
+
+    currentCrashHandler = crashHandler;
+    for (size_t i = 0; i < amountOfCrashSignals; i++)
+        sigaction(crashSignals[i], &action, &savedCrashActions[i]);
+}
+
+static void PlatformSpecificUninstallCrashHandlerImplementation()
+{
+    if (currentCrashHandler == NULL) return;
+
+    for (size_t i = 0; i < amountOfCrashSignals; i++)
+        sigaction(crashSignals[i], &savedCrashActions[i], NULL);
+    currentCrashHandler = NULL;
+}
+
+static void PlatformSpecificWriteBacktraceImplementation()
+{
+#ifdef __GLIBC__
+    void* frames[64];
+    int amountOfFrames = backtrace(frames, 64);
+    backtrace_symbols_fd(frames, amountOfFrames, STDERR_FILENO);
+#endif
+}
+
+#endif
+
+void (*PlatformSpecificInstallCrashHandler)(void (*)(const char*)) = PlatformSpecificInstallCrashHandlerImplementation;
+void (*PlatformSpecificUninstallCrashHandler)() = PlatformSpecificUninstallCrashHandlerImplementation;
+void (*PlatformSpecificWriteBacktrace)() = PlatformSpecificWriteBacktraceImplementation;
+
+///////////// Page operations
+
+#ifdef __MINGW32__
+
+static size_t PlatformSpecificPageSizeImplementation()
+{
+    return 0;
+}
+
+static void* PlatformSpecificAllocatePagesImplementation(size_t)
+{
+    return NULL;
+}
+
+static void PlatformSpecificFreePagesImplementation(void*, size_t)
+{
+}
+
+static void PlatformSpecificProtectPagesImplementation(void*, size_t)
+{
+}
+
+#else
+
+static size_t PlatformSpecificPageSizeImplementation()
+{
+    long pageSize = sysconf(_SC_PAGESIZE);
+    return (pageSize > 0) ? (size_t) pageSize : 0;
+}
+
+static void* PlatformSpecificAllocatePagesImplementation(size_t size)
+{
+    void* memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    return (memory == MAP_FAILED) ? NULL : memory;
+}
+
+static void PlatformSpecificFreePagesImplementation(void* memory, size_t size)
+{
+    munmap(memory, size);
+}
+
+static void PlatformSpecificProtectPagesImplementation(void* memory, size_t size)
+{
+    mprotect(memory, size, PROT_NONE);
+}
+
+#endif
+
+size_t (*PlatformSpecificPageSize)(void) = PlatformSpecificPageSizeImplementation;
+void* (*PlatformSpecificAllocatePages)(size_t) = PlatformSpecificAllocatePagesImplementation;
+void (*PlatformSpecificFreePages)(void*, size_t) = PlatformSpecificFreePagesImplementation;
+void (*PlatformSpecificProtectPages)(void*, size_t) = PlatformSpecificProtectPagesImplementation;
+
 }
@@ -41,9 +41,12 @@ int (*PlatformSpecificWaitPid)(int, int*, int) = NULL;
 PlatformSpecificFile (*PlatformSpecificFOpen)(const char* filename, const char* flag) = NULL;
 void (*PlatformSpecificFPuts)(const char* str, PlatformSpecificFile file) = NULL;
 void (*PlatformSpecificFClose)(PlatformSpecificFile file) = NULL;
+char* (*PlatformSpecificFGets)(char* str, int size, PlatformSpecificFile file) = NULL;
+void (*PlatformSpecificFFlush)(PlatformSpecificFile file) = NULL;
 
 int (*PlatformSpecificPutchar)(int c) = NULL;
 void (*PlatformSpecificFlush)(void) = NULL;
+void (*PlatformSpecificWrite)(const char* buffer, size_t size) = NULL;
 
 /* Dynamic Memory operations */
 void* (*PlatformSpecificMalloc)(size_t) = NULL;
@@ -56,4 +59,14 @@ PlatformSpecificMutex (*PlatformSpecificMutexCreate)(void) = NULL;
 void (*PlatformSpecificMutexLock)(PlatformSpecificMutex mtx) = NULL;
 void (*PlatformSpecificMutexUnlock)(PlatformSpecificMutex mtx) = NULL;
 void (*PlatformSpecificMutexDestroy)(PlatformSpecificMutex mtx) = NULL;
+size_t (*PlatformSpecificAtomicAdd)(volatile size_t* value, size_t amount) = NULL;
+
+void (*PlatformSpecificInstallCrashHandler)(void (*crashHandler)(const char* signalName)) = NULL;
+void (*PlatformSpecificUninstallCrashHandler)(void) = NULL;
+void (*PlatformSpecificWriteBacktrace)(void) = NULL;
+
+size_t (*PlatformSpecificPageSize)(void) = NULL;
+void* (*PlatformSpecificAllocatePages)(size_t size) = NULL;
+void (*PlatformSpecificFreePages)(void* memory, size_t size) = NULL;
+void (*PlatformSpecificProtectPages)(void* memory, size_t size) = NULL;
 
@@ -100,6 +100,11 @@ int PlatformSpecificPutchar(int c) {
     return putchar(c);
 }
 
+void PlatformSpecificWrite(const char* buffer, size_t size) {
+    fwrite(buffer, 1, size, stdout);
+    fflush(stdout);
+}
+
 double PlatformSpecificFabs(double d) {
     return fabs(d);
 }
@@ -137,6 +142,14 @@ void PlatformSpecificFClose(PlatformSpecificFile file) {
     fclose((FILE*)file);
 }
 
+char* PlatformSpecificFGets(char* str, int size, PlatformSpecificFile file) {
+    return fgets(str, size, (FILE*)file);
+}
+
+void PlatformSpecificFFlush(PlatformSpecificFile file) {
+    fflush((FILE*)file);
+}
+
 extern "C" {
     
 static int IsNanImplementation(double d)
@@ -174,3 +187,51 @@ void (*PlatformSpecificMutexLock)(PlatformSpecificMutex) = DummyMutexLock;
 void (*PlatformSpecificMutexUnlock)(PlatformSpecificMutex) = DummyMutexUnlock;
 void (*PlatformSpecificMutexDestroy)(PlatformSpecificMutex) = DummyMutexDestroy;
 
+/* Not atomic, only safe when a single thread allocates */
+static size_t DummyAtomicAdd(volatile size_t* value, size_t amount)
+{
+    *value += amount;
+    return *value;
+}
+
+size_t (*PlatformSpecificAtomicAdd)(volatile size_t*, size_t) = DummyAtomicAdd;
+
+static void DummyInstallCrashHandler(void (*)(const char*))
+{
+}
+
+static void DummyUninstallCrashHandler(void)
+{
+}
+
+static void DummyWriteBacktrace(void)
+{
+}
+
+void (*PlatformSpecificInstallCrashHandler)(void (*)(const char*)) = DummyInstallCrashHandler;
+void (*PlatformSpecificUninstallCrashHandler)(void) = DummyUninstallCrashHandler;
+void (*PlatformSpecificWriteBacktrace)(void) = DummyWriteBacktrace;
+
+static size_t DummyPageSize(void)
+{
+    return 0;
+}
+
+static void* DummyAllocatePages(size_t)
+{
+    return NULL;
+}
+
+static void DummyFreePages(void*, size_t)
+{
+}
+
+static void DummyProtectPages(void*, size_t)
+{
+}
+
+size_t (*PlatformSpecificPageSize)(void) = DummyPageSize;
+void* (*PlatformSpecificAllocatePages)(size_t) = DummyAllocatePages;
+void (*PlatformSpecificFreePages)(void*, size_t) = DummyFreePages;
+void (*PlatformSpecificProtectPages)(void*, size_t) = DummyProtectPages;
+
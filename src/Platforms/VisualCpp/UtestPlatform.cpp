@@ -138,17 +138,36 @@ static void VisualCppFClose(PlatformSpecificFile file)
    fclose((FILE*)file);
 }
 
+static char* VisualCppFGets(char* str, int size, PlatformSpecificFile file)
+{
+   return fgets(str, size, (FILE*)file);
+}
+
+static void VisualCppFFlush(PlatformSpecificFile file)
+{
+   fflush((FILE*)file);
+}
+
 PlatformSpecificFile (*PlatformSpecificFOpen)(const char* filename, const char* flag) = VisualCppFOpen;
 void (*PlatformSpecificFPuts)(const char* str, PlatformSpecificFile file) = VisualCppFPuts;
 void (*PlatformSpecificFClose)(PlatformSpecificFile file) = VisualCppFClose;
+char* (*PlatformSpecificFGets)(char* str, int size, PlatformSpecificFile file) = VisualCppFGets;
+void (*PlatformSpecificFFlush)(PlatformSpecificFile file) = VisualCppFFlush;
 
 static void VisualCppFlush()
 {
   fflush(stdout);
 }
 
+static void VisualCppWrite(const char* buffer, size_t size)
+{
+  fwrite(buffer, 1, size, stdout);
+  fflush(stdout);
+}
+
 int (*PlatformSpecificPutchar)(int c) = putchar;
 void (*PlatformSpecificFlush)(void) = VisualCppFlush;
+void (*PlatformSpecificWrite)(const char* buffer, size_t size) = VisualCppWrite;
 
 static void* VisualCppMalloc(size_t size)
 {
@@ -193,3 +212,58 @@ PlatformSpecificMutex (*PlatformSpecificMutexCreate)(void) = VisualCppMutexCreat
 void (*PlatformSpecificMutexLock)(PlatformSpecificMutex) = VisualCppMutexLock;
 void (*PlatformSpecificMutexUnlock)(PlatformSpecificMutex) = VisualCppMutexUnlock;
 void (*PlatformSpecificMutexDestroy)(PlatformSpecificMutex) = VisualCppMutexDestroy;
+
+static size_t VisualCppAtomicAdd(volatile size_t* value, size_t amount)
+{
+#ifdef _WIN64
+	return (size_t) InterlockedExchangeAdd64((volatile LONGLONG*) value, (LONGLONG) amount) + amount;
+#else
+	return (size_t) InterlockedExchangeAdd((volatile LONG*) value, (LONG) amount) + amount;
+#endif
+}
+
+size_t (*PlatformSpecificAtomicAdd)(volatile size_t*, size_t) = VisualCppAtomicAdd;
+
+static void DummyInstallCrashHandler(void (*)(const char*))
+{
+}
+
+static void DummyUninstallCrashHandler(void)
+{
+}
+
+static void DummyWriteBacktrace(void)
+{
+}
+
+void (*PlatformSpecificInstallCrashHandler)(void (*)(const char*)) = DummyInstallCrashHandler;
+void (*PlatformSpecificUninstallCrashHandler)(void) = DummyUninstallCrashHandler;
+void (*PlatformSpecificWriteBacktrace)(void) = DummyWriteBacktrace;
+
+static size_t VisualCppPageSize(void)
+{
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    return systemInfo.dwPageSize;
+}
+
+static void* VisualCppAllocatePages(size_t size)
+{
+    return VirtualAlloc(NULL, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+}
+
+static void VisualCppFreePages(void* memory, size_t)
+{
+    VirtualFree(memory, 0, MEM_RELEASE);
+}
+
+static void VisualCppProtectPages(void* memory, size_t size)
+{
+    DWORD oldProtection;
+    VirtualProtect(memory, size, PAGE_NOACCESS, &oldProtection);
+}
+
+size_t (*PlatformSpecificPageSize)(void) = VisualCppPageSize;
+void* (*PlatformSpecificAllocatePages)(size_t) = VisualCppAllocatePages;
+void (*PlatformSpecificFreePages)(void*, size_t) = VisualCppFreePages;
+void (*PlatformSpecificProtectPages)(void*, size_t) = VisualCppProtectPages;
@@ -134,17 +134,36 @@ static void PlatformSpecificFCloseImplementation(PlatformSpecificFile file)
     fclose((FILE*)file);
 }
 
+static char* PlatformSpecificFGetsImplementation(char* str, int size, PlatformSpecificFile file)
+{
+    return fgets(str, size, (FILE*)file);
+}
+
+static void PlatformSpecificFFlushImplementation(PlatformSpecificFile file)
+{
+    fflush((FILE*)file);
+}
+
 static void PlatformSpecificFlushImplementation()
 {
   fflush(stdout);
 }
 
+static void PlatformSpecificWriteImplementation(const char* buffer, size_t size)
+{
+  fwrite(buffer, 1, size, stdout);
+  fflush(stdout);
+}
+
 extern "C" PlatformSpecificFile (*PlatformSpecificFOpen)(const char*, const char*) = PlatformSpecificFOpenImplementation;
 extern "C" void (*PlatformSpecificFPuts)(const char*, PlatformSpecificFile) = PlatformSpecificFPutsImplementation;
 extern "C" void (*PlatformSpecificFClose)(PlatformSpecificFile) = PlatformSpecificFCloseImplementation;
+extern "C" char* (*PlatformSpecificFGets)(char*, int, PlatformSpecificFile) = PlatformSpecificFGetsImplementation;
+extern "C" void (*PlatformSpecificFFlush)(PlatformSpecificFile) = PlatformSpecificFFlushImplementation;
 
 extern "C" int (*PlatformSpecificPutchar)(int) = putchar;
 extern "C" void (*PlatformSpecificFlush)() = PlatformSpecificFlushImplementation;
+extern "C" void (*PlatformSpecificWrite)(const char*, size_t) = PlatformSpecificWriteImplementation;
 extern "C" void* (*PlatformSpecificMalloc)(size_t) = malloc;
 extern "C" void* (*PlatformSpecificRealloc) (void*, size_t) = realloc;
 extern "C" void (*PlatformSpecificFree)(void*) = free;
@@ -181,3 +200,51 @@ extern "C" void (*PlatformSpecificMutexLock)(PlatformSpecificMutex) = DummyMutex
 extern "C" void (*PlatformSpecificMutexUnlock)(PlatformSpecificMutex) = DummyMutexUnlock;
 extern "C" void (*PlatformSpecificMutexDestroy)(PlatformSpecificMutex) = DummyMutexDestroy;
 
+/* Not atomic, only safe when a single thread allocates */
+static size_t DummyAtomicAdd(volatile size_t* value, size_t amount)
+{
+    *value += amount;
+    return *value;
+}
+
+extern "C" size_t (*PlatformSpecificAtomicAdd)(volatile size_t*, size_t) = DummyAtomicAdd;
+
+static void DummyInstallCrashHandler(void (*)(const char*))
+{
+}
+
+static void DummyUninstallCrashHandler(void)
+{
+}
+
+static void DummyWriteBacktrace(void)
+{
+}
+
+extern "C" void (*PlatformSpecificInstallCrashHandler)(void (*)(const char*)) = DummyInstallCrashHandler;
+extern "C" void (*PlatformSpecificUninstallCrashHandler)(void) = DummyUninstallCrashHandler;
+extern "C" void (*PlatformSpecificWriteBacktrace)(void) = DummyWriteBacktrace;
+
+static size_t DummyPageSize(void)
+{
+    return 0;
+}
+
+static void* DummyAllocatePages(size_t)
+{
+    return NULL;
+}
+
+static void DummyFreePages(void*, size_t)
+{
+}
+
+static void DummyProtectPages(void*, size_t)
+{
+}
+
+extern "C" size_t (*PlatformSpecificPageSize)(void) = DummyPageSize;
+extern "C" void* (*PlatformSpecificAllocatePages)(size_t) = DummyAllocatePages;
+extern "C" void (*PlatformSpecificFreePages)(void*, size_t) = DummyFreePages;
+extern "C" void (*PlatformSpecificProtectPages)(void*, size_t) = DummyProtectPages;
+
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2007, Michael Feathers, James Grenning and Bas Vodde
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE EARLIER MENTIONED AUTHORS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <copyright holder> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * Lists the tests of an ELF test executable from its test manifest, without running it.
+ *
+ *   CppUTestManifestReader [-lg|-ln] executable
+ *
+ * -lg and -ln list as the test executable does with the same options. Without an option, every
+ * record is listed on a line of its own. Exits with 1 when the executable has no test manifest.
+ */
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/TestManifest.h"
+
+#include <stdio.h>
+
+static unsigned char* readExecutable(const char* fileName, size_t& size)
+{
+    FILE* file = fopen(fileName, "rb");
+    if (file == NULL) return NULL;
+
+    unsigned char* image = NULL;
+    long length = (fseek(file, 0, SEEK_END) == 0) ? ftell(file) : -1;
+    if (length > 0 && fseek(file, 0, SEEK_SET) == 0) {
+        size = (size_t) length;
+        image = new unsigned char[size];
+        if (fread(image, 1, size, file) != size) {
+            delete [] image;
+            image = NULL;
+        }
+    }
+    fclose(file);
+    return image;
+}
+
+int main(int ac, const char** av)
+{
+    SimpleString option = (ac == 3) ? av[1] : "";
+    if ((ac != 2 && ac != 3) || (ac == 3 && option != "-lg" && option != "-ln")) {
+        fprintf(stderr, "usage: %s [-lg|-ln] executable\n", av[0]);
+        return 2;
+    }
+
+    const char* fileName = av[ac - 1];
+    size_t size = 0;
+    unsigned char* image = readExecutable(fileName, size);
+    if (image == NULL) {
+        fprintf(stderr, "%s: cannot read %s\n", av[0], fileName);
+        return 1;
+    }
+
+    int result = 0;
+    TestManifest manifest = TestManifest::fromElfImage(image, size);
+    if (manifest.isEmpty()) {
+        fprintf(stderr, "%s: no test manifest in %s\n", av[0], fileName);
+        result = 1;
+    }
+    else if (option == "-lg")
+        printf("%s", manifest.listTestGroupNames().asCharString());
+    else if (option == "-ln")
+        printf("%s", manifest.listTestGroupAndCaseNames().asCharString());
+    else
+        printf("%s", manifest.listRecords().asCharString());
+
+    delete [] image;
+    return result;
+}
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2007, Michael Feathers, James Grenning and Bas Vodde
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE EARLIER MENTIONED AUTHORS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <copyright holder> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/TestTestingFixture.h"
+#include "CppUTest/AllocationFailureRunner.h"
+
+static int runs;
+
+static char* allocate(size_t size)
+{
+    return getCurrentMallocAllocator()->alloc_memory(size, __FILE__, __LINE__);
+}
+
+static void release(char* memory)
+{
+    getCurrentMallocAllocator()->free_memory(memory, __FILE__, __LINE__);
+}
+
+static void _allocateNothing()
+{
+    runs++;
+}
+
+static void _handleFailingAllocations()
+{
+    runs++;
+    char* memory = allocate(10);
+    if (memory) release(memory);
+}
+
+static void _assumeAllocationsSucceed()
+{
+    runs++;
+    char* first = allocate(10);
+    CHECK(first != NULL);
+    char* second = allocate(10);
+    CHECK(second != NULL);
+    release(second);
+    release(first);
+}
+
+static void _failTheTest()
+{
+    runs++;
+    release(allocate(10));
+    FAIL("fails anyway");
+}
+
+TEST_GROUP(AllocationFailureRunner)
+{
+    TestTestingFixture fixture;
+    AllocationFailureRunner runner;
+
+    void setup()
+    {
+        runs = 0;
+        fixture.registry_->setAllocationFailureRunner(&runner);
+    }
+};
+
+TEST(AllocationFailureRunner, TestWithoutAllocationsRunsOnce)
+{
+    fixture.setTestFunction(_allocateNothing);
+    fixture.runAllTests();
+    LONGS_EQUAL(1, runs);
+    LONGS_EQUAL(0, fixture.getFailureCount());
+}
+
+TEST(AllocationFailureRunner, TestIsRunAgainForEveryAllocation)
+{
+    fixture.setTestFunction(_handleFailingAllocations);
+    fixture.runAllTests();
+    LONGS_EQUAL(2, runs);
+    LONGS_EQUAL(0, fixture.getFailureCount());
+}
+
+TEST(AllocationFailureRunner, RerunsAreCountedApartFromTheTestsThatRan)
+{
+    fixture.setTestFunction(_handleFailingAllocations);
+    fixture.runAllTests();
+    LONGS_EQUAL(1, fixture.result_->getRunCount());
+    LONGS_EQUAL(1, fixture.result_->getRerunCount());
+}
+
+TEST(AllocationFailureRunner, ReportsTheAllocationThatWasFailed)
+{
+    fixture.setTestFunction(_assumeAllocationsSucceed);
+    fixture.runAllTests();
+    LONGS_EQUAL(2, runs);
+    LONGS_EQUAL(2, fixture.getFailureCount());
+    fixture.assertPrintContains("Failed while failing allocation 1 of 2");
+}
+
+TEST(AllocationFailureRunner, FailingTestIsNotRunAgain)
+{
+    fixture.setTestFunction(_failTheTest);
+    fixture.runAllTests();
+    LONGS_EQUAL(1, runs);
+    LONGS_EQUAL(1, fixture.getFailureCount());
+}
+
+TEST(AllocationFailureRunner, AllocatorsAreRestoredAfterTheTest)
+{
+    TestMemoryAllocator* mallocAllocator = getCurrentMallocAllocator();
+    TestMemoryAllocator* newAllocator = getCurrentNewAllocator();
+    fixture.setTestFunction(_assumeAllocationsSucceed);
+    fixture.runAllTests();
+    POINTERS_EQUAL(mallocAllocator, getCurrentMallocAllocator());
+    POINTERS_EQUAL(newAllocator, getCurrentNewAllocator());
+}
+
+class AllocatingFixtureTest : public Utest
+{
+public:
+    AllocatingFixtureTest() : memory_(allocate(10))
+    {
+    }
+    ~AllocatingFixtureTest()
+    {
+        if (memory_) release(memory_);
+    }
+    void testBody() _override
+    {
+        runs++;
+        CHECK(memory_ != NULL);
+    }
+private:
+    char* memory_;
+};
+
+class AllocatingFixtureTestShell : public UtestShell
+{
+public:
+    virtual Utest* createTest() _override { return new AllocatingFixtureTest; }
+};
+
+TEST(AllocationFailureRunner, AllocationsOfTheFixtureAreNotFailed)
+{
+    AllocatingFixtureTestShell shell;
+    fixture.addTest(&shell);
+    fixture.setTestFunction(_allocateNothing);
+    fixture.runAllTests();
+    LONGS_EQUAL(2, runs);
+    LONGS_EQUAL(0, fixture.getFailureCount());
+}
+
+#if !defined(__MINGW32__) && !defined(_MSC_VER)
+
+TEST(AllocationFailureRunner, CountingRunAndRerunsRunInOneSeparateProcess)
+{
+    fixture.registry_->setRunTestsInSeperateProcess();
+    fixture.setTestFunction(_handleFailingAllocations);
+    fixture.runAllTests();
+    LONGS_EQUAL(0, runs);
+    LONGS_EQUAL(0, fixture.getFailureCount());
+}
+
+TEST(AllocationFailureRunner, FailingRerunInSeparateProcessFailsTheTest)
+{
+    fixture.registry_->setRunTestsInSeperateProcess();
+    fixture.setTestFunction(_assumeAllocationsSucceed);
+    fixture.runAllTests();
+    LONGS_EQUAL(0, runs);
+    LONGS_EQUAL(1, fixture.getFailureCount());
+    fixture.assertPrintContains("Failed in separate process");
+}
+
+#endif
+
+#if CPPUTEST_USE_STD_CPP_LIB && CPPUTEST_USE_MEM_LEAK_DETECTION
+
+static void _newWithoutHandlingBadAlloc()
+{
+    runs++;
+    delete new int;
+}
+
+TEST(AllocationFailureRunner, UnhandledBadAllocFailsTheTest)
+{
+    fixture.setTestFunction(_newWithoutHandlingBadAlloc);
+    fixture.runAllTests();
+    LONGS_EQUAL(2, runs);
+    fixture.assertPrintContains("Unexpected std::bad_alloc was thrown");
+    fixture.assertPrintContains("Failed while failing allocation 1 of 1");
+}
+
+#endif
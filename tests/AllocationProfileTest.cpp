@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2007, Michael Feathers, James Grenning and Bas Vodde
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE EARLIER MENTIONED AUTHORS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <copyright holder> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/AllocationProfile.h"
+#include "CppUTest/MemoryLeakDetector.h"
+#include "CppUTest/TestMemoryAllocator.h"
+#include "CppUTest/TestTestingFixture.h"
+
+static const char* fileA = "a.cpp";
+static const char* fileB = "b.cpp";
+
+TEST_GROUP(AllocationProfile)
+{
+    AllocationProfile profile;
+};
+
+TEST(AllocationProfile, startsEmpty)
+{
+    CHECK(profile.getNumberOfCallSites() == 0);
+    CHECK(profile.getCallSite(fileA, 1) == NULL);
+    STRCMP_EQUAL("", profile.asString(AllocationProfile::profile_collapsed).asCharString());
+}
+
+TEST(AllocationProfile, countsAllocationsPerCallSite)
+{
+    profile.allocated(fileA, 1, 10);
+    profile.allocated(fileA, 1, 20);
+    profile.allocated(fileA, 2, 5);
+
+    CHECK(profile.getNumberOfCallSites() == 2);
+    const AllocationCallSite* site = profile.getCallSite(fileA, 1);
+    CHECK(site->allocations_ == 2);
+    CHECK(site->bytes_ == 30);
+    CHECK(profile.getCallSite(fileA, 2)->bytes_ == 5);
+}
+
+TEST(AllocationProfile, freeingLowersTheLiveBytesButKeepsThePeak)
+{
+    profile.allocated(fileA, 1, 10);
+    profile.allocated(fileA, 1, 20);
+    profile.freed(fileA, 1, 10);
+    profile.allocated(fileA, 1, 5);
+
+    const AllocationCallSite* site = profile.getCallSite(fileA, 1);
+    CHECK(site->liveBytes_ == 25);
+    CHECK(site->peakLiveBytes_ == 30);
+}
+
+TEST(AllocationProfile, freeingMemoryOfAnUnknownCallSiteIsIgnored)
+{
+    profile.freed(fileA, 1, 10);
+    CHECK(profile.getNumberOfCallSites() == 0);
+}
+
+TEST(AllocationProfile, keepsAllCallSitesWhenTheTableGrows)
+{
+    for (int line = 1; line <= 1000; line++)
+        profile.allocated(fileA, line, (size_t) line);
+
+    CHECK(profile.getNumberOfCallSites() == 1000);
+    for (int line = 1; line <= 1000; line++)
+        CHECK(profile.getCallSite(fileA, line)->bytes_ == (size_t) line);
+}
+
+TEST(AllocationProfile, collapsedProfileIsSortedByBytes)
+{
+    profile.allocated(fileA, 1, 100);
+    profile.allocated(fileB, 2, 300);
+    profile.allocated(fileA, 3, 200);
+
+    STRCMP_EQUAL("b.cpp:2 300\na.cpp:3 200\na.cpp:1 100\n", profile.asString(AllocationProfile::profile_collapsed).asCharString());
+}
+
+TEST(AllocationProfile, remembersTheTestAndGroupThatAllocatedTheMost)
+{
+    UtestShell first("group1", "first", "file", 1);
+    UtestShell second("group1", "second", "file", 1);
+    UtestShell third("group2", "third", "file", 1);
+
+    profile.startTest(first);
+    profile.allocated(fileA, 1, 10);
+    profile.endTest();
+    profile.startTest(second);
+    profile.allocated(fileA, 1, 20);
+    profile.endTest();
+    profile.startTest(third);
+    profile.allocated(fileA, 1, 25);
+    profile.endTest();
+    profile.endGroup();
+
+    const AllocationCallSite* site = profile.getCallSite(fileA, 1);
+    STRCMP_EQUAL("TEST(group2, third)", site->heaviestTest_);
+    CHECK(site->heaviestTestBytes_ == 25);
+    STRCMP_EQUAL("group1", site->heaviestGroup_);
+    CHECK(site->heaviestGroupBytes_ == 30);
+}
+
+TEST(AllocationProfile, tableNamesTheHeaviestTestAndGroup)
+{
+    UtestShell test("group", "test", "file", 1);
+    profile.startTest(test);
+    profile.allocated(fileA, 1, 10);
+    profile.endTest();
+    profile.endGroup();
+
+    STRCMP_EQUAL("Allocation profile: 1 call sites, sorted by bytes allocated\n"
+        "a.cpp:1: 10 bytes in 1 allocations, peak 10 bytes live, most by TEST(group, test) (10 bytes), most by group group (10 bytes)\n",
+        profile.asString().asCharString());
+}
+
+TEST(AllocationProfile, tableNamesTheHeaviestTestAfterItsShellIsGone)
+{
+    UtestShell* test = new UtestShell("group", "test", "file", 1);
+    profile.startTest(*test);
+    profile.allocated(fileA, 1, 10);
+    profile.endTest();
+    profile.endGroup();
+    delete test;
+
+    STRCMP_CONTAINS("most by TEST(group, test) (10 bytes), most by group group (10 bytes)", profile.asString().asCharString());
+}
+
+TEST(AllocationProfile, clearForgetsAllCallSites)
+{
+    profile.allocated(fileA, 1, 10);
+    profile.clear();
+    CHECK(profile.getNumberOfCallSites() == 0);
+    CHECK(profile.getCallSite(fileA, 1) == NULL);
+}
+
+class AllocationProfileFailureForTest : public MemoryLeakFailure
+{
+public:
+    virtual void fail(char*)
+    {
+    }
+};
+
+TEST(AllocationProfile, leakDetectorPassesAllocationsAndDeallocationsToTheProfile)
+{
+    AllocationProfileFailureForTest reporter;
+    MemoryLeakDetector detector(&reporter);
+    detector.setAllocationProfile(&profile);
+
+    char* memory = detector.allocMemory(defaultNewAllocator(), 10, fileA, 1);
+    memory = detector.reallocMemory(defaultNewAllocator(), memory, 20, fileB, 2);
+    detector.deallocMemory(defaultNewAllocator(), memory);
+
+    CHECK(profile.getCallSite(fileA, 1)->bytes_ == 10);
+    CHECK(profile.getCallSite(fileA, 1)->liveBytes_ == 0);
+    CHECK(profile.getCallSite(fileB, 2)->peakLiveBytes_ == 20);
+    CHECK(profile.getCallSite(fileB, 2)->liveBytes_ == 0);
+}
+
+TEST(AllocationProfile, pluginMarksTheTestBoundaries)
+{
+    AllocationProfilePlugin plugin("AllocationProfilePlugin", &profile);
+    UtestShell test("group", "test", "file", 1);
+    TestTestingFixture fixture;
+
+    plugin.preTestAction(test, *fixture.result_);
+    profile.allocated(fileA, 1, 10);
+    plugin.postTestAction(test, *fixture.result_);
+    profile.allocated(fileA, 1, 30);
+
+    STRCMP_EQUAL("TEST(group, test)", profile.getCallSite(fileA, 1)->heaviestTest_);
+    CHECK(profile.getCallSite(fileA, 1)->heaviestTestBytes_ == 10);
+}
@@ -79,6 +79,14 @@ TEST(CommandLineArguments, verboseSetMultipleParameters)
     CHECK(args->isVerbose());
 }
 
+TEST(CommandLineArguments, verboseWithPeakMemory)
+{
+    const char* argv[] = { "tests.exe", "-vm" };
+    CHECK(newArgumentParser(2, argv));
+    CHECK(args->isVerbose());
+    CHECK(args->isPrintingPeakMemory());
+}
+
 TEST(CommandLineArguments, setColor)
 {
     const char* argv[] = { "tests.exe", "-c" };
@@ -86,6 +94,52 @@ TEST(CommandLineArguments, setColor)
     CHECK(args->isColor());
 }
 
+TEST(CommandLineArguments, setBufferedOutput)
+{
+    const char* argv[] = { "tests.exe", "-b" };
+    CHECK(newArgumentParser(2, argv));
+    CHECK(args->isBufferedOutput());
+}
+
+TEST(CommandLineArguments, setCrashHandler)
+{
+    const char* argv[] = { "tests.exe", "-s" };
+    CHECK(newArgumentParser(2, argv));
+    CHECK(args->isInstallingCrashHandler());
+    CHECK(!args->isWritingCrashBacktrace());
+}
+
+TEST(CommandLineArguments, setCrashHandlerWithBacktrace)
+{
+    const char* argv[] = { "tests.exe", "-sb" };
+    CHECK(newArgumentParser(2, argv));
+    CHECK(args->isInstallingCrashHandler());
+    CHECK(args->isWritingCrashBacktrace());
+}
+
+TEST(CommandLineArguments, setAllocationProfile)
+{
+    const char* argv[] = { "tests.exe", "-ap" };
+    CHECK(newArgumentParser(2, argv));
+    CHECK(args->isProfilingAllocations());
+    CHECK(!args->isCollapsedAllocationProfile());
+}
+
+TEST(CommandLineArguments, setCollapsedAllocationProfile)
+{
+    const char* argv[] = { "tests.exe", "-apcollapsed" };
+    CHECK(newArgumentParser(2, argv));
+    CHECK(args->isProfilingAllocations());
+    CHECK(args->isCollapsedAllocationProfile());
+}
+
+TEST(CommandLineArguments, failEachAllocation)
+{
+    const char* argv[] = { "tests.exe", "-fa" };
+    CHECK(newArgumentParser(2, argv));
+    CHECK(args->isFailingEachAllocation());
+}
+
 TEST(CommandLineArguments, repeatSet)
 {
     int argc = 2;
@@ -110,6 +164,42 @@ TEST(CommandLineArguments, repeatSetDefaultsToTwo)
     LONGS_EQUAL(2, args->getRepeatCount());
 }
 
+TEST(CommandLineArguments, shuffleIsOffByDefault)
+{
+    int argc = 1;
+    const char* argv[] = { "tests.exe" };
+    CHECK(newArgumentParser(argc, argv));
+    CHECK(!args->isShuffling());
+}
+
+TEST(CommandLineArguments, shuffleSeedSet)
+{
+    int argc = 2;
+    const char* argv[] = { "tests.exe", "-z3000000000" };
+    CHECK(newArgumentParser(argc, argv));
+    CHECK(args->isShuffling());
+    CHECK(3000000000UL == args->getShuffleSeed());
+}
+
+TEST(CommandLineArguments, shuffleSeedSetDifferentParameter)
+{
+    int argc = 3;
+    const char* argv[] = { "tests.exe", "-z", "42" };
+    CHECK(newArgumentParser(argc, argv));
+    CHECK(args->isShuffling());
+    CHECK(42 == args->getShuffleSeed());
+}
+
+TEST(CommandLineArguments, shuffleWithoutSeedLeavesTheSeedToTheRunner)
+{
+    int argc = 3;
+    const char* argv[] = { "tests.exe", "-z", "-v" };
+    CHECK(newArgumentParser(argc, argv));
+    CHECK(args->isShuffling());
+    CHECK(0 == args->getShuffleSeed());
+    CHECK(args->isVerbose());
+}
+
 TEST(CommandLineArguments, runningTestsInSeperateProcesses)
 {
     int argc = 2;
@@ -241,6 +331,50 @@ TEST(CommandLineArguments, setJUnitOutputDifferentParameter)
     CHECK(args->isJUnitOutput());
 }
 
+TEST(CommandLineArguments, setJUnitSingleFileOutput)
+{
+    int argc = 2;
+    const char* argv[] = { "tests.exe", "-ojunitsingle" };
+    CHECK(newArgumentParser(argc, argv));
+    CHECK(args->isJUnitOutput());
+    CHECK(args->isJUnitSingleFileOutput());
+}
+
+TEST(CommandLineArguments, setJsonOutput)
+{
+    int argc = 3;
+    const char* argv[] = { "tests.exe", "-o", "json" };
+    CHECK(newArgumentParser(argc, argv));
+    CHECK(args->isJsonOutput());
+    CHECK(!args->isJUnitOutput());
+}
+
+TEST(CommandLineArguments, setJournalFileName)
+{
+    int argc = 3;
+    const char* argv[] = { "tests.exe", "-j", "journal.txt" };
+    CHECK(newArgumentParser(argc, argv));
+    STRCMP_EQUAL("journal.txt", args->getJournalFileName().asCharString());
+    CHECK(!args->isResuming());
+}
+
+TEST(CommandLineArguments, resumeWithJournalFileName)
+{
+    int argc = 3;
+    const char* argv[] = { "tests.exe", "-jjournal.txt", "--resume" };
+    CHECK(newArgumentParser(argc, argv));
+    STRCMP_EQUAL("journal.txt", args->getJournalFileName().asCharString());
+    CHECK(args->isResuming());
+}
+
+TEST(CommandLineArguments, resumeWithoutJournalFileNameUsesTheDefaultJournal)
+{
+    int argc = 2;
+    const char* argv[] = { "tests.exe", "--resume" };
+    CHECK(newArgumentParser(argc, argv));
+    STRCMP_EQUAL("cpputest_journal.txt", args->getJournalFileName().asCharString());
+}
+
 TEST(CommandLineArguments, setOutputToGarbage)
 {
     int argc = 3;
@@ -264,12 +398,20 @@ TEST(CommandLineArguments, setPrintGroupsAndNames)
     CHECK(args->isListingTestGroupAndCaseNames());
 }
 
+TEST(CommandLineArguments, setPrintTestManifest)
+{
+    int argc = 2;
+    const char* argv[] = { "tests.exe", "-lm" };
+    CHECK(newArgumentParser(argc, argv));
+    CHECK(args->isListingTestManifest());
+}
+
 TEST(CommandLineArguments, weirdParamatersPrintsUsageAndReturnsFalse)
 {
     int argc = 2;
     const char* argv[] = { "tests.exe", "-SomethingWeird" };
     CHECK(!newArgumentParser(argc, argv));
-    STRCMP_EQUAL("usage [-v] [-c] [-p] [-lg] [-ln] [-r#] [-g|sg groupName]... [-n|sn testName]... [\"TEST(groupName, testName)\"]... [-o{normal, junit}] [-k packageName]\n",
+    STRCMP_EQUAL("usage [-v|vm] [-c] [-b] [-p] [-s|sb] [-lg] [-ln] [-lm] [-ap|apcollapsed] [-fa] [-r#] [-z[seed]] [-g|sg groupName]... [-n|sn testName]... [\"TEST(groupName, testName)\"]... [-o{normal, junit, junitsingle, json}] [-k packageName] [-j journalFile] [--resume]\n",
             args->usage());
 }
 
@@ -288,6 +430,12 @@ TEST(CommandLineArguments, checkDefaultArguments)
     const char* argv[] = { "tests.exe" };
     CHECK(newArgumentParser(argc, argv));
     CHECK(!args->isVerbose());
+    CHECK(!args->isBufferedOutput());
+    CHECK(!args->isInstallingCrashHandler());
+    CHECK(!args->isProfilingAllocations());
+    CHECK(!args->isFailingEachAllocation());
+    CHECK(!args->isResuming());
+    STRCMP_EQUAL("", args->getJournalFileName().asCharString());
     LONGS_EQUAL(1, args->getRepeatCount());
     CHECK(NULL == args->getGroupFilters());
     CHECK(NULL == args->getNameFilters());
@@ -60,9 +60,10 @@ class CommandLineTestRunnerWithStringBufferOutput : public CommandLineTestRunner
 public:
   StringBufferTestOutput* fakeJUnitOuputWhichIsReallyABuffer_;
   StringBufferTestOutput* fakeConsoleOutputWhichIsReallyABuffer;
+  StringBufferTestOutput* fakeJsonOutputWhichIsReallyABuffer_;
 
   CommandLineTestRunnerWithStringBufferOutput(int argc, const char** argv, TestRegistry* registry)
-    : CommandLineTestRunner(argc, argv, registry), fakeJUnitOuputWhichIsReallyABuffer_(NULL), fakeConsoleOutputWhichIsReallyABuffer(NULL)
+    : CommandLineTestRunner(argc, argv, registry), fakeJUnitOuputWhichIsReallyABuffer_(NULL), fakeConsoleOutputWhichIsReallyABuffer(NULL), fakeJsonOutputWhichIsReallyABuffer_(NULL)
   {}
 
   TestOutput* createConsoleOutput()
@@ -76,6 +77,12 @@ public:
     fakeJUnitOuputWhichIsReallyABuffer_ = new StringBufferTestOutput;
     return fakeJUnitOuputWhichIsReallyABuffer_;
   }
+
+  TestOutput* createJsonOutput()
+  {
+    fakeJsonOutputWhichIsReallyABuffer_ = new StringBufferTestOutput;
+    return fakeJsonOutputWhichIsReallyABuffer_;
+  }
 };
 
 TEST_GROUP(CommandLineTestRunner)
@@ -131,6 +138,16 @@ TEST(CommandLineTestRunner, JunitOutputEnabled)
     CHECK(commandLineTestRunner.fakeJUnitOuputWhichIsReallyABuffer_);
 }
 
+TEST(CommandLineTestRunner, JsonOutputEnabled)
+{
+    const char* argv[] = { "tests.exe", "-ojson"};
+
+    CommandLineTestRunnerWithStringBufferOutput commandLineTestRunner(2, argv, &registry);
+    commandLineTestRunner.runAllTestsMain();
+    CHECK(commandLineTestRunner.fakeJsonOutputWhichIsReallyABuffer_);
+    CHECK(commandLineTestRunner.fakeConsoleOutputWhichIsReallyABuffer == NULL);
+}
+
 TEST(CommandLineTestRunner, JunitOutputAndVerboseEnabled)
 {
     const char* argv[] = { "tests.exe", "-ojunit", "-v"};
@@ -141,6 +158,29 @@ TEST(CommandLineTestRunner, JunitOutputAndVerboseEnabled)
     STRCMP_CONTAINS("TEST(group, test)", commandLineTestRunner.fakeConsoleOutputWhichIsReallyABuffer->getOutput().asCharString());
 }
 
+TEST(CommandLineTestRunner, allocationProfileIsPrintedAtTheEndOfTheRun)
+{
+    const char* argv[] = { "tests.exe", "-ap" };
+
+    CommandLineTestRunnerWithStringBufferOutput commandLineTestRunner(2, argv, &registry);
+    commandLineTestRunner.runAllTestsMain();
+
+    STRCMP_CONTAINS("Allocation profile:", commandLineTestRunner.fakeConsoleOutputWhichIsReallyABuffer->getOutput().asCharString());
+    LONGS_EQUAL(0, registry.countPlugins());
+}
+
+TEST(CommandLineTestRunner, shuffledRunsPrintTheSeedOfEveryRepetition)
+{
+    const char* argv[] = { "tests.exe", "-z", "7", "-r2" };
+
+    CommandLineTestRunnerWithStringBufferOutput commandLineTestRunner(4, argv, &registry);
+    commandLineTestRunner.runAllTestsMain();
+
+    STRCMP_CONTAINS("Test run 1 of 2\nShuffling tests with seed 7\n", commandLineTestRunner.fakeConsoleOutputWhichIsReallyABuffer->getOutput().asCharString());
+    STRCMP_CONTAINS("Test run 2 of 2\nShuffling tests with seed 483484\n", commandLineTestRunner.fakeConsoleOutputWhichIsReallyABuffer->getOutput().asCharString());
+    CHECK(0 == registry.getShuffleSeed());
+}
+
 TEST(CommandLineTestRunner, listTestGroupNamesShouldWorkProperly)
 {
     const char* argv[] = { "tests.exe", "-lg" };
@@ -161,6 +201,20 @@ TEST(CommandLineTestRunner, listTestGroupAndCaseNamesShouldWorkProperly)
     STRCMP_CONTAINS("group.test", commandLineTestRunner.fakeConsoleOutputWhichIsReallyABuffer->getOutput().asCharString());
 }
 
+#if CPPUTEST_USE_TEST_MANIFEST
+
+TEST(CommandLineTestRunner, listTestManifestListsTheTestsOfTheExecutable)
+{
+    const char* argv[] = { "tests.exe", "-lm" };
+
+    CommandLineTestRunnerWithStringBufferOutput commandLineTestRunner(2, argv, &registry);
+    commandLineTestRunner.runAllTestsMain();
+
+    STRCMP_CONTAINS("TEST CommandLineTestRunner listTestManifestListsTheTestsOfTheExecutable", commandLineTestRunner.fakeConsoleOutputWhichIsReallyABuffer->getOutput().asCharString());
+}
+
+#endif
+
 struct FakeOutput
 {
     FakeOutput() : SaveFOpen(PlatformSpecificFOpen), SaveFPuts(PlatformSpecificFPuts),
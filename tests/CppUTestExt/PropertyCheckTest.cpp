@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2007, Michael Feathers, James Grenning and Bas Vodde
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE EARLIER MENTIONED AUTHORS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <copyright holder> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/TestTestingFixture.h"
+#include "CppUTestExt/PropertyCheck.h"
+
+static void _generatedValuesStayInTheirRange(PropertyCase& propertyCase)
+{
+    int i = propertyCase.anyInt(-5, 5);
+    CHECK(i >= -5 && i <= 5);
+    long l = propertyCase.anyLong(10, 20);
+    CHECK(l >= 10 && l <= 20);
+    unsigned long u = propertyCase.anyUnsignedLong(7);
+    CHECK(u <= 7);
+    double d = propertyCase.anyDouble(-1.0, 2.0);
+    CHECK(d >= -1.0 && d <= 2.0);
+    CHECK(propertyCase.anyIndex(3) < 3);
+    CHECK(SimpleString::StrLen(propertyCase.anyCString(4)) <= 4);
+    size_t length;
+    propertyCase.anyBytes(3, length);
+    CHECK(length <= 3);
+}
+
+static void _longsBelowAHundred(PropertyCase& propertyCase)
+{
+    CHECK(propertyCase.anyLong(0, 1000) < 100);
+}
+
+static void _stringsShorterThanThree(PropertyCase& propertyCase)
+{
+    CHECK(propertyCase.anyString(10).size() < 3);
+}
+
+static void _sumsOfTwoInts(PropertyCase& propertyCase)
+{
+    int a = propertyCase.anyInt(-1000, 1000);
+    int b = propertyCase.anyInt(-1000, 1000);
+    CHECK(a + b < 10);
+}
+
+static void _alwaysFails(PropertyCase&)
+{
+    FAIL("always");
+}
+
+static void _lengthsOfGeneratedStrings(PropertyCase& propertyCase)
+{
+    SimpleString s = propertyCase.anyString(8);
+    LONGS_EQUAL(SimpleString::StrLen(s.asCharString()), s.size());
+}
+
+static void _checkPassingProperty()
+{
+    CHECK_PROPERTY(_lengthsOfGeneratedStrings);
+}
+
+static void _checkLongsBelowAHundred()
+{
+    CHECK_PROPERTY_CASES(_longsBelowAHundred, 1000);
+}
+
+static void _checkStringsShorterThanThree()
+{
+    CHECK_PROPERTY_CASES(_stringsShorterThanThree, 1000);
+}
+
+static void _checkSumsOfTwoInts()
+{
+    CHECK_PROPERTY_WITH_SEED(_sumsOfTwoInts, 1000, 1);
+}
+
+static void _checkAlwaysFailsWithSeed()
+{
+    CHECK_PROPERTY_WITH_SEED(_alwaysFails, 10, 1234);
+}
+
+TEST_GROUP(PropertyCheck)
+{
+    TestTestingFixture fixture;
+};
+
+TEST(PropertyCheck, generatedValuesStayInTheirRange)
+{
+    CHECK_PROPERTY_CASES(_generatedValuesStayInTheirRange, 500);
+}
+
+TEST(PropertyCheck, passingPropertyCountsOneCheck)
+{
+    fixture.setTestFunction(_checkPassingProperty);
+    fixture.runAllTests();
+    LONGS_EQUAL(0, fixture.getFailureCount());
+    LONGS_EQUAL(1, fixture.getCheckCount());
+}
+
+TEST(PropertyCheck, failingLongIsShrunkToTheSmallestFailingValue)
+{
+    fixture.setTestFunction(_checkLongsBelowAHundred);
+    fixture.runAllTests();
+    LONGS_EQUAL(1, fixture.getFailureCount());
+    fixture.assertPrintContains("to the input:\n\t100\n");
+    fixture.assertPrintContains("CHECK(propertyCase.anyLong(0, 1000) < 100) failed");
+}
+
+TEST(PropertyCheck, failingStringIsShrunkToTheShortestFailingString)
+{
+    fixture.setTestFunction(_checkStringsShorterThanThree);
+    fixture.runAllTests();
+    fixture.assertPrintContains("to the input:\n\t\"aaa\"\n");
+}
+
+TEST(PropertyCheck, failingCompositeIsShrunkAsAWhole)
+{
+    fixture.setTestFunction(_checkSumsOfTwoInts);
+    fixture.runAllTests();
+    fixture.assertPrintContains("to the input:\n\t10, 0\n");
+}
+
+TEST(PropertyCheck, failureReportsTheSeedAndTheCase)
+{
+    fixture.setTestFunction(_checkAlwaysFailsWithSeed);
+    fixture.runAllTests();
+    fixture.assertPrintContains("Property failed on case 1 with seed 1234");
+    fixture.assertPrintContains("always");
+}
+
+TEST(PropertyCheck, sameSeedMakesTheSameCases)
+{
+    PropertyCase first;
+    PropertyCase second;
+    first.setSeed(42);
+    second.setSeed(42);
+    for (int testCase = 0; testCase < 10; testCase++) {
+        first.startRandomCase();
+        second.startRandomCase();
+        LONGS_EQUAL(first.anyLong(-100000, 100000), second.anyLong(-100000, 100000));
+        STRCMP_EQUAL(first.anyCString(20), second.anyCString(20));
+    }
+}
+
+TEST(PropertyCheck, replayedChoicesMakeTheSameValues)
+{
+    PropertyCase propertyCase;
+    propertyCase.startRandomCase();
+    long l = propertyCase.anyLong(-50, 50);
+    SimpleString s = propertyCase.anyString(5);
+    size_t length;
+    const unsigned char* bytes = propertyCase.anyBytes(4, length);
+    SimpleString bytesAsString = StringFromBinary(bytes, length);
+
+    unsigned long choices[64];
+    size_t count = propertyCase.getChoiceCount();
+    for (size_t i = 0; i < count; i++)
+        choices[i] = propertyCase.getChoices()[i];
+
+    propertyCase.startReplay(choices, count, true);
+    LONGS_EQUAL(l, propertyCase.anyLong(-50, 50));
+    CHECK_EQUAL(s, propertyCase.anyString(5));
+    size_t replayedLength;
+    bytes = propertyCase.anyBytes(4, replayedLength);
+    CHECK(length == replayedLength);
+    CHECK_EQUAL(bytesAsString, StringFromBinary(bytes, replayedLength));
+}
+
+TEST(PropertyCheck, descriptionListsTheDrawnValues)
+{
+    unsigned long choices[] = { 1, 4, 2, 0, 1, 1, 0xAB };
+    PropertyCase propertyCase;
+    propertyCase.startReplay(choices, 7, true);
+    propertyCase.anyLong(-10, 10);
+    propertyCase.anyCString(5);
+    size_t length;
+    propertyCase.anyBytes(5, length);
+    STRCMP_EQUAL("-5, \"ab\", <AB>", propertyCase.getDescription().asCharString());
+}
+
+TEST(PropertyCheck, largeStringsDoNotOutliveTheirCase)
+{
+    PropertyCase propertyCase;
+    for (int testCase = 0; testCase < 20; testCase++) {
+        propertyCase.startRandomCase();
+        for (int i = 0; i < 50; i++)
+            CHECK(SimpleString::StrLen(propertyCase.anyCString(1000)) <= 1000);
+    }
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2007, Michael Feathers, James Grenning and Bas Vodde
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE EARLIER MENTIONED AUTHORS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <copyright holder> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/GuardPageAllocatorPlugin.h"
+#include "CppUTest/TestTestingFixture.h"
+
+TEST_GROUP(GuardPageAllocatorPlugin)
+{
+    GuardPageAllocatorPlugin* plugin;
+    TestTestingFixture* fixture;
+    UtestShell* guardedTest;
+    UtestShell* otherTest;
+    TestResult* result;
+
+    void setup()
+    {
+        plugin = new GuardPageAllocatorPlugin;
+        fixture = new TestTestingFixture;
+        guardedTest = new UtestShell("GuardedGroup", "test", "file", 1);
+        otherTest = new UtestShell("OtherGroup", "test", "file", 1);
+        result = new TestResult(*fixture->output_);
+    }
+
+    void teardown()
+    {
+        delete result;
+        delete otherTest;
+        delete guardedTest;
+        delete fixture;
+        delete plugin;
+    }
+};
+
+TEST(GuardPageAllocatorPlugin, guardsNoGroupsByDefault)
+{
+    CHECK(!plugin->isGuarding("GuardedGroup"));
+}
+
+TEST(GuardPageAllocatorPlugin, guardsSelectedGroups)
+{
+    plugin->guardTestGroups("Guarded");
+    CHECK(plugin->isGuarding("GuardedGroup"));
+    CHECK(!plugin->isGuarding("OtherGroup"));
+}
+
+TEST(GuardPageAllocatorPlugin, installsGuardPageAllocatorsForGuardedGroups)
+{
+    TestMemoryAllocator* mallocAllocator = getCurrentMallocAllocator();
+    TestMemoryAllocator* newAllocator = getCurrentNewAllocator();
+    TestMemoryAllocator* newArrayAllocator = getCurrentNewArrayAllocator();
+    plugin->guardTestGroups("Guarded");
+
+    plugin->preTestAction(*guardedTest, *result);
+    STRCMP_EQUAL("Guard Page Malloc Allocator", getCurrentMallocAllocator()->name());
+    STRCMP_EQUAL("Guard Page New Allocator", getCurrentNewAllocator()->name());
+    STRCMP_EQUAL("Guard Page New [] Allocator", getCurrentNewArrayAllocator()->name());
+    plugin->postTestAction(*guardedTest, *result);
+
+    POINTERS_EQUAL(mallocAllocator, getCurrentMallocAllocator());
+    POINTERS_EQUAL(newAllocator, getCurrentNewAllocator());
+    POINTERS_EQUAL(newArrayAllocator, getCurrentNewArrayAllocator());
+}
+
+TEST(GuardPageAllocatorPlugin, leavesOtherGroupsAlone)
+{
+    TestMemoryAllocator* mallocAllocator = getCurrentMallocAllocator();
+    plugin->guardTestGroups("Guarded");
+
+    plugin->preTestAction(*otherTest, *result);
+    POINTERS_EQUAL(mallocAllocator, getCurrentMallocAllocator());
+    plugin->postTestAction(*otherTest, *result);
+}
+
+TEST(GuardPageAllocatorPlugin, guardedGroupsCanAllocateAndFree)
+{
+    plugin->guardTestGroups("Guarded");
+
+    plugin->preTestAction(*guardedTest, *result);
+    char* memory = (char*) malloc(10);
+    int* number = new int(1);
+    char* array = new char[10];
+    delete [] array;
+    delete number;
+    free(memory);
+    plugin->postTestAction(*guardedTest, *result);
+}
+
+TEST(GuardPageAllocatorPlugin, parsesGuardAllGroups)
+{
+    const char* argv[] = { "-pguardpages" };
+    CHECK(plugin->parseArguments(1, argv, 0));
+    CHECK(plugin->isGuarding("OtherGroup"));
+}
+
+TEST(GuardPageAllocatorPlugin, parsesGuardOneGroup)
+{
+    const char* argv[] = { "-pguardpages=Guarded" };
+    CHECK(plugin->parseArguments(1, argv, 0));
+    CHECK(plugin->isGuarding("GuardedGroup"));
+    CHECK(!plugin->isGuarding("OtherGroup"));
+}
+
+TEST(GuardPageAllocatorPlugin, parsesSamplingAndUnderrun)
+{
+    const char* argv[] = { "-pguardsample=10", "-pguardunderrun" };
+    CHECK(plugin->parseArguments(2, argv, 0));
+    CHECK(plugin->parseArguments(2, argv, 1));
+}
+
+TEST(GuardPageAllocatorPlugin, ignoresOtherArguments)
+{
+    const char* argv[] = { "-pmemoryreport=normal" };
+    CHECK(!plugin->parseArguments(1, argv, 0));
+}
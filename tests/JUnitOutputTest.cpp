@@ -157,12 +157,14 @@ class JUnitTestOutputTestRunner
     UtestShell* currentTest_;
     bool firstTestInGroup_;
     int timeTheTestTakes_;
+    size_t peakMemory_;
+    size_t peakBlocks_;
     TestFailure* testFailure_;
 
 public:
 
     JUnitTestOutputTestRunner(TestResult result) :
-        result_(result), currentGroupName_(0), currentTest_(0), firstTestInGroup_(true), timeTheTestTakes_(0), testFailure_(0)
+        result_(result), currentGroupName_(0), currentTest_(0), firstTestInGroup_(true), timeTheTestTakes_(0), peakMemory_(0), peakBlocks_(0), testFailure_(0)
     {
         millisTime = 0;
         theTime =  "1978-10-03T00:00:00";
@@ -191,6 +193,8 @@ public:
         if (currentTest_) {
             result_.currentGroupEnded(currentTest_);
             firstTestInGroup_ = true;
+            delete currentTest_;
+            currentTest_ = 0;
         }
 
         currentGroupName_ = 0;
@@ -198,7 +202,6 @@ public:
 
     JUnitTestOutputTestRunner& withGroup(const char* groupName)
     {
-        runPreviousTest();
         endOfPreviousTestGroup();
 
         currentGroupName_ = groupName;
@@ -241,9 +244,18 @@ public:
             testFailure_ = 0;
         }
 
+        result_.setCurrentTestPeakMemory(peakMemory_, peakBlocks_);
+        peakMemory_ = peakBlocks_ = 0;
         result_.currentTestEnded(currentTest_);
     }
 
+    JUnitTestOutputTestRunner& thatPeaksAt(size_t bytes, size_t blocks)
+    {
+        peakMemory_ = bytes;
+        peakBlocks_ = blocks;
+        return *this;
+    }
+
     JUnitTestOutputTestRunner& thatTakes(int timeElapsed)
     {
         timeTheTestTakes_ = timeElapsed;
@@ -551,7 +563,7 @@ TEST(JUnitOutputTest, testFailuresInSeparateGroups)
     STRCMP_EQUAL("<failure message=\"file:99: Failure\" type=\"AssertionFailedError\">\n", outputFile->line(8));
 
     outputFile = fileSystem.file("cpputest_AnotherGroup.xml");
-    STRCMP_EQUAL("<failure message=\"anotherFile:10: otherFailure\" type=\"AssertionFailedError\">\n", outputFile->line(8));
+    STRCMP_EQUAL("<failure message=\"anotherFile:10: otherFailure\" type=\"AssertionFailedError\">\n", outputFile->line(6));
 }
 
 TEST(JUnitOutputTest, twoTestGroupsWriteToTwoDifferentFiles)
@@ -599,3 +611,190 @@ TEST(JUnitOutputTest, TestCaseBlockForIgnoredTest)
    STRCMP_EQUAL("<skipped />\n", outputFile->line(6));
    STRCMP_EQUAL("</testcase>\n", outputFile->line(7));
 }
+
+TEST(JUnitOutputTest, peakMemoryOfATestIsWrittenAsProperties)
+{
+    testCaseRunner->start()
+            .withGroup("memoryGroup").withTest("testName").thatPeaksAt(120, 3)
+            .end();
+
+    outputFile = fileSystem.file("cpputest_memoryGroup.xml");
+    STRCMP_EQUAL("<testcase classname=\"memoryGroup\" name=\"testName\" time=\"0.000\">\n", outputFile->line(5));
+    STRCMP_EQUAL("<properties>\n", outputFile->line(6));
+    STRCMP_EQUAL("<property name=\"peak_memory_bytes\" value=\"120\"/>\n", outputFile->line(7));
+    STRCMP_EQUAL("<property name=\"peak_memory_blocks\" value=\"3\"/>\n", outputFile->line(8));
+    STRCMP_EQUAL("</properties>\n", outputFile->line(9));
+    STRCMP_EQUAL("</testcase>\n", outputFile->line(10));
+}
+
+TEST_GROUP(JUnitSingleFileOutputTest)
+{
+    JUnitSingleFileTestOutput *junitOutput;
+    TestResult *result;
+    JUnitTestOutputTestRunner *testCaseRunner;
+    FileForJUnitOutputTests* outputFile;
+
+    void setup()
+    {
+        UT_PTR_SET(PlatformSpecificFOpen, (PlatformSpecificFile(*)(const char*, const char*))mockFOpen);
+        UT_PTR_SET(PlatformSpecificFPuts, mockFPuts);
+        UT_PTR_SET(PlatformSpecificFClose, mockFClose);
+        junitOutput = new JUnitSingleFileTestOutput();
+        result = new TestResult(*junitOutput);
+        testCaseRunner = new JUnitTestOutputTestRunner(*result);
+    }
+
+    void teardown()
+    {
+        delete testCaseRunner;
+        delete result;
+        delete junitOutput;
+        fileSystem.clear();
+    }
+};
+
+static PlatformSpecificFile failingFOpen(const char*, const char*)
+{
+    return 0;
+}
+
+TEST(JUnitSingleFileOutputTest, nothingIsWrittenWhenTheFileCannotBeOpened)
+{
+    UT_PTR_SET(PlatformSpecificFOpen, failingFOpen);
+    testCaseRunner->start()
+            .withGroup("groupname").withTest("testname")
+            .end();
+
+    LONGS_EQUAL(0, fileSystem.amountOfFiles());
+}
+
+static void* failingRealloc(void*, size_t)
+{
+    return NULL;
+}
+
+TEST(JUnitSingleFileOutputTest, testSuitesAreClosedWhenTheTestCasesCannotBeBuffered)
+{
+    UT_PTR_SET(PlatformSpecificRealloc, failingRealloc);
+    testCaseRunner->start()
+            .withGroup("groupname").withTest("testname")
+            .end();
+
+    outputFile = fileSystem.file("cpputest.xml");
+    STRCMP_EQUAL("<testsuites>\n", outputFile->line(2));
+    STRCMP_EQUAL("</testsuites>\n", outputFile->lineFromTheBack(1));
+}
+
+TEST(JUnitSingleFileOutputTest, twoTestGroupsWriteToOneFile)
+{
+    testCaseRunner->start()
+            .withGroup("firstTestGroup").withTest("testName")
+            .withGroup("secondTestGroup").withTest("testName")
+            .end();
+
+    LONGS_EQUAL(1, fileSystem.amountOfFiles());
+    CHECK(fileSystem.fileExists("cpputest.xml"));
+}
+
+TEST(JUnitSingleFileOutputTest, fileStartsWithXmlHeaderAndIsWrappedInTestSuites)
+{
+    testCaseRunner->start()
+            .withGroup("groupname").withTest("testname")
+            .end();
+
+    outputFile = fileSystem.file("cpputest.xml");
+    STRCMP_EQUAL("<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n", outputFile->line(1));
+    STRCMP_EQUAL("<testsuites>\n", outputFile->line(2));
+    STRCMP_EQUAL("</testsuites>\n", outputFile->lineFromTheBack(1));
+}
+
+TEST(JUnitSingleFileOutputTest, eachGroupIsWrittenAsACompleteTestSuite)
+{
+    testCaseRunner->start()
+            .withGroup("firstTestGroup").withTest("firstTestName")
+            .withGroup("secondTestGroup").withTest("secondTestName").withTest("thirdTestName")
+            .end();
+
+    outputFile = fileSystem.file("cpputest.xml");
+    STRCMP_EQUAL("<testsuite errors=\"0\" failures=\"0\" hostname=\"localhost\" name=\"firstTestGroup\" tests=\"1\" time=\"0.000\" timestamp=\"1978-10-03T00:00:00\">\n", outputFile->line(3));
+    STRCMP_EQUAL("<properties>\n", outputFile->line(4));
+    STRCMP_EQUAL("</properties>\n", outputFile->line(5));
+    STRCMP_EQUAL("<testcase classname=\"firstTestGroup\" name=\"firstTestName\" time=\"0.000\">\n", outputFile->line(6));
+    STRCMP_EQUAL("</testcase>\n", outputFile->line(7));
+    STRCMP_EQUAL("<system-out></system-out>\n", outputFile->line(8));
+    STRCMP_EQUAL("<system-err></system-err>\n", outputFile->line(9));
+    STRCMP_EQUAL("</testsuite>\n", outputFile->line(10));
+    STRCMP_EQUAL("<testsuite errors=\"0\" failures=\"0\" hostname=\"localhost\" name=\"secondTestGroup\" tests=\"2\" time=\"0.000\" timestamp=\"1978-10-03T00:00:00\">\n", outputFile->line(11));
+    STRCMP_EQUAL("<testcase classname=\"secondTestGroup\" name=\"secondTestName\" time=\"0.000\">\n", outputFile->line(14));
+    STRCMP_EQUAL("<testcase classname=\"secondTestGroup\" name=\"thirdTestName\" time=\"0.000\">\n", outputFile->line(16));
+    STRCMP_EQUAL("</testsuite>\n", outputFile->lineFromTheBack(2));
+}
+
+TEST(JUnitSingleFileOutputTest, elapsedTimeIsWrittenForGroupAndTestCases)
+{
+    testCaseRunner->start()
+            .withGroup("timeGroup")
+                .withTest("firstTestName").thatTakes(10).seconds()
+                .withTest("secondTestName").thatTakes(50).seconds()
+            .end();
+
+    outputFile = fileSystem.file("cpputest.xml");
+    STRCMP_EQUAL("<testsuite errors=\"0\" failures=\"0\" hostname=\"localhost\" name=\"timeGroup\" tests=\"2\" time=\"0.060\" timestamp=\"1978-10-03T00:00:00\">\n", outputFile->line(3));
+    STRCMP_EQUAL("<testcase classname=\"timeGroup\" name=\"firstTestName\" time=\"0.010\">\n", outputFile->line(6));
+    STRCMP_EQUAL("<testcase classname=\"timeGroup\" name=\"secondTestName\" time=\"0.050\">\n", outputFile->line(8));
+}
+
+TEST(JUnitSingleFileOutputTest, peakMemoryOfATestIsWrittenAsProperties)
+{
+    testCaseRunner->start()
+            .withGroup("memoryGroup").withTest("testName").thatPeaksAt(120, 3)
+            .end();
+
+    outputFile = fileSystem.file("cpputest.xml");
+    STRCMP_EQUAL("<testcase classname=\"memoryGroup\" name=\"testName\" time=\"0.000\">\n", outputFile->line(6));
+    STRCMP_EQUAL("<properties>\n", outputFile->line(7));
+    STRCMP_EQUAL("<property name=\"peak_memory_bytes\" value=\"120\"/>\n", outputFile->line(8));
+    STRCMP_EQUAL("<property name=\"peak_memory_blocks\" value=\"3\"/>\n", outputFile->line(9));
+    STRCMP_EQUAL("</properties>\n", outputFile->line(10));
+}
+
+TEST(JUnitSingleFileOutputTest, failureIsEscapedTheSameWayAsThePerGroupOutput)
+{
+    testCaseRunner->start()
+            .withGroup("testGroup")
+                .withTest("passingOne")
+                .withTest("FailingTest").thatFails("Test <\"just\" & failing>\n", "thisfile", 10)
+            .end();
+
+    outputFile = fileSystem.file("cpputest.xml");
+    STRCMP_EQUAL("<testsuite errors=\"0\" failures=\"1\" hostname=\"localhost\" name=\"testGroup\" tests=\"2\" time=\"0.000\" timestamp=\"1978-10-03T00:00:00\">\n", outputFile->line(3));
+    STRCMP_EQUAL("<testcase classname=\"testGroup\" name=\"FailingTest\" time=\"0.000\">\n", outputFile->line(8));
+    STRCMP_EQUAL("<failure message=\"thisfile:10: Test ['just' &amp; failing]{newline}\" type=\"AssertionFailedError\">\n", outputFile->line(9));
+    STRCMP_EQUAL("</failure>\n", outputFile->line(10));
+    STRCMP_EQUAL("</testcase>\n", outputFile->line(11));
+}
+
+TEST(JUnitSingleFileOutputTest, ignoredTestIsSkippedAndPackageNameIsUsed)
+{
+    junitOutput->setPackageName("packagename");
+    testCaseRunner->start()
+            .withGroup("groupname").withIgnoredTest("testname")
+            .end();
+
+    outputFile = fileSystem.file("cpputest.xml");
+    STRCMP_EQUAL("<testcase classname=\"packagename.groupname\" name=\"testname\" time=\"0.000\">\n", outputFile->line(6));
+    STRCMP_EQUAL("<skipped />\n", outputFile->line(7));
+    STRCMP_EQUAL("</testcase>\n", outputFile->line(8));
+}
+
+TEST(JUnitSingleFileOutputTest, manyTestCasesGrowTheGroupBuffer)
+{
+    testCaseRunner->start().withGroup("bigGroup");
+    for (int i = 0; i < 200; i++)
+        testCaseRunner->withTest("aTestWithAReasonablyLongNameToFillTheBuffer");
+    testCaseRunner->end();
+
+    outputFile = fileSystem.file("cpputest.xml");
+    STRCMP_EQUAL("<testsuite errors=\"0\" failures=\"0\" hostname=\"localhost\" name=\"bigGroup\" tests=\"200\" time=\"0.000\" timestamp=\"1978-10-03T00:00:00\">\n", outputFile->line(3));
+    LONGS_EQUAL(2 + 2 + 400 + 4 + 1, outputFile->amountOfLines());
+}
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2007, Michael Feathers, James Grenning and Bas Vodde
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE EARLIER MENTIONED AUTHORS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <copyright holder> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/JsonTestOutput.h"
+#include "CppUTest/TestResult.h"
+#include "CppUTest/PlatformSpecificFunctions.h"
+
+static long millisTime;
+
+extern "C" {
+
+    static long MockGetPlatformSpecificTimeInMillis()
+    {
+        return millisTime;
+    }
+
+}
+
+class JsonTestOutputToString : public JsonTestOutput
+{
+public:
+    virtual void printBuffer(const char* s) _override
+    {
+        output += s;
+    }
+
+    virtual void flush() _override
+    {
+        flushed = true;
+    }
+
+    SimpleString output;
+    bool flushed;
+
+    JsonTestOutputToString() : flushed(false) {}
+};
+
+TEST_GROUP(JsonTestOutput)
+{
+    JsonTestOutputToString* printer;
+    UtestShell* tst;
+    TestResult* result;
+
+    void setup()
+    {
+        printer = new JsonTestOutputToString;
+        tst = new UtestShell("group", "test", "file", 10);
+        result = new TestResult(*printer);
+        millisTime = 0;
+        UT_PTR_SET(GetPlatformSpecificTimeInMillis, MockGetPlatformSpecificTimeInMillis);
+    }
+
+    void teardown()
+    {
+        delete result;
+        delete tst;
+        delete printer;
+    }
+
+    void runPassingTest()
+    {
+        result->currentTestStarted(tst);
+        millisTime += 3;
+        result->countCheck();
+        result->countCheck();
+        result->currentTestEnded(tst);
+    }
+};
+
+TEST(JsonTestOutput, testsStartedIsOneLine)
+{
+    printer->printTestsStarted();
+    STRCMP_EQUAL("{\"event\":\"tests_started\"}\n", printer->output.asCharString());
+}
+
+TEST(JsonTestOutput, groupStartAndEnd)
+{
+    result->currentGroupStarted(tst);
+    millisTime = 5;
+    result->currentGroupEnded(tst);
+    STRCMP_EQUAL("{\"event\":\"group_start\",\"group\":\"group\"}\n"
+                 "{\"event\":\"group_end\",\"group\":\"group\",\"duration_ns\":5000000}\n", printer->output.asCharString());
+}
+
+TEST(JsonTestOutput, passingTestPrintsStartAndEndWithDurationAndChecks)
+{
+    runPassingTest();
+    STRCMP_EQUAL("{\"event\":\"test_start\",\"group\":\"group\",\"name\":\"test\",\"file\":\"file\",\"line\":10}\n"
+                 "{\"event\":\"test_end\",\"group\":\"group\",\"name\":\"test\",\"result\":\"passed\",\"duration_ns\":3000000,\"checks\":2,\"allocations\":0,\"peak_memory_bytes\":0,\"peak_memory_blocks\":0}\n",
+                 printer->output.asCharString());
+}
+
+TEST(JsonTestOutput, checksAreCountedPerTest)
+{
+    runPassingTest();
+    printer->output = "";
+    result->currentTestStarted(tst);
+    result->countCheck();
+    result->currentTestEnded(tst);
+    STRCMP_CONTAINS("\"duration_ns\":0,\"checks\":1,", printer->output.asCharString());
+}
+
+TEST(JsonTestOutput, failingTestPrintsFailureEventAndFailedResult)
+{
+    result->currentTestStarted(tst);
+    result->addFailure(TestFailure(tst, "failfile", 20, "message"));
+    result->currentTestEnded(tst);
+    STRCMP_CONTAINS("{\"event\":\"test_failure\",\"group\":\"group\",\"name\":\"test\",\"file\":\"failfile\",\"line\":20,\"message\":\"message\"}\n",
+                    printer->output.asCharString());
+    STRCMP_CONTAINS("\"result\":\"failed\"", printer->output.asCharString());
+}
+
+TEST(JsonTestOutput, ignoredTestHasIgnoredResult)
+{
+    IgnoredUtestShell ignored("group", "ignored", "file", 12);
+    result->currentTestStarted(&ignored);
+    result->currentTestEnded(&ignored);
+    STRCMP_CONTAINS("\"name\":\"ignored\",\"result\":\"ignored\"", printer->output.asCharString());
+}
+
+TEST(JsonTestOutput, allocationsDuringTheTestAreCounted)
+{
+    result->currentTestStarted(tst);
+    char* memory = new char[10];
+    delete [] memory;
+    result->currentTestEnded(tst);
+    STRCMP_CONTAINS("\"allocations\":1,", printer->output.asCharString());
+}
+
+TEST(JsonTestOutput, peakMemoryOfTheTestIsPrinted)
+{
+    result->currentTestStarted(tst);
+    result->setCurrentTestPeakMemory(120, 3);
+    result->currentTestEnded(tst);
+    STRCMP_CONTAINS("\"peak_memory_bytes\":120,\"peak_memory_blocks\":3}", printer->output.asCharString());
+}
+
+TEST(JsonTestOutput, stringsAreEscaped)
+{
+    UtestShell weird("gr\"oup", "te\\st", "fi\tle", 1);
+    result->currentTestStarted(&weird);
+    result->addFailure(TestFailure(&weird, "file", 1, "line\nbreak\001"));
+    STRCMP_CONTAINS("\"group\":\"gr\\\"oup\",\"name\":\"te\\\\st\",\"file\":\"fi\\tle\"", printer->output.asCharString());
+    STRCMP_CONTAINS("\"message\":\"line\\nbreak\\u0001\"", printer->output.asCharString());
+}
+
+TEST(JsonTestOutput, longStringsAreEscapedInPieces)
+{
+    SimpleString longMessage("\"", 300);
+    result->currentTestStarted(tst);
+    result->addFailure(TestFailure(tst, "file", 1, longMessage));
+    STRCMP_CONTAINS(SimpleString("\\\"", 300).asCharString(), printer->output.asCharString());
+}
+
+TEST(JsonTestOutput, testsEndedPrintsTotalsAndFlushes)
+{
+    runPassingTest();
+    result->countTest();
+    result->countRun();
+    printer->output = "";
+    millisTime = 0;
+    result->testsEnded();
+    STRCMP_EQUAL("{\"event\":\"tests_ended\",\"tests\":1,\"ran\":1,\"checks\":2,\"ignored\":0,\"filtered_out\":0,\"failures\":0,\"duration_ns\":0}\n",
+                 printer->output.asCharString());
+    CHECK(printer->flushed);
+}
+
+TEST(JsonTestOutput, testRunIsOneLine)
+{
+    printer->printTestRun(2, 3);
+    STRCMP_EQUAL("{\"event\":\"run_start\",\"run\":2,\"of\":3}\n", printer->output.asCharString());
+}
+
+TEST(JsonTestOutput, printedTextIsARecordOfItsOwn)
+{
+    printer->print("some \"text\"\n");
+    STRCMP_EQUAL("{\"event\":\"print\",\"text\":\"some \\\"text\\\"\\n\"}\n", printer->output.asCharString());
+}
+
+TEST(JsonTestOutput, printedNumberIsARecordOfItsOwn)
+{
+    printer->print(42L);
+    STRCMP_EQUAL("{\"event\":\"print\",\"text\":\"42\"}\n", printer->output.asCharString());
+}
@@ -72,7 +72,7 @@ class AllocatorForMemoryLeakDetectionTest: public TestMemoryAllocator
 {
 public:
     AllocatorForMemoryLeakDetectionTest() :
-        alloc_called(0), free_called(0), allocMemoryLeakNodeCalled(0), freeMemoryLeakNodeCalled(0)
+        alloc_called(0), free_called(0), allocMemoryLeakNodeCalled(0), freeMemoryLeakNodeCalled(0), lastFreeFile(NULL), lastFreeLine(0)
     {
     }
 
@@ -80,6 +80,8 @@ public:
     int free_called;
     int allocMemoryLeakNodeCalled;
     int freeMemoryLeakNodeCalled;
+    const char* lastFreeFile;
+    int lastFreeLine;
 
     char* alloc_memory(size_t size, const char* file, int line)
     {
@@ -89,6 +91,8 @@ public:
     void free_memory(char* memory, const char* file, int line)
     {
         free_called++;
+        lastFreeFile = file;
+        lastFreeLine = line;
         TestMemoryAllocator::free_memory(memory, file, line);
     }
 
@@ -101,6 +105,7 @@ public:
     void freeMemoryLeakNode(char* memory)
     {
         freeMemoryLeakNodeCalled++;
+        PlatformSpecificMemset(memory, 0, sizeof(MemoryLeakDetectorNode));
         TestMemoryAllocator::free_memory(memory, __FILE__, __LINE__);
     }
 };
@@ -129,6 +134,66 @@ TEST_GROUP(MemoryLeakDetectorTest)
     }
 };
 
+TEST(MemoryLeakDetectorTest, FailedReallocKeepsTheOldMemoryTracked)
+{
+    FaultInjectionSchedule schedule;
+    FaultInjectionMemoryAllocator failingAllocator(&schedule, testAllocator);
+    char* mem = detector->allocMemory(&failingAllocator, 10, "file", 1, true);
+    schedule.failAllocationNumber(2);
+
+    POINTERS_EQUAL(NULL, detector->reallocMemory(&failingAllocator, mem, 20, "other.cpp", 2, true));
+    LONGS_EQUAL(1, detector->totalMemoryLeaks(mem_leak_period_checking));
+    CHECK(detector->getCurrentMemoryInUse() == 10);
+
+    detector->deallocMemory(&failingAllocator, mem, true);
+    LONGS_EQUAL(0, detector->totalMemoryLeaks(mem_leak_period_checking));
+}
+
+TEST(MemoryLeakDetectorTest, PeakMemoryOfTheCheckingPeriodIsTracked)
+{
+    char* mem1 = detector->allocMemory(testAllocator, 10);
+    char* mem2 = detector->allocMemory(testAllocator, 20);
+    detector->deallocMemory(testAllocator, mem1);
+    char* mem3 = detector->allocMemory(testAllocator, 5);
+
+    CHECK(detector->getCurrentMemoryInUse() == 25);
+    CHECK(detector->getCurrentBlocksInUse() == 2);
+    CHECK(detector->getPeakMemoryInUse() == 30);
+    CHECK(detector->getPeakBlocksInUse() == 2);
+
+    detector->deallocMemory(testAllocator, mem2);
+    detector->deallocMemory(testAllocator, mem3);
+    CHECK(detector->getCurrentMemoryInUse() == 0);
+    CHECK(detector->getPeakMemoryInUse() == 30);
+}
+
+TEST(MemoryLeakDetectorTest, PeakMemoryIsResetWhenCheckingStarts)
+{
+    char* mem = detector->allocMemory(testAllocator, 10);
+    detector->stopChecking();
+    detector->startChecking();
+    CHECK(detector->getPeakMemoryInUse() == 0);
+
+    detector->deallocMemory(testAllocator, mem);
+    CHECK(detector->getCurrentMemoryInUse() == 0);
+    CHECK(detector->getCurrentBlocksInUse() == 0);
+}
+
+TEST(MemoryLeakDetectorTest, MemoryAllocatedOutsideTheCheckingPeriodDoesNotCountForThePeak)
+{
+    detector->stopChecking();
+    char* mem = detector->allocMemory(testAllocator, 10);
+    detector->startChecking();
+    detector->deallocMemory(testAllocator, mem);
+    char* reallocated = detector->reallocMemory(testAllocator, NULL, 8, "file", 1);
+    reallocated = detector->reallocMemory(testAllocator, reallocated, 16, "file", 1);
+
+    CHECK(detector->getCurrentMemoryInUse() == 16);
+    CHECK(detector->getPeakMemoryInUse() == 16);
+    CHECK(detector->getCurrentBlocksInUse() == 1);
+    detector->deallocMemory(testAllocator, reallocated);
+}
+
 TEST(MemoryLeakDetectorTest, OneLeak)
 {
     char* mem = detector->allocMemory(testAllocator, 3);
@@ -396,6 +461,58 @@ TEST(MemoryLeakDetectorTest, AllocOneTypeFreeAnotherTypeWithCheckingDisabled)
     detector->enableAllocationTypeChecking();
 }
 
+TEST(MemoryLeakDetectorTest, alignedMemoryIsAlignedAndFreedWithoutFailures)
+{
+    char* mem = detector->allocAlignedMemory(testAllocator, 10, 256, "ALLOC.c", 10);
+    LONGS_EQUAL(0, (long) ((size_t) mem % 256));
+    LONGS_EQUAL(1, detector->totalMemoryLeaks(mem_leak_period_checking));
+    detector->deallocAlignedMemory(testAllocator, mem, 256);
+    LONGS_EQUAL(0, detector->totalMemoryLeaks(mem_leak_period_checking));
+    LONGS_EQUAL(1, testAllocator->free_called);
+    STRCMP_EQUAL("", reporter->message->asCharString());
+}
+
+TEST(MemoryLeakDetectorTest, alignedMemoryStaysAlignedWithAHeadRedzone)
+{
+    detector->setRedzoneSizes(40, 3);
+    char* mem = detector->allocAlignedMemory(testAllocator, 10, 64);
+    LONGS_EQUAL(0, (long) ((size_t) mem % 64));
+    mem[-1] = 'x';
+    detector->deallocSizedMemory(testAllocator, mem, 10, 64, "FREE.c", 100);
+    CHECK(reporter->message->contains("Memory corruption"));
+}
+
+TEST(MemoryLeakDetectorTest, sizedDeallocationWithTheAllocatedSizeIsNoFailure)
+{
+    char* mem = detector->allocMemory(testAllocator, 10);
+    detector->deallocSizedMemory(testAllocator, mem, 10, 0);
+    STRCMP_EQUAL("", reporter->message->asCharString());
+    LONGS_EQUAL(1, testAllocator->free_called);
+}
+
+TEST(MemoryLeakDetectorTest, sizedDeallocationWithAnotherSizeIsReported)
+{
+    char* mem = detector->allocMemory(testAllocator, 10, "ALLOC.c", 10);
+    detector->deallocSizedMemory(testAllocator, mem, 8, 0, "FREE.c", 100);
+    CHECK(reporter->message->contains("Deallocation size mismatch: deallocated as 8 bytes"));
+    CHECK(reporter->message->contains("   allocated at file: ALLOC.c line: 10 size: 10"));
+    CHECK(reporter->message->contains("   deallocated at file: FREE.c line: 100"));
+}
+
+TEST(MemoryLeakDetectorTest, alignedDeallocationOfUnalignedMemoryIsReported)
+{
+    char* mem = detector->allocMemory(testAllocator, 10, "ALLOC.c", 10);
+    detector->deallocAlignedMemory(testAllocator, mem, 32, "FREE.c", 100);
+    CHECK(reporter->message->contains("Deallocation alignment mismatch: allocated with alignment 0, deallocated with alignment 32"));
+}
+
+TEST(MemoryLeakDetectorTest, unalignedDeallocationOfAlignedMemoryIsReported)
+{
+    char* mem = detector->allocAlignedMemory(testAllocator, 10, 32);
+    detector->deallocMemory(testAllocator, mem);
+    CHECK(reporter->message->contains("Deallocation alignment mismatch: allocated with alignment 32, deallocated with alignment 0"));
+}
+
 TEST(MemoryLeakDetectorTest, mallocLeakGivesAdditionalWarning)
 {
     char* mem = detector->allocMemory(defaultMallocAllocator(), 100, "ALLOC.c", 10);
@@ -428,6 +545,104 @@ TEST(MemoryLeakDetectorTest, MarkCheckingPeriodLeaksAsNonCheckingPeriod)
     PlatformSpecificFree(mem2);
 }
 
+TEST(MemoryLeakDetectorTest, LeaksAreCountedPerPeriod)
+{
+    detector->disable();
+    char* disabled = detector->allocMemory(testAllocator, 1);
+    detector->enable();
+    char* enabled = detector->allocMemory(testAllocator, 2);
+    detector->startChecking();
+    char* checking1 = detector->allocMemory(testAllocator, 3);
+    char* checking2 = detector->allocMemory(testAllocator, 4);
+
+    LONGS_EQUAL(1, detector->totalMemoryLeaks(mem_leak_period_disabled));
+    LONGS_EQUAL(3, detector->totalMemoryLeaks(mem_leak_period_enabled));
+    LONGS_EQUAL(2, detector->totalMemoryLeaks(mem_leak_period_checking));
+    LONGS_EQUAL(4, detector->totalMemoryLeaks(mem_leak_period_all));
+
+    detector->deallocMemory(testAllocator, checking1);
+    detector->deallocMemory(testAllocator, disabled);
+    LONGS_EQUAL(0, detector->totalMemoryLeaks(mem_leak_period_disabled));
+    LONGS_EQUAL(1, detector->totalMemoryLeaks(mem_leak_period_checking));
+    LONGS_EQUAL(2, detector->totalMemoryLeaks(mem_leak_period_all));
+
+    detector->deallocMemory(testAllocator, enabled);
+    detector->deallocMemory(testAllocator, checking2);
+    LONGS_EQUAL(0, detector->totalMemoryLeaks(mem_leak_period_all));
+}
+
+TEST(MemoryLeakDetectorTest, ReportOfCheckingPeriodOnlyContainsCheckingPeriodLeaks)
+{
+    detector->stopChecking();
+    char* enabled = detector->allocMemory(testAllocator, 11, "enabled.cpp", 1);
+    detector->startChecking();
+    char* checking = detector->allocMemory(testAllocator, 22, "checking.cpp", 2);
+    detector->stopChecking();
+
+    SimpleString output = detector->report(mem_leak_period_checking);
+    STRCMP_CONTAINS("checking.cpp", output.asCharString());
+    CHECK(!output.contains("enabled.cpp"));
+
+    output = detector->report(mem_leak_period_enabled);
+    STRCMP_CONTAINS("checking.cpp", output.asCharString());
+    STRCMP_CONTAINS("enabled.cpp", output.asCharString());
+
+    detector->deallocMemory(testAllocator, enabled);
+    detector->deallocMemory(testAllocator, checking);
+}
+
+TEST(MemoryLeakDetectorTest, MarkedLeaksCanStillBeFreed)
+{
+    char* mem = detector->allocMemory(testAllocator, 5);
+    detector->markCheckingPeriodLeaksAsNonCheckingPeriod();
+    LONGS_EQUAL(1, detector->totalMemoryLeaks(mem_leak_period_enabled));
+    detector->deallocMemory(testAllocator, mem);
+    LONGS_EQUAL(0, detector->totalMemoryLeaks(mem_leak_period_all));
+    STRCMP_CONTAINS("No memory leaks", detector->report(mem_leak_period_all));
+}
+
+TEST(MemoryLeakDetectorTest, AllocationsOfATestGroupAreNoLeaksOfItsTests)
+{
+    detector->stopChecking();
+    detector->startCheckingTestGroup();
+    char* groupMem = detector->allocMemory(testAllocator, 5);
+    detector->stopChecking();
+    detector->startChecking();
+    char* testMem = detector->allocMemory(testAllocator, 5);
+    detector->stopChecking();
+    LONGS_EQUAL(1, detector->totalMemoryLeaks(mem_leak_period_checking));
+    LONGS_EQUAL(1, detector->totalMemoryLeaks(mem_leak_period_test_group));
+    detector->deallocMemory(testAllocator, groupMem);
+    detector->deallocMemory(testAllocator, testMem);
+}
+
+TEST(MemoryLeakDetectorTest, MarkTestGroupPeriodLeaksAsNonCheckingPeriod)
+{
+    detector->stopChecking();
+    detector->startCheckingTestGroup();
+    char* mem = detector->allocMemory(testAllocator, 5);
+    detector->stopChecking();
+    detector->markTestGroupPeriodLeaksAsNonCheckingPeriod();
+    LONGS_EQUAL(0, detector->totalMemoryLeaks(mem_leak_period_test_group));
+    LONGS_EQUAL(1, detector->totalMemoryLeaks(mem_leak_period_enabled));
+    detector->deallocMemory(testAllocator, mem);
+}
+
+TEST(MemoryLeakDetectorTest, ClearAllAccountingOfAPeriodKeepsTheOtherPeriods)
+{
+    detector->stopChecking();
+    char* enabled = detector->allocMemory(defaultMallocAllocator(), 5, true);
+    detector->startChecking();
+    char* checking = detector->allocMemory(defaultMallocAllocator(), 5, true);
+    detector->clearAllAccounting(mem_leak_period_checking);
+
+    LONGS_EQUAL(0, detector->totalMemoryLeaks(mem_leak_period_checking));
+    LONGS_EQUAL(1, detector->totalMemoryLeaks(mem_leak_period_enabled));
+    detector->deallocMemory(defaultMallocAllocator(), enabled, true);
+    LONGS_EQUAL(0, detector->totalMemoryLeaks(mem_leak_period_all));
+    PlatformSpecificFree(checking);
+}
+
 TEST(MemoryLeakDetectorTest, memoryCorruption)
 {
     char* mem = detector->allocMemory(defaultMallocAllocator(), 10, "ALLOC.c", 10);
@@ -440,6 +655,215 @@ TEST(MemoryLeakDetectorTest, memoryCorruption)
     CHECK(reporter->message->contains("   deallocated at file: FREE.c line: 100 type: free"));
 }
 
+TEST(MemoryLeakDetectorTest, tailRedzoneIsFilledWithTheRedzonePattern)
+{
+    unsigned char* mem = (unsigned char*) detector->allocMemory(testAllocator, 10);
+    BYTES_EQUAL(MemoryLeakDetector::default_redzone_pattern, mem[10]);
+    BYTES_EQUAL(MemoryLeakDetector::default_redzone_pattern, mem[12]);
+    detector->deallocMemory(testAllocator, mem);
+}
+
+TEST(MemoryLeakDetectorTest, writeBeforeTheMemoryIsDetectedWithAHeadRedzone)
+{
+    detector->setRedzoneSizes(16, 3);
+    char* mem = detector->allocMemory(defaultMallocAllocator(), 10, "ALLOC.c", 10);
+    mem[-1] = 'O';
+    detector->deallocMemory(defaultMallocAllocator(), mem, "FREE.c", 100);
+    CHECK(reporter->message->contains("Memory corruption"));
+    CHECK(reporter->message->contains("   allocated at file: ALLOC.c line: 10 size: 10 type: malloc"));
+}
+
+TEST(MemoryLeakDetectorTest, writeFarBehindTheMemoryIsDetectedWithALargeTailRedzone)
+{
+    detector->setRedzoneSizes(0, 64);
+    char* mem = detector->allocMemory(testAllocator, 10);
+    mem[70] = 'O';
+    detector->deallocMemory(testAllocator, mem);
+    CHECK(reporter->message->contains("Memory corruption"));
+}
+
+TEST(MemoryLeakDetectorTest, redzonesWithoutCorruptionAreNotReported)
+{
+    detector->setRedzoneSizes(40, 100);
+    char* mem = detector->allocMemory(testAllocator, 13);
+    PlatformSpecificMemset(mem, 0, 13);
+    detector->deallocMemory(testAllocator, mem);
+    STRCMP_EQUAL("", reporter->message->asCharString());
+    LONGS_EQUAL(1, testAllocator->free_called);
+}
+
+TEST(MemoryLeakDetectorTest, headRedzoneKeepsTheMemoryAligned)
+{
+    detector->setRedzoneSizes(3, 3);
+    char* mem = detector->allocMemory(testAllocator, 8);
+    LONGS_EQUAL(0, (long) ((size_t) mem % (2 * sizeof(void*))));
+    detector->deallocMemory(testAllocator, mem);
+    STRCMP_EQUAL("", reporter->message->asCharString());
+}
+
+TEST(MemoryLeakDetectorTest, poisonPatternsAreConfigurable)
+{
+    detector->setRedzoneSizes(16, 3);
+    detector->setPoisonPatterns(0xAA, 0x55);
+    unsigned char* mem = (unsigned char*) detector->allocMemory(testAllocator, 4);
+    BYTES_EQUAL(0xAA, mem[-1]);
+    BYTES_EQUAL(0xAA, mem[4]);
+    detector->invalidateMemory((char*) mem);
+    BYTES_EQUAL(0x55, mem[0]);
+    BYTES_EQUAL(0x55, mem[3]);
+    detector->deallocMemory(testAllocator, mem);
+    STRCMP_EQUAL("", reporter->message->asCharString());
+}
+
+TEST(MemoryLeakDetectorTest, changingTheRedzonesOnlyAffectsNewMemory)
+{
+    char* mem = detector->allocMemory(testAllocator, 10);
+    detector->setRedzoneSizes(32, 32);
+    detector->setPoisonPatterns(0x11, 0x22);
+    detector->deallocMemory(testAllocator, mem);
+    STRCMP_EQUAL("", reporter->message->asCharString());
+}
+
+TEST(MemoryLeakDetectorTest, reallocKeepsTheContentsAndTheRedzones)
+{
+    detector->setRedzoneSizes(16, 3);
+    char* mem = detector->allocMemory(defaultMallocAllocator(), 4, true);
+    PlatformSpecificMemCpy(mem, "abc", 4);
+    mem = detector->reallocMemory(defaultMallocAllocator(), mem, 1000, "file", 1, true);
+    STRCMP_EQUAL("abc", mem);
+    mem[-1] = 'O';
+    detector->deallocMemory(defaultMallocAllocator(), mem, true);
+    CHECK(reporter->message->contains("Memory corruption"));
+}
+
+TEST(MemoryLeakDetectorTest, reportCorruptedMemoryIsEmptyWhenAllRedzonesAreIntact)
+{
+    char* mem = detector->allocMemory(testAllocator, 10);
+    STRCMP_EQUAL("", detector->reportCorruptedMemory(mem_leak_period_checking));
+    detector->deallocMemory(testAllocator, mem);
+}
+
+TEST(MemoryLeakDetectorTest, reportCorruptedMemoryFindsCorruptedMemoryThatIsNotFreed)
+{
+    detector->stopChecking();
+    char* notChecked = detector->allocMemory(testAllocator, 10, "notchecked.cpp", 1);
+    detector->startChecking();
+    char* mem = detector->allocMemory(testAllocator, 10, "checked.cpp", 2);
+    mem[10] = 'O';
+    notChecked[10] = 'O';
+
+    SimpleString output = detector->reportCorruptedMemory(mem_leak_period_checking);
+    STRCMP_CONTAINS("Memory corruption (written out of bounds?) found at the end of the test", output.asCharString());
+    STRCMP_CONTAINS("allocated at file: checked.cpp line: 2 size: 10", output.asCharString());
+    CHECK(!output.contains("notchecked.cpp"));
+
+    detector->removeMemoryLeakInformationWithoutCheckingOrDeallocatingTheMemoryButDeallocatingTheAccountInformation(testAllocator, mem, false);
+    detector->removeMemoryLeakInformationWithoutCheckingOrDeallocatingTheMemoryButDeallocatingTheAccountInformation(testAllocator, notChecked, false);
+    testAllocator->free_memory(mem, "file", 1);
+    testAllocator->free_memory(notChecked, "file", 1);
+}
+
+TEST(MemoryLeakDetectorTest, quarantinedMemoryIsPoisonedAndFreedWhenFlushed)
+{
+    detector->setQuarantineSize(100);
+    unsigned char* mem = (unsigned char*) detector->allocMemory(testAllocator, 10);
+    detector->deallocMemory(testAllocator, mem);
+    LONGS_EQUAL(0, testAllocator->free_called);
+    BYTES_EQUAL(MemoryLeakDetector::default_freed_memory_pattern, mem[0]);
+    BYTES_EQUAL(MemoryLeakDetector::default_freed_memory_pattern, mem[9]);
+    LONGS_EQUAL(0, detector->totalMemoryLeaks(mem_leak_period_all));
+
+    STRCMP_EQUAL("", detector->flushQuarantine());
+    LONGS_EQUAL(1, testAllocator->free_called);
+}
+
+TEST(MemoryLeakDetectorTest, writeToQuarantinedMemoryIsReportedWhenFlushed)
+{
+    detector->setQuarantineSize(100);
+    char* mem = detector->allocMemory(testAllocator, 10, "ALLOC.c", 10);
+    detector->deallocMemory(testAllocator, mem, "FREE.c", 100);
+    mem[3] = 'x';
+
+    SimpleString output = detector->flushQuarantine();
+    STRCMP_CONTAINS("Write to freed memory (used after free?)", output.asCharString());
+    STRCMP_CONTAINS("allocated at file: ALLOC.c line: 10 size: 10", output.asCharString());
+    STRCMP_CONTAINS("deallocated at file: FREE.c line: 100", output.asCharString());
+    LONGS_EQUAL(1, testAllocator->free_called);
+}
+
+TEST(MemoryLeakDetectorTest, oldestQuarantinedMemoryIsVerifiedAndFreedWhenTheQuarantineIsFull)
+{
+    detector->setQuarantineSize(20);
+    char* mem1 = detector->allocMemory(testAllocator, 15, "ALLOC.c", 1);
+    char* mem2 = detector->allocMemory(testAllocator, 15, "ALLOC.c", 2);
+    detector->deallocMemory(testAllocator, mem1, "FREE.c", 1);
+    mem1[0] = 'x';
+    LONGS_EQUAL(0, testAllocator->free_called);
+
+    detector->deallocMemory(testAllocator, mem2, "FREE.c", 2);
+    LONGS_EQUAL(1, testAllocator->free_called);
+    CHECK(reporter->message->contains("Write to freed memory"));
+    CHECK(reporter->message->contains("allocated at file: ALLOC.c line: 1 size: 15"));
+
+    STRCMP_EQUAL("", detector->flushQuarantine());
+    LONGS_EQUAL(2, testAllocator->free_called);
+}
+
+TEST(MemoryLeakDetectorTest, memoryLargerThanTheQuarantineIsFreedImmediately)
+{
+    detector->setQuarantineSize(10);
+    char* mem = detector->allocMemory(testAllocator, 11);
+    detector->deallocMemory(testAllocator, mem);
+    LONGS_EQUAL(1, testAllocator->free_called);
+}
+
+TEST(MemoryLeakDetectorTest, quarantineOfSizeZeroIsOff)
+{
+    detector->setQuarantineSize(0);
+    char* mem = detector->allocMemory(testAllocator, 0);
+    detector->deallocMemory(testAllocator, mem);
+    LONGS_EQUAL(1, testAllocator->free_called);
+}
+
+TEST(MemoryLeakDetectorTest, memoryFreedOutsideTheCheckingPeriodIsNotQuarantined)
+{
+    detector->setQuarantineSize(100);
+    detector->stopChecking();
+    char* mem = detector->allocMemory(testAllocator, 10);
+    detector->deallocMemory(testAllocator, mem);
+    LONGS_EQUAL(1, testAllocator->free_called);
+}
+
+TEST(MemoryLeakDetectorTest, separatelyAllocatedNodesAreFreedWhenLeavingTheQuarantine)
+{
+    detector->setQuarantineSize(100);
+    char* mem = detector->allocMemory(testAllocator, 10, true);
+    detector->deallocMemory(testAllocator, mem, true);
+    LONGS_EQUAL(0, testAllocator->freeMemoryLeakNodeCalled);
+    detector->flushQuarantine();
+    LONGS_EQUAL(1, testAllocator->freeMemoryLeakNodeCalled);
+    LONGS_EQUAL(1, testAllocator->free_called);
+}
+
+TEST(MemoryLeakDetectorTest, memoryLeavingTheQuarantineIsFreedWhereItWasDeallocatedAfterItsNodeIsFreed)
+{
+    detector->setQuarantineSize(100);
+    char* mem = detector->allocMemory(testAllocator, 10, true);
+    detector->deallocMemory(testAllocator, mem, "free.cpp", 13, true);
+    detector->flushQuarantine();
+    STRCMP_EQUAL("free.cpp", testAllocator->lastFreeFile);
+    LONGS_EQUAL(13, testAllocator->lastFreeLine);
+}
+
+TEST(MemoryLeakDetectorTest, quarantineIsFreedWhenTheDetectorIsDestroyed)
+{
+    detector->setQuarantineSize(100);
+    detector->deallocMemory(testAllocator, detector->allocMemory(testAllocator, 10));
+    delete detector;
+    detector = new MemoryLeakDetector(reporter);
+    LONGS_EQUAL(1, testAllocator->free_called);
+}
+
 TEST(MemoryLeakDetectorTest, safelyDeleteNULL)
 {
     detector->deallocMemory(defaultNewAllocator(), 0);
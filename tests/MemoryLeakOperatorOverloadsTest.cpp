@@ -227,6 +227,82 @@ TEST(MemoryLeakOverridesToBeUsedInProductionCode, OperatorNewArrayOverloadingWit
     delete[] leak;
 }
 
+#if CPPUTEST_USE_SIZED_DEALLOCATION
+
+static void deleteWithTheWrongSize()
+{
+    char* memory = new char[10];
+    ::operator delete[](memory, (size_t) 5);
+    FAIL("Should never come here"); // LCOV_EXCL_LINE
+} // LCOV_EXCL_LINE
+
+TEST(MemoryLeakOverridesToBeUsedInProductionCode, SizedDeleteWithTheWrongSizeCausesATestFailure)
+{
+    TestTestingFixture fixture;
+    fixture.setTestFunction(deleteWithTheWrongSize);
+    fixture.runAllTests();
+    LONGS_EQUAL(1, fixture.getFailureCount());
+    fixture.assertPrintContains("Deallocation size mismatch: deallocated as 5 bytes");
+}
+
+#endif
+
+#if CPPUTEST_USE_ALIGNED_NEW
+
+struct OverAlignedForTest
+{
+    alignas(64) char data[64];
+};
+
+TEST(MemoryLeakOverridesToBeUsedInProductionCode, OverAlignedNewViaTheNewMacroIsAlignedAndTracked)
+{
+    OverAlignedForTest* leak = new OverAlignedForTest;
+    LONGS_EQUAL(0, (long) ((size_t) leak % 64));
+    STRCMP_CONTAINS("MemoryLeakOperatorOverloadsTest.cpp", memLeakDetector->report(mem_leak_period_checking));
+    delete leak;
+}
+
+TEST(MemoryLeakOverridesToBeUsedInProductionCode, OverAlignedNewArrayViaTheNewMacroIsAlignedAndTracked)
+{
+    OverAlignedForTest* leak = new OverAlignedForTest[3];
+    LONGS_EQUAL(0, (long) ((size_t) leak % 64));
+    STRCMP_CONTAINS("MemoryLeakOperatorOverloadsTest.cpp", memLeakDetector->report(mem_leak_period_checking));
+    delete [] leak;
+}
+
+TEST(MemoryLeakOverridesToBeUsedInProductionCode, AlignedOperatorNewWithoutMacroIsTracked)
+{
+    int memLeaks = memLeakDetector->totalMemoryLeaks(mem_leak_period_checking);
+#ifdef CPPUTEST_USE_NEW_MACROS
+    #undef new
+#endif
+    void* memory = ::operator new(100, std::align_val_t(256));
+    void* nothrowMemory = ::operator new[](100, std::align_val_t(256), std::nothrow);
+#ifdef CPPUTEST_USE_NEW_MACROS
+    #include "CppUTest/MemoryLeakDetectorNewMacros.h"
+#endif
+    LONGS_EQUAL(0, (long) ((size_t) memory % 256));
+    LONGS_EQUAL(0, (long) ((size_t) nothrowMemory % 256));
+    LONGS_EQUAL(memLeaks + 2, memLeakDetector->totalMemoryLeaks(mem_leak_period_checking));
+    ::operator delete(memory, std::align_val_t(256));
+    ::operator delete[](nothrowMemory, std::align_val_t(256), std::nothrow);
+    LONGS_EQUAL(memLeaks, memLeakDetector->totalMemoryLeaks(mem_leak_period_checking));
+}
+
+TEST(MemoryLeakOverridesToBeUsedInProductionCode, OverAlignedNewIsAlignedWithoutLeakDetection)
+{
+    MemoryLeakWarningPlugin::turnOffNewDeleteOverloads();
+    OverAlignedForTest* memory = new OverAlignedForTest;
+    OverAlignedForTest* array = new OverAlignedForTest[2];
+    LONGS_EQUAL(0, (long) ((size_t) memory % 64));
+    LONGS_EQUAL(0, (long) ((size_t) array % 64));
+    delete [] array;
+    delete memory;
+    MemoryLeakWarningPlugin::turnOnNewDeleteOverloads();
+}
+
+#endif
+
 #else
 
 TEST(MemoryLeakOverridesToBeUsedInProductionCode, MemoryOverridesAreDisabled)
@@ -122,6 +122,25 @@ TEST(MemoryLeakWarningTest, TwoLeaks)
     fixture->assertPrintContains("Total number of leaks:  2");
 }
 
+static void _testAllocateAndFreeTwoBlocks()
+{
+    leak1 = detector->allocMemory(allocator, 10);
+    leak2 = (long*) (void*) detector->allocMemory(allocator, 4);
+    detector->deallocMemory(allocator, leak1);
+    detector->deallocMemory(allocator, leak2);
+    leak1 = 0;
+    leak2 = 0;
+}
+
+TEST(MemoryLeakWarningTest, PeakMemoryOfTheTestIsPassedToTheTestResult)
+{
+    fixture->setTestFunction(_testAllocateAndFreeTwoBlocks);
+    fixture->runAllTests();
+    LONGS_EQUAL(0, fixture->getFailureCount());
+    CHECK(fixture->result_->getCurrentTestPeakMemory() == 14);
+    CHECK(fixture->result_->getCurrentTestPeakBlocks() == 2);
+}
+
 static void _testIgnore2()
 {
     memPlugin->expectLeaksInTest(2);
@@ -136,6 +155,42 @@ TEST(MemoryLeakWarningTest, Ignore2)
     LONGS_EQUAL(0, fixture->getFailureCount());
 }
 
+static void _testLeakWithCorruptedMemory()
+{
+    memPlugin->expectLeaksInTest(1);
+    leak1 = detector->allocMemory(allocator, 10, "file", 5);
+    leak1[10] = 'x';
+}
+
+TEST(MemoryLeakWarningTest, CorruptedMemoryIsReportedAtTheEndOfTheTest)
+{
+    fixture->setTestFunction(_testLeakWithCorruptedMemory);
+    fixture->runAllTests();
+    LONGS_EQUAL(1, fixture->getFailureCount());
+    fixture->assertPrintContains("Memory corruption (written out of bounds?) found at the end of the test");
+    fixture->assertPrintContains("allocated at file: file line: 5 size: 10");
+    detector->removeMemoryLeakInformationWithoutCheckingOrDeallocatingTheMemoryButDeallocatingTheAccountInformation(allocator, leak1, false);
+    allocator->free_memory(leak1, "file", 5);
+    leak1 = 0;
+}
+
+static void _testWriteToFreedMemory()
+{
+    detector->setQuarantineSize(1000);
+    char* memory = detector->allocMemory(allocator, 10, "file", 7);
+    detector->deallocMemory(allocator, memory, "file", 8);
+    memory[0] = 'x';
+}
+
+TEST(MemoryLeakWarningTest, WriteToFreedMemoryIsReportedAtTheEndOfTheTest)
+{
+    fixture->setTestFunction(_testWriteToFreedMemory);
+    fixture->runAllTests();
+    LONGS_EQUAL(1, fixture->getFailureCount());
+    fixture->assertPrintContains("Write to freed memory (used after free?)");
+    fixture->assertPrintContains("deallocated at file: file line: 8");
+}
+
 static void _failAndLeakMemory()
 {
     leak1 = detector->allocMemory(allocator, 10);
@@ -149,6 +204,33 @@ TEST(MemoryLeakWarningTest, FailingTestDoesNotReportMemoryLeaks)
     LONGS_EQUAL(1, fixture->getFailureCount());
 }
 
+static void _allocateInTheGroupSetup()
+{
+    leak1 = detector->allocMemory(allocator, 10);
+}
+
+static void _freeInTheGroupTeardown()
+{
+    detector->deallocMemory(allocator, leak1);
+    leak1 = 0;
+}
+
+TEST(MemoryLeakWarningTest, AllocationOfTheGroupSetupIsNoLeakOfTheTests)
+{
+    TestGroupFixtureInstaller groupFixture("Generic", _allocateInTheGroupSetup, _freeInTheGroupTeardown, __FILE__, __LINE__);
+    fixture->runAllTests();
+    LONGS_EQUAL(0, fixture->getFailureCount());
+}
+
+TEST(MemoryLeakWarningTest, AllocationOfTheGroupSetupNotFreedByTheGroupTeardownIsReported)
+{
+    TestGroupFixtureInstaller groupFixture("Generic", _allocateInTheGroupSetup, NULL, __FILE__, __LINE__);
+    fixture->runAllTests();
+    LONGS_EQUAL(1, fixture->getFailureCount());
+    fixture->assertPrintContains("TEST_GROUP_TEARDOWN(Generic)");
+    fixture->assertPrintContains("Total number of leaks:  1");
+}
+
 static bool memoryLeakDetectorWasDeleted = false;
 static bool memoryLeakFailureWasDelete = false;
 
@@ -484,6 +566,145 @@ TEST(MemoryLeakWarningThreadSafe, turnOnThreadSafeNewDeleteOverloads)
 
 #endif
 
+#if CPPUTEST_USE_ALIGNED_NEW
+
+TEST(MemoryLeakWarningThreadSafe, turnOnThreadSafeNewDeleteOverloadsAlsoLocksAlignedNewAndDelete)
+{
+    int storedAmountOfLeaks = MemoryLeakWarningPlugin::getGlobalDetector()->totalMemoryLeaks(mem_leak_period_all);
+    MemoryLeakWarningPlugin::turnOnThreadSafeNewDeleteOverloads();
+
+#ifdef CPPUTEST_USE_NEW_MACROS
+    #undef new
+#endif
+    void* memory = ::operator new[](20, std::align_val_t(64), "file", 1);
+#ifdef CPPUTEST_USE_NEW_MACROS
+    #include "CppUTest/MemoryLeakDetectorNewMacros.h"
+#endif
+    LONGS_EQUAL(storedAmountOfLeaks + 1, MemoryLeakWarningPlugin::getGlobalDetector()->totalMemoryLeaks(mem_leak_period_all));
+    ::operator delete[](memory, std::align_val_t(64));
+
+    LONGS_EQUAL(storedAmountOfLeaks, MemoryLeakWarningPlugin::getGlobalDetector()->totalMemoryLeaks(mem_leak_period_all));
+    CHECK_EQUAL(2, mutexLockCount);
+    CHECK_EQUAL(2, mutexUnlockCount);
+
+    MemoryLeakWarningPlugin::turnOnNewDeleteOverloads();
+}
+
+#endif
+
+static int atomicAddCount = 0;
+
+static size_t StubAtomicAdd(volatile size_t* value, size_t amount)
+{
+    atomicAddCount++;
+    *value += amount;
+    return *value;
+}
+
+TEST_GROUP(MemoryLeakWarningStatisticsOnly)
+{
+    void setup()
+    {
+        UT_PTR_SET(PlatformSpecificMutexLock, StubMutexLock);
+        UT_PTR_SET(PlatformSpecificMutexUnlock, StubMutexUnlock);
+
+        mutexLockCount = 0;
+        mutexUnlockCount = 0;
+        atomicAddCount = 0;
+        MemoryLeakWarningPlugin::resetAllocationStatistics();
+    }
+
+    void teardown()
+    {
+        MemoryLeakWarningPlugin::turnOnNewDeleteOverloads();
+    }
+};
+
+TEST(MemoryLeakWarningStatisticsOnly, MallocReallocFreeAreCountedWithoutLockingOrTracking)
+{
+    int storedAmountOfLeaks = MemoryLeakWarningPlugin::getGlobalDetector()->totalMemoryLeaks(mem_leak_period_all);
+    MemoryLeakWarningPlugin::turnOnStatisticsOnlyNewDeleteOverloads();
+
+    char* memory = (char*) cpputest_malloc(10);
+    memory = (char*) cpputest_realloc(memory, 30);
+    LONGS_EQUAL(storedAmountOfLeaks, MemoryLeakWarningPlugin::getGlobalDetector()->totalMemoryLeaks(mem_leak_period_all));
+    cpputest_free(memory);
+
+    MemoryLeakWarningPlugin::turnOnNewDeleteOverloads();
+    MemoryAllocationStatistics statistics = MemoryLeakWarningPlugin::getAllocationStatistics();
+    CHECK(statistics.allocations == 2);
+    CHECK(statistics.deallocations == 2);
+    CHECK(statistics.bytesAllocated == 40);
+    LONGS_EQUAL(0, mutexLockCount);
+    LONGS_EQUAL(0, mutexUnlockCount);
+}
+
+TEST(MemoryLeakWarningStatisticsOnly, NewAndDeleteAreCounted)
+{
+    MemoryLeakWarningPlugin::turnOnStatisticsOnlyNewDeleteOverloads();
+
+    int* n = new int;
+    char* str = new char[20];
+    delete [] str;
+    delete n;
+
+    MemoryLeakWarningPlugin::turnOnNewDeleteOverloads();
+    MemoryAllocationStatistics statistics = MemoryLeakWarningPlugin::getAllocationStatistics();
+    CHECK(statistics.allocations == 2);
+    CHECK(statistics.deallocations == 2);
+    CHECK(statistics.bytesAllocated == sizeof(int) + 20);
+    LONGS_EQUAL(0, mutexLockCount);
+}
+
+#if CPPUTEST_USE_ALIGNED_NEW
+
+TEST(MemoryLeakWarningStatisticsOnly, AlignedNewAndDeleteAreCounted)
+{
+    MemoryLeakWarningPlugin::turnOnStatisticsOnlyNewDeleteOverloads();
+
+#ifdef CPPUTEST_USE_NEW_MACROS
+    #undef new
+#endif
+    void* memory = ::operator new(24, std::align_val_t(128), "file", 1);
+#ifdef CPPUTEST_USE_NEW_MACROS
+    #include "CppUTest/MemoryLeakDetectorNewMacros.h"
+#endif
+    LONGS_EQUAL(0, (long) ((size_t) memory % 128));
+    ::operator delete(memory, 24, std::align_val_t(128));
+
+    MemoryLeakWarningPlugin::turnOnNewDeleteOverloads();
+    MemoryAllocationStatistics statistics = MemoryLeakWarningPlugin::getAllocationStatistics();
+    CHECK(statistics.allocations == 1);
+    CHECK(statistics.deallocations == 1);
+    CHECK(statistics.bytesAllocated == 24);
+}
+
+#endif
+
+TEST(MemoryLeakWarningStatisticsOnly, CountersAreUpdatedWithThePlatformAtomicAdd)
+{
+    UT_PTR_SET(PlatformSpecificAtomicAdd, StubAtomicAdd);
+    MemoryLeakWarningPlugin::turnOnStatisticsOnlyNewDeleteOverloads();
+
+    cpputest_free(cpputest_malloc(10));
+
+    MemoryLeakWarningPlugin::turnOnNewDeleteOverloads();
+    LONGS_EQUAL(3, atomicAddCount);
+}
+
+TEST(MemoryLeakWarningStatisticsOnly, ResetClearsTheCounters)
+{
+    MemoryLeakWarningPlugin::turnOnStatisticsOnlyNewDeleteOverloads();
+    cpputest_free(cpputest_malloc(10));
+    MemoryLeakWarningPlugin::turnOnNewDeleteOverloads();
+
+    MemoryLeakWarningPlugin::resetAllocationStatistics();
+    MemoryAllocationStatistics statistics = MemoryLeakWarningPlugin::getAllocationStatistics();
+    CHECK(statistics.allocations == 0);
+    CHECK(statistics.deallocations == 0);
+    CHECK(statistics.bytesAllocated == 0);
+}
+
 #endif
 
 #endif
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2007, Michael Feathers, James Grenning and Bas Vodde
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE EARLIER MENTIONED AUTHORS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <copyright holder> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/MemoryPoolPlugin.h"
+#include "CppUTest/TestMemoryAllocator.h"
+#include "CppUTest/TestTestingFixture.h"
+
+TEST_GROUP(MemoryPoolPlugin)
+{
+    MemoryPoolPlugin* plugin;
+    TestTestingFixture* fixture;
+    UtestShell* test;
+    TestResult* result;
+
+    void setup()
+    {
+        plugin = new MemoryPoolPlugin;
+        fixture = new TestTestingFixture;
+        test = new UtestShell("group", "test", "file", 1);
+        result = new TestResult(*fixture->output_);
+    }
+
+    void teardown()
+    {
+        delete result;
+        delete test;
+        delete fixture;
+        delete plugin;
+    }
+};
+
+TEST(MemoryPoolPlugin, isDisabledByDefault)
+{
+    CHECK(!plugin->isEnabled());
+    plugin->runAllPreTestAction(*test, *result);
+    CHECK(!isTestMemoryPoolEnabled());
+    plugin->runAllPostTestAction(*test, *result);
+}
+
+TEST(MemoryPoolPlugin, enablesThePoolWhileATestRuns)
+{
+    plugin->enable();
+    plugin->runAllPreTestAction(*test, *result);
+    CHECK(isTestMemoryPoolEnabled());
+    plugin->runAllPostTestAction(*test, *result);
+    CHECK(!isTestMemoryPoolEnabled());
+}
+
+TEST(MemoryPoolPlugin, testsAllocateFromThePoolAndTheLeakDetectorStillSeesThem)
+{
+    plugin->enable();
+    plugin->preTestAction(*test, *result);
+    char* memory = (char*) malloc(10);
+    int* number = new int(1);
+    CHECK(getTestMemoryPool()->getBlocksInUse() >= 2);
+    delete number;
+    free(memory);
+    plugin->postTestAction(*test, *result);
+}
+
+TEST(MemoryPoolPlugin, parsesEnable)
+{
+    const char* argv[] = { "-pmempool" };
+    CHECK(plugin->parseArguments(1, argv, 0));
+    CHECK(plugin->isEnabled());
+}
+
+TEST(MemoryPoolPlugin, ignoresOtherArguments)
+{
+    const char* argv[] = { "-pguardpages" };
+    CHECK(!plugin->parseArguments(1, argv, 0));
+}
@@ -667,6 +667,14 @@ TEST(SimpleString, unsigned_long)
 
 #endif
 
+TEST(SimpleString, StrHash)
+{
+    char blabla[] = "blabla";
+    CHECK(SimpleString::StrHash(blabla) == SimpleString::StrHash("blabla"));
+    CHECK(SimpleString::StrHash("bla") != SimpleString::StrHash("blabla"));
+    CHECK(SimpleString::StrHash("") != SimpleString::StrHash("a"));
+}
+
 TEST(SimpleString, StrCmp)
 {
     char empty[] = "";
@@ -777,6 +785,110 @@ TEST(SimpleString, StrStr)
     CHECK(SimpleString::StrStr(foo, foo) == foo);
 }
 
+TEST(SimpleString, StrCmpNoCase)
+{
+    CHECK(SimpleString::StrCmpNoCase("", "") == 0);
+    CHECK(SimpleString::StrCmpNoCase("BlaBla", "bLAbla") == 0);
+    CHECK(SimpleString::StrCmpNoCase("bla", "BLABLA") == -'b');
+    CHECK(SimpleString::StrCmpNoCase("BLABLA", "bla") == 'b');
+    CHECK(SimpleString::StrCmpNoCase("@[", "`{") != 0);
+    CHECK(SimpleString::StrCmpNoCase("\xC4", "\xE4") != 0);
+}
+
+static void fillWithAlphabet(char* buffer, size_t length, char firstLetter)
+{
+    for (size_t i = 0; i < length; i++)
+        buffer[i] = (char) (firstLetter + (char) (i % 26));
+    buffer[length] = '\0';
+}
+
+TEST(SimpleString, StrCmpNoCaseOfLongStringsAtAllAlignments)
+{
+    char upper[80];
+    char lower[80];
+    for (size_t offset = 0; offset < sizeof(long); offset++) {
+        fillWithAlphabet(upper + offset, 70, 'A');
+        fillWithAlphabet(lower + offset, 70, 'a');
+        CHECK(SimpleString::StrCmpNoCase(upper + offset, lower + offset) == 0);
+        CHECK(SimpleString::StrCmpNoCase(upper + offset, lower + offset + 1) != 0);
+        lower[offset + 69] = '!';
+        CHECK(SimpleString::StrCmpNoCase(upper + offset, lower + offset) == 'r' - '!');
+        lower[offset + 69] = '\0';
+        CHECK(SimpleString::StrCmpNoCase(upper + offset, lower + offset) == 'r');
+    }
+}
+
+TEST(SimpleString, NoCaseCompareAndSearchOfLongStringsFoldOnlyAsciiCapitals)
+{
+    char first[40];
+    char second[40];
+    bool foldsAsToLower = true;
+    for (int a = 1; a < 256; a++) {
+        for (int b = 1; b < 256; b++) {
+            for (size_t i = 0; i < sizeof(first) - 1; i++) {
+                first[i] = (char) ((i % 3) ? a : 'x');
+                second[i] = (char) ((i % 3) ? b : 'X');
+            }
+            first[sizeof(first) - 1] = second[sizeof(second) - 1] = '\0';
+            bool equal = SimpleString::ToLower((char) a) == SimpleString::ToLower((char) b);
+            if ((SimpleString::StrCmpNoCase(first, second) == 0) != equal) foldsAsToLower = false;
+            if ((SimpleString::StrStrNoCase(first, second) == first) != equal) foldsAsToLower = false;
+        }
+    }
+    CHECK(foldsAsToLower);
+}
+
+TEST(SimpleString, StrStrNoCase)
+{
+    char foobarfoo[] = "fooBARfoo";
+    CHECK(SimpleString::StrStrNoCase(foobarfoo, "") == foobarfoo);
+    CHECK(SimpleString::StrStrNoCase("", "foo") == 0);
+    CHECK(SimpleString::StrStrNoCase(foobarfoo, "bArF") == foobarfoo + 3);
+    CHECK(SimpleString::StrStrNoCase(foobarfoo, "barfoox") == 0);
+    CHECK(SimpleString::StrStrNoCase("@", "`") == 0);
+}
+
+TEST(SimpleString, StrStrOfLongStringsFindsTheFirstMatchAtAllAlignments)
+{
+    char haystack[200];
+    for (size_t offset = 0; offset < sizeof(long); offset++) {
+        fillWithAlphabet(haystack + offset, 190, 'a');
+        haystack[offset + 150] = 'Q';
+        CHECK(SimpleString::StrStr(haystack + offset, "stQv") == haystack + offset + 148);
+        CHECK(SimpleString::StrStrNoCase(haystack + offset, "STQV") == haystack + offset + 148);
+        CHECK(SimpleString::StrStrNoCase(haystack + offset, "nopqrstu") == haystack + offset + 13);
+        CHECK(SimpleString::StrStr(haystack + offset, "stQvX") == 0);
+        CHECK(SimpleString::StrStrNoCase(haystack + offset, "yzab") == haystack + offset + 24);
+    }
+}
+
+TEST(SimpleString, StringsAtTheEndOfAHeapBlockAreNotReadPastTheirEnd)
+{
+    char* abc = (char*) PlatformSpecificMalloc(4);
+    SimpleString::StrNCpy(abc, "abc", 4);
+    CHECK(SimpleString::StrCmp(abc, "abc") == 0);
+    CHECK(SimpleString::StrCmpNoCase(abc, "ABC") == 0);
+    CHECK(SimpleString::StrStr(abc, "c") == abc + 2);
+    CHECK(SimpleString::StrStrNoCase(abc, "x") == 0);
+    PlatformSpecificFree(abc);
+}
+
+TEST(SimpleString, StringAssertionsDoNotAllocateStrings)
+{
+    MyOwnStringAllocator myOwnAllocator;
+    SimpleString::setStringAllocator(&myOwnAllocator);
+    STRCMP_EQUAL("Hello", "Hello");
+    STRNCMP_EQUAL("Hello", "Help", 3);
+    STRCMP_NOCASE_EQUAL("Hello", "hELLO");
+    STRCMP_CONTAINS("ell", "Hello");
+    STRCMP_NOCASE_CONTAINS("ELL", "hello");
+    UtestShell::getCurrent()->assertCstrNoCaseEqual("Hello", "hELLO", __FILE__, __LINE__);
+    UtestShell::getCurrent()->assertCstrContains("ell", "Hello", __FILE__, __LINE__);
+    UtestShell::getCurrent()->assertCstrNoCaseContains("ELL", "hello", __FILE__, __LINE__);
+    SimpleString::setStringAllocator(NULL);
+    CHECK(!myOwnAllocator.memoryWasAllocated);
+}
+
 TEST(SimpleString, AtoI)
 {
     char max_short_str[] = "32767";
@@ -794,6 +906,15 @@ TEST(SimpleString, AtoI)
     CHECK(32767  == SimpleString::AtoI(max_short_str));
 }
 
+TEST(SimpleString, AtoU)
+{
+    CHECK(12345  == SimpleString::AtoU("012345"));
+    CHECK(12345  == SimpleString::AtoU("12345/"));
+    CHECK(123    == SimpleString::AtoU("\t \r\n123"));
+    CHECK(0      == SimpleString::AtoU("-12345"));
+    CHECK(4294967295UL == SimpleString::AtoU("4294967295"));
+}
+
 TEST(SimpleString, Binary)
 {
     const unsigned char value[] = { 0x00, 0x01, 0x2A, 0xFF };
@@ -825,6 +946,62 @@ TEST(SimpleString, MemCmpFirstLastNotMatching)
     CHECK(0 != SimpleString::MemCmp(base, lastNotMatching, sizeof(base)));
 }
 
+TEST(SimpleString, MemCmpOfLargeBuffersAtAllAlignments)
+{
+    unsigned char first[100];
+    unsigned char second[100];
+    for (size_t i = 0; i < sizeof(first); i++)
+        first[i] = second[i] = (unsigned char) i;
+
+    for (size_t firstOffset = 0; firstOffset < sizeof(long); firstOffset++) {
+        for (size_t secondOffset = 0; secondOffset < sizeof(long); secondOffset++) {
+            for (size_t i = 0; i < 90; i++)
+                second[secondOffset + i] = first[firstOffset + i];
+            LONGS_EQUAL(0, SimpleString::MemCmp(first + firstOffset, second + secondOffset, 90));
+            second[secondOffset + 70] = 0xFF;
+            CHECK(SimpleString::MemCmp(first + firstOffset, second + secondOffset, 90) < 0);
+            CHECK(SimpleString::MemFirstDifference(first + firstOffset, second + secondOffset, 90) == 70);
+            second[secondOffset + 70] = first[firstOffset + 70];
+        }
+    }
+}
+
+TEST(SimpleString, MemoryAtTheEdgesOfHeapBlocksIsNotReadOutsideTheCompare)
+{
+    unsigned char* first = (unsigned char*) PlatformSpecificMalloc(21);
+    unsigned char* second = (unsigned char*) PlatformSpecificMalloc(22);
+    for (size_t i = 0; i < 21; i++)
+        first[i] = second[i + 1] = (unsigned char) i;
+    LONGS_EQUAL(0, SimpleString::MemCmp(first, second + 1, 21));
+    LONGS_EQUAL(0, SimpleString::MemCountDifferences(first + 3, second + 4, 18));
+    PlatformSpecificFree(first);
+    PlatformSpecificFree(second);
+}
+
+TEST(SimpleString, MemFirstDifference)
+{
+    unsigned char base[] = { 0x00, 0x01, 0x2A, 0xFF };
+    unsigned char lastNotMatching[] = { 0x00, 0x01, 0x2A, 0x00 };
+    CHECK(SimpleString::MemFirstDifference(base, base, sizeof(base)) == sizeof(base));
+    CHECK(SimpleString::MemFirstDifference(base, lastNotMatching, sizeof(base)) == 3);
+    CHECK(SimpleString::MemFirstDifference(NULL, NULL, 0) == 0);
+}
+
+TEST(SimpleString, MemCountDifferences)
+{
+    unsigned char first[64] = { 0 };
+    unsigned char second[64] = { 0 };
+    second[1] = 0x80;
+    second[9] = 0x01;
+    second[10] = 0xFF;
+    second[40] = 0x7F;
+    second[63] = 0x10;
+    CHECK(SimpleString::MemCountDifferences(first, second, sizeof(first)) == 5);
+    CHECK(SimpleString::MemCountDifferences(first + 1, second + 3, 60) == 3);
+    CHECK(SimpleString::MemCountDifferences(first, second + 1, 63) == 5);
+    CHECK(SimpleString::MemCountDifferences(first, first, sizeof(first)) == 0);
+}
+
 
 TEST(SimpleString, MaskedBits1byte)
 {
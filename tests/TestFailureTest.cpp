@@ -109,6 +109,12 @@ TEST(TestFailure, FailFailure)
     FAILURE_EQUAL("chk", f);
 }
 
+TEST(TestFailure, PeakMemoryFailure)
+{
+    PeakMemoryFailure f(test, failFileName, failLineNumber, 100, 120, 3);
+    FAILURE_EQUAL("expected <peak memory below 100 bytes>\n\tbut was  <120 bytes in 3 blocks>", f);
+}
+
 TEST(TestFailure, LongsEqualFailure)
 {
     LongsEqualFailure f(test, failFileName, failLineNumber, 1, 2);
@@ -294,6 +300,33 @@ TEST(TestFailure, BinaryEqualExpectedNull)
     FAILURE_EQUAL("expected <(null)>\n\tbut was  <00 00 00 00 00 00 01>", f);
 }
 
+TEST(TestFailure, BinaryEqualOfLargeBuffersShowsAWindowAroundTheFirstDifference)
+{
+    unsigned char expectedData[100] = { 0 };
+    unsigned char actualData[100] = { 0 };
+    actualData[50] = 0x01;
+    actualData[99] = 0x02;
+    BinaryEqualFailure f(test, failFileName, failLineNumber, expectedData, actualData, sizeof(expectedData));
+    FAILURE_EQUAL("expected <... 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 ...>\n"
+                "\tbut was  <... 00 00 00 00 00 00 00 00 01 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 ...>\n"
+                "\tdifference starts at position 50 at: <00 00 00 01 00 00 00>\n"
+                "\t                                                ^\n"
+                "\t2 of 100 bytes differ", f);
+}
+
+TEST(TestFailure, BinaryEqualOfLargeBuffersWithDifferenceAtTheEnd)
+{
+    unsigned char expectedData[40] = { 0 };
+    unsigned char actualData[40] = { 0 };
+    actualData[39] = 0xFF;
+    BinaryEqualFailure f(test, failFileName, failLineNumber, expectedData, actualData, sizeof(expectedData));
+    FAILURE_EQUAL("expected <... 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00>\n"
+                "\tbut was  <... 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 FF>\n"
+                "\tdifference starts at position 39 at: <00 00 00 FF         >\n"
+                "\t                                                ^\n"
+                "\t1 of 40 bytes differ", f);
+}
+
 TEST(TestFailure, BitsEqual1byte)
 {
     BitsEqualFailure f(test, failFileName, failLineNumber, 0x01, 0x03, 0xFF, 1);
@@ -311,3 +344,38 @@ TEST(TestFailure, BitsEqual4bytes)
     BitsEqualFailure f(test, failFileName, failLineNumber, 0x00000001, 0x00000003, 0xFFFFFFFF, 4);
     FAILURE_EQUAL("expected <00000000 00000000 00000000 00000001>\n\tbut was  <00000000 00000000 00000000 00000011>", f);
 }
+
+TEST(TestFailure, BinaryEqualKeepsTheComparedBytes)
+{
+    const unsigned char expectedData[] = {0x00};
+    unsigned char actualData[] = {0x01};
+    BinaryEqualFailure f(test, failFileName, failLineNumber, expectedData, actualData, sizeof(expectedData));
+    actualData[0] = 0x02;
+    FAILURE_EQUAL("expected <00>\n"
+                "\tbut was  <01>\n"
+                "\tdifference starts at position 0 at: <         01         >\n"
+                "\t                                               ^", f);
+}
+
+TEST(TestFailure, StringEqualKeepsTheComparedStrings)
+{
+    char actual[] = "abc";
+    StringEqualFailure f(test, failFileName, failLineNumber, "abd", actual);
+    actual[2] = 'x';
+    FAILURE_EQUAL("expected <abd>\n"
+                "\tbut was  <abc>\n"
+                "\tdifference starts at position 2 at: <        abc         >\n"
+                "\t                                               ^", f);
+}
+
+TEST(TestFailure, CopyOfAFailureKeepsTheMessageFormattedWhenCopied)
+{
+    char actual[] = "abc";
+    StringEqualFailure f(test, failFileName, failLineNumber, "abd", actual);
+    TestFailure copy(f);
+    actual[2] = 'x';
+    FAILURE_EQUAL("expected <abd>\n"
+                "\tbut was  <abc>\n"
+                "\tdifference starts at position 2 at: <        abc         >\n"
+                "\t                                               ^", copy);
+}
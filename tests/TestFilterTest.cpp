@@ -57,6 +57,20 @@ TEST(TestFilter, strictMatching)
     CHECK(!filter.match(" filter"));
 }
 
+TEST(TestFilter, strictMatchingOfTheRowsOfAParameterizedTest)
+{
+    TestFilter filter("name/*");
+    filter.strictMatching();
+    CHECK(filter.match("name/*"));
+    CHECK(filter.match("name/0"));
+    CHECK(filter.match("name/12"));
+    CHECK(!filter.match("name/"));
+    CHECK(!filter.match("name/1x"));
+    CHECK(!filter.match("name/1/2"));
+    CHECK(!filter.match("othername/0"));
+    CHECK(!filter.match("name"));
+}
+
 TEST(TestFilter, equality)
 {
     TestFilter filter1("filter");
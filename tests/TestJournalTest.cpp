@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2007, Michael Feathers, James Grenning and Bas Vodde
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE EARLIER MENTIONED AUTHORS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <copyright holder> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/TestJournal.h"
+#include "CppUTest/TestRegistry.h"
+#include "CppUTest/TestOutput.h"
+#include "CppUTest/PlatformSpecificFunctions.h"
+
+class FileForJournalTests
+{
+public:
+    FileForJournalTests() : exists(false), readPosition(0), flushCount(0) {}
+
+    SimpleString content;
+    bool exists;
+    size_t readPosition;
+    int flushCount;
+};
+
+extern "C" {
+    static FileForJournalTests journalFile;
+
+    static PlatformSpecificFile mockFOpen(const char*, const char* flag)
+    {
+        if (SimpleString(flag) == "r") {
+            if (!journalFile.exists) return 0;
+            journalFile.readPosition = 0;
+        }
+        if (SimpleString(flag) == "w")
+            journalFile.content = "";
+        journalFile.exists = true;
+        return &journalFile;
+    }
+
+    static void mockFPuts(const char* str, PlatformSpecificFile file)
+    {
+        ((FileForJournalTests*)file)->content += str;
+    }
+
+    static char* mockFGets(char* str, int size, PlatformSpecificFile file)
+    {
+        FileForJournalTests* journal = (FileForJournalTests*)file;
+        const char* content = journal->content.asCharString();
+        size_t length = journal->content.size();
+        if (journal->readPosition >= length) return 0;
+
+        int i = 0;
+        while (i < size - 1 && journal->readPosition < length) {
+            char ch = content[journal->readPosition++];
+            str[i++] = ch;
+            if (ch == '\n') break;
+        }
+        str[i] = '\0';
+        return str;
+    }
+
+    static void mockFFlush(PlatformSpecificFile file)
+    {
+        ((FileForJournalTests*)file)->flushCount++;
+    }
+
+    static void mockFClose(PlatformSpecificFile)
+    {
+    }
+}
+
+class JournalTestThatRecordsRuns: public UtestShell
+{
+public:
+    JournalTestThatRecordsRuns(const char* name, bool fails = false) :
+        UtestShell("group", name, "file", 1), hasRun_(false), fails_(fails)
+    {
+    }
+
+    virtual void runOneTest(TestPlugin*, TestResult& result)
+    {
+        hasRun_ = true;
+        if (fails_) result.addFailure(TestFailure(this, "failed"));
+    }
+
+    bool hasRun_;
+    bool fails_;
+};
+
+TEST_GROUP(TestJournal)
+{
+    TestJournal* journal;
+    UtestShell* test;
+
+    void setup()
+    {
+        journalFile.content = "";
+        journalFile.exists = false;
+        journalFile.flushCount = 0;
+        UT_PTR_SET(PlatformSpecificFOpen, (PlatformSpecificFile(*)(const char*, const char*))mockFOpen);
+        UT_PTR_SET(PlatformSpecificFPuts, mockFPuts);
+        UT_PTR_SET(PlatformSpecificFGets, mockFGets);
+        UT_PTR_SET(PlatformSpecificFFlush, mockFFlush);
+        UT_PTR_SET(PlatformSpecificFClose, mockFClose);
+        journal = new TestJournal("journal");
+        test = new UtestShell("group", "test", "file", 1);
+    }
+
+    void teardown()
+    {
+        delete test;
+        delete journal;
+    }
+
+    void previousRunWas(const char* content)
+    {
+        journalFile.content = content;
+        journalFile.exists = true;
+        journal->loadPreviousRun();
+    }
+};
+
+TEST(TestJournal, recordsStartAndOutcomeOfATest)
+{
+    journal->open(false);
+    journal->testStarted(*test);
+    journal->testEnded(*test, false);
+    STRCMP_EQUAL("START group test\nPASS group test\n", journalFile.content.asCharString());
+}
+
+TEST(TestJournal, recordsFailingTest)
+{
+    journal->open(false);
+    journal->testEnded(*test, true);
+    STRCMP_EQUAL("FAIL group test\n", journalFile.content.asCharString());
+}
+
+TEST(TestJournal, everyRecordIsFlushed)
+{
+    journal->open(false);
+    journal->testStarted(*test);
+    journal->testEnded(*test, false);
+    LONGS_EQUAL(2, journalFile.flushCount);
+}
+
+TEST(TestJournal, openingWithoutAppendStartsAnEmptyJournal)
+{
+    journalFile.content = "PASS group test\n";
+    journal->open(false);
+    STRCMP_EQUAL("", journalFile.content.asCharString());
+}
+
+TEST(TestJournal, openingWithAppendKeepsThePreviousRun)
+{
+    journalFile.content = "PASS group test\n";
+    journal->open(true);
+    journal->testStarted(*test);
+    STRCMP_EQUAL("PASS group test\nSTART group test\n", journalFile.content.asCharString());
+}
+
+TEST(TestJournal, nothingHappenedBeforeWithoutAJournalFile)
+{
+    journal->loadPreviousRun();
+    CHECK(!journal->hasPassedBefore(*test));
+    CHECK(!journal->hasCrashedBefore(*test));
+}
+
+TEST(TestJournal, passedTestIsFound)
+{
+    previousRunWas("START group test\nPASS group test\n");
+    CHECK(journal->hasPassedBefore(*test));
+    CHECK(!journal->hasCrashedBefore(*test));
+}
+
+TEST(TestJournal, failedTestHasNotPassed)
+{
+    previousRunWas("START group test\nFAIL group test\n");
+    CHECK(!journal->hasPassedBefore(*test));
+    CHECK(!journal->hasCrashedBefore(*test));
+}
+
+TEST(TestJournal, startedTestWithoutOutcomeHasCrashed)
+{
+    previousRunWas("START group other\nPASS group other\nSTART group test\n");
+    CHECK(journal->hasCrashedBefore(*test));
+}
+
+TEST(TestJournal, skippedTestHasNotPassed)
+{
+    previousRunWas("SKIP group test\n");
+    CHECK(!journal->hasPassedBefore(*test));
+    CHECK(!journal->hasCrashedBefore(*test));
+}
+
+TEST(TestJournal, laterRecordOfTheSameTestWins)
+{
+    previousRunWas("START group test\nFAIL group test\nSTART group test\nPASS group test\n");
+    CHECK(journal->hasPassedBefore(*test));
+}
+
+TEST(TestJournal, testsAreFoundInAnyOrder)
+{
+    UtestShell first("group", "first", "file", 1);
+    previousRunWas("PASS group first\nPASS group second\nPASS group test\n");
+    CHECK(journal->hasPassedBefore(*test));
+    CHECK(journal->hasPassedBefore(first));
+    CHECK(!journal->hasPassedBefore(UtestShell("group", "unknown", "file", 1)));
+}
+
+TEST(TestJournal, allTestsOfALargeJournalAreFound)
+{
+    SimpleString content;
+    for (int i = 0; i < 500; i++)
+        content += StringFromFormat("%s group%d test%d\n", (i % 2) ? "PASS" : "FAIL", i % 7, i);
+    previousRunWas(content.asCharString());
+
+    for (int i = 0; i < 500; i++) {
+        SimpleString group = StringFromFormat("group%d", i % 7);
+        SimpleString name = StringFromFormat("test%d", i);
+        CHECK(journal->hasPassedBefore(UtestShell(group.asCharString(), name.asCharString(), "file", 1)) == (i % 2 == 1));
+    }
+    CHECK(!journal->hasPassedBefore(UtestShell("group0", "test1", "file", 1)));
+}
+
+TEST(TestJournal, longRecordsAreReadCompletely)
+{
+    SimpleString longName("x", 1000);
+    UtestShell longTest("group", longName.asCharString(), "file", 1);
+    previousRunWas((SimpleString("PASS group ") + longName + "\n").asCharString());
+    CHECK(journal->hasPassedBefore(longTest));
+}
+
+TEST(TestJournal, registryRunsOnlyTheTestsThatDidNotPassBefore)
+{
+    JournalTestThatRecordsRuns passed("passed");
+    JournalTestThatRecordsRuns failed("failed");
+    TestRegistry registry;
+    StringBufferTestOutput output;
+    TestResult result(output);
+    registry.addTest(&passed);
+    registry.addTest(&failed);
+
+    previousRunWas("PASS group passed\nFAIL group failed\n");
+    journal->open(true);
+    registry.setJournal(journal);
+    registry.runAllTests(result);
+
+    CHECK(!passed.hasRun_);
+    CHECK(failed.hasRun_);
+    LONGS_EQUAL(0, result.getFilteredOutCount());
+    LONGS_EQUAL(1, result.getPassedBeforeCount());
+    STRCMP_EQUAL("PASS group passed\nFAIL group failed\nSTART group failed\nPASS group failed\n", journalFile.content.asCharString());
+}
+
+TEST(TestJournal, registryRecordsFailuresOfTheTest)
+{
+    JournalTestThatRecordsRuns failing("failing", true);
+    TestRegistry registry;
+    StringBufferTestOutput output;
+    TestResult result(output);
+    registry.addTest(&failing);
+
+    journal->open(false);
+    registry.setJournal(journal);
+    registry.runAllTests(result);
+
+    STRCMP_EQUAL("START group failing\nFAIL group failing\n", journalFile.content.asCharString());
+}
+
+TEST(TestJournal, registryDoesNotRunTestThatCrashedBeforeButReportsItFailed)
+{
+    JournalTestThatRecordsRuns crashed("crashed");
+    TestRegistry registry;
+    StringBufferTestOutput output;
+    TestResult result(output);
+    registry.addTest(&crashed);
+
+    previousRunWas("START group crashed\n");
+    journal->open(true);
+    registry.setJournal(journal);
+    registry.runAllTests(result);
+
+    CHECK(!crashed.hasRun_);
+    LONGS_EQUAL(1, result.getFailureCount());
+    STRCMP_CONTAINS("crashed in a previous run", output.getOutput().asCharString());
+    STRCMP_EQUAL("START group crashed\nCRASH group crashed\n", journalFile.content.asCharString());
+}
+
+static void _failingGroupSetup()
+{
+    FAIL("group setup fails");
+}
+
+TEST(TestJournal, registryRecordsTheTestsThatAFailedGroupSetupSkipped)
+{
+    JournalTestThatRecordsRuns skipped("skipped");
+    TestRegistry registry;
+    StringBufferTestOutput output;
+    TestResult result(output);
+    registry.addTest(&skipped);
+    registry.setCurrentRegistry(&registry);
+    TestGroupFixtureInstaller groupFixture("group", _failingGroupSetup, NULL, "file", 1);
+    registry.setCurrentRegistry(NULL);
+
+    journal->open(false);
+    registry.setJournal(journal);
+    registry.runAllTests(result);
+
+    CHECK(!skipped.hasRun_);
+    LONGS_EQUAL(1, result.getIgnoredCount());
+    STRCMP_EQUAL("SKIP group skipped\n", journalFile.content.asCharString());
+}
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2007, Michael Feathers, James Grenning and Bas Vodde
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE EARLIER MENTIONED AUTHORS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <copyright holder> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/TestManifest.h"
+#include "CppUTest/PlatformSpecificFunctions.h"
+
+static const char records[] =
+    "TEST\0" "GroupA\0" "first\0" "a.cpp\0" "12\0"
+    "\0\0\0"
+    "TEST_P\0" "GroupA\0" "table\0" "a.cpp\0" "20\0"
+    "IGNORE_TEST\0" "GroupB\0" "ignored\0" "b.cpp\0" "30\0"
+    "TEST\0" "GroupA\0" "last\0" "c.cpp\0" "40\0"
+    "TEST\0" "GroupC\0" "incomplete\0";
+
+static void writeElfField(unsigned char* image, size_t offset, size_t width, bool bigEndian, size_t value)
+{
+    for (size_t i = 0; i < width; i++)
+        image[offset + (bigEndian ? width - 1 - i : i)] = (unsigned char) ((value >> (8 * i)) & 0xFF);
+}
+
+/* A header, the manifest, the section names and the section headers of a null section, the names and the manifest */
+static size_t buildElfImage(unsigned char* image, bool elf64, bool bigEndian, const char* manifest, size_t manifestSize)
+{
+    static const char names[] = "\0.shstrtab\0cpputest_manifest";
+    size_t address = elf64 ? 8 : 4;
+    size_t headerSize = elf64 ? 64 : 52;
+    size_t sectionHeaderSize = elf64 ? 64 : 40;
+    size_t namesOffset = headerSize + manifestSize;
+    size_t sectionHeaders = namesOffset + sizeof(names);
+    size_t size = sectionHeaders + 3 * sectionHeaderSize;
+
+    for (size_t i = 0; i < size; i++) image[i] = 0;
+    image[0] = 0x7F; image[1] = 'E'; image[2] = 'L'; image[3] = 'F';
+    image[4] = elf64 ? 2 : 1;
+    image[5] = bigEndian ? 2 : 1;
+    writeElfField(image, elf64 ? 0x28 : 0x20, address, bigEndian, sectionHeaders);
+    writeElfField(image, elf64 ? 0x3A : 0x2E, 2, bigEndian, sectionHeaderSize);
+    writeElfField(image, elf64 ? 0x3C : 0x30, 2, bigEndian, 3);
+    writeElfField(image, elf64 ? 0x3E : 0x32, 2, bigEndian, 1);
+
+    PlatformSpecificMemCpy(image + headerSize, manifest, manifestSize);
+    PlatformSpecificMemCpy(image + namesOffset, names, sizeof(names));
+
+    size_t offsetField = elf64 ? 0x18 : 0x10;
+    size_t sizeField = elf64 ? 0x20 : 0x14;
+    size_t namesHeader = sectionHeaders + sectionHeaderSize;
+    writeElfField(image, namesHeader, 4, bigEndian, 1);
+    writeElfField(image, namesHeader + offsetField, address, bigEndian, namesOffset);
+    writeElfField(image, namesHeader + sizeField, address, bigEndian, sizeof(names));
+    size_t manifestHeader = sectionHeaders + 2 * sectionHeaderSize;
+    writeElfField(image, manifestHeader, 4, bigEndian, 11);
+    writeElfField(image, manifestHeader + offsetField, address, bigEndian, headerSize);
+    writeElfField(image, manifestHeader + sizeField, address, bigEndian, manifestSize);
+    return size;
+}
+
+TEST_GROUP(TestManifest)
+{
+    TestManifest* manifest;
+
+    void setup()
+    {
+        manifest = new TestManifest(records, records + sizeof(records));
+    }
+    void teardown()
+    {
+        delete manifest;
+    }
+};
+
+TEST(TestManifest, recordsAreReadSkippingThePaddingBetweenThem)
+{
+    size_t offset = 0;
+    TestManifestRecord record;
+
+    CHECK(manifest->readRecord(offset, record));
+    STRCMP_EQUAL("TEST", record.kind);
+    STRCMP_EQUAL("GroupA", record.group);
+    STRCMP_EQUAL("first", record.name);
+    STRCMP_EQUAL("a.cpp", record.file);
+    LONGS_EQUAL(12, record.lineNumber);
+
+    CHECK(manifest->readRecord(offset, record));
+    STRCMP_EQUAL("TEST_P", record.kind);
+    STRCMP_EQUAL("table", record.name);
+    LONGS_EQUAL(20, record.lineNumber);
+}
+
+TEST(TestManifest, incompleteRecordAtTheEndIsNotRead)
+{
+    size_t offset = 0;
+    TestManifestRecord record;
+    int count = 0;
+    while (manifest->readRecord(offset, record))
+        count++;
+    LONGS_EQUAL(4, count);
+    STRCMP_EQUAL("last", record.name);
+}
+
+TEST(TestManifest, emptyManifest)
+{
+    TestManifest empty(NULL, NULL);
+    CHECK(empty.isEmpty());
+    CHECK(!manifest->isEmpty());
+    STRCMP_EQUAL("", empty.listTestGroupNames().asCharString());
+    STRCMP_EQUAL("", empty.listTestGroupAndCaseNames().asCharString());
+}
+
+TEST(TestManifest, listTestGroupNamesListsEveryGroupOnce)
+{
+    STRCMP_EQUAL("GroupA GroupB", manifest->listTestGroupNames().asCharString());
+}
+
+TEST(TestManifest, listTestGroupAndCaseNamesListsTheRowsOfParameterizedTestsWithAWildcard)
+{
+    STRCMP_EQUAL("GroupA.first GroupA.table/* GroupB.ignored GroupA.last", manifest->listTestGroupAndCaseNames().asCharString());
+}
+
+TEST(TestManifest, listRecordsListsOneRecordALine)
+{
+    STRCMP_EQUAL("TEST GroupA first a.cpp:12\n"
+                 "TEST_P GroupA table a.cpp:20\n"
+                 "IGNORE_TEST GroupB ignored b.cpp:30\n"
+                 "TEST GroupA last c.cpp:40\n", manifest->listRecords().asCharString());
+}
+
+TEST(TestManifest, manifestIsFoundInA64BitLittleEndianElfImage)
+{
+    unsigned char image[512];
+    size_t size = buildElfImage(image, true, false, records, sizeof(records));
+    STRCMP_EQUAL(manifest->listRecords().asCharString(), TestManifest::fromElfImage(image, size).listRecords().asCharString());
+}
+
+TEST(TestManifest, manifestIsFoundInA32BitBigEndianElfImage)
+{
+    unsigned char image[512];
+    size_t size = buildElfImage(image, false, true, records, sizeof(records));
+    STRCMP_EQUAL(manifest->listRecords().asCharString(), TestManifest::fromElfImage(image, size).listRecords().asCharString());
+}
+
+TEST(TestManifest, noManifestInAnImageThatIsNoElf)
+{
+    unsigned char image[512];
+    size_t size = buildElfImage(image, true, false, records, sizeof(records));
+    image[1] = 'X';
+    CHECK(TestManifest::fromElfImage(image, size).isEmpty());
+}
+
+TEST(TestManifest, noManifestInATruncatedElfImage)
+{
+    unsigned char image[512];
+    size_t size = buildElfImage(image, true, false, records, sizeof(records));
+    size_t lastSectionHeader = size - 64;
+    for (size_t truncated = 0; truncated <= lastSectionHeader; truncated += 7)
+        CHECK(TestManifest::fromElfImage(image, truncated).isEmpty());
+}
+
+#if CPPUTEST_USE_TEST_MANIFEST
+
+static const int lineOfTheLinkedInTest = __LINE__ + 1;
+TEST(TestManifest, linkedInManifestHasARecordOfThisTest)
+{
+    TestManifest linkedIn = TestManifest::linkedIn();
+    size_t offset = 0;
+    TestManifestRecord record;
+    bool found = false;
+    while (!found && linkedIn.readRecord(offset, record))
+        found = SimpleString(record.name) == "linkedInManifestHasARecordOfThisTest";
+
+    CHECK(found);
+    STRCMP_EQUAL("TEST", record.kind);
+    STRCMP_EQUAL("TestManifest", record.group);
+    STRCMP_EQUAL(__FILE__, record.file);
+    LONGS_EQUAL(lineOfTheLinkedInTest, record.lineNumber);
+}
+
+#endif
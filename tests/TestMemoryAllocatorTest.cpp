@@ -27,6 +27,7 @@
 
 #include "CppUTest/TestHarness.h"
 #include "CppUTest/TestMemoryAllocator.h"
+#include "CppUTest/MemoryLeakDetector.h"
 #include "CppUTest/PlatformSpecificFunctions.h"
 
 TEST_GROUP(TestMemoryAllocatorTest)
@@ -112,6 +113,359 @@ TEST(TestMemoryAllocatorTest, NullUnknownNames)
     STRCMP_EQUAL("unknown", allocator->free_name());
 }
 
+TEST_GROUP(SizeClassMemoryPool)
+{
+    SizeClassMemoryPool pool;
+};
+
+TEST(SizeClassMemoryPool, SmallAllocationsArePooled)
+{
+    char* memory = pool.allocate(10);
+    CHECK(pool.owns(memory));
+    CHECK(pool.getBlockSize(memory) == 16);
+    CHECK(pool.getBlocksInUse() == 1);
+    pool.deallocate(memory);
+    CHECK(pool.getBlocksInUse() == 0);
+}
+
+TEST(SizeClassMemoryPool, LargeAllocationsAreNotPooled)
+{
+    POINTERS_EQUAL(NULL, pool.allocate(SizeClassMemoryPool::largestPooledSize + 1));
+    CHECK(pool.getNumberOfSlabs() == 0);
+}
+
+TEST(SizeClassMemoryPool, DoesNotOwnHeapMemory)
+{
+    pool.deallocate(pool.allocate(10));
+    char* memory = (char*) PlatformSpecificMalloc(10);
+    CHECK(!pool.owns(memory));
+    CHECK(!pool.owns(NULL));
+    PlatformSpecificFree(memory);
+}
+
+TEST(SizeClassMemoryPool, FreedBlocksAreReusedForTheSameSizeClass)
+{
+    char* memory = pool.allocate(20);
+    pool.deallocate(memory);
+    POINTERS_EQUAL(memory, pool.allocate(32));
+    pool.deallocate(memory);
+}
+
+TEST(SizeClassMemoryPool, BlocksAreAlignedAndDoNotOverlap)
+{
+    char* first = pool.allocate(48);
+    char* second = pool.allocate(48);
+    CHECK((size_t) first % 16 == 0);
+    CHECK((size_t) second % 16 == 0);
+    CHECK(second >= first + 48 || first >= second + 48);
+    pool.deallocate(second);
+    pool.deallocate(first);
+}
+
+TEST(SizeClassMemoryPool, GrowsWhenSlabsAreFull)
+{
+    char* memory[2000];
+    for (int i = 0; i < 2000; i++)
+        memory[i] = pool.allocate(256);
+    CHECK(pool.getNumberOfSlabs() > 16);
+    for (int i = 0; i < 2000; i++)
+        CHECK(pool.owns(memory[i]));
+    for (int i = 0; i < 2000; i++)
+        pool.deallocate(memory[i]);
+}
+
+TEST(SizeClassMemoryPool, ResetOnlyWhenNoBlockIsInUse)
+{
+    char* first = pool.allocate(10);
+    CHECK(!pool.reset());
+    pool.deallocate(first);
+    CHECK(pool.reset());
+    POINTERS_EQUAL(first, pool.allocate(100));
+    CHECK(pool.getNumberOfSlabs() == 16);
+    pool.deallocate(first);
+}
+
+static int mallocsBeforeFailure;
+static void* (*originalMalloc)(size_t);
+
+static void* _mallocThatFailsOnce(size_t size)
+{
+    return (mallocsBeforeFailure-- == 0) ? NULL : originalMalloc(size);
+}
+
+TEST(SizeClassMemoryPool, KeepsItsSlabsWhenTheSlabTableCannotGrow)
+{
+    char* first = pool.allocate(256);
+    while (pool.getNumberOfSlabs() < 48)
+        pool.allocate(256);
+
+    originalMalloc = PlatformSpecificMalloc;
+    mallocsBeforeFailure = 0;
+    UT_PTR_SET(PlatformSpecificMalloc, _mallocThatFailsOnce);
+    while (pool.allocate(256) != NULL)
+        ;
+    CHECK(pool.getNumberOfSlabs() == 48);
+    CHECK(pool.owns(first));
+
+    CHECK(pool.allocate(256) != NULL);
+    CHECK(pool.getNumberOfSlabs() == 64);
+}
+
+TEST_GROUP(TestMemoryPool)
+{
+    TestMemoryAllocator allocator;
+
+    void teardown()
+    {
+        setTestMemoryPoolEnabled(false);
+    }
+};
+
+TEST(TestMemoryPool, DefaultAllocatorsUseThePoolWhileEnabled)
+{
+    setTestMemoryPoolEnabled(true);
+    char* memory = allocator.alloc_memory(10, "file", 1);
+    CHECK(getTestMemoryPool()->owns(memory));
+    setTestMemoryPoolEnabled(false);
+    allocator.free_memory(memory, "file", 1);
+
+    memory = allocator.alloc_memory(10, "file", 1);
+    CHECK(!getTestMemoryPool()->owns(memory));
+    allocator.free_memory(memory, "file", 1);
+}
+
+TEST(TestMemoryPool, ReallocMovesPooledMemoryAndKeepsTheContents)
+{
+    setTestMemoryPoolEnabled(true);
+    char* memory = allocator.alloc_memory(4, "file", 1);
+    PlatformSpecificMemCpy(memory, "abc", 4);
+    POINTERS_EQUAL(memory, allocator.realloc_memory(memory, 16, "file", 1));
+
+    memory = allocator.realloc_memory(memory, 1000, "file", 1);
+    CHECK(!getTestMemoryPool()->owns(memory));
+    STRCMP_EQUAL("abc", memory);
+    allocator.free_memory(memory, "file", 1);
+}
+
+TEST_GROUP(FaultInjectionMemoryAllocatorTest)
+{
+    FaultInjectionSchedule schedule;
+    TestMemoryAllocator original;
+    FaultInjectionMemoryAllocator* allocator;
+
+    void setup()
+    {
+        allocator = new FaultInjectionMemoryAllocator(&schedule, &original);
+    }
+    void teardown()
+    {
+        delete allocator;
+    }
+
+    unsigned failuresIn(unsigned allocations, size_t size = 10, const char* file = "file.cpp", int line = 1)
+    {
+        unsigned failures = 0;
+        for (unsigned i = 0; i < allocations; i++) {
+            char* memory = allocator->alloc_memory(size, file, line);
+            if (memory == NULL) failures++;
+            else allocator->free_memory(memory, file, line);
+        }
+        return failures;
+    }
+};
+
+TEST(FaultInjectionMemoryAllocatorTest, NothingFailsWithoutASchedule)
+{
+    LONGS_EQUAL(0, failuresIn(10));
+    LONGS_EQUAL(10, schedule.getAllocationCount());
+}
+
+TEST(FaultInjectionMemoryAllocatorTest, FailsTheNthAllocation)
+{
+    schedule.failAllocationNumber(3);
+    allocator->free_memory(allocator->alloc_memory(10, "file", 1), "file", 1);
+    allocator->free_memory(allocator->alloc_memory(10, "file", 1), "file", 1);
+    POINTERS_EQUAL(NULL, allocator->alloc_memory(10, "file", 1));
+    LONGS_EQUAL(0, failuresIn(5));
+    LONGS_EQUAL(1, schedule.getFailedAllocationCount());
+}
+
+TEST(FaultInjectionMemoryAllocatorTest, FailsEveryNthAllocation)
+{
+    schedule.failEveryNthAllocation(4);
+    LONGS_EQUAL(3, failuresIn(12));
+}
+
+TEST(FaultInjectionMemoryAllocatorTest, RandomFailuresAreReproducibleForASeed)
+{
+    schedule.failRandomly(0.5, 42);
+    unsigned failures = failuresIn(100);
+    CHECK(failures > 0 && failures < 100);
+
+    schedule.clear();
+    schedule.failRandomly(0.5, 42);
+    LONGS_EQUAL(failures, failuresIn(100));
+}
+
+TEST(FaultInjectionMemoryAllocatorTest, FailsOnceTheByteLimitIsReached)
+{
+    schedule.failAfterBytes(25);
+    LONGS_EQUAL(0, failuresIn(2));
+    LONGS_EQUAL(1, failuresIn(1));
+    LONGS_EQUAL(0, failuresIn(1, 5));
+}
+
+TEST(FaultInjectionMemoryAllocatorTest, FailsAllocationsFromACallSite)
+{
+    schedule.failAllocationsFrom("dir/file.cpp", 5);
+    LONGS_EQUAL(0, failuresIn(1, 10, "/root/dir/file.cpp", 4));
+    LONGS_EQUAL(1, failuresIn(1, 10, "/root/dir/file.cpp", 5));
+    LONGS_EQUAL(0, failuresIn(1, 10, "/root/other/file.cpp", 5));
+
+    schedule.failAllocationsFrom("file.cpp");
+    LONGS_EQUAL(2, failuresIn(2, 10, "/root/other/file.cpp", 7));
+}
+
+TEST(FaultInjectionMemoryAllocatorTest, ReallocFailsLikeAlloc)
+{
+    char* memory = allocator->alloc_memory(10, "file", 1);
+    schedule.failAllocationNumber(2);
+    POINTERS_EQUAL(NULL, allocator->realloc_memory(memory, 20, "file", 1));
+    allocator->free_memory(memory, "file", 1);
+}
+
+TEST(FaultInjectionMemoryAllocatorTest, OnlyCountsAllocationsOfTheRestrictedTest)
+{
+    UtestShell otherTest("group", "test", "file", 1);
+    schedule.restrictToTest(&otherTest);
+    schedule.failEveryNthAllocation(1);
+    LONGS_EQUAL(0, failuresIn(3));
+    LONGS_EQUAL(0, schedule.getAllocationCount());
+
+    schedule.restrictToTest(UtestShell::getCurrent());
+    LONGS_EQUAL(3, failuresIn(3));
+}
+
+TEST(FaultInjectionMemoryAllocatorTest, TakesTheNamesOfTheOriginalAllocator)
+{
+    CHECK(allocator->isOfEqualType(&original));
+    STRCMP_EQUAL(original.alloc_name(), allocator->alloc_name());
+    STRCMP_EQUAL(original.free_name(), allocator->free_name());
+    allocator->freeMemoryLeakNode(allocator->allocMemoryLeakNode(10));
+}
+
+TEST_GROUP(GuardPageMemoryAllocatorTest)
+{
+    GuardPageMemoryAllocator allocator;
+};
+
+TEST(GuardPageMemoryAllocatorTest, AllocatedMemoryIsUsable)
+{
+    char* memory = allocator.alloc_memory(100, "file", 1);
+    PlatformSpecificMemset(memory, 0xAB, 100);
+    allocator.free_memory(memory, "file", 1);
+}
+
+TEST(GuardPageMemoryAllocatorTest, EveryAllocationIsGuardedByDefault)
+{
+    if (PlatformSpecificPageSize == NULL || PlatformSpecificPageSize() == 0) return;
+
+    allocator.free_memory(allocator.alloc_memory(10, "file", 1), "file", 1);
+    allocator.free_memory(allocator.alloc_memory(10, "file", 1), "file", 1);
+    LONGS_EQUAL(2, allocator.getGuardedAllocations());
+}
+
+TEST(GuardPageMemoryAllocatorTest, SamplingGuardsEveryNthAllocation)
+{
+    if (PlatformSpecificPageSize == NULL || PlatformSpecificPageSize() == 0) return;
+
+    allocator.setSamplingInterval(3);
+    char* memory[7];
+    for (int i = 0; i < 7; i++)
+        memory[i] = allocator.alloc_memory(10, "file", 1);
+    for (int i = 0; i < 7; i++)
+        allocator.free_memory(memory[i], "file", 1);
+    LONGS_EQUAL(2, allocator.getGuardedAllocations());
+}
+
+TEST(GuardPageMemoryAllocatorTest, GuardedMemoryEndsAtThePageBoundary)
+{
+    if (PlatformSpecificPageSize == NULL || PlatformSpecificPageSize() == 0) return;
+
+    allocator.setAlignment(1);
+    char* memory = allocator.alloc_memory(10, "file", 1);
+    CHECK(((size_t) memory + 10) % PlatformSpecificPageSize() == 0);
+    allocator.free_memory(memory, "file", 1);
+}
+
+TEST(GuardPageMemoryAllocatorTest, GuardedMemoryStartsAtThePageBoundaryWhenGuardingUnderruns)
+{
+    if (PlatformSpecificPageSize == NULL || PlatformSpecificPageSize() == 0) return;
+
+    allocator.setGuardPlacement(GuardPageMemoryAllocator::guard_before_memory);
+    char* memory = allocator.alloc_memory(10, "file", 1);
+    CHECK((size_t) memory % PlatformSpecificPageSize() == 0);
+    allocator.free_memory(memory, "file", 1);
+}
+
+TEST(GuardPageMemoryAllocatorTest, UnguardedMemoryIsFreedWhenGuardingUnderruns)
+{
+    allocator.setGuardPlacement(GuardPageMemoryAllocator::guard_before_memory);
+    allocator.setSamplingInterval(2);
+    char* unguarded = allocator.alloc_memory(10, "file", 1);
+    char* guarded = allocator.alloc_memory(10, "file", 1);
+    allocator.free_memory(unguarded, "file", 1);
+    allocator.free_memory(guarded, "file", 1);
+}
+
+TEST(GuardPageMemoryAllocatorTest, ReallocKeepsTheContents)
+{
+    char* memory = allocator.alloc_memory(4, "file", 1);
+    PlatformSpecificMemCpy(memory, "abc", 4);
+    memory = allocator.realloc_memory(memory, 5000, "file", 1);
+    STRCMP_EQUAL("abc", memory);
+    memory = allocator.realloc_memory(memory, 2, "file", 1);
+    BYTES_EQUAL('a', memory[0]);
+    BYTES_EQUAL('b', memory[1]);
+    allocator.free_memory(memory, "file", 1);
+}
+
+TEST(GuardPageMemoryAllocatorTest, HeapMemoryOfOtherAllocatorsIsFreedToTheHeap)
+{
+    char* memory = (char*) PlatformSpecificMalloc(32);
+    PlatformSpecificMemset(memory, 0, 32);
+    allocator.free_memory(memory, "file", 1);
+}
+
+static size_t _noPageSize()
+{
+    return 0;
+}
+
+TEST(GuardPageMemoryAllocatorTest, FallsBackToTheHeapWithoutPageSupport)
+{
+    UT_PTR_SET(PlatformSpecificPageSize, _noPageSize);
+    GuardPageMemoryAllocator heapOnlyAllocator;
+    heapOnlyAllocator.free_memory(heapOnlyAllocator.alloc_memory(10, "file", 1), "file", 1);
+    LONGS_EQUAL(0, heapOnlyAllocator.getGuardedAllocations());
+}
+
+TEST(GuardPageMemoryAllocatorTest, LeakDetectorWorksOnGuardedMemory)
+{
+    MemoryLeakDetector* detector = MemoryLeakWarningPlugin::getGlobalDetector();
+    char* memory = detector->allocMemory(&allocator, 10, "file", 1);
+    memory = detector->reallocMemory(&allocator, memory, 20, "file", 1);
+    detector->deallocMemory(&allocator, memory, "file", 1);
+}
+
+TEST(GuardPageMemoryAllocatorTest, LeakDetectorPutsNothingBetweenGuardedMemoryAndItsGuard)
+{
+    MemoryLeakDetector* detector = MemoryLeakWarningPlugin::getGlobalDetector();
+    char* memory = detector->allocMemory(&allocator, 1, "file", 1);
+    CHECK(((size_t) (memory + 1) % PlatformSpecificPageSize()) == 0);
+    detector->deallocMemory(&allocator, memory, "file", 1);
+}
+
 #define MAX_SIZE_THATS_OKAY_FOR_MSC (size_t) -1 - 96
 
 static void failTryingToAllocateTooMuchMemory(void)
@@ -145,6 +145,27 @@ TEST(TestOutput, PrintTestVerboseEnded)
     STRCMP_EQUAL("TEST(group, test) - 5 ms\n", mock->getOutput().asCharString());
 }
 
+TEST(TestOutput, PrintTestVerboseEndedLeavesOutPeakMemoryUnlessAskedFor)
+{
+    mock->verbose();
+    result->currentTestStarted(tst);
+    millisTime = 5;
+    result->setCurrentTestPeakMemory(120, 3);
+    result->currentTestEnded(tst);
+    STRCMP_EQUAL("TEST(group, test) - 5 ms\n", mock->getOutput().asCharString());
+}
+
+TEST(TestOutput, PrintTestVerboseEndedWithPeakMemory)
+{
+    mock->verbose();
+    mock->peakMemory();
+    result->currentTestStarted(tst);
+    millisTime = 5;
+    result->setCurrentTestPeakMemory(120, 3);
+    result->currentTestEnded(tst);
+    STRCMP_EQUAL("TEST(group, test) - 5 ms, peak 120 bytes in 3 blocks\n", mock->getOutput().asCharString());
+}
+
 TEST(TestOutput, printColorWithSuccess)
 {
     mock->color();
@@ -226,6 +247,25 @@ TEST(TestOutput, printTestsEnded)
     STRCMP_EQUAL("\nOK (1 tests, 3 ran, 1 checks, 2 ignored, 0 filtered out, 10 ms)\n\n", mock->getOutput().asCharString());
 }
 
+TEST(TestOutput, printTestsEndedWithReruns)
+{
+    result->countTest();
+    result->countRun();
+    result->countRerun();
+    printer->printTestsEnded(*result);
+    STRCMP_EQUAL("\nOK (1 tests, 1 ran, 1 reruns, 0 checks, 0 ignored, 0 filtered out, 10 ms)\n\n", mock->getOutput().asCharString());
+}
+
+TEST(TestOutput, printTestsEndedWithTestsThatPassedBefore)
+{
+    result->countTest();
+    result->countTest();
+    result->countRun();
+    result->countPassedBefore();
+    printer->printTestsEnded(*result);
+    STRCMP_EQUAL("\nOK (2 tests, 1 ran, 0 checks, 0 ignored, 0 filtered out, 1 passed before, 10 ms)\n\n", mock->getOutput().asCharString());
+}
+
 TEST(TestOutput, printTestsEndedWithFailures)
 {
     result->addFailure(*f);
@@ -414,3 +454,130 @@ TEST(CompositeTestOutput, deletePreviousInstanceWhenSettingNew)
   // CHECK NO MEMORY LEAKS
 }
 
+
+static SimpleString writtenToConsole;
+static int amountOfWrites;
+
+extern "C" {
+
+    static void FakePlatformSpecificWrite(const char* buffer, size_t size)
+    {
+        writtenToConsole += StringFromFormat("%.*s", (int) size, buffer);
+        amountOfWrites++;
+    }
+
+    static void FakePlatformSpecificFlush()
+    {
+        writtenToConsole += "<stdio>";
+    }
+
+}
+
+TEST_GROUP(BufferedConsoleTestOutput)
+{
+    BufferedConsoleTestOutput* output;
+    UtestShell* tst;
+
+    void setup()
+    {
+        writtenToConsole = "";
+        amountOfWrites = 0;
+        UT_PTR_SET(PlatformSpecificWrite, FakePlatformSpecificWrite);
+        output = new BufferedConsoleTestOutput(8);
+        tst = new UtestShell("group", "test", "file", 10);
+        TestOutput::setWorkingEnvironment(TestOutput::eclipse);
+    }
+    void teardown()
+    {
+        TestOutput::setWorkingEnvironment(TestOutput::detectEnvironment);
+        delete output;
+        delete tst;
+        writtenToConsole = "";
+    }
+};
+
+TEST(BufferedConsoleTestOutput, nothingIsWrittenBeforeFlush)
+{
+    output->print("hello");
+    LONGS_EQUAL(0, amountOfWrites);
+    output->flush();
+    LONGS_EQUAL(1, amountOfWrites);
+    STRCMP_EQUAL("hello", writtenToConsole.asCharString());
+}
+
+TEST(BufferedConsoleTestOutput, flushWithoutOutputDoesNotWrite)
+{
+    output->flush();
+    LONGS_EQUAL(0, amountOfWrites);
+}
+
+TEST(BufferedConsoleTestOutput, writesTheBlockWhenItIsFull)
+{
+    output->print("12345");
+    output->print("6789");
+    LONGS_EQUAL(1, amountOfWrites);
+    STRCMP_EQUAL("12345", writtenToConsole.asCharString());
+    output->flush();
+    STRCMP_EQUAL("123456789", writtenToConsole.asCharString());
+}
+
+TEST(BufferedConsoleTestOutput, outputLargerThanTheBlockIsWrittenDirectly)
+{
+    output->print("12");
+    output->print("3456789abc");
+    LONGS_EQUAL(2, amountOfWrites);
+    STRCMP_EQUAL("123456789abc", writtenToConsole.asCharString());
+}
+
+TEST(BufferedConsoleTestOutput, failuresAreWrittenImmediately)
+{
+    TestFailure failure(tst, "file", 20, "msg");
+    output->print(failure);
+    STRCMP_EQUAL("\nfile:20: error: Failure in TEST(group, test)\n\tmsg\n\n", writtenToConsole.asCharString());
+}
+
+TEST(BufferedConsoleTestOutput, endOfTheTestsIsWrittenImmediately)
+{
+    TestResult result(*output);
+    output->printTestsEnded(result);
+    STRCMP_CONTAINS("OK (0 tests", writtenToConsole.asCharString());
+}
+
+TEST(BufferedConsoleTestOutput, stdioIsFlushedBeforeTheBlockIsWritten)
+{
+    UT_PTR_SET(PlatformSpecificFlush, FakePlatformSpecificFlush);
+    output->print("12");
+    output->flush();
+    STRCMP_EQUAL("<stdio>12", writtenToConsole.asCharString());
+}
+
+TEST(BufferedConsoleTestOutput, writeLatestBufferWritesTheBlockOfTheLatestOutput)
+{
+    BufferedConsoleTestOutput* latest = new BufferedConsoleTestOutput(8);
+    output->print("12");
+    latest->print("34");
+    BufferedConsoleTestOutput::writeLatestBuffer();
+    STRCMP_EQUAL("34", writtenToConsole.asCharString());
+    delete latest;
+    BufferedConsoleTestOutput::writeLatestBuffer();
+    STRCMP_EQUAL("3412", writtenToConsole.asCharString());
+}
+
+TEST(BufferedConsoleTestOutput, outputsCanBeDeletedInAnyOrder)
+{
+    BufferedConsoleTestOutput* first = new BufferedConsoleTestOutput(8);
+    BufferedConsoleTestOutput* second = new BufferedConsoleTestOutput(8);
+    delete first;
+    delete second;
+    output->print("12");
+    BufferedConsoleTestOutput::writeLatestBuffer();
+    STRCMP_EQUAL("12", writtenToConsole.asCharString());
+}
+
+TEST(BufferedConsoleTestOutput, destructorWritesTheRemainingOutput)
+{
+    output->print(12);
+    delete output;
+    output = NULL;
+    STRCMP_EQUAL("12", writtenToConsole.asCharString());
+}
@@ -37,8 +37,8 @@ const int testLineNumber = 1;
 class MockTest: public UtestShell
 {
 public:
-    MockTest(const char* group = "Group") :
-        UtestShell(group, "Name", "File", testLineNumber), hasRun_(false)
+    MockTest(const char* group = "Group", const char* name = "Name") :
+        UtestShell(group, name, "File", testLineNumber), hasRun_(false)
     {
     }
     virtual void runOneTest(TestPlugin*, TestResult&)
@@ -49,6 +49,18 @@ public:
     bool hasRun_;
 };
 
+class MockOrderedTest: public MockTest
+{
+public:
+    MockOrderedTest(const char* group, const char* name) : MockTest(group, name)
+    {
+    }
+    virtual bool keepsItsOrder() const _override
+    {
+        return true;
+    }
+};
+
 class MockTestResult: public TestResult
 {
 public:
@@ -59,6 +71,7 @@ public:
     int countCurrentTestEnded;
     int countCurrentGroupStarted;
     int countCurrentGroupEnded;
+    SimpleString testsInOrder;
 
     MockTestResult(TestOutput& p) :
         TestResult(p)
@@ -78,6 +91,7 @@ public:
         countCurrentTestEnded = 0;
         countCurrentGroupStarted = 0;
         countCurrentGroupEnded = 0;
+        testsInOrder = "";
     }
 
     virtual void testsStarted()
@@ -88,9 +102,10 @@ public:
     {
         countTestsEnded++;
     }
-    virtual void currentTestStarted(UtestShell* /*test*/)
+    virtual void currentTestStarted(UtestShell* test)
     {
         countCurrentTestStarted++;
+        testsInOrder += StringFromFormat("%s.%s ", test->getGroup().asCharString(), test->getName().asCharString());
     }
     virtual void currentTestEnded(UtestShell* /*test*/)
     {
@@ -107,6 +122,8 @@ public:
 
 };
 
+static SimpleString* groupFixtureLog = NULL;
+
 TEST_GROUP(TestRegistry)
 {
     TestRegistry* myRegistry;
@@ -128,10 +145,12 @@ TEST_GROUP(TestRegistry)
         test4 = new MockTest();
         myRegistry = new TestRegistry();
         myRegistry->setCurrentRegistry(myRegistry);
+        groupFixtureLog = &mockResult->testsInOrder;
     }
 
     void teardown()
     {
+        groupFixtureLog = NULL;
         myRegistry->setCurrentRegistry(0);
         delete myRegistry;
         delete test1;
@@ -307,6 +326,102 @@ TEST(TestRegistry, CurrentRepetitionIsCorrectTwo)
     LONGS_EQUAL(2, myRegistry->getCurrentRepetition());
 }
 
+TEST(TestRegistry, shuffledRunKeepsTheTestsOfAGroupTogether)
+{
+    MockTest a1("A", "1"), a2("A", "2"), a3("A", "3"), b1("B", "1"), b2("B", "2"), c1("C", "1");
+    myRegistry->addTest(&a1);
+    myRegistry->addTest(&a2);
+    myRegistry->addTest(&a3);
+    myRegistry->addTest(&b1);
+    myRegistry->addTest(&b2);
+    myRegistry->addTest(&c1);
+    myRegistry->setShuffleSeed(42);
+    myRegistry->runAllTests(*result);
+
+    LONGS_EQUAL(6, mockResult->countCurrentTestStarted);
+    LONGS_EQUAL(3, mockResult->countCurrentGroupStarted);
+    LONGS_EQUAL(3, mockResult->countCurrentGroupEnded);
+    CHECK(a1.hasRun_ && a2.hasRun_ && a3.hasRun_ && b1.hasRun_ && b2.hasRun_ && c1.hasRun_);
+}
+
+TEST(TestRegistry, sameShuffleSeedRunsTheSameOrder)
+{
+    MockTest a1("A", "1"), a2("A", "2"), a3("A", "3"), b1("B", "1"), b2("B", "2"), c1("C", "1");
+    myRegistry->addTest(&a1);
+    myRegistry->addTest(&a2);
+    myRegistry->addTest(&a3);
+    myRegistry->addTest(&b1);
+    myRegistry->addTest(&b2);
+    myRegistry->addTest(&c1);
+
+    myRegistry->setShuffleSeed(42);
+    myRegistry->runAllTests(*result);
+    SimpleString firstOrder = mockResult->testsInOrder;
+    mockResult->resetCount();
+    myRegistry->setShuffleSeed(42);
+    myRegistry->runAllTests(*result);
+
+    STRCMP_EQUAL(firstOrder.asCharString(), mockResult->testsInOrder.asCharString());
+    STRCMP_EQUAL("B.1 B.2 C.1 A.3 A.1 A.2 ", firstOrder.asCharString());
+}
+
+TEST(TestRegistry, withoutAShuffleSeedTestsRunInReverseOrderOfRegistration)
+{
+    MockTest a1("A", "1"), a2("A", "2"), b1("B", "1");
+    myRegistry->addTest(&a1);
+    myRegistry->addTest(&a2);
+    myRegistry->addTest(&b1);
+    myRegistry->runAllTests(*result);
+    STRCMP_EQUAL("B.1 A.2 A.1 ", mockResult->testsInOrder.asCharString());
+}
+
+TEST(TestRegistry, groupsWithTestsThatKeepTheirOrderAreNotShuffled)
+{
+    MockOrderedTest a1("A", "1"), a2("A", "2"), a3("A", "3"), c1("C", "1"), c2("C", "2");
+    MockTest b1("B", "1"), b2("B", "2"), d1("D", "1"), d2("D", "2");
+    myRegistry->addTest(&a1);
+    myRegistry->addTest(&a2);
+    myRegistry->addTest(&a3);
+    myRegistry->addTest(&b1);
+    myRegistry->addTest(&b2);
+    myRegistry->addTest(&c1);
+    myRegistry->addTest(&c2);
+    myRegistry->addTest(&d1);
+    myRegistry->addTest(&d2);
+
+    for (unsigned long seed = 1; seed < 20; seed++) {
+        mockResult->resetCount();
+        myRegistry->setShuffleSeed(seed);
+        myRegistry->runAllTests(*result);
+        STRCMP_CONTAINS("C.2 C.1 ", mockResult->testsInOrder.asCharString());
+        STRCMP_CONTAINS("A.3 A.2 A.1 ", mockResult->testsInOrder.asCharString());
+        CHECK(mockResult->testsInOrder.find('C') < mockResult->testsInOrder.find('A'));
+    }
+}
+
+TEST(TestRegistry, shuffledRunRunsTheTestsOfAGroupTogetherWhenTheyWereRegisteredApart)
+{
+    MockTest a1("A", "1"), b1("B", "1"), a2("A", "2");
+    myRegistry->addTest(&a1);
+    myRegistry->addTest(&b1);
+    myRegistry->addTest(&a2);
+    myRegistry->setShuffleSeed(42);
+    myRegistry->runAllTests(*result);
+
+    LONGS_EQUAL(2, mockResult->countCurrentGroupStarted);
+    LONGS_EQUAL(2, mockResult->countCurrentGroupEnded);
+}
+
+TEST(TestRegistry, everyShuffledRunDerivesANewSeed)
+{
+    myRegistry->addTest(test1);
+    myRegistry->setShuffleSeed(7);
+    myRegistry->runAllTests(*result);
+    CHECK(483484 == myRegistry->getShuffleSeed());
+    myRegistry->runAllTests(*result);
+    CHECK(3328985325UL == myRegistry->getShuffleSeed());
+}
+
 class MyTestPluginDummy: public TestPlugin
 {
 public:
@@ -359,3 +474,319 @@ TEST(TestRegistry, listTestGroupAndCaseNames_shouldListBackwardsGroupATestaAfter
     SimpleString s = output->getOutput();
     STRCMP_EQUAL("GROUP_A.test_aa GROUP_B.test_b GROUP_A.test_a", s.asCharString());
 }
+
+class MockParameterizedTest: public ParameterizedUtestShell
+{
+public:
+    MockParameterizedTest() :
+        ParameterizedUtestShell("Name", 3)
+    {
+        setGroupName("Group");
+    }
+    virtual void runOneTest(TestPlugin*, TestResult&)
+    {
+        rowsRun += getName();
+        rowsRun += ";";
+    }
+
+    SimpleString rowsRun;
+};
+
+TEST(TestRegistry, parameterizedTestRunsOnceForEveryRow)
+{
+    MockParameterizedTest parameterizedTest;
+    myRegistry->addTest(&parameterizedTest);
+    myRegistry->addTest(test1);
+    myRegistry->runAllTests(*result);
+    STRCMP_EQUAL("Name/0;Name/1;Name/2;", parameterizedTest.rowsRun.asCharString());
+    LONGS_EQUAL(4, myRegistry->countTests());
+    LONGS_EQUAL(4, result->getTestCount());
+    LONGS_EQUAL(4, mockResult->countCurrentTestStarted);
+    LONGS_EQUAL(1, mockResult->countCurrentGroupStarted);
+}
+
+TEST(TestRegistry, nameFilterSelectsSingleRowsOfAParameterizedTest)
+{
+    MockParameterizedTest parameterizedTest;
+    TestFilter nameFilter("Name/1");
+    nameFilter.strictMatching();
+    myRegistry->setNameFilters(&nameFilter);
+    myRegistry->addTest(&parameterizedTest);
+    myRegistry->runAllTests(*result);
+    STRCMP_EQUAL("Name/1;", parameterizedTest.rowsRun.asCharString());
+    LONGS_EQUAL(2, result->getFilteredOutCount());
+}
+
+TEST(TestRegistry, listTestGroupAndCaseNamesListsEveryRowOfAParameterizedTest)
+{
+    MockParameterizedTest parameterizedTest;
+    myRegistry->addTest(&parameterizedTest);
+    myRegistry->listTestGroupAndCaseNames(*result);
+    STRCMP_EQUAL("Group.Name/0 Group.Name/1 Group.Name/2", output->getOutput().asCharString());
+}
+
+static int descriptorShellsMade = 0;
+
+static UtestShell& descriptorShellA1()
+{
+    static MockTest shell;
+    descriptorShellsMade++;
+    return shell;
+}
+
+static UtestShell& descriptorShellA2()
+{
+    static MockTest shell;
+    descriptorShellsMade++;
+    return shell;
+}
+
+static UtestShell& descriptorShellB1()
+{
+    static MockTest shell;
+    descriptorShellsMade++;
+    return shell;
+}
+
+static TestDescriptor descriptorA1 = { "A", "1", "File", testLineNumber, descriptorShellA1, NULL, NULL, NULL };
+static TestDescriptor descriptorA2 = { "A", "2", "File", testLineNumber, descriptorShellA2, NULL, NULL, NULL };
+static TestDescriptor descriptorB1 = { "B", "1", "File", testLineNumber, descriptorShellB1, NULL, NULL, NULL };
+
+TEST(TestRegistry, testFromADescriptorIsCountedWithoutMakingItsShell)
+{
+    descriptorShellsMade = 0;
+    TestDescriptorInstaller a1(descriptorA1);
+    LONGS_EQUAL(1, myRegistry->countTests());
+    LONGS_EQUAL(0, descriptorShellsMade);
+}
+
+TEST(TestRegistry, testFromADescriptorRunsWithTheNamesOfTheDescriptor)
+{
+    descriptorShellsMade = 0;
+    TestDescriptorInstaller a1(descriptorA1);
+    myRegistry->runAllTests(*result);
+    STRCMP_EQUAL("A.1 ", mockResult->testsInOrder.asCharString());
+    LONGS_EQUAL(1, descriptorShellsMade);
+    LONGS_EQUAL(1, myRegistry->countTests());
+}
+
+TEST(TestRegistry, onlyTestsFromDescriptorsThatPassTheFiltersGetAShell)
+{
+    descriptorShellsMade = 0;
+    TestDescriptorInstaller a1(descriptorA1);
+    TestDescriptorInstaller a2(descriptorA2);
+    TestDescriptorInstaller b1(descriptorB1);
+    TestFilter groupFilter("B");
+    myRegistry->setGroupFilters(&groupFilter);
+    myRegistry->runAllTests(*result);
+
+    STRCMP_EQUAL("B.1 ", mockResult->testsInOrder.asCharString());
+    LONGS_EQUAL(1, descriptorShellsMade);
+    LONGS_EQUAL(3, result->getTestCount());
+    LONGS_EQUAL(2, result->getFilteredOutCount());
+}
+
+TEST(TestRegistry, testsFromDescriptorsRunWhereTheirShellsWouldHaveBeenInstalled)
+{
+    MockTest c1("C", "1"), c2("C", "2");
+    myRegistry->addTest(&c1);
+    TestDescriptorInstaller a1(descriptorA1);
+    myRegistry->addTest(&c2);
+    TestDescriptorInstaller a2(descriptorA2);
+    TestDescriptorInstaller b1(descriptorB1);
+    myRegistry->runAllTests(*result);
+    STRCMP_EQUAL("B.1 A.2 C.2 A.1 C.1 ", mockResult->testsInOrder.asCharString());
+}
+
+TEST(TestRegistry, testFromADescriptorThatPassesTheFiltersOfALaterRunKeepsItsPlace)
+{
+    MockTest c1("C", "1");
+    TestDescriptorInstaller a1(descriptorA1);
+    TestDescriptorInstaller a2(descriptorA2);
+    myRegistry->addTest(&c1);
+    TestDescriptorInstaller b1(descriptorB1);
+    TestFilter nameFilter("1");
+    myRegistry->setNameFilters(&nameFilter);
+    myRegistry->runAllTests(*result);
+    STRCMP_EQUAL("B.1 C.1 A.1 ", mockResult->testsInOrder.asCharString());
+
+    mockResult->resetCount();
+    myRegistry->setNameFilters(NULL);
+    myRegistry->runAllTests(*result);
+    STRCMP_EQUAL("B.1 C.1 A.2 A.1 ", mockResult->testsInOrder.asCharString());
+}
+
+TEST(TestRegistry, testAddedBeforeAnotherRunsBehindTheTestsFromDescriptorsInFrontOfIt)
+{
+    MockTest c1("C", "1"), c2("C", "2"), c3("C", "3");
+    TestDescriptorInstaller a1(descriptorA1);
+    myRegistry->addTest(&c1);
+    TestDescriptorInstaller a2(descriptorA2);
+    myRegistry->addTestBefore(&c2, &c1);
+    myRegistry->addTestBefore(&c3, NULL);
+    myRegistry->runAllTests(*result);
+    STRCMP_EQUAL("A.2 C.2 C.1 A.1 C.3 ", mockResult->testsInOrder.asCharString());
+}
+
+TEST(TestRegistry, findTestWithNameFindsATestFromADescriptor)
+{
+    TestDescriptorInstaller b1(descriptorB1);
+    UtestShell* test = myRegistry->findTestWithName("1");
+    CHECK(test != NULL);
+    STRCMP_EQUAL("B", test->getGroup().asCharString());
+}
+
+TEST(TestRegistry, unDoLastAddTestDescriptor)
+{
+    TestDescriptorInstaller a1(descriptorA1);
+    TestDescriptorInstaller a2(descriptorA2);
+    a2.unDo();
+    LONGS_EQUAL(1, myRegistry->countTests());
+    myRegistry->runAllTests(*result);
+    STRCMP_EQUAL("A.1 ", mockResult->testsInOrder.asCharString());
+}
+
+TEST(TestRegistry, addTestDescriptorsAddsThemInTheirOrder)
+{
+    MockTest c1("C", "1");
+    TestDescriptor* descriptors[] = { &descriptorA1, &descriptorA2, &descriptorB1 };
+    myRegistry->addTest(&c1);
+    myRegistry->addTestDescriptors(descriptors, descriptors + 3);
+    LONGS_EQUAL(4, myRegistry->countTests());
+    myRegistry->runAllTests(*result);
+    STRCMP_EQUAL("B.1 A.2 A.1 C.1 ", mockResult->testsInOrder.asCharString());
+}
+
+static UtestShell& descriptorShellM1()
+{
+    static MockTest shell;
+    return shell;
+}
+
+static UtestShell& descriptorShellM3()
+{
+    static MockTest shell;
+    return shell;
+}
+
+static UtestShell& descriptorShellN1()
+{
+    static MockTest shell;
+    return shell;
+}
+
+TEST(TestRegistry, addTestDescriptorsKeepsAGroupWithInstalledTestsTogether)
+{
+    static TestDescriptor descriptorM1 = { "M", "1", "Mixed", 10, descriptorShellM1, NULL, NULL, NULL };
+    static TestDescriptor descriptorM3 = { "M", "3", "Mixed", 30, descriptorShellM3, NULL, NULL, NULL };
+    static TestDescriptor descriptorN1 = { "N", "1", "Other", 10, descriptorShellN1, NULL, NULL, NULL };
+    TestDescriptor* descriptors[] = { &descriptorM1, &descriptorM3, &descriptorN1 };
+    MockTest c1("C", "1");
+    MockTest m2("M", "2");
+    m2.setFileName("Mixed");
+    m2.setLineNumber(20);
+    myRegistry->addTest(&c1);
+    myRegistry->addTest(&m2);
+
+    myRegistry->addTestDescriptors(descriptors, descriptors + 3);
+    myRegistry->runAllTests(*result);
+    STRCMP_EQUAL("N.1 M.3 M.2 M.1 C.1 ", mockResult->testsInOrder.asCharString());
+}
+
+static void groupSetupLogs()
+{
+    *groupFixtureLog += "setup ";
+}
+
+static void groupTeardownLogs()
+{
+    *groupFixtureLog += "teardown ";
+}
+
+static void groupSetupFails()
+{
+    *groupFixtureLog += "setup ";
+    FAIL("group setup fails");
+}
+
+class GroupFixtureLoggingPlugin : public TestPlugin
+{
+public:
+    GroupFixtureLoggingPlugin() : TestPlugin("GroupFixtureLoggingPlugin")
+    {
+    }
+
+    virtual void preTestGroupFixtureAction(TestGroupFixtureShell& fixture, TestResult&) _override
+    {
+        *groupFixtureLog += StringFromFormat("pre:%s ", fixture.getFormattedName().asCharString());
+    }
+
+    virtual void postTestGroupFixtureAction(TestGroupFixtureShell& fixture, TestResult&) _override
+    {
+        *groupFixtureLog += StringFromFormat("post:%s ", fixture.getFormattedName().asCharString());
+    }
+};
+
+TEST(TestRegistry, groupFixtureRunsOnceAroundTheTestsOfItsGroup)
+{
+    MockTest a1("A", "1"), a2("A", "2"), b1("B", "1");
+    myRegistry->addTest(&a1);
+    myRegistry->addTest(&a2);
+    myRegistry->addTest(&b1);
+    TestGroupFixtureInstaller groupFixture("A", groupSetupLogs, groupTeardownLogs, __FILE__, __LINE__);
+    myRegistry->runAllTests(*result);
+    STRCMP_EQUAL("B.1 setup A.2 A.1 teardown ", mockResult->testsInOrder.asCharString());
+}
+
+TEST(TestRegistry, groupFixtureDoesNotRunWhenNoTestOfItsGroupRuns)
+{
+    MockTest a1("A", "1"), b1("B", "1");
+    myRegistry->addTest(&a1);
+    myRegistry->addTest(&b1);
+    TestGroupFixtureInstaller groupFixture("A", groupSetupLogs, groupTeardownLogs, __FILE__, __LINE__);
+    TestFilter groupFilter("B");
+    myRegistry->setGroupFilters(&groupFilter);
+    myRegistry->runAllTests(*result);
+    STRCMP_EQUAL("B.1 ", mockResult->testsInOrder.asCharString());
+}
+
+TEST(TestRegistry, groupWithOnlyATeardownRunsItAfterItsTests)
+{
+    MockTest a1("A", "1");
+    myRegistry->addTest(&a1);
+    TestGroupFixtureInstaller groupFixture("A", NULL, groupTeardownLogs, __FILE__, __LINE__);
+    myRegistry->runAllTests(*result);
+    STRCMP_EQUAL("A.1 teardown ", mockResult->testsInOrder.asCharString());
+}
+
+TEST(TestRegistry, testsOfAGroupWhoseSetupFailsAreIgnoredButItsTeardownRuns)
+{
+    MockTest a1("A", "1"), a2("A", "2"), b1("B", "1");
+    myRegistry->addTest(&a1);
+    myRegistry->addTest(&a2);
+    myRegistry->addTest(&b1);
+    TestGroupFixtureInstaller groupFixture("A", groupSetupFails, groupTeardownLogs, __FILE__, __LINE__);
+    myRegistry->runAllTests(*result);
+    STRCMP_EQUAL("B.1 setup A.2 A.1 teardown ", mockResult->testsInOrder.asCharString());
+    CHECK(!a1.hasRun_);
+    CHECK(!a2.hasRun_);
+    LONGS_EQUAL(1, result->getFailureCount());
+    LONGS_EQUAL(3, result->getTestCount());
+    LONGS_EQUAL(2, result->getIgnoredCount());
+    STRCMP_CONTAINS("TEST_GROUP_SETUP(A)", output->getOutput().asCharString());
+    STRCMP_CONTAINS("File:1 Not run, because TEST_GROUP_SETUP(A) failed", output->getOutput().asCharString());
+}
+
+TEST(TestRegistry, pluginsRunTheirGroupFixtureActionsAroundTheGroupFixture)
+{
+    GroupFixtureLoggingPlugin plugin;
+    myRegistry->installPlugin(&plugin);
+    MockTest a1("A", "1");
+    myRegistry->addTest(&a1);
+    TestGroupFixtureInstaller groupFixture("A", groupSetupLogs, groupTeardownLogs, __FILE__, __LINE__);
+    myRegistry->runAllTests(*result);
+    STRCMP_EQUAL("pre:TEST_GROUP_SETUP(A) setup post:TEST_GROUP_SETUP(A) A.1 "
+                 "pre:TEST_GROUP_TEARDOWN(A) teardown post:TEST_GROUP_TEARDOWN(A) ",
+                 mockResult->testsInOrder.asCharString());
+    myRegistry->resetPlugins();
+}
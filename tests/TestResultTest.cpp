@@ -64,3 +64,15 @@ TEST(TestResult, TestEndedWillPrintResultsAndExecutionTime)
     res->testsEnded();
     CHECK(mock->getOutput().contains("10 ms"));
 }
+
+TEST(TestResult, PeakMemoryIsResetWhenATestStarts)
+{
+    UtestShell test("group", "test", "file", 1);
+    res->setCurrentTestPeakMemory(120, 3);
+    CHECK(res->getCurrentTestPeakMemory() == 120);
+    CHECK(res->getCurrentTestPeakBlocks() == 3);
+
+    res->currentTestStarted(&test);
+    CHECK(res->getCurrentTestPeakMemory() == 0);
+    CHECK(res->getCurrentTestPeakBlocks() == 0);
+}
@@ -707,6 +707,36 @@ TEST(UnitTestMacros, MEMCMP_EQUALNullExpectedNullActual)
     MEMCMP_EQUAL(NULL, NULL, 1024);
 }
 
+TEST(UnitTestMacros, CHECK_PEAK_MEMORY_BELOWPassesWhenBelowTheLimit)
+{
+    CHECK_PEAK_MEMORY_BELOW(1000000);
+}
+
+#if CPPUTEST_USE_MEM_LEAK_DETECTION
+
+static void _failingPeakMemoryCheck()
+{
+    CHECK_PEAK_MEMORY_BELOW(64);
+    lineOfCodeExecutedAfterCheck = true; // LCOV_EXCL_LINE
+} // LCOV_EXCL_LINE
+
+TEST(UnitTestMacros, CHECK_PEAK_MEMORY_BELOWFailsWhenTheTestUsedTooMuchMemory)
+{
+    char* memory = new char[100];
+    runTestWithMethod(_failingPeakMemoryCheck);
+    delete [] memory;
+    CHECK_TEST_FAILS_PROPER_WITH_TEXT("expected <peak memory below 64 bytes>");
+    CHECK_TEST_FAILS_PROPER_WITH_TEXT("blocks>");
+}
+
+#endif
+
+TEST(UnitTestMacros, CHECK_PEAK_MEMORY_BELOWBehavesAsAProperMacro)
+{
+    if (false) CHECK_PEAK_MEMORY_BELOW(0)
+    else CHECK_PEAK_MEMORY_BELOW(1000000)
+}
+
 TEST(UnitTestMacros, BITS_EQUALBehavesAsAProperMacro)
 {
     if (false) BITS_EQUAL(0x00, 0xFF, 0xFF)
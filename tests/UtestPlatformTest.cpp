@@ -29,6 +29,8 @@
 #include "CppUTest/TestHarness.h"
 #include "CppUTest/TestTestingFixture.h"
 #include "CppUTest/PlatformSpecificFunctions.h"
+#include "CppUTest/TestMemoryAllocator.h"
+#include "CppUTest/GuardPageAllocatorPlugin.h"
 
 TEST_GROUP(UTestPlatformsTest_PlatformSpecificRunTestInASeperateProcess)
 {
@@ -86,7 +88,7 @@ extern "C" {
         }
     }
 
-    static int waitpid_failed_stub(int, int*, int) { return -1; }
+    static int waitpid_failed_stub(int, int*, int) { errno = ECHILD; return -1; }
 }
 
 static int _accessViolationTestFunction()
@@ -96,6 +98,32 @@ static int _accessViolationTestFunction()
 
 #include <unistd.h>
 #include <signal.h>
+#include <pthread.h>
+
+extern "C" {
+
+    static void* _passChecksInThread(void*)
+    {
+        for (int i = 0; i < 1000; i++)
+            CHECK(true);
+        return NULL;
+    }
+
+}
+
+static void _passChecksInAnotherThread()
+{
+    pthread_t thread;
+    pthread_create(&thread, NULL, _passChecksInThread, NULL);
+    pthread_join(thread, NULL);
+}
+
+TEST(UTestPlatformsTest_PlatformSpecificRunTestInASeperateProcess, ChecksPassedInAnotherThreadAreCounted)
+{
+    fixture.setTestFunction(_passChecksInAnotherThread);
+    fixture.runAllTests();
+    LONGS_EQUAL(1000, fixture.getCheckCount());
+}
 
 static void _stoppedTestFunction()
 {
@@ -143,6 +171,122 @@ TEST(UTestPlatformsTest_PlatformSpecificRunTestInASeperateProcess, CallToWaitPid
     fixture.assertPrintContains("OK (1 tests, 0 ran, 0 checks, 0 ignored, 0 filtered out");
 }
 
+static void _silentCrashHandler(const char*)
+{
+}
+
+static void _exitingCrashHandler(const char*)
+{
+    _exit(7);
+}
+
+static void _crashWithSilentCrashHandler()
+{
+    PlatformSpecificInstallCrashHandler(_silentCrashHandler);
+    _accessViolationTestFunction();
+}
+
+static void _crashWithExitingCrashHandler()
+{
+    PlatformSpecificInstallCrashHandler(_exitingCrashHandler);
+    _accessViolationTestFunction();
+}
+
+static void _crashWithUninstalledCrashHandler()
+{
+    PlatformSpecificInstallCrashHandler(_exitingCrashHandler);
+    PlatformSpecificUninstallCrashHandler();
+    _accessViolationTestFunction();
+}
+
+TEST(UTestPlatformsTest_PlatformSpecificRunTestInASeperateProcess, CrashHandlerIsCalledOnCrash)
+{
+    fixture.registry_->setRunTestsInSeperateProcess();
+    fixture.setTestFunction(_crashWithExitingCrashHandler);
+    fixture.runAllTests();
+    fixture.assertPrintContains("Failed in separate process");
+    CHECK(!fixture.output_->getOutput().contains("killed by signal"));
+}
+
+TEST(UTestPlatformsTest_PlatformSpecificRunTestInASeperateProcess, CrashHandlerStillTerminatesWithTheSignal)
+{
+    fixture.registry_->setRunTestsInSeperateProcess();
+    fixture.setTestFunction(_crashWithSilentCrashHandler);
+    fixture.runAllTests();
+    fixture.assertPrintContains("Failed in separate process - killed by signal 11");
+}
+
+TEST(UTestPlatformsTest_PlatformSpecificRunTestInASeperateProcess, UninstalledCrashHandlerIsNotCalled)
+{
+    fixture.registry_->setRunTestsInSeperateProcess();
+    fixture.setTestFunction(_crashWithUninstalledCrashHandler);
+    fixture.runAllTests();
+    fixture.assertPrintContains("Failed in separate process - killed by signal 11");
+}
+
+static void _writeBehindGuardedMemory()
+{
+    GuardPageMemoryAllocator allocator;
+    allocator.setAlignment(1);
+    char* memory = allocator.alloc_memory(10, "file", 1);
+    memory[10] = 'x';
+}
+
+static void _writeInFrontOfGuardedMemory()
+{
+    GuardPageMemoryAllocator allocator;
+    allocator.setGuardPlacement(GuardPageMemoryAllocator::guard_before_memory);
+    char* memory = allocator.alloc_memory(10, "file", 1);
+    memory[-1] = 'x';
+}
+
+TEST(UTestPlatformsTest_PlatformSpecificRunTestInASeperateProcess, GuardPageCatchesOverrunAtTheWrite)
+{
+    fixture.registry_->setRunTestsInSeperateProcess();
+    fixture.setTestFunction(_writeBehindGuardedMemory);
+    fixture.runAllTests();
+    fixture.assertPrintContains("Failed in separate process - killed by signal");
+}
+
+TEST(UTestPlatformsTest_PlatformSpecificRunTestInASeperateProcess, GuardPageCatchesUnderrunAtTheWrite)
+{
+    fixture.registry_->setRunTestsInSeperateProcess();
+    fixture.setTestFunction(_writeInFrontOfGuardedMemory);
+    fixture.runAllTests();
+    fixture.assertPrintContains("Failed in separate process - killed by signal");
+}
+
+static void _writeOneByteBehindMallocOfAGuardedTest()
+{
+    char* memory = (char*) malloc(1);
+    memory[1] = 'x';
+    free(memory);
+}
+
+static void _writeOneByteBehindNewOfAGuardedTest()
+{
+    char* memory = new char;
+    memory[1] = 'x';
+    delete memory;
+}
+
+TEST(UTestPlatformsTest_PlatformSpecificRunTestInASeperateProcess, GuardPageAllocatorPluginCatchesOneByteOverrunsOfTheTest)
+{
+    GuardPageAllocatorPlugin plugin;
+    plugin.guardTestGroups("Generic");
+    fixture.registry_->installPlugin(&plugin);
+    fixture.registry_->setRunTestsInSeperateProcess();
+
+    fixture.setTestFunction(_writeOneByteBehindMallocOfAGuardedTest);
+    fixture.runAllTests();
+    fixture.assertPrintContains("Failed in separate process - killed by signal");
+
+    fixture.setTestFunction(_writeOneByteBehindNewOfAGuardedTest);
+    fixture.runAllTests();
+    LONGS_EQUAL(2, fixture.getFailureCount());
+    fixture.registry_->resetPlugins();
+}
+
 TEST(UTestPlatformsTest_PlatformSpecificRunTestInASeperateProcess, CallToWaitPidFailedInSeparateProcessWorks)
 {
     UT_PTR_SET(PlatformSpecificWaitPid, waitpid_failed_stub);
@@ -82,6 +82,107 @@ TEST(UtestShell, PassedCheckEqualWillIncreaseTheAmountOfChecks)
     LONGS_EQUAL(1, fixture.getCheckCount());
 }
 
+static void _passingChecksOfEachKindTestMethod()
+{
+    int value = 5;
+    CHECK(true);
+    CHECK_TEXT(true, "text");
+    CHECK_FALSE(false);
+    LONGS_EQUAL(1, 1);
+    UNSIGNED_LONGS_EQUAL(1, 1);
+    POINTERS_EQUAL(&value, &value);
+    DOUBLES_EQUAL(1.0, 1.001, 0.01);
+    BITS_EQUAL(0x0F, 0xFF, 0x0F);
+}
+
+TEST(UtestShell, PassingChecksAreCountedInTheResultOfTheTestThatDidThem)
+{
+    fixture.setTestFunction(_passingChecksOfEachKindTestMethod);
+    fixture.runAllTests();
+    LONGS_EQUAL(8, fixture.getCheckCount());
+    LONGS_EQUAL(0, fixture.getFailureCount());
+}
+
+static int _evaluationCount;
+
+static long _countedEvaluation()
+{
+    return ++_evaluationCount;
+}
+
+static void _failingLongsEqualTestMethod()
+{
+    LONGS_EQUAL(5, _countedEvaluation());
+}
+
+TEST(UtestShell, FailingChecksEvaluateTheirParametersOnlyOnce)
+{
+    _evaluationCount = 0;
+    fixture.setTestFunction(_failingLongsEqualTestMethod);
+    fixture.runAllTests();
+    LONGS_EQUAL(1, _evaluationCount);
+    LONGS_EQUAL(1, fixture.getCheckCount());
+    fixture.assertPrintContains("expected <5 0x5>");
+}
+
+static int _amountOfPassingChecks;
+
+static void _manyPassingChecksTestMethod()
+{
+    for (int i = 0; i < _amountOfPassingChecks; i++) {
+        volatile long actual = i;
+        LONGS_EQUAL(i, actual);
+    }
+}
+
+TEST(UtestShell, ManyPassingChecksAreAllCounted)
+{
+    _amountOfPassingChecks = 1000000;
+    fixture.setTestFunction(_manyPassingChecksTestMethod);
+    fixture.runAllTests();
+    LONGS_EQUAL(1000000, fixture.getCheckCount());
+}
+
+class AssertTrueRecordingTestShell : public ExecFunctionTestShell
+{
+public:
+    int assertTrueCalls;
+
+    AssertTrueRecordingTestShell() : assertTrueCalls(0) {}
+
+    virtual void assertTrue(bool condition, const char *checkString, const char *conditionString, const char *fileName, int lineNumber, const TestTerminator& testTerminator) _override
+    {
+        assertTrueCalls++;
+        ExecFunctionTestShell::assertTrue(condition, checkString, conditionString, fileName, lineNumber, testTerminator);
+    }
+};
+
+static void _failingCheckMethod()
+{
+    CHECK(false);
+}
+
+TEST(UtestShell, FailingCheckIsReportedThroughAssertTrue)
+{
+    AssertTrueRecordingTestShell shell;
+    shell.testFunction_ = _failingCheckMethod;
+    fixture.addTest(&shell);
+    fixture.runAllTests();
+    LONGS_EQUAL(1, shell.assertTrueCalls);
+    LONGS_EQUAL(1, fixture.getFailureCount());
+}
+
+/* Benchmark of the passing checks, change it into a TEST to run it */
+IGNORE_TEST(UtestShell, PassingChecksPerSecondBenchmark)
+{
+    _amountOfPassingChecks = 100000000;
+    fixture.setTestFunction(_manyPassingChecksTestMethod);
+    long start = GetPlatformSpecificTimeInMillis();
+    fixture.runAllTests();
+    long elapsed = GetPlatformSpecificTimeInMillis() - start;
+    if (elapsed == 0) elapsed = 1;
+    UT_PRINT(StringFromFormat("%d checks in %ld ms: %ld checks/sec", fixture.getCheckCount(), elapsed, (long) (fixture.getCheckCount() / elapsed) * 1000).asCharString());
+}
 
 IGNORE_TEST(UtestShell, IgnoreTestAccessingFixture)
 {
@@ -194,6 +295,73 @@ IGNORE_TEST(UtestShell, TestDefaultCrashMethodInSeparateProcessTest) {}
 
 #endif
 
+static char crashReport[256];
+static size_t crashReportLength = 0;
+
+extern "C" {
+    static void crashReportWrite(const char* buffer, size_t size)
+    {
+        PlatformSpecificMemCpy(crashReport + crashReportLength, buffer, size);
+        crashReportLength += size;
+        crashReport[crashReportLength] = '\0';
+    }
+}
+
+static void crashReportBacktrace()
+{
+    crashReportWrite("backtrace\n", 10);
+}
+
+static void _reportCrashMethod()
+{
+    UtestShell::reportCrashOfCurrentTest("SIGSEGV");
+}
+
+static void _reportCrashWithBacktraceMethod()
+{
+    UtestShell::reportCrashOfCurrentTestWithBacktrace("SIGSEGV");
+}
+
+/* The report writes the block of the latest buffered output, so each test has one of its own rather than the one of -b */
+TEST(UtestShell, CrashReportNamesTheCurrentTest)
+{
+    crashReportLength = 0;
+    UT_PTR_SET(PlatformSpecificWrite, crashReportWrite);
+    BufferedConsoleTestOutput bufferedOutput;
+    UT_PTR_SET(PlatformSpecificWriteBacktrace, crashReportBacktrace);
+    fixture.genTest_->setFileName("crashfile.cpp");
+    fixture.genTest_->setLineNumber(42);
+    fixture.setTestFunction(_reportCrashMethod);
+    fixture.runAllTests();
+    STRCMP_EQUAL("\ncrashfile.cpp:42: error: Crashed with SIGSEGV in TEST(Generic, Generic)\n", crashReport);
+}
+
+TEST(UtestShell, CrashReportComesAfterTheBufferedOutput)
+{
+    crashReportLength = 0;
+    UT_PTR_SET(PlatformSpecificWrite, crashReportWrite);
+    BufferedConsoleTestOutput bufferedOutput;
+    bufferedOutput.print("...");
+    fixture.genTest_->setFileName("crashfile.cpp");
+    fixture.genTest_->setLineNumber(42);
+    fixture.setTestFunction(_reportCrashMethod);
+    fixture.runAllTests();
+    STRCMP_EQUAL("...\ncrashfile.cpp:42: error: Crashed with SIGSEGV in TEST(Generic, Generic)\n", crashReport);
+}
+
+TEST(UtestShell, CrashReportWithBacktraceWritesTheBacktraceAfterTheTest)
+{
+    crashReportLength = 0;
+    UT_PTR_SET(PlatformSpecificWrite, crashReportWrite);
+    BufferedConsoleTestOutput bufferedOutput;
+    UT_PTR_SET(PlatformSpecificWriteBacktrace, crashReportBacktrace);
+    fixture.genTest_->setFileName("crashfile.cpp");
+    fixture.genTest_->setLineNumber(42);
+    fixture.setTestFunction(_reportCrashWithBacktraceMethod);
+    fixture.runAllTests();
+    STRCMP_EQUAL("\ncrashfile.cpp:42: error: Crashed with SIGSEGV in TEST(Generic, Generic)\nbacktrace\n", crashReport);
+}
+
 #if CPPUTEST_USE_STD_CPP_LIB
 
 static bool destructorWasCalledOnFailedTest = false;
@@ -214,6 +382,37 @@ TEST(UtestShell, DestructorIsCalledForLocalObjectsWhenTheTestFails)
 
 #endif
 
+struct AdditionRow
+{
+    long augend;
+    long addend;
+    long sum;
+};
+
+static const AdditionRow additionRows[] =
+{
+    { 0, 0, 0 },
+    { 1, 2, 3 },
+    { -1, 1, 0 }
+};
+
+TEST_P(UtestShell, AdditionFromATable, AdditionRow, additionRows)
+{
+    LONGS_EQUAL(param.sum, param.augend + param.addend);
+}
+
+static long squareOf(size_t index)
+{
+    return (long) (index * index);
+}
+
+TEST_P_GENERATED(UtestShell, SquaresFromAGenerator, long, 4, squareOf)
+{
+    long root = 0;
+    while (root * root < param) root++;
+    LONGS_EQUAL(param, root * root);
+}
+
 TEST_BASE(MyOwnTest)
 {
     MyOwnTest() :
@@ -286,3 +485,31 @@ TEST(CanHaveMemberVariablesInTestGroupThatAllocateMemoryWithoutCausingMemoryLeak
     dummy.allocateMoreMemory();
 }
 
+static int* sharedByTheGroup = NULL;
+
+TEST_GROUP(UtestGroupFixture)
+{
+};
+
+TEST_GROUP_SETUP(UtestGroupFixture)
+{
+    sharedByTheGroup = new int(0);
+}
+
+TEST_GROUP_TEARDOWN(UtestGroupFixture)
+{
+    delete sharedByTheGroup;
+    sharedByTheGroup = NULL;
+}
+
+TEST(UtestGroupFixture, TestsSeeWhatTheGroupSetupMade)
+{
+    CHECK(sharedByTheGroup != NULL);
+    (*sharedByTheGroup)++;
+}
+
+TEST(UtestGroupFixture, TestsShareWhatTheGroupSetupMade)
+{
+    CHECK(sharedByTheGroup != NULL);
+    (*sharedByTheGroup)++;
+}